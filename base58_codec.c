@@ -0,0 +1,166 @@
+#include "base58_codec.h"
+#include <stdlea.h>
+
+#define LIMB_COUNT (CTE_BASE58_MAX_SIZE / 4)
+#define GROUP_BASE 656356768u // 58^5
+
+/** @brief The Bitcoin Base58 alphabet. */
+static const char base58_digits[58] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+/** @brief Value of each character, or -1 if it is not a Base58 digit. */
+static const int8_t base58_values[128] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, 0,  1,  2,  3,  4,  5,  6,  7,  8,  -1, -1, -1, -1, -1, -1, -1, 9,
+    10, 11, 12, 13, 14, 15, 16, -1, 17, 18, 19, 20, 21, -1, 22, 23, 24, 25, 26, 27, 28, 29,
+    30, 31, 32, -1, -1, -1, -1, -1, -1, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, -1, 44,
+    45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, -1, -1, -1, -1, -1,
+};
+
+/**
+ * @brief Multiplies the little-endian limbs by `factor` and adds `addend`.
+ * @return The carry out of the top limb; non-zero means overflow.
+ * @note Internal helper function.
+ */
+static uint32_t _mul_add(uint32_t *limbs, size_t count, uint32_t factor, uint32_t addend)
+{
+    uint64_t carry = addend;
+    for (size_t i = 0; i < count; ++i)
+    {
+        carry += (uint64_t)limbs[i] * factor;
+        limbs[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    return (uint32_t)carry;
+}
+
+/**
+ * @brief Divides the little-endian limbs by `divisor` in place.
+ * @return The remainder.
+ * @note Internal helper function.
+ */
+static uint32_t _div_mod(uint32_t *limbs, size_t count, uint32_t divisor)
+{
+    uint64_t remainder = 0;
+    for (size_t i = count; i-- > 0;)
+    {
+        uint64_t value = remainder << 32 | limbs[i];
+        limbs[i] = (uint32_t)(value / divisor);
+        remainder = value % divisor;
+    }
+    return (uint32_t)remainder;
+}
+
+LEA_EXPORT(cte_base58_decode)
+bool cte_base58_decode(const char *text, size_t length, uint8_t *out, size_t size)
+{
+    if (size == 0 || size > CTE_BASE58_MAX_SIZE || length > CTE_BASE58_MAX_LENGTH)
+    {
+        return false;
+    }
+    size_t zeros = 0;
+    while (zeros < length && text[zeros] == '1')
+    {
+        zeros++;
+    }
+
+    uint32_t limbs[LIMB_COUNT] = {0};
+    size_t limb_count = (size + 3) / 4;
+    size_t i = 0;
+    while (i < length)
+    {
+        uint32_t group = 0;
+        uint32_t factor = 1;
+        for (size_t end = i + 5 < length ? i + 5 : length; i < end; ++i)
+        {
+            unsigned char c = (unsigned char)text[i];
+            int value = c < 128 ? base58_values[c] : -1;
+            if (value < 0)
+            {
+                return false;
+            }
+            group = group * 58 + (uint32_t)value;
+            factor *= 58;
+        }
+        if (_mul_add(limbs, limb_count, factor, group) != 0)
+        {
+            return false;
+        }
+    }
+
+    // Limbs to big-endian bytes; bits above `size` bytes must be clear.
+    if (size % 4 != 0 && limbs[limb_count - 1] >> (8 * (size % 4)) != 0)
+    {
+        return false;
+    }
+    for (size_t k = 0; k < size; ++k)
+    {
+        size_t bit = 8 * (size - 1 - k);
+        out[k] = (uint8_t)(limbs[bit / 32] >> (bit % 32));
+    }
+
+    size_t zero_bytes = 0;
+    while (zero_bytes < size && out[zero_bytes] == 0)
+    {
+        zero_bytes++;
+    }
+    return zero_bytes == zeros;
+}
+
+LEA_EXPORT(cte_base58_encode)
+size_t cte_base58_encode(const uint8_t *data, size_t size, char *out)
+{
+    if (size == 0 || size > CTE_BASE58_MAX_SIZE)
+    {
+        return 0;
+    }
+    size_t zeros = 0;
+    while (zeros < size && data[zeros] == 0)
+    {
+        zeros++;
+    }
+
+    uint32_t limbs[LIMB_COUNT] = {0};
+    size_t limb_count = (size + 3) / 4;
+    for (size_t k = 0; k < size; ++k)
+    {
+        size_t bit = 8 * (size - 1 - k);
+        limbs[bit / 32] |= (uint32_t)data[k] << (bit % 32);
+    }
+
+    // Peel off five digits per division, least significant first.
+    char digits[CTE_BASE58_MAX_LENGTH + 5];
+    size_t count = 0;
+    for (;;)
+    {
+        while (limb_count > 0 && limbs[limb_count - 1] == 0)
+        {
+            limb_count--;
+        }
+        if (limb_count == 0)
+        {
+            break;
+        }
+        uint32_t group = _div_mod(limbs, limb_count, GROUP_BASE);
+        for (int d = 0; d < 5; ++d)
+        {
+            digits[count++] = base58_digits[group % 58];
+            group /= 58;
+        }
+    }
+    while (count > 0 && digits[count - 1] == base58_digits[0])
+    {
+        count--; // padding digits of the last group
+    }
+
+    size_t length = 0;
+    for (; length < zeros; ++length)
+    {
+        out[length] = base58_digits[0];
+    }
+    while (count > 0)
+    {
+        out[length++] = digits[--count];
+    }
+    return length;
+}
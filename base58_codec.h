@@ -0,0 +1,51 @@
+#ifndef BASE58_CODEC_H
+#define BASE58_CODEC_H
+
+#include <stdlea.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file base58_codec.h
+ * @brief Base58 (Bitcoin alphabet) conversion of fixed-size keys.
+ *
+ * Keys are at most `CTE_PUBKEY_SIZE_SLH_256F` (64) bytes, so the value is held
+ * in sixteen 32-bit limbs and digits are consumed five at a time
+ * (58^5 < 2^32), one multiply-add pass over the limbs per group.
+ */
+
+/** @brief Largest key size handled, in bytes. */
+#define CTE_BASE58_MAX_SIZE 64
+/** @brief Longest Base58 string for a `CTE_BASE58_MAX_SIZE`-byte key. */
+#define CTE_BASE58_MAX_LENGTH 88
+
+/**
+ * @brief Decodes a Base58 string into exactly `size` bytes.
+ *
+ * Each leading '1' stands for one leading zero byte, so the string must
+ * decode to exactly `size` bytes, not fewer or more.
+ *
+ * @param text The Base58 digits; no terminator is required.
+ * @param length The number of digits at `text`.
+ * @param out Receives `size` bytes. Its contents are unspecified on failure.
+ * @param size The expected size, 1 to `CTE_BASE58_MAX_SIZE`.
+ * @return `true` on success, `false` on an invalid digit or a size mismatch.
+ */
+bool cte_base58_decode(const char *text, size_t length, uint8_t *out, size_t size);
+
+/**
+ * @brief Encodes bytes as Base58.
+ * @param data The bytes to encode.
+ * @param size The number of bytes, at most `CTE_BASE58_MAX_SIZE`.
+ * @param out Receives up to `CTE_BASE58_MAX_LENGTH` digits; no terminator is written.
+ * @return The number of digits written, or 0 if `size` is out of range.
+ */
+size_t cte_base58_encode(const uint8_t *data, size_t size, char *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BASE58_CODEC_H
@@ -0,0 +1,247 @@
+#include "base64_codec.h"
+#include <stdlea.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BASE64_CODEC_X86 1
+#endif
+
+/** @brief The standard Base64 alphabet. */
+static const char base64_digits[64] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/**
+ * @brief Returns the value of one Base64 digit, or -1 if it is not a digit.
+ * @note Internal helper function.
+ */
+static int _sextet(char c)
+{
+    if (c >= 'A' && c <= 'Z')
+    {
+        return c - 'A';
+    }
+    if (c >= 'a' && c <= 'z')
+    {
+        return c - 'a' + 26;
+    }
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0' + 52;
+    }
+    if (c == '+')
+    {
+        return 62;
+    }
+    if (c == '/')
+    {
+        return 63;
+    }
+    return -1;
+}
+
+/**
+ * @brief Encodes `size` bytes (padding the last group) with the scalar loop.
+ * @note Internal helper function.
+ */
+static void _encode_scalar(const uint8_t *data, size_t size, char *out)
+{
+    for (; size >= 3; size -= 3, data += 3, out += 4)
+    {
+        uint32_t v = (uint32_t)data[0] << 16 | (uint32_t)data[1] << 8 | data[2];
+        out[0] = base64_digits[v >> 18];
+        out[1] = base64_digits[(v >> 12) & 0x3F];
+        out[2] = base64_digits[(v >> 6) & 0x3F];
+        out[3] = base64_digits[v & 0x3F];
+    }
+    if (size > 0)
+    {
+        uint32_t v = (uint32_t)data[0] << 16 | (size > 1 ? (uint32_t)data[1] << 8 : 0);
+        out[0] = base64_digits[v >> 18];
+        out[1] = base64_digits[(v >> 12) & 0x3F];
+        out[2] = size > 1 ? base64_digits[(v >> 6) & 0x3F] : '=';
+        out[3] = '=';
+    }
+}
+
+/**
+ * @brief Decodes `groups` unpadded 4-character groups into 3 bytes each.
+ * @return `false` if any character is invalid.
+ * @note Internal helper function.
+ */
+static bool _decode_scalar(const char *text, size_t groups, uint8_t *out)
+{
+    for (size_t g = 0; g < groups; ++g, text += 4, out += 3)
+    {
+        int a = _sextet(text[0]), b = _sextet(text[1]), c = _sextet(text[2]), d = _sextet(text[3]);
+        if ((a | b | c | d) < 0)
+        {
+            return false;
+        }
+        uint32_t v = (uint32_t)a << 18 | (uint32_t)b << 12 | (uint32_t)c << 6 | (uint32_t)d;
+        out[0] = (uint8_t)(v >> 16);
+        out[1] = (uint8_t)(v >> 8);
+        out[2] = (uint8_t)v;
+    }
+    return true;
+}
+
+#ifdef BASE64_CODEC_X86
+
+/*
+ * The AVX2 blocks follow Muła and Lemire, "Faster Base64 Encoding and
+ * Decoding Using AVX2 Instructions": bytes are spread into 6-bit lanes with
+ * multiplies, and digits are classified and translated with pshufb lookups
+ * indexed by nibble.
+ */
+
+/**
+ * @brief Encodes 24 bytes into 32 characters with AVX2. Reads 28 bytes.
+ * @note Internal helper function.
+ */
+__attribute__((target("avx2"))) static void _encode_avx2_block(const uint8_t *data, char *out)
+{
+    __m256i in = _mm256_set_m128i(_mm_loadu_si128((const __m128i *)(data + 12)),
+                                  _mm_loadu_si128((const __m128i *)data));
+    // Each 32-bit lane becomes bytes (b1, b0, b2, b1) of one 3-byte group.
+    in = _mm256_shuffle_epi8(in, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1, 10, 11, 9, 10,
+                                                 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m256i ac = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)),
+                                    _mm256_set1_epi32(0x04000040));
+    __m256i bd = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)),
+                                    _mm256_set1_epi32(0x01000010));
+    __m256i sextets = _mm256_or_si256(ac, bd);
+
+    // Offset to add per range: 0-25 -> 13, 26-51 -> 0, 52-61 -> 1..10, 62 -> 11, 63 -> 12.
+    __m256i range = _mm256_subs_epu8(sextets, _mm256_set1_epi8(51));
+    range = _mm256_or_si256(range, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), sextets),
+                                                    _mm256_set1_epi8(13)));
+    const __m256i offsets = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '+' - 62, '/' - 63, 'A', 0, 0, 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    __m256i chars = _mm256_add_epi8(sextets, _mm256_shuffle_epi8(offsets, range));
+    _mm256_storeu_si256((__m256i *)out, chars);
+}
+
+/**
+ * @brief Decodes 32 characters into 24 bytes with AVX2.
+ * @return `false` if any character is invalid.
+ * @note Internal helper function.
+ */
+__attribute__((target("avx2"))) static bool _decode_avx2_block(const char *text, uint8_t *out)
+{
+    const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A,
+                                            0x1B, 0x1B, 0x1B, 0x1A, 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0, 0, 16, 19, 4,
+                                              -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask_2f = _mm256_set1_epi8(0x2F);
+
+    __m256i in = _mm256_loadu_si256((const __m256i *)text);
+    __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask_2f);
+    __m256i lo_nibbles = _mm256_and_si256(in, mask_2f);
+    // A character is valid when its high- and low-nibble classes share no bit.
+    if (!_mm256_testz_si256(_mm256_shuffle_epi8(lut_lo, lo_nibbles), _mm256_shuffle_epi8(lut_hi, hi_nibbles)))
+    {
+        return false;
+    }
+    __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(_mm256_cmpeq_epi8(in, mask_2f), hi_nibbles));
+    __m256i sextets = _mm256_add_epi8(in, roll);
+
+    __m256i pairs = _mm256_maddubs_epi16(sextets, _mm256_set1_epi32(0x01400140));
+    __m256i groups = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+    groups = _mm256_shuffle_epi8(groups, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1,
+                                                          0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    groups = _mm256_permutevar8x32_epi32(groups, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    uint8_t block[32];
+    _mm256_storeu_si256((__m256i *)block, groups);
+    memcpy(out, block, 24);
+    return true;
+}
+
+#endif // BASE64_CODEC_X86
+
+LEA_EXPORT(cte_base64_encoded_length)
+size_t cte_base64_encoded_length(size_t size)
+{
+    return (size + 2) / 3 * 4;
+}
+
+LEA_EXPORT(cte_base64_encode)
+void cte_base64_encode(const uint8_t *data, size_t size, char *out)
+{
+    size_t done = 0;
+#ifdef BASE64_CODEC_X86
+    if (__builtin_cpu_supports("avx2"))
+    {
+        for (; done + 28 <= size; done += 24)
+        {
+            _encode_avx2_block(data + done, out + done / 3 * 4);
+        }
+    }
+#endif
+    _encode_scalar(data + done, size - done, out + done / 3 * 4);
+}
+
+LEA_EXPORT(cte_base64_decode)
+bool cte_base64_decode(const char *text, size_t length, uint8_t *out, size_t *size)
+{
+    if (length % 4 != 0)
+    {
+        return false;
+    }
+    if (length == 0)
+    {
+        *size = 0;
+        return true;
+    }
+
+    // The last group may be padded; everything before it is plain digits.
+    size_t groups = length / 4 - 1;
+    size_t done = 0;
+#ifdef BASE64_CODEC_X86
+    if (__builtin_cpu_supports("avx2"))
+    {
+        for (; done + 8 <= groups; done += 8)
+        {
+            if (!_decode_avx2_block(text + 4 * done, out + 3 * done))
+            {
+                return false;
+            }
+        }
+    }
+#endif
+    if (!_decode_scalar(text + 4 * done, groups - done, out + 3 * done))
+    {
+        return false;
+    }
+
+    const char *last = text + 4 * groups;
+    uint8_t *tail = out + 3 * groups;
+    size_t padding = last[3] != '=' ? 0 : last[2] != '=' ? 1 : 2;
+    int a = _sextet(last[0]), b = _sextet(last[1]);
+    int c = padding < 2 ? _sextet(last[2]) : 0;
+    int d = padding < 1 ? _sextet(last[3]) : 0;
+    if ((a | b | c | d) < 0)
+    {
+        return false;
+    }
+    uint32_t v = (uint32_t)a << 18 | (uint32_t)b << 12 | (uint32_t)c << 6 | (uint32_t)d;
+    if ((padding == 1 && (v & 0xFF) != 0) || (padding == 2 && (v & 0xFFFF) != 0))
+    {
+        return false; // non-canonical bits under the padding
+    }
+    tail[0] = (uint8_t)(v >> 16);
+    if (padding < 2)
+    {
+        tail[1] = (uint8_t)(v >> 8);
+    }
+    if (padding < 1)
+    {
+        tail[2] = (uint8_t)v;
+    }
+    *size = 3 * groups + 3 - padding;
+    return true;
+}
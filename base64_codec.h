@@ -0,0 +1,52 @@
+#ifndef BASE64_CODEC_H
+#define BASE64_CODEC_H
+
+#include <stdlea.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file base64_codec.h
+ * @brief Validated Base64 (RFC 4648, padded) encoding and decoding.
+ *
+ * On x86 the codec converts 24 bytes per step with AVX2 when the CPU
+ * supports it (checked at run time); the tail and other targets use a
+ * scalar loop. Both paths accept exactly the same input.
+ */
+
+/**
+ * @brief Returns the encoded length of `size` bytes, including padding.
+ * @param size The number of bytes to encode.
+ * @return The number of Base64 characters.
+ */
+size_t cte_base64_encoded_length(size_t size);
+
+/**
+ * @brief Encodes bytes as padded Base64.
+ * @param data The bytes to encode.
+ * @param size The number of bytes at `data`.
+ * @param out Receives `cte_base64_encoded_length(size)` characters; no terminator is written.
+ */
+void cte_base64_encode(const uint8_t *data, size_t size, char *out);
+
+/**
+ * @brief Decodes padded Base64.
+ *
+ * The length must be a multiple of 4, with at most two '=' at the end, and
+ * unused bits before the padding must be zero.
+ *
+ * @param text The characters; no whitespace or terminator.
+ * @param length The number of characters at `text`.
+ * @param out Receives the bytes; must hold `length / 4 * 3`. Its contents are unspecified on failure.
+ * @param size Receives the number of decoded bytes.
+ * @return `true` on success, `false` on malformed input.
+ */
+bool cte_base64_decode(const char *text, size_t length, uint8_t *out, size_t *size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BASE64_CODEC_H
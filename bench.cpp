@@ -0,0 +1,315 @@
+#include "cte.hpp"
+#include "cte_schema.h"
+#include "shape_cache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * @file bench.cpp
+ * @brief Native micro-benchmarks for the CTE library.
+ *
+ * Each benchmark decodes the same representative transaction many times and
+ * reports the time per transaction. A checksum over the decoded values is
+ * printed with every result so the compiler cannot discard the work and so
+ * the variants can be checked against each other.
+ */
+
+#define DEFAULT_ITERATIONS 1000000
+#define ROUNDS 5
+
+/**
+ * @brief Builds the representative transaction used by all benchmarks.
+ * @param enc The encoder to write into; it is reset first.
+ */
+static void build_sample(cte::encoder &enc)
+{
+    uint8_t keys[2 * CTE_PUBKEY_SIZE_ED25519];
+    uint8_t sigs[2 * CTE_SIGNATURE_SIZE_ED25519];
+    uint8_t cmd[96];
+    memset(keys, 0xAA, sizeof(keys));
+    memset(sigs, 0xBB, sizeof(sigs));
+    memset(cmd, 0xCC, sizeof(cmd));
+
+    enc.reset();
+    enc.write_public_key_list(CTE_CRYPTO_TYPE_ED25519, keys);
+    enc.write_signature_list(CTE_CRYPTO_TYPE_ED25519, sigs);
+    enc.write_index_reference(1);
+    enc.write_uleb128(1000000);
+    enc.write_uleb128(5000);
+    enc.write_sleb128(-42);
+    enc.write_uint32(0xDEADBEEF);
+    enc.write_uint64(9876543210ULL);
+    enc.write_boolean(true);
+    enc.write_command_data({cmd, 8});
+    enc.write_command_data(cmd);
+}
+
+/**
+ * @brief Accumulates a decoded field into a checksum (shared by all variants).
+ */
+static inline uint64_t mix(uint64_t sum, uint64_t v)
+{
+    return (sum ^ v) * 0x100000001B3ULL;
+}
+
+/**
+ * @brief Hand-written peek/switch loop over the C API.
+ */
+static uint64_t decode_c_api(cte_decoder_t *dec)
+{
+    uint64_t sum = 0;
+    cte_decoder_reset(dec);
+    for (;;)
+    {
+        int type = cte_decoder_peek_type(dec);
+        switch (type)
+        {
+        case CTE_PEEK_EOF:
+            return sum;
+        case CTE_PEEK_TYPE_PK_LIST_ED25519:
+            sum = mix(sum, cte_decoder_read_public_key_list_data(dec)[0]);
+            break;
+        case CTE_PEEK_TYPE_SIG_LIST_ED25519:
+            sum = mix(sum, cte_decoder_read_signature_list_data(dec)[0]);
+            break;
+        case CTE_PEEK_TYPE_IXDATA_LEGACY_INDEX:
+            sum = mix(sum, cte_decoder_read_ixdata_index_reference(dec));
+            break;
+        case CTE_PEEK_TYPE_IXDATA_ULEB128:
+            sum = mix(sum, cte_decoder_read_ixdata_uleb128(dec));
+            break;
+        case CTE_PEEK_TYPE_IXDATA_SLEB128:
+            sum = mix(sum, (uint64_t)cte_decoder_read_ixdata_sleb128(dec));
+            break;
+        case CTE_PEEK_TYPE_IXDATA_UINT32:
+            sum = mix(sum, cte_decoder_read_ixdata_uint32(dec));
+            break;
+        case CTE_PEEK_TYPE_IXDATA_UINT64:
+            sum = mix(sum, cte_decoder_read_ixdata_uint64(dec));
+            break;
+        case CTE_PEEK_TYPE_IXDATA_CONST_TRUE:
+        case CTE_PEEK_TYPE_IXDATA_CONST_FALSE:
+            sum = mix(sum, cte_decoder_read_ixdata_boolean(dec));
+            break;
+        case CTE_PEEK_TYPE_CMD_SHORT:
+        case CTE_PEEK_TYPE_CMD_EXTENDED:
+            cte_decoder_read_command_data_payload(dec);
+            sum = mix(sum, cte_decoder_get_last_command_payload_length(dec));
+            break;
+        default:
+            lea_abort("Unexpected field type in benchmark sample");
+        }
+    }
+}
+
+/**
+ * @brief The same loop written against the C++ field range.
+ */
+static uint64_t decode_cpp_range(cte::decoder &dec)
+{
+    uint64_t sum = 0;
+    dec.reset();
+    for (const cte::field_view &f : dec.fields())
+    {
+        switch (f.type)
+        {
+        case CTE_PEEK_TYPE_PK_LIST_ED25519:
+        case CTE_PEEK_TYPE_SIG_LIST_ED25519:
+            sum = mix(sum, f.bytes[0]);
+            break;
+        case CTE_PEEK_TYPE_CMD_SHORT:
+        case CTE_PEEK_TYPE_CMD_EXTENDED:
+            sum = mix(sum, f.bytes.size());
+            break;
+        case CTE_PEEK_TYPE_IXDATA_CONST_TRUE:
+        case CTE_PEEK_TYPE_IXDATA_CONST_FALSE:
+            sum = mix(sum, f.value.boolean);
+            break;
+        default:
+            sum = mix(sum, f.value.u64);
+            break;
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief The same loop over a policy-parameterised `cte::basic_decoder`.
+ */
+template <typename Policy>
+static uint64_t decode_policy(cte::basic_decoder<Policy> &dec)
+{
+    uint64_t sum = 0;
+    dec.reset();
+    for (cte::field_view f; dec.next(f);)
+    {
+        switch (f.type)
+        {
+        case CTE_PEEK_TYPE_PK_LIST_ED25519:
+        case CTE_PEEK_TYPE_SIG_LIST_ED25519:
+            sum = mix(sum, f.bytes[0]);
+            break;
+        case CTE_PEEK_TYPE_CMD_SHORT:
+        case CTE_PEEK_TYPE_CMD_EXTENDED:
+            sum = mix(sum, f.bytes.size());
+            break;
+        case CTE_PEEK_TYPE_IXDATA_CONST_TRUE:
+        case CTE_PEEK_TYPE_IXDATA_CONST_FALSE:
+            sum = mix(sum, f.value.boolean);
+            break;
+        default:
+            sum = mix(sum, f.value.u64);
+            break;
+        }
+    }
+    return sum;
+}
+
+#define SAMPLE_SCHEMA(X)          \
+    X(PK_LIST_ED25519, keys)      \
+    X(SIG_LIST_ED25519, sigs)     \
+    X(IXDATA_LEGACY_INDEX, index) \
+    X(IXDATA_ULEB128, amount)     \
+    X(IXDATA_ULEB128, fee)        \
+    X(IXDATA_SLEB128, delta)      \
+    X(IXDATA_UINT32, tag)         \
+    X(IXDATA_UINT64, nonce)       \
+    X(IXDATA_BOOLEAN, flag)       \
+    X(CMD, method)                \
+    X(CMD, args)
+
+CTE_SCHEMA_DEFINE(sample, SAMPLE_SCHEMA)
+
+/**
+ * @brief The sample decoded by its generated schema decoder.
+ */
+static uint64_t decode_schema(cte_decoder_t *dec)
+{
+    sample s;
+    dec->position = 0;
+    if (!sample_try_decode(dec, &s))
+        lea_abort("Benchmark sample does not match its schema");
+    uint64_t sum = 0;
+    sum = mix(sum, s.keys.data[0]);
+    sum = mix(sum, s.sigs.data[0]);
+    sum = mix(sum, s.index);
+    sum = mix(sum, s.amount);
+    sum = mix(sum, s.fee);
+    sum = mix(sum, (uint64_t)s.delta);
+    sum = mix(sum, s.tag);
+    sum = mix(sum, s.nonce);
+    sum = mix(sum, s.flag);
+    sum = mix(sum, s.method.length);
+    sum = mix(sum, s.args.length);
+    return sum;
+}
+
+/**
+ * @brief The sample decoded through the shape cache (a hit after the first call).
+ */
+static uint64_t decode_shape_cache(cte_shape_cache_t *cache, std::span<const uint8_t> bytes)
+{
+    cte_field_t fields[CTE_SHAPE_MAX_FIELDS];
+    size_t n = cte_shape_cache_decode(cache, bytes.data(), bytes.size(), fields, CTE_SHAPE_MAX_FIELDS);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        switch (fields[i].type)
+        {
+        case CTE_PEEK_TYPE_PK_LIST_ED25519:
+        case CTE_PEEK_TYPE_SIG_LIST_ED25519:
+            sum = mix(sum, fields[i].data[0]);
+            break;
+        case CTE_PEEK_TYPE_CMD_SHORT:
+        case CTE_PEEK_TYPE_CMD_EXTENDED:
+            sum = mix(sum, fields[i].length);
+            break;
+        case CTE_PEEK_TYPE_IXDATA_CONST_TRUE:
+        case CTE_PEEK_TYPE_IXDATA_CONST_FALSE:
+            sum = mix(sum, fields[i].value.boolean);
+            break;
+        default:
+            sum = mix(sum, fields[i].value.u64);
+            break;
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief Runs `body` `iterations` times per round and prints the best round's
+ * time per transaction.
+ */
+template <typename Body>
+static void run(const char *name, long iterations, Body body)
+{
+    uint64_t sum = 0;
+    double best_ns = 0;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < iterations; ++i)
+        {
+            sum += body();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        if (round == 0 || ns < best_ns)
+        {
+            best_ns = ns;
+        }
+    }
+    printf("  %-24s %10.1f ns/tx   checksum %016llx\n", name, best_ns / (double)iterations, (unsigned long long)sum);
+}
+
+/**
+ * @brief Main entry point for the native benchmarks.
+ * @param argc The number of command-line arguments.
+ * @param argv `argv[1]` optionally overrides the iteration count.
+ * @return 0 on success.
+ */
+int main(int argc, char *argv[])
+{
+    long iterations = argc > 1 ? strtol(argv[1], NULL, 0) : DEFAULT_ITERATIONS;
+    if (iterations <= 0)
+    {
+        fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    cte::encoder enc(CTE_MAX_TRANSACTION_SIZE);
+    build_sample(enc);
+    printf("CTE benchmarks (%ld iterations, %zu-byte transaction)\n", iterations, enc.data().size());
+
+    cte::decoder cpp_dec(enc.data());
+    cte_decoder_t *c_dec = cte_decoder_init(enc.data().size());
+    memcpy(cte_decoder_load(c_dec), enc.data().data(), enc.data().size());
+
+    printf("Decode: C API vs C++ field range\n");
+    run("c_api", iterations, [&] { return decode_c_api(c_dec); });
+    run("cpp_range", iterations, [&] { return decode_cpp_range(cpp_dec); });
+
+    cte::strict_decoder strict_dec(enc.data());
+    cte::minimal_decoder minimal_dec(enc.data());
+    printf("Decode: checking policies\n");
+    run("strict", iterations, [&] { return decode_policy(strict_dec); });
+    run("minimal", iterations, [&] { return decode_policy(minimal_dec); });
+
+    printf("Decode: generated schema decoder\n");
+    run("schema", iterations, [&] { return decode_schema(c_dec); });
+
+    cte_shape_cache_t *cache = cte_shape_cache_init(64);
+    printf("Decode: shape-plan cache\n");
+    run("shape_cache", iterations, [&] { return decode_shape_cache(cache, enc.data()); });
+    cte_shape_stats_t stats;
+    cte_shape_cache_get_stats(cache, &stats);
+    printf("  hit rate %.4f (%llu of %llu)\n", (double)stats.hits / (double)stats.lookups,
+           (unsigned long long)stats.hits, (unsigned long long)stats.lookups);
+    cte_shape_cache_free(cache);
+
+    cte_decoder_free(c_dec);
+    return 0;
+}
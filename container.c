@@ -0,0 +1,614 @@
+#include "container.h"
+#include <stdlea.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define CONTAINER_X86_64 1
+#endif
+
+/** @brief First bytes of a container. */
+static const uint8_t file_magic[4] = {'C', 'T', 'E', 'C'};
+/** @brief Last bytes of a finished container. */
+static const uint8_t trailer_magic[8] = {'C', 'T', 'E', 'C', 'I', 'N', 'D', 'X'};
+/**
+ * @brief First bytes of a sync marker. Read as a record, 0xF0 'C' would
+ * declare a length far above the maximum, so at a record boundary a
+ * marker is never mistaken for a record.
+ */
+static const uint8_t sync_magic[8] = {0xF0, 'C', 'T', 'E', 'S', 'Y', 'N', 0x0F};
+/** @brief Format version written in the header. */
+#define CONTAINER_VERSION 1
+/** @brief Bytes of index staged per sink call by `cte_container_writer_finish()`. */
+#define INDEX_CHUNK 4096
+
+/** @brief CRC-32C of each byte value (reflected polynomial 0x82F63B78). */
+static const uint32_t crc32c_table[256] = {
+    0x00000000, 0xF26B8303, 0xE13B70F7, 0x1350F3F4, 0xC79A971F, 0x35F1141C,
+    0x26A1E7E8, 0xD4CA64EB, 0x8AD958CF, 0x78B2DBCC, 0x6BE22838, 0x9989AB3B,
+    0x4D43CFD0, 0xBF284CD3, 0xAC78BF27, 0x5E133C24, 0x105EC76F, 0xE235446C,
+    0xF165B798, 0x030E349B, 0xD7C45070, 0x25AFD373, 0x36FF2087, 0xC494A384,
+    0x9A879FA0, 0x68EC1CA3, 0x7BBCEF57, 0x89D76C54, 0x5D1D08BF, 0xAF768BBC,
+    0xBC267848, 0x4E4DFB4B, 0x20BD8EDE, 0xD2D60DDD, 0xC186FE29, 0x33ED7D2A,
+    0xE72719C1, 0x154C9AC2, 0x061C6936, 0xF477EA35, 0xAA64D611, 0x580F5512,
+    0x4B5FA6E6, 0xB93425E5, 0x6DFE410E, 0x9F95C20D, 0x8CC531F9, 0x7EAEB2FA,
+    0x30E349B1, 0xC288CAB2, 0xD1D83946, 0x23B3BA45, 0xF779DEAE, 0x05125DAD,
+    0x1642AE59, 0xE4292D5A, 0xBA3A117E, 0x4851927D, 0x5B016189, 0xA96AE28A,
+    0x7DA08661, 0x8FCB0562, 0x9C9BF696, 0x6EF07595, 0x417B1DBC, 0xB3109EBF,
+    0xA0406D4B, 0x522BEE48, 0x86E18AA3, 0x748A09A0, 0x67DAFA54, 0x95B17957,
+    0xCBA24573, 0x39C9C670, 0x2A993584, 0xD8F2B687, 0x0C38D26C, 0xFE53516F,
+    0xED03A29B, 0x1F682198, 0x5125DAD3, 0xA34E59D0, 0xB01EAA24, 0x42752927,
+    0x96BF4DCC, 0x64D4CECF, 0x77843D3B, 0x85EFBE38, 0xDBFC821C, 0x2997011F,
+    0x3AC7F2EB, 0xC8AC71E8, 0x1C661503, 0xEE0D9600, 0xFD5D65F4, 0x0F36E6F7,
+    0x61C69362, 0x93AD1061, 0x80FDE395, 0x72966096, 0xA65C047D, 0x5437877E,
+    0x4767748A, 0xB50CF789, 0xEB1FCBAD, 0x197448AE, 0x0A24BB5A, 0xF84F3859,
+    0x2C855CB2, 0xDEEEDFB1, 0xCDBE2C45, 0x3FD5AF46, 0x7198540D, 0x83F3D70E,
+    0x90A324FA, 0x62C8A7F9, 0xB602C312, 0x44694011, 0x5739B3E5, 0xA55230E6,
+    0xFB410CC2, 0x092A8FC1, 0x1A7A7C35, 0xE811FF36, 0x3CDB9BDD, 0xCEB018DE,
+    0xDDE0EB2A, 0x2F8B6829, 0x82F63B78, 0x709DB87B, 0x63CD4B8F, 0x91A6C88C,
+    0x456CAC67, 0xB7072F64, 0xA457DC90, 0x563C5F93, 0x082F63B7, 0xFA44E0B4,
+    0xE9141340, 0x1B7F9043, 0xCFB5F4A8, 0x3DDE77AB, 0x2E8E845F, 0xDCE5075C,
+    0x92A8FC17, 0x60C37F14, 0x73938CE0, 0x81F80FE3, 0x55326B08, 0xA759E80B,
+    0xB4091BFF, 0x466298FC, 0x1871A4D8, 0xEA1A27DB, 0xF94AD42F, 0x0B21572C,
+    0xDFEB33C7, 0x2D80B0C4, 0x3ED04330, 0xCCBBC033, 0xA24BB5A6, 0x502036A5,
+    0x4370C551, 0xB11B4652, 0x65D122B9, 0x97BAA1BA, 0x84EA524E, 0x7681D14D,
+    0x2892ED69, 0xDAF96E6A, 0xC9A99D9E, 0x3BC21E9D, 0xEF087A76, 0x1D63F975,
+    0x0E330A81, 0xFC588982, 0xB21572C9, 0x407EF1CA, 0x532E023E, 0xA145813D,
+    0x758FE5D6, 0x87E466D5, 0x94B49521, 0x66DF1622, 0x38CC2A06, 0xCAA7A905,
+    0xD9F75AF1, 0x2B9CD9F2, 0xFF56BD19, 0x0D3D3E1A, 0x1E6DCDEE, 0xEC064EED,
+    0xC38D26C4, 0x31E6A5C7, 0x22B65633, 0xD0DDD530, 0x0417B1DB, 0xF67C32D8,
+    0xE52CC12C, 0x1747422F, 0x49547E0B, 0xBB3FFD08, 0xA86F0EFC, 0x5A048DFF,
+    0x8ECEE914, 0x7CA56A17, 0x6FF599E3, 0x9D9E1AE0, 0xD3D3E1AB, 0x21B862A8,
+    0x32E8915C, 0xC083125F, 0x144976B4, 0xE622F5B7, 0xF5720643, 0x07198540,
+    0x590AB964, 0xAB613A67, 0xB831C993, 0x4A5A4A90, 0x9E902E7B, 0x6CFBAD78,
+    0x7FAB5E8C, 0x8DC0DD8F, 0xE330A81A, 0x115B2B19, 0x020BD8ED, 0xF0605BEE,
+    0x24AA3F05, 0xD6C1BC06, 0xC5914FF2, 0x37FACCF1, 0x69E9F0D5, 0x9B8273D6,
+    0x88D28022, 0x7AB90321, 0xAE7367CA, 0x5C18E4C9, 0x4F48173D, 0xBD23943E,
+    0xF36E6F75, 0x0105EC76, 0x12551F82, 0xE03E9C81, 0x34F4F86A, 0xC69F7B69,
+    0xD5CF889D, 0x27A40B9E, 0x79B737BA, 0x8BDCB4B9, 0x988C474D, 0x6AE7C44E,
+    0xBE2DA0A5, 0x4C4623A6, 0x5F16D052, 0xAD7D5351,
+};
+
+struct cte_container_writer
+{
+    cte_container_sink_t sink;
+    void *context;
+    uint8_t flags;
+    bool failed;   /**< The sink reported an error. */
+    bool finished; /**< The index has been written. */
+    bool has_allocator;
+    cte_allocator_t allocator;
+    uint32_t sync_interval;
+    uint64_t offset;       /**< Bytes written so far. */
+    uint64_t record_count;
+    uint64_t *blocks;      /**< Offset of each block's sync marker. */
+    size_t block_capacity;
+    uint32_t *records;     /**< Offset of each record relative to its block. */
+    size_t record_capacity;
+};
+
+/**
+ * @brief Stores a 32-bit value little-endian.
+ * @note Internal helper function.
+ */
+static void _put32(uint8_t *p, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        p[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+/**
+ * @brief Stores a 64-bit value little-endian.
+ * @note Internal helper function.
+ */
+static void _put64(uint8_t *p, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        p[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+/**
+ * @brief Loads a little-endian 32-bit value.
+ * @note Internal helper function.
+ */
+static uint32_t _get32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+/**
+ * @brief Loads a little-endian 64-bit value.
+ * @note Internal helper function.
+ */
+static uint64_t _get64(const uint8_t *p)
+{
+    return (uint64_t)_get32(p) | (uint64_t)_get32(p + 4) << 32;
+}
+
+#ifdef CONTAINER_X86_64
+/**
+ * @brief Extends an inverted CRC-32C with the SSE4.2 instruction, 8 bytes per step.
+ * @note Internal helper function.
+ */
+__attribute__((target("sse4.2"))) static uint32_t _crc32c_sse42(uint32_t crc, const uint8_t *data, size_t size)
+{
+    uint64_t c = crc;
+    for (; size >= 8; data += 8, size -= 8)
+    {
+        uint64_t word;
+        memcpy(&word, data, 8);
+        c = _mm_crc32_u64(c, word);
+    }
+    crc = (uint32_t)c;
+    for (; size > 0; ++data, --size)
+    {
+        crc = _mm_crc32_u8(crc, *data);
+    }
+    return crc;
+}
+#endif
+
+LEA_EXPORT(cte_crc32c)
+uint32_t cte_crc32c(uint32_t crc, const uint8_t *data, size_t size)
+{
+    crc = ~crc;
+#ifdef CONTAINER_X86_64
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        return ~_crc32c_sse42(crc, data, size);
+    }
+#endif
+    for (size_t i = 0; i < size; ++i)
+    {
+        crc = crc32c_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/**
+ * @brief Passes bytes to the sink, remembering a failure.
+ * @note Internal helper function.
+ */
+static bool _emit(cte_container_writer_t *writer, const uint8_t *data, size_t size)
+{
+    if (!writer->failed && !writer->sink(writer->context, data, size))
+    {
+        writer->failed = true;
+    }
+    writer->offset += size;
+    return !writer->failed;
+}
+
+/**
+ * @brief Doubles an index array until it holds `needed` entries.
+ * @note Internal helper function.
+ */
+static void *_grow(cte_container_writer_t *writer, void *array, size_t *capacity, size_t needed, size_t item)
+{
+    if (needed <= *capacity)
+    {
+        return array;
+    }
+    const cte_allocator_t *allocator = writer->has_allocator ? &writer->allocator : NULL;
+    size_t grown = *capacity ? 2 * *capacity : 1024;
+    void *bigger = cte_allocate(allocator, grown * item, 8);
+    if (array)
+    {
+        memcpy(bigger, array, *capacity * item);
+        cte_deallocate(allocator, array, *capacity * item, 8);
+    }
+    *capacity = grown;
+    return bigger;
+}
+
+LEA_EXPORT(cte_container_writer_init)
+cte_container_writer_t *cte_container_writer_init(uint32_t sync_interval, uint8_t flags, cte_container_sink_t sink,
+                                                  void *context, const cte_allocator_t *allocator)
+{
+    if (sync_interval < 1 || sync_interval > CTE_CONTAINER_MAX_SYNC_INTERVAL)
+    {
+        lea_abort("Container sync interval out of range");
+    }
+    cte_container_writer_t *writer =
+        cte_allocate(allocator, sizeof(cte_container_writer_t), _Alignof(cte_container_writer_t));
+    memset(writer, 0, sizeof(*writer));
+    writer->has_allocator = allocator != NULL;
+    if (allocator)
+    {
+        writer->allocator = *allocator;
+    }
+    writer->sink = sink;
+    writer->context = context;
+    writer->flags = flags & CTE_CONTAINER_CHECKSUMS;
+    writer->sync_interval = sync_interval;
+
+    uint8_t header[CTE_CONTAINER_HEADER_SIZE] = {0};
+    memcpy(header, file_magic, sizeof(file_magic));
+    header[4] = CONTAINER_VERSION;
+    header[5] = writer->flags;
+    _put32(header + 8, sync_interval);
+    _emit(writer, header, sizeof(header));
+    return writer;
+}
+
+LEA_EXPORT(cte_container_writer_resume)
+cte_container_writer_t *cte_container_writer_resume(const cte_container_t *container, size_t end,
+                                                    cte_container_sink_t sink, void *context,
+                                                    const cte_allocator_t *allocator)
+{
+    if (end < CTE_CONTAINER_HEADER_SIZE || end > container->size)
+    {
+        return NULL;
+    }
+    cte_container_writer_t *writer =
+        cte_allocate(allocator, sizeof(cte_container_writer_t), _Alignof(cte_container_writer_t));
+    memset(writer, 0, sizeof(*writer));
+    writer->has_allocator = allocator != NULL;
+    if (allocator)
+    {
+        writer->allocator = *allocator;
+    }
+    writer->sink = sink;
+    writer->context = context;
+    writer->flags = container->flags;
+    writer->sync_interval = container->sync_interval;
+
+    // Rebuild the index exactly as `cte_container_writer_append()` would have recorded it.
+    cte_container_t view = *container;
+    view.body_end = end;
+    size_t offset = CTE_CONTAINER_HEADER_SIZE;
+    uint64_t index = 0;
+    cte_container_record_t record;
+    while (offset < end)
+    {
+        size_t at = offset;
+        if (cte_container_next(&view, &offset, &index, &record) != CTE_CONTAINER_OK ||
+            record.index != writer->record_count)
+        {
+            cte_container_writer_free(writer);
+            return NULL;
+        }
+        uint64_t block = writer->record_count / writer->sync_interval;
+        if (writer->record_count % writer->sync_interval == 0)
+        {
+            writer->blocks = _grow(writer, writer->blocks, &writer->block_capacity, block + 1, sizeof(uint64_t));
+            writer->blocks[block] = at;
+        }
+        writer->records =
+            _grow(writer, writer->records, &writer->record_capacity, writer->record_count + 1, sizeof(uint32_t));
+        writer->records[writer->record_count] = (uint32_t)(record.offset - writer->blocks[block]);
+        writer->record_count++;
+    }
+    writer->offset = end;
+    return writer;
+}
+
+LEA_EXPORT(cte_container_writer_free)
+void cte_container_writer_free(cte_container_writer_t *writer)
+{
+    if (!writer)
+    {
+        return;
+    }
+    cte_allocator_t allocator = writer->allocator;
+    const cte_allocator_t *hooks = writer->has_allocator ? &allocator : NULL;
+    if (writer->blocks)
+    {
+        cte_deallocate(hooks, writer->blocks, writer->block_capacity * sizeof(uint64_t), 8);
+    }
+    if (writer->records)
+    {
+        cte_deallocate(hooks, writer->records, writer->record_capacity * sizeof(uint32_t), 8);
+    }
+    cte_deallocate(hooks, writer, sizeof(cte_container_writer_t), _Alignof(cte_container_writer_t));
+}
+
+LEA_EXPORT(cte_container_writer_append)
+bool cte_container_writer_append(cte_container_writer_t *writer, const uint8_t *data, size_t size)
+{
+    if (size < 1 || size > CTE_MAX_TRANSACTION_SIZE)
+    {
+        lea_abort("Container record size out of range");
+    }
+    if (writer->finished)
+    {
+        lea_abort("Append to a finished container");
+    }
+
+    // Sync marker, length, transaction and checksum go to the sink in one call.
+    uint8_t frame[CTE_CONTAINER_SYNC_SIZE + 2 + CTE_MAX_TRANSACTION_SIZE + 4];
+    size_t used = 0;
+    uint64_t block = writer->record_count / writer->sync_interval;
+    if (writer->record_count % writer->sync_interval == 0)
+    {
+        writer->blocks = _grow(writer, writer->blocks, &writer->block_capacity, block + 1, sizeof(uint64_t));
+        writer->blocks[block] = writer->offset;
+        memcpy(frame, sync_magic, sizeof(sync_magic));
+        _put64(frame + 8, writer->record_count);
+        used = CTE_CONTAINER_SYNC_SIZE;
+    }
+    writer->records =
+        _grow(writer, writer->records, &writer->record_capacity, writer->record_count + 1, sizeof(uint32_t));
+    writer->records[writer->record_count] = (uint32_t)(writer->offset + used - writer->blocks[block]);
+    writer->record_count++;
+
+    frame[used++] = (uint8_t)((size & 0x7F) | (size > 0x7F ? 0x80 : 0));
+    if (size > 0x7F)
+    {
+        frame[used++] = (uint8_t)(size >> 7);
+    }
+    memcpy(frame + used, data, size);
+    used += size;
+    if (writer->flags & CTE_CONTAINER_CHECKSUMS)
+    {
+        _put32(frame + used, cte_crc32c(0, data, size));
+        used += 4;
+    }
+    return _emit(writer, frame, used);
+}
+
+LEA_EXPORT(cte_container_writer_finish)
+bool cte_container_writer_finish(cte_container_writer_t *writer)
+{
+    if (writer->finished)
+    {
+        return !writer->failed;
+    }
+    writer->finished = true;
+    uint64_t index_offset = writer->offset;
+    uint64_t block_count = (writer->record_count + writer->sync_interval - 1) / writer->sync_interval;
+
+    // The index is converted to little-endian in chunks, checksummed as it goes.
+    uint8_t chunk[INDEX_CHUNK];
+    size_t used = 0;
+    uint32_t crc = 0;
+    for (uint64_t i = 0; i < block_count; ++i)
+    {
+        _put64(chunk + used, writer->blocks[i]);
+        used += 8;
+        if (used == INDEX_CHUNK)
+        {
+            crc = cte_crc32c(crc, chunk, used);
+            _emit(writer, chunk, used);
+            used = 0;
+        }
+    }
+    for (uint64_t i = 0; i < writer->record_count; ++i)
+    {
+        _put32(chunk + used, writer->records[i]);
+        used += 4;
+        if (used == INDEX_CHUNK)
+        {
+            crc = cte_crc32c(crc, chunk, used);
+            _emit(writer, chunk, used);
+            used = 0;
+        }
+    }
+    crc = cte_crc32c(crc, chunk, used);
+    _emit(writer, chunk, used);
+
+    uint8_t trailer[CTE_CONTAINER_TRAILER_SIZE] = {0};
+    _put64(trailer, writer->record_count);
+    _put64(trailer + 8, index_offset);
+    _put32(trailer + 16, crc);
+    memcpy(trailer + 24, trailer_magic, sizeof(trailer_magic));
+    return _emit(writer, trailer, sizeof(trailer));
+}
+
+LEA_EXPORT(cte_container_writer_count)
+uint64_t cte_container_writer_count(const cte_container_writer_t *writer)
+{
+    return writer->record_count;
+}
+
+LEA_EXPORT(cte_container_open)
+bool cte_container_open(cte_container_t *container, const uint8_t *data, size_t size)
+{
+    if (size < CTE_CONTAINER_HEADER_SIZE || memcmp(data, file_magic, sizeof(file_magic)) != 0 ||
+        data[4] != CONTAINER_VERSION || (data[5] & ~CTE_CONTAINER_CHECKSUMS) != 0)
+    {
+        return false;
+    }
+    uint32_t sync_interval = _get32(data + 8);
+    if (sync_interval < 1 || sync_interval > CTE_CONTAINER_MAX_SYNC_INTERVAL)
+    {
+        return false;
+    }
+    container->data = data;
+    container->size = size;
+    container->flags = data[5];
+    container->sync_interval = sync_interval;
+    container->indexed = false;
+    container->record_count = 0;
+    container->body_end = size;
+
+    if (size < CTE_CONTAINER_HEADER_SIZE + CTE_CONTAINER_TRAILER_SIZE)
+    {
+        return true;
+    }
+    const uint8_t *trailer = data + size - CTE_CONTAINER_TRAILER_SIZE;
+    if (memcmp(trailer + 24, trailer_magic, sizeof(trailer_magic)) != 0)
+    {
+        return true;
+    }
+    uint64_t record_count = _get64(trailer);
+    uint64_t index_offset = _get64(trailer + 8);
+    uint64_t index_room = size - CTE_CONTAINER_TRAILER_SIZE;
+    if (index_offset < CTE_CONTAINER_HEADER_SIZE || index_offset > index_room || record_count > index_room / 4)
+    {
+        return true;
+    }
+    uint64_t block_count = (record_count + sync_interval - 1) / sync_interval;
+    if (index_offset + block_count * 8 + record_count * 4 != index_room ||
+        cte_crc32c(0, data + index_offset, (size_t)(index_room - index_offset)) != _get32(trailer + 16))
+    {
+        return true;
+    }
+    container->indexed = true;
+    container->record_count = record_count;
+    container->body_end = (size_t)index_offset;
+    return true;
+}
+
+/**
+ * @brief Reads the record whose length prefix is at `offset`.
+ * @return The status; on `CTE_CONTAINER_OK` or `CTE_CONTAINER_CHECKSUM`, `*next` is the offset after the record.
+ * @note Internal helper function.
+ */
+static cte_container_status_t _read_record(const cte_container_t *container, size_t offset, uint64_t index,
+                                           cte_container_record_t *record, size_t *next)
+{
+    const uint8_t *data = container->data;
+    size_t end = container->body_end;
+    if (offset >= end)
+    {
+        return CTE_CONTAINER_MALFORMED;
+    }
+    size_t size = data[offset] & 0x7F;
+    size_t position = offset + 1;
+    if (data[offset] & 0x80)
+    {
+        if (position >= end || data[position] & 0x80)
+        {
+            return CTE_CONTAINER_MALFORMED;
+        }
+        size |= (size_t)data[position++] << 7;
+    }
+    size_t checksum = container->flags & CTE_CONTAINER_CHECKSUMS ? 4 : 0;
+    if (size < 1 || size > CTE_MAX_TRANSACTION_SIZE || size + checksum > end - position)
+    {
+        return CTE_CONTAINER_MALFORMED;
+    }
+    record->data = data + position;
+    record->size = size;
+    record->offset = offset;
+    record->index = index;
+    *next = position + size + checksum;
+    if (checksum && cte_crc32c(0, record->data, size) != _get32(data + position + size))
+    {
+        return CTE_CONTAINER_CHECKSUM;
+    }
+    return CTE_CONTAINER_OK;
+}
+
+LEA_EXPORT(cte_container_get)
+cte_container_status_t cte_container_get(const cte_container_t *container, uint64_t index,
+                                         cte_container_record_t *record)
+{
+    if (!container->indexed || index >= container->record_count)
+    {
+        return CTE_CONTAINER_OUT_OF_RANGE;
+    }
+    uint64_t block_count = (container->record_count + container->sync_interval - 1) / container->sync_interval;
+    const uint8_t *blocks = container->data + container->body_end;
+    const uint8_t *records = blocks + block_count * 8;
+    uint64_t offset = _get64(blocks + index / container->sync_interval * 8) + _get32(records + index * 4);
+    if (offset >= container->body_end)
+    {
+        return CTE_CONTAINER_MALFORMED;
+    }
+    size_t next;
+    return _read_record(container, (size_t)offset, index, record, &next);
+}
+
+LEA_EXPORT(cte_container_next)
+cte_container_status_t cte_container_next(const cte_container_t *container, size_t *offset, uint64_t *index,
+                                          cte_container_record_t *record)
+{
+    size_t position = *offset;
+    uint64_t number = *index;
+    if (position >= container->body_end)
+    {
+        return CTE_CONTAINER_END;
+    }
+    if (container->body_end - position >= CTE_CONTAINER_SYNC_SIZE &&
+        memcmp(container->data + position, sync_magic, sizeof(sync_magic)) == 0)
+    {
+        number = _get64(container->data + position + 8);
+        position += CTE_CONTAINER_SYNC_SIZE;
+        if (position == container->body_end)
+        {
+            return CTE_CONTAINER_MALFORMED; // a marker always precedes a record
+        }
+    }
+    size_t next;
+    cte_container_status_t status = _read_record(container, position, number, record, &next);
+    if (status == CTE_CONTAINER_MALFORMED)
+    {
+        *offset = position;
+        *index = number;
+        return status;
+    }
+    *offset = next;
+    *index = number + 1;
+    return status;
+}
+
+LEA_EXPORT(cte_container_sync)
+size_t cte_container_sync(const cte_container_t *container, size_t offset, uint64_t *index)
+{
+    const uint8_t *data = container->data;
+    size_t end = container->body_end;
+    if (offset < CTE_CONTAINER_HEADER_SIZE)
+    {
+        offset = CTE_CONTAINER_HEADER_SIZE;
+    }
+    while (end >= CTE_CONTAINER_SYNC_SIZE && offset <= end - CTE_CONTAINER_SYNC_SIZE)
+    {
+        const uint8_t *hit = memchr(data + offset, sync_magic[0], end - CTE_CONTAINER_SYNC_SIZE + 1 - offset);
+        if (!hit)
+        {
+            break;
+        }
+        offset = (size_t)(hit - data);
+        if (memcmp(hit, sync_magic, sizeof(sync_magic)) == 0)
+        {
+            if (index)
+            {
+                *index = _get64(hit + 8);
+            }
+            return offset;
+        }
+        ++offset;
+    }
+    return end;
+}
+
+LEA_EXPORT(cte_container_split)
+void cte_container_split(const cte_container_t *container, unsigned part, unsigned parts, size_t *start,
+                         size_t *end)
+{
+    size_t bounds[2];
+    for (unsigned k = 0; k < 2; ++k)
+    {
+        unsigned p = part + k;
+        if (p == 0)
+        {
+            bounds[k] = CTE_CONTAINER_HEADER_SIZE < container->body_end ? CTE_CONTAINER_HEADER_SIZE
+                                                                        : container->body_end;
+        }
+        else if (p >= parts)
+        {
+            bounds[k] = container->body_end;
+        }
+        else if (container->indexed)
+        {
+            uint64_t block_count =
+                (container->record_count + container->sync_interval - 1) / container->sync_interval;
+            uint64_t block = block_count * p / parts;
+            bounds[k] = block < block_count ? (size_t)_get64(container->data + container->body_end + block * 8)
+                                            : container->body_end;
+        }
+        else
+        {
+            size_t body = container->body_end - CTE_CONTAINER_HEADER_SIZE;
+            size_t offset = CTE_CONTAINER_HEADER_SIZE + (size_t)((uint64_t)body * p / parts);
+            bounds[k] = cte_container_sync(container, offset, NULL);
+        }
+    }
+    *start = bounds[0];
+    *end = bounds[1] > bounds[0] ? bounds[1] : bounds[0];
+}
@@ -0,0 +1,250 @@
+#ifndef CONTAINER_H
+#define CONTAINER_H
+
+#include "cte.h"
+#include <stdlea.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file container.h
+ * @brief A file format holding many transactions, with an offset index.
+ *
+ * Layout (all integers little-endian):
+ *
+ *     header   16 bytes: "CTEC", version 1, flags, 2 zero bytes,
+ *              u32 sync interval, 4 zero bytes
+ *     body     blocks of up to `sync interval` records, each block preceded by
+ *              a 16-byte sync marker: 8 magic bytes and the u64 number of
+ *              the block's first record
+ *     record   ULEB128 length (1-1232), the transaction, and a u32 CRC-32C of
+ *              the transaction if the header has `CTE_CONTAINER_CHECKSUMS`
+ *     index    u64 offset of each block's sync marker, then a u32 offset of
+ *              each record relative to its block's sync marker
+ *     trailer  32 bytes: u64 record count, u64 offset of the index, u32
+ *              CRC-32C of the index, 4 zero bytes, "CTECINDX"
+ *
+ * Writing streams through a sink; only the index is kept in memory. Reading
+ * works on a view of the whole file (usually mapped) without allocating.
+ * With an intact index any record is found in constant time. A file
+ * whose writer never finished has no index; it is still read
+ * sequentially, and sync markers let readers split it or resume after
+ * damage without it.
+ */
+
+/** @brief Size of the file header. */
+#define CTE_CONTAINER_HEADER_SIZE 16
+/** @brief Size of a sync marker. */
+#define CTE_CONTAINER_SYNC_SIZE 16
+/** @brief Size of the trailer. */
+#define CTE_CONTAINER_TRAILER_SIZE 32
+/** @brief Header flag: every record is followed by a CRC-32C of its transaction. */
+#define CTE_CONTAINER_CHECKSUMS 0x01
+/** @brief Largest sync interval; keeps relative record offsets within 32 bits. */
+#define CTE_CONTAINER_MAX_SYNC_INTERVAL (1u << 20)
+
+/**
+ * @brief Result of reading a record.
+ */
+typedef enum
+{
+    CTE_CONTAINER_OK,           /**< The record was read. */
+    CTE_CONTAINER_END,          /**< No more records. */
+    CTE_CONTAINER_OUT_OF_RANGE, /**< No such record number, or the container has no index. */
+    CTE_CONTAINER_MALFORMED,    /**< The record's framing is damaged; its extent is unknown. */
+    CTE_CONTAINER_CHECKSUM,     /**< The record was read but its checksum does not match. */
+} cte_container_status_t;
+
+/**
+ * @struct cte_container
+ * @brief A read-only view of a container, filled by `cte_container_open()`.
+ */
+typedef struct cte_container
+{
+    const uint8_t *data;    /**< @param data The whole file. */
+    size_t size;            /**< @param size The size of the file. */
+    uint8_t flags;          /**< @param flags `CTE_CONTAINER_*` header flags. */
+    uint32_t sync_interval; /**< @param sync_interval Records per block. */
+    bool indexed;           /**< @param indexed The index and trailer are present and intact. */
+    uint64_t record_count;  /**< @param record_count Number of records; valid only if `indexed`. */
+    size_t body_end;        /**< @param body_end End of the last record: the index offset, or the file size. */
+} cte_container_t;
+
+/**
+ * @struct cte_container_record
+ * @brief One record of a container.
+ */
+typedef struct cte_container_record
+{
+    const uint8_t *data; /**< @param data The transaction, inside the container view. */
+    size_t size;         /**< @param size The size of the transaction. */
+    size_t offset;       /**< @param offset Offset of the record's length prefix in the file. */
+    uint64_t index;      /**< @param index The record number. */
+} cte_container_record_t;
+
+/**
+ * @brief Receives the bytes of a container as it is written.
+ * @param context The writer's sink context.
+ * @param data The bytes.
+ * @param size The number of bytes.
+ * @return `false` to report a write error; the writer then fails all later calls.
+ */
+typedef bool (*cte_container_sink_t)(void *context, const uint8_t *data, size_t size);
+
+/** @brief Opaque container writer. */
+typedef struct cte_container_writer cte_container_writer_t;
+
+/**
+ * @brief Computes or extends a CRC-32C (Castagnoli).
+ *
+ * Uses the SSE4.2 `crc32` instruction when the CPU supports it (checked at
+ * run time) and a table otherwise.
+ *
+ * @param crc 0 to start, or the result of the previous call to continue.
+ * @param data The bytes.
+ * @param size The number of bytes.
+ * @return The CRC of everything passed so far.
+ */
+uint32_t cte_crc32c(uint32_t crc, const uint8_t *data, size_t size);
+
+/**
+ * @brief Creates a writer and writes the container header.
+ * @param sync_interval Records per block, 1 to `CTE_CONTAINER_MAX_SYNC_INTERVAL`.
+ * @param flags `CTE_CONTAINER_CHECKSUMS` or 0.
+ * @param sink Receives the container bytes in order.
+ * @param context Passed to `sink`.
+ * @param allocator The allocation hooks for the index, or NULL for stdlea `malloc`.
+ * @return A pointer to the new writer. If writing the header failed, later calls return `false`.
+ * @note Aborts via `lea_abort` if `sync_interval` is out of range.
+ */
+cte_container_writer_t *cte_container_writer_init(uint32_t sync_interval, uint8_t flags, cte_container_sink_t sink,
+                                                  void *context, const cte_allocator_t *allocator);
+
+/**
+ * @brief Creates a writer that continues an unfinished container.
+ *
+ * The records in front of `end` are scanned to rebuild the index, and the
+ * next record is written at `end`. The sink must append to the
+ * container's bytes at `end`. Use this to keep appending after a restart,
+ * once anything damaged past the last good record has been cut off.
+ *
+ * @param container A view of the unfinished container.
+ * @param end The end of the last record to keep; `CTE_CONTAINER_HEADER_SIZE` for none.
+ * @param sink Receives the bytes that follow.
+ * @param context Passed to `sink`.
+ * @param allocator The allocation hooks for the index, or NULL for stdlea `malloc`.
+ * @return A pointer to the new writer, or NULL if a record before `end`
+ * cannot be read or `end` is not a record boundary.
+ */
+cte_container_writer_t *cte_container_writer_resume(const cte_container_t *container, size_t end,
+                                                    cte_container_sink_t sink, void *context,
+                                                    const cte_allocator_t *allocator);
+
+/**
+ * @brief Releases a writer. Passing NULL is a no-op.
+ * @param writer The writer; a container left unfinished has no index.
+ */
+void cte_container_writer_free(cte_container_writer_t *writer);
+
+/**
+ * @brief Appends one transaction as the next record.
+ * @param writer The writer.
+ * @param data The transaction. It is stored as given, without validation.
+ * @param size Its size, 1 to `CTE_MAX_TRANSACTION_SIZE`.
+ * @return `false` if the sink failed now or earlier.
+ * @note Aborts via `lea_abort` if `size` is out of range or the writer is finished.
+ */
+bool cte_container_writer_append(cte_container_writer_t *writer, const uint8_t *data, size_t size);
+
+/**
+ * @brief Writes the index and trailer. No records can be appended afterwards.
+ * @param writer The writer.
+ * @return `false` if the sink failed now or earlier.
+ */
+bool cte_container_writer_finish(cte_container_writer_t *writer);
+
+/**
+ * @brief Returns the number of records appended so far.
+ * @param writer The writer.
+ */
+uint64_t cte_container_writer_count(const cte_container_writer_t *writer);
+
+/**
+ * @brief Opens a view of a container.
+ * @param container Receives the view.
+ * @param data The whole file; it must stay valid while the view is used.
+ * @param size The size of the file.
+ * @return `false` if the header is missing or invalid. A missing or damaged
+ * index is not an error; `container->indexed` is then `false`.
+ */
+bool cte_container_open(cte_container_t *container, const uint8_t *data, size_t size);
+
+/**
+ * @brief Reads a record by number using the index.
+ * @param container The view.
+ * @param index The record number.
+ * @param record Receives the record.
+ * @return `CTE_CONTAINER_OK`, `CTE_CONTAINER_CHECKSUM` (with `record` filled),
+ * `CTE_CONTAINER_MALFORMED`, or `CTE_CONTAINER_OUT_OF_RANGE` if `index` is
+ * past the end or the container has no index.
+ */
+cte_container_status_t cte_container_get(const cte_container_t *container, uint64_t index,
+                                         cte_container_record_t *record);
+
+/**
+ * @brief Reads the record at `*offset`, skipping a sync marker first.
+ *
+ * Start at `CTE_CONTAINER_HEADER_SIZE` with `*index` 0, or at an offset
+ * from `cte_container_sync()` or `cte_container_split()`; sync markers
+ * set `*index`. On `CTE_CONTAINER_OK` and `CTE_CONTAINER_CHECKSUM` both are
+ * advanced past the record. On `CTE_CONTAINER_MALFORMED` they are left at
+ * the damaged record (past any sync marker before it); call
+ * `cte_container_sync()` from the next byte to resume.
+ *
+ * @param container The view.
+ * @param offset The read position.
+ * @param index The number of the record at `*offset`.
+ * @param record Receives the record.
+ * @return `CTE_CONTAINER_OK`, `CTE_CONTAINER_CHECKSUM`, `CTE_CONTAINER_MALFORMED`,
+ * or `CTE_CONTAINER_END` at `container->body_end`.
+ */
+cte_container_status_t cte_container_next(const cte_container_t *container, size_t *offset, uint64_t *index,
+                                          cte_container_record_t *record);
+
+/**
+ * @brief Finds the first sync marker at or after `offset`.
+ *
+ * A transaction that happens to contain the marker bytes can cause a false
+ * match. This only matters when scanning a container without an index.
+ *
+ * @param container The view.
+ * @param offset Where to start looking.
+ * @param index Receives the number of the marker's first record; may be NULL.
+ * @return The marker's offset, or `container->body_end` if there is none.
+ */
+size_t cte_container_sync(const cte_container_t *container, size_t offset, uint64_t *index);
+
+/**
+ * @brief Divides the records into `parts` byte ranges at sync markers.
+ *
+ * Each range starts at a sync marker (or is empty) and is read with
+ * `cte_container_next()` until the offset reaches `*end`. With an index the
+ * ranges hold equal numbers of blocks; without one they hold about equal
+ * numbers of bytes.
+ *
+ * @param container The view.
+ * @param part The range to compute, 0 to `parts - 1`.
+ * @param parts The number of ranges.
+ * @param start Receives the start of the range.
+ * @param end Receives the end of the range.
+ */
+void cte_container_split(const cte_container_t *container, unsigned part, unsigned parts, size_t *start,
+                         size_t *end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONTAINER_H
@@ -50,3 +50,42 @@ size_t get_signature_item_size(uint8_t type_code)
         lea_abort("Invalid signature type code");
     }
 }
+
+/**
+ * @brief Allocates through `allocator`, or stdlea `malloc` if it is NULL.
+ * @param allocator The allocation hooks, or NULL.
+ * @param size The number of bytes to allocate.
+ * @param alignment The required alignment (a power of two).
+ * @return A pointer to the block.
+ * @note This function will abort via `lea_abort` if the allocation fails.
+ */
+LEA_EXPORT(cte_allocate)
+void *cte_allocate(const cte_allocator_t *allocator, size_t size, size_t alignment)
+{
+    void *ptr = allocator ? allocator->alloc(allocator->context, size, alignment) : malloc(size);
+    if (!ptr)
+    {
+        lea_abort("Allocation failed");
+    }
+    return ptr;
+}
+
+/**
+ * @brief Releases a block obtained from `cte_allocate()` with the same allocator.
+ * @param allocator The allocation hooks, or NULL.
+ * @param ptr The block to release.
+ * @param size The size passed to `cte_allocate()`.
+ * @param alignment The alignment passed to `cte_allocate()`.
+ */
+LEA_EXPORT(cte_deallocate)
+void cte_deallocate(const cte_allocator_t *allocator, void *ptr, size_t size, size_t alignment)
+{
+    if (allocator)
+    {
+        allocator->free(allocator->context, ptr, size, alignment);
+    }
+    else
+    {
+        free(ptr);
+    }
+}
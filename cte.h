@@ -3,6 +3,10 @@
 
 #include <stdlea.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * @file cte.h
  * @brief Core definitions and constants for the Compact Transaction Encoding (CTE).
@@ -195,6 +199,65 @@
 #define CTE_COMMAND_EXTENDED_MAX_LEN 1197/**< Maximum practical payload length for the extended format. */
 /** @} */
 
+/**
+ * @name Header Byte Construction
+ * @brief Build field header bytes from their components.
+ *
+ * These are the single definition of the header layouts; the encoder uses
+ * them, and so does code that precomputes headers at compile time. They do
+ * not validate their arguments.
+ * @{
+ */
+/** Header of a Public Key List (`tag` = `CTE_TAG_PUBLIC_KEY_LIST`) or Signature List (`CTE_TAG_SIGNATURE_LIST`). */
+#define CTE_LIST_HEADER(tag, count, type_code) \
+    ((uint8_t)((tag) | (((count) & 0x0F) << 2) | ((type_code) & CTE_CRYPTO_TYPE_MASK)))
+/** Header of an IxData field with the 4-bit `code` (index, scheme, type or value) and 2-bit `subtype`. */
+#define CTE_IXDATA_HEADER(code, subtype) \
+    ((uint8_t)(CTE_TAG_IXDATA_FIELD | (((code) & 0x0F) << 2) | ((subtype) & CTE_IXDATA_SUBTYPE_MASK)))
+/** Header of a short-format Command Data field (`length` 0-31). */
+#define CTE_COMMAND_SHORT_HEADER(length) \
+    ((uint8_t)(CTE_TAG_COMMAND_DATA | CTE_COMMAND_FORMAT_SHORT | ((length) & CTE_COMMAND_SHORT_MAX_LEN)))
+/** First header byte of an extended-format Command Data field (`length` 32-1197). */
+#define CTE_COMMAND_EXTENDED_HEADER1(length) \
+    ((uint8_t)(CTE_TAG_COMMAND_DATA | CTE_COMMAND_FORMAT_EXTENDED | ((((length) >> 8) & 0x07) << 2)))
+/** Second header byte of an extended-format Command Data field. */
+#define CTE_COMMAND_EXTENDED_HEADER2(length) ((uint8_t)((length) & 0xFF))
+/** @} */
+
+/**
+ * @struct cte_allocator
+ * @brief Allocation hooks for encoder and decoder contexts and their buffers.
+ *
+ * `alloc` must return memory aligned to at least `alignment` bytes, or NULL
+ * on failure. `free` receives the same size and alignment that were passed
+ * to `alloc` for that block, so arena and pool allocators need no headers.
+ */
+typedef struct cte_allocator
+{
+    void *(*alloc)(void *context, size_t size, size_t alignment);          /**< @param alloc Allocates a block. */
+    void (*free)(void *context, void *ptr, size_t size, size_t alignment); /**< @param free Releases a block. */
+    void *context;                                                         /**< @param context Passed to both hooks. */
+} cte_allocator_t;
+
+/**
+ * @brief Allocates through `allocator`, or stdlea `malloc` if it is NULL.
+ * @param allocator The allocation hooks, or NULL.
+ * @param size The number of bytes to allocate.
+ * @param alignment The required alignment (a power of two).
+ * @return A pointer to the block.
+ * @note This function will abort via `lea_abort` if the allocation fails.
+ */
+void *cte_allocate(const cte_allocator_t *allocator, size_t size, size_t alignment);
+
+/**
+ * @brief Releases a block obtained from `cte_allocate()` with the same allocator.
+ * @param allocator The allocation hooks, or NULL.
+ * @param ptr The block to release.
+ * @param size The size passed to `cte_allocate()`.
+ * @param alignment The alignment passed to `cte_allocate()`.
+ */
+void cte_deallocate(const cte_allocator_t *allocator, void *ptr, size_t size, size_t alignment);
+
 /**
  * @brief Gets the size in bytes of a public key for a given crypto type.
  * @param type_code The crypto type code (e.g., CTE_CRYPTO_TYPE_ED25519).
@@ -215,4 +278,8 @@ size_t get_public_key_size(uint8_t type_code);
  */
 size_t get_signature_item_size(uint8_t type_code);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif // CTE_H
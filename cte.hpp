@@ -0,0 +1,1260 @@
+#ifndef CTE_HPP
+#define CTE_HPP
+
+#include "decoder.h"
+#include "encoder.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @file cte.hpp
+ * @brief Header-only C++20 layer over the CTE encoder and decoder.
+ *
+ * The classes in this file are thin wrappers: every member forwards to the
+ * corresponding C function, so the generated code is the same as calling the
+ * C API by hand. They add RAII ownership of the contexts, `std::span` views of
+ * list and command payloads, and a forward range over the fields of a
+ * transaction. Errors are reported exactly as in the C API, via `lea_abort`.
+ *
+ * The `cte::prebaked` namespace encodes fields entirely at compile time for
+ * fragments whose values are known in advance.
+ *
+ * `cte::pmr_allocator()` adapts a `std::pmr::memory_resource` to the C
+ * allocation hooks, so contexts and buffers can live in arenas or pools.
+ *
+ * `cte::basic_decoder` is a standalone decoder whose set of validity checks is
+ * a template parameter (`strict_checks` or `minimal_checks`).
+ */
+
+namespace cte
+{
+
+/**
+ * @brief Marks the small forwarding helpers that must always be inlined, even
+ * at `-Os`, so the range compiles to the same calls as a hand-written loop.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define CTE_HPP_INLINE inline __attribute__((always_inline))
+#else
+#define CTE_HPP_INLINE inline
+#endif
+
+namespace detail
+{
+/** @brief Public key sizes indexed by crypto type code (mirrors `get_public_key_size`). */
+inline constexpr uint8_t public_key_size[4] = {CTE_PUBKEY_SIZE_ED25519, CTE_PUBKEY_SIZE_SLH_128F,
+                                               CTE_PUBKEY_SIZE_SLH_192F, CTE_PUBKEY_SIZE_SLH_256F};
+/** @brief Signature item sizes indexed by crypto type code (mirrors `get_signature_item_size`). */
+inline constexpr uint8_t signature_item_size[4] = {CTE_SIGNATURE_SIZE_ED25519, CTE_SIGNATURE_HASH_SIZE_PQC,
+                                                   CTE_SIGNATURE_HASH_SIZE_PQC, CTE_SIGNATURE_HASH_SIZE_PQC};
+} // namespace detail
+
+/**
+ * @brief Compile-time encoding of constant transaction fragments.
+ *
+ * Each function mirrors one `cte_encoder_write_ixdata_*` / `cte_encoder_begin_*`
+ * call and returns the encoded field as a `std::array` whose size the compiler
+ * computes. Fragments are joined with `concat()` (no version byte) or
+ * `transaction()` (with the version byte), and spliced into a running encoder
+ * with `cte::encoder::append()`:
+ *
+ * @code
+ * constexpr auto prefix = cte::prebaked::concat(
+ *     cte::prebaked::command_data(cte::prebaked::literal("transfer")),
+ *     cte::prebaked::boolean(true));
+ * enc.append(prefix);
+ * @endcode
+ *
+ * Values that decide the encoded length (ULEB128/SLEB128 values, payload and
+ * list sizes) are template arguments. Invalid arguments are rejected with
+ * `lea_abort`, which is not `constexpr`, so in a constant expression they are
+ * compile errors.
+ */
+namespace prebaked
+{
+
+/** @brief An encoded fragment of `N` bytes. */
+template <size_t N>
+using bytes = std::array<uint8_t, N>;
+
+/** @brief Number of bytes `_encode_uleb128` emits for `value`. */
+constexpr size_t uleb128_size(uint64_t value)
+{
+    size_t size = 1;
+    while (value >>= 7)
+    {
+        ++size;
+    }
+    return size;
+}
+
+/** @brief Number of bytes `_encode_sleb128` emits for `value`. */
+constexpr size_t sleb128_size(int64_t value)
+{
+    size_t size = 1;
+    for (;;)
+    {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        if ((value == 0 && !(byte & 0x40)) || (value == -1 && (byte & 0x40)))
+        {
+            return size;
+        }
+        ++size;
+    }
+}
+
+/** @brief Converts a string literal (without its terminating NUL) into bytes. */
+template <size_t L>
+constexpr bytes<L - 1> literal(const char (&text)[L])
+{
+    bytes<L - 1> out{};
+    for (size_t i = 0; i + 1 < L; ++i)
+    {
+        out[i] = (uint8_t)text[i];
+    }
+    return out;
+}
+
+/** @brief Concatenates fragments without adding a version byte. */
+template <size_t... N>
+constexpr bytes<(N + ... + 0)> concat(const bytes<N> &...parts)
+{
+    bytes<(N + ... + 0)> out{};
+    size_t position = 0;
+    ((std::copy(parts.begin(), parts.end(), out.begin() + position), position += N), ...);
+    return out;
+}
+
+/** @brief Concatenates fragments behind the `CTE_VERSION_BYTE`, forming a whole transaction. */
+template <size_t... N>
+constexpr bytes<1 + (N + ... + 0)> transaction(const bytes<N> &...parts)
+{
+    return concat(bytes<1>{CTE_VERSION_BYTE}, parts...);
+}
+
+/** @brief Mirrors `cte_encoder_write_ixdata_index_reference`. */
+constexpr bytes<1> index_reference(uint8_t index)
+{
+    if (index > CTE_LEGACY_INDEX_MAX_VALUE)
+    {
+        lea_abort("Legacy index value out of range (0-15)");
+    }
+    return {CTE_IXDATA_HEADER(index, CTE_IXDATA_SUBTYPE_LEGACY_INDEX)};
+}
+
+/** @brief Mirrors `cte_encoder_write_ixdata_uleb128`. */
+template <uint64_t Value>
+constexpr bytes<1 + uleb128_size(Value)> uleb128()
+{
+    bytes<1 + uleb128_size(Value)> out{CTE_IXDATA_HEADER(CTE_IXDATA_VARINT_ENC_ULEB128, CTE_IXDATA_SUBTYPE_VARINT)};
+    uint64_t value = Value;
+    for (size_t i = 1; i < out.size(); ++i)
+    {
+        out[i] = (uint8_t)((value & 0x7f) | (i + 1 < out.size() ? 0x80 : 0));
+        value >>= 7;
+    }
+    return out;
+}
+
+/** @brief Mirrors `cte_encoder_write_ixdata_sleb128`. */
+template <int64_t Value>
+constexpr bytes<1 + sleb128_size(Value)> sleb128()
+{
+    bytes<1 + sleb128_size(Value)> out{CTE_IXDATA_HEADER(CTE_IXDATA_VARINT_ENC_SLEB128, CTE_IXDATA_SUBTYPE_VARINT)};
+    int64_t value = Value;
+    for (size_t i = 1; i < out.size(); ++i)
+    {
+        out[i] = (uint8_t)((value & 0x7f) | (i + 1 < out.size() ? 0x80 : 0));
+        value >>= 7;
+    }
+    return out;
+}
+
+namespace detail
+{
+/** @brief Encodes a fixed-size IxData field; the payload is written little-endian. */
+template <typename T>
+constexpr bytes<1 + sizeof(T)> fixed(uint8_t type_code, T value)
+{
+    using U = std::conditional_t<sizeof(T) == 1, uint8_t,
+                                 std::conditional_t<sizeof(T) == 2, uint16_t,
+                                                    std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+    U raw = std::bit_cast<U>(value);
+    bytes<1 + sizeof(T)> out{CTE_IXDATA_HEADER(type_code, CTE_IXDATA_SUBTYPE_FIXED)};
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+        out[1 + i] = (uint8_t)(raw >> (8 * i));
+    }
+    return out;
+}
+} // namespace detail
+
+constexpr bytes<2> int8(int8_t value) { return detail::fixed(CTE_IXDATA_FIXED_TYPE_INT8, value); }
+constexpr bytes<3> int16(int16_t value) { return detail::fixed(CTE_IXDATA_FIXED_TYPE_INT16, value); }
+constexpr bytes<5> int32(int32_t value) { return detail::fixed(CTE_IXDATA_FIXED_TYPE_INT32, value); }
+constexpr bytes<9> int64(int64_t value) { return detail::fixed(CTE_IXDATA_FIXED_TYPE_INT64, value); }
+constexpr bytes<2> uint8(uint8_t value) { return detail::fixed(CTE_IXDATA_FIXED_TYPE_UINT8, value); }
+constexpr bytes<3> uint16(uint16_t value) { return detail::fixed(CTE_IXDATA_FIXED_TYPE_UINT16, value); }
+constexpr bytes<5> uint32(uint32_t value) { return detail::fixed(CTE_IXDATA_FIXED_TYPE_UINT32, value); }
+constexpr bytes<9> uint64(uint64_t value) { return detail::fixed(CTE_IXDATA_FIXED_TYPE_UINT64, value); }
+constexpr bytes<5> float32(float value) { return detail::fixed(CTE_IXDATA_FIXED_TYPE_FLOAT32, value); }
+constexpr bytes<9> float64(double value) { return detail::fixed(CTE_IXDATA_FIXED_TYPE_FLOAT64, value); }
+
+/** @brief Mirrors `cte_encoder_write_ixdata_boolean`. */
+constexpr bytes<1> boolean(bool value)
+{
+    return {CTE_IXDATA_HEADER(value ? CTE_IXDATA_CONST_VAL_TRUE : CTE_IXDATA_CONST_VAL_FALSE,
+                              CTE_IXDATA_SUBTYPE_CONSTANT)};
+}
+
+/**
+ * @brief Mirrors `cte_encoder_begin_command_data` followed by a copy of `payload`.
+ *
+ * The short format is selected for payloads of up to 31 bytes and the extended
+ * format (two header bytes) for 32-1197 bytes.
+ */
+template <size_t L>
+constexpr bytes<(L <= CTE_COMMAND_SHORT_MAX_LEN ? 1 : 2) + L> command_data(const bytes<L> &payload)
+{
+    static_assert(L <= CTE_COMMAND_EXTENDED_MAX_LEN, "Command data length out of range (0-1197)");
+    constexpr size_t header_size = L <= CTE_COMMAND_SHORT_MAX_LEN ? 1 : 2;
+    bytes<header_size + L> out{};
+    if constexpr (header_size == 1)
+    {
+        out[0] = CTE_COMMAND_SHORT_HEADER(L);
+    }
+    else
+    {
+        out[0] = CTE_COMMAND_EXTENDED_HEADER1(L);
+        out[1] = CTE_COMMAND_EXTENDED_HEADER2(L);
+    }
+    std::copy(payload.begin(), payload.end(), out.begin() + header_size);
+    return out;
+}
+
+/**
+ * @brief Mirrors `cte_encoder_begin_public_key_list` followed by a copy of `keys`.
+ * @param keys The concatenated keys; the count is `N` divided by the key size.
+ */
+template <uint8_t TypeCode, size_t N>
+constexpr bytes<1 + N> public_key_list(const bytes<N> &keys)
+{
+    constexpr size_t item_size = cte::detail::public_key_size[TypeCode & CTE_CRYPTO_TYPE_MASK];
+    static_assert(TypeCode <= CTE_CRYPTO_TYPE_MASK, "Invalid public key type code");
+    static_assert(N % item_size == 0, "Key bytes are not a whole number of keys");
+    static_assert(N / item_size >= 1 && N / item_size <= CTE_LIST_MAX_LEN,
+                  "Invalid public key list length (must be 1-15)");
+    bytes<1 + N> out{CTE_LIST_HEADER(CTE_TAG_PUBLIC_KEY_LIST, N / item_size, TypeCode)};
+    std::copy(keys.begin(), keys.end(), out.begin() + 1);
+    return out;
+}
+
+/**
+ * @brief Mirrors `cte_encoder_begin_signature_list` followed by a copy of `sigs`.
+ * @param sigs The concatenated items; the count is `N` divided by the item size.
+ */
+template <uint8_t TypeCode, size_t N>
+constexpr bytes<1 + N> signature_list(const bytes<N> &sigs)
+{
+    constexpr size_t item_size = cte::detail::signature_item_size[TypeCode & CTE_CRYPTO_TYPE_MASK];
+    static_assert(TypeCode <= CTE_CRYPTO_TYPE_MASK, "Invalid signature type code");
+    static_assert(N % item_size == 0, "Signature bytes are not a whole number of items");
+    static_assert(N / item_size >= 1 && N / item_size <= CTE_LIST_MAX_LEN,
+                  "Invalid signature list length (must be 1-15)");
+    bytes<1 + N> out{CTE_LIST_HEADER(CTE_TAG_SIGNATURE_LIST, N / item_size, TypeCode)};
+    std::copy(sigs.begin(), sigs.end(), out.begin() + 1);
+    return out;
+}
+
+} // namespace prebaked
+
+namespace detail
+{
+/** @brief `cte_allocator_t::alloc` hook over a `std::pmr::memory_resource`. */
+inline void *pmr_alloc(void *context, size_t size, size_t alignment) noexcept
+{
+    try
+    {
+        return static_cast<std::pmr::memory_resource *>(context)->allocate(size, alignment);
+    }
+    catch (...)
+    {
+        return nullptr; // The C side reports the failure via lea_abort.
+    }
+}
+
+/** @brief `cte_allocator_t::free` hook over a `std::pmr::memory_resource`. */
+inline void pmr_free(void *context, void *ptr, size_t size, size_t alignment) noexcept
+{
+    static_cast<std::pmr::memory_resource *>(context)->deallocate(ptr, size, alignment);
+}
+} // namespace detail
+
+/**
+ * @brief Returns allocation hooks that forward to `resource`.
+ *
+ * The hooks are copied into each context, but `resource` itself must outlive
+ * every encoder and decoder created with them.
+ */
+inline cte_allocator_t pmr_allocator(std::pmr::memory_resource *resource) noexcept
+{
+    return {detail::pmr_alloc, detail::pmr_free, resource};
+}
+
+/**
+ * @brief Owning wrapper around a `cte_encoder_t` context.
+ *
+ * The context is released with `cte_encoder_free()` when the wrapper is
+ * destroyed. The wrapper is move-only.
+ */
+class encoder
+{
+public:
+    /**
+     * @brief Creates an encoder with an internal buffer of `capacity` bytes.
+     * @param capacity The total size in bytes of the internal buffer.
+     */
+    explicit encoder(size_t capacity) : handle_(cte_encoder_init(capacity)) {}
+
+    /**
+     * @brief Creates an encoder whose context and buffer come from `allocator`.
+     * @param capacity The total size in bytes of the internal buffer.
+     * @param allocator The allocation hooks; they are copied.
+     */
+    encoder(size_t capacity, const cte_allocator_t &allocator)
+        : handle_(cte_encoder_init_with_allocator(capacity, &allocator))
+    {
+    }
+
+    /**
+     * @brief Creates an encoder whose context and buffer come from `resource`.
+     * @param capacity The total size in bytes of the internal buffer.
+     * @param resource The memory resource; it must outlive the encoder.
+     */
+    encoder(size_t capacity, std::pmr::memory_resource *resource) : encoder(capacity, pmr_allocator(resource)) {}
+
+    ~encoder() { cte_encoder_free(handle_); }
+
+    encoder(const encoder &) = delete;
+    encoder &operator=(const encoder &) = delete;
+
+    encoder(encoder &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    encoder &operator=(encoder &&other) noexcept
+    {
+        if (this != &other)
+        {
+            cte_encoder_free(handle_);
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    /** @brief Returns the underlying C context. */
+    cte_encoder_t *get() const noexcept { return handle_; }
+
+    /** @brief Rewinds the encoder to an empty transaction (version byte only). */
+    void reset() { cte_encoder_reset(handle_); }
+
+    /** @brief Returns the bytes encoded so far, including the version byte. */
+    std::span<const uint8_t> data() const
+    {
+        return {cte_encoder_get_data(handle_), cte_encoder_get_size(handle_)};
+    }
+
+    /**
+     * @brief Begins a Public Key List field.
+     * @return A writable view of the reserved key bytes (`key_count` keys).
+     */
+    std::span<uint8_t> begin_public_key_list(uint8_t key_count, uint8_t type_code)
+    {
+        void *ptr = cte_encoder_begin_public_key_list(handle_, key_count, type_code);
+        return {static_cast<uint8_t *>(ptr), key_count * get_public_key_size(type_code)};
+    }
+
+    /**
+     * @brief Begins a Signature List field.
+     * @return A writable view of the reserved signature bytes (`sig_count` items).
+     */
+    std::span<uint8_t> begin_signature_list(uint8_t sig_count, uint8_t type_code)
+    {
+        void *ptr = cte_encoder_begin_signature_list(handle_, sig_count, type_code);
+        return {static_cast<uint8_t *>(ptr), sig_count * get_signature_item_size(type_code)};
+    }
+
+    /**
+     * @brief Begins a Command Data field.
+     * @return A writable view of the reserved payload bytes.
+     */
+    std::span<uint8_t> begin_command_data(size_t length)
+    {
+        void *ptr = cte_encoder_begin_command_data(handle_, length);
+        return {static_cast<uint8_t *>(ptr), length};
+    }
+
+    /**
+     * @brief Writes a complete Public Key List field.
+     * @param keys The concatenated keys; the count is derived from the key size.
+     * @note Aborts via `lea_abort` if `keys` is not a whole number of keys.
+     */
+    void write_public_key_list(uint8_t type_code, std::span<const uint8_t> keys)
+    {
+        size_t item_size = get_public_key_size(type_code);
+        if (keys.size() % item_size != 0)
+            lea_abort("Key bytes are not a whole number of keys");
+        size_t count = keys.size() / item_size;
+        std::memcpy(cte_encoder_begin_public_key_list(handle_, (uint8_t)count, type_code), keys.data(), keys.size());
+    }
+
+    /**
+     * @brief Writes a complete Signature List field.
+     * @param sigs The concatenated items; the count is derived from the item size.
+     * @note Aborts via `lea_abort` if `sigs` is not a whole number of items.
+     */
+    void write_signature_list(uint8_t type_code, std::span<const uint8_t> sigs)
+    {
+        size_t item_size = get_signature_item_size(type_code);
+        if (sigs.size() % item_size != 0)
+            lea_abort("Signature bytes are not a whole number of items");
+        size_t count = sigs.size() / item_size;
+        std::memcpy(cte_encoder_begin_signature_list(handle_, (uint8_t)count, type_code), sigs.data(), sigs.size());
+    }
+
+    /** @brief Writes a complete Command Data field. */
+    void write_command_data(std::span<const uint8_t> payload)
+    {
+        std::memcpy(cte_encoder_begin_command_data(handle_, payload.size()), payload.data(), payload.size());
+    }
+
+    void write_index_reference(uint8_t index) { cte_encoder_write_ixdata_index_reference(handle_, index); }
+    void write_uleb128(uint64_t value) { cte_encoder_write_ixdata_uleb128(handle_, value); }
+    void write_sleb128(int64_t value) { cte_encoder_write_ixdata_sleb128(handle_, value); }
+    void write_int8(int8_t value) { cte_encoder_write_ixdata_int8(handle_, value); }
+    void write_int16(int16_t value) { cte_encoder_write_ixdata_int16(handle_, value); }
+    void write_int32(int32_t value) { cte_encoder_write_ixdata_int32(handle_, value); }
+    void write_int64(int64_t value) { cte_encoder_write_ixdata_int64(handle_, value); }
+    void write_uint8(uint8_t value) { cte_encoder_write_ixdata_uint8(handle_, value); }
+    void write_uint16(uint16_t value) { cte_encoder_write_ixdata_uint16(handle_, value); }
+    void write_uint32(uint32_t value) { cte_encoder_write_ixdata_uint32(handle_, value); }
+    void write_uint64(uint64_t value) { cte_encoder_write_ixdata_uint64(handle_, value); }
+    void write_float32(float value) { cte_encoder_write_ixdata_float32(handle_, value); }
+    void write_float64(double value) { cte_encoder_write_ixdata_float64(handle_, value); }
+    void write_boolean(bool value) { cte_encoder_write_ixdata_boolean(handle_, value); }
+
+    /**
+     * @brief Copies pre-encoded fields (for example a `cte::prebaked` fragment) into the stream.
+     * @warning The bytes are not validated; they must be complete, well-formed fields.
+     */
+    void append(std::span<const uint8_t> fragment)
+    {
+        std::memcpy(cte_encoder_reserve_raw(handle_, fragment.size()), fragment.data(), fragment.size());
+    }
+
+private:
+    cte_encoder_t *handle_;
+};
+
+/**
+ * @brief A decoded field: its peek type plus a tagged view of its value.
+ *
+ * Which member is meaningful depends on `type`:
+ * - Public Key / Signature Lists: `count` and `bytes` (all items concatenated).
+ * - Command Data: `bytes` (the payload).
+ * - Legacy Index, Varint Zero, ULEB128 and unsigned fixed types: `value.u64`.
+ * - SLEB128 and signed fixed types: `value.i64`.
+ * - Float32 / Float64: `value.f32` / `value.f64`.
+ * - Boolean constants: `value.boolean`.
+ *
+ * `bytes` points into the decoder's buffer and stays valid as long as it does.
+ */
+struct field_view
+{
+    int type = CTE_PEEK_EOF;       /**< The `CTE_PEEK_TYPE_*` identifier of the field. */
+    size_t offset = 0;             /**< Offset of the field's header byte in the transaction. */
+    size_t count = 0;              /**< Item count for lists. */
+    std::span<const uint8_t> bytes; /**< List items or command payload. */
+    union
+    {
+        uint64_t u64;
+        int64_t i64;
+        float f32;
+        double f64;
+        bool boolean;
+    } value{};
+};
+
+/**
+ * @brief Reads the field at the decoder's current position into `out`.
+ *
+ * The caller must have obtained `type` from `cte_decoder_peek_type()` on the
+ * same decoder. This is the exact sequence of C calls a hand-written
+ * peek/switch loop makes.
+ *
+ * `out` is only written once the C call has returned: the decoder pointer
+ * escapes into that call, and a store made before it would have to be
+ * reloaded, which keeps the compiler from folding the caller's own switch
+ * on `out.type` into this one.
+ *
+ * @warning Aborts via `lea_abort` on malformed data or reserved type codes.
+ */
+CTE_HPP_INLINE void read_field(cte_decoder_t *decoder, int type, field_view &out)
+{
+    const size_t offset = decoder->position;
+    size_t count = 0;
+    std::span<const uint8_t> bytes;
+    switch (type)
+    {
+    case CTE_PEEK_TYPE_PK_LIST_ED25519:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_128F:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_192F:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_256F:
+    {
+        const uint8_t *data = cte_decoder_read_public_key_list_data(decoder);
+        count = decoder->last_list_count;
+        bytes = {data, count * detail::public_key_size[data[-1] & CTE_CRYPTO_TYPE_MASK]};
+        break;
+    }
+    case CTE_PEEK_TYPE_SIG_LIST_ED25519:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_128F:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_192F:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_256F:
+    {
+        const uint8_t *data = cte_decoder_read_signature_list_data(decoder);
+        count = decoder->last_list_count;
+        bytes = {data, count * detail::signature_item_size[data[-1] & CTE_CRYPTO_TYPE_MASK]};
+        break;
+    }
+    case CTE_PEEK_TYPE_IXDATA_LEGACY_INDEX:
+        out.value.u64 = cte_decoder_read_ixdata_index_reference(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_VARINT_ZERO:
+        cte_decoder_read_ixdata_varint_zero(decoder);
+        out.value.u64 = 0;
+        break;
+    case CTE_PEEK_TYPE_IXDATA_ULEB128:
+        out.value.u64 = cte_decoder_read_ixdata_uleb128(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_SLEB128:
+        out.value.i64 = cte_decoder_read_ixdata_sleb128(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_INT8:
+        out.value.i64 = cte_decoder_read_ixdata_int8(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_INT16:
+        out.value.i64 = cte_decoder_read_ixdata_int16(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_INT32:
+        out.value.i64 = cte_decoder_read_ixdata_int32(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_INT64:
+        out.value.i64 = cte_decoder_read_ixdata_int64(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_UINT8:
+        out.value.u64 = cte_decoder_read_ixdata_uint8(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_UINT16:
+        out.value.u64 = cte_decoder_read_ixdata_uint16(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_UINT32:
+        out.value.u64 = cte_decoder_read_ixdata_uint32(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_UINT64:
+        out.value.u64 = cte_decoder_read_ixdata_uint64(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_FLOAT32:
+        out.value.f32 = cte_decoder_read_ixdata_float32(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_FLOAT64:
+        out.value.f64 = cte_decoder_read_ixdata_float64(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_CONST_FALSE:
+    case CTE_PEEK_TYPE_IXDATA_CONST_TRUE:
+        out.value.boolean = cte_decoder_read_ixdata_boolean(decoder);
+        break;
+    case CTE_PEEK_TYPE_CMD_SHORT:
+    case CTE_PEEK_TYPE_CMD_EXTENDED:
+    {
+        const uint8_t *data = cte_decoder_read_command_data_payload(decoder);
+        bytes = {data, decoder->last_cmd_len};
+        break;
+    }
+    default:
+        lea_abort("Reserved or unknown field type");
+    }
+    out.type = type;
+    out.offset = offset;
+    out.count = count;
+    out.bytes = bytes;
+}
+
+/**
+ * @brief A forward range over the fields of a transaction.
+ *
+ * Each iterator carries its own copy of the (small) decoder state, so
+ * iterators are independent cursors over the same buffer and the range can be
+ * traversed more than once. The range only borrows the buffer; the decoder
+ * it was created from must outlive it.
+ */
+class field_range
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = field_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const field_view *;
+        using reference = const field_view &;
+
+        iterator() = default;
+
+        explicit iterator(const cte_decoder_t &start) : cursor_(start) { advance(); }
+
+        reference operator*() const noexcept { return current_; }
+        pointer operator->() const noexcept { return &current_; }
+
+        CTE_HPP_INLINE iterator &operator++()
+        {
+            advance();
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator previous = *this;
+            advance();
+            return previous;
+        }
+
+        bool operator==(const iterator &other) const noexcept
+        {
+            return current_.type == other.current_.type && current_.offset == other.current_.offset;
+        }
+
+        bool operator==(std::default_sentinel_t) const noexcept { return current_.type == CTE_PEEK_EOF; }
+
+    private:
+        CTE_HPP_INLINE void advance()
+        {
+            int type = cte_decoder_peek_type(&cursor_);
+            if (type == CTE_PEEK_EOF)
+            {
+                current_.type = CTE_PEEK_EOF;
+                current_.offset = cursor_.position;
+                return;
+            }
+            read_field(&cursor_, type, current_);
+        }
+
+        cte_decoder_t cursor_{};
+        field_view current_{};
+    };
+
+    explicit field_range(const cte_decoder_t &start) : start_(start) {}
+
+    iterator begin() const { return iterator(start_); }
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+    cte_decoder_t start_;
+};
+
+/**
+ * @brief Owning wrapper around a `cte_decoder_t` context.
+ *
+ * The context is released with `cte_decoder_free()` when the wrapper is
+ * destroyed. The wrapper is move-only.
+ */
+class decoder
+{
+public:
+    /**
+     * @brief Creates a decoder and loads a copy of `bytes` into it.
+     * @param bytes The encoded transaction (1 to `CTE_MAX_TRANSACTION_SIZE` bytes).
+     */
+    explicit decoder(std::span<const uint8_t> bytes) : handle_(cte_decoder_init(bytes.size()))
+    {
+        std::memcpy(cte_decoder_load(handle_), bytes.data(), bytes.size());
+    }
+
+    /**
+     * @brief Creates a decoder whose context and buffer come from `allocator`,
+     * and loads a copy of `bytes` into it.
+     * @param bytes The encoded transaction (1 to `CTE_MAX_TRANSACTION_SIZE` bytes).
+     * @param allocator The allocation hooks; they are copied.
+     */
+    decoder(std::span<const uint8_t> bytes, const cte_allocator_t &allocator)
+        : handle_(cte_decoder_init_with_allocator(bytes.size(), &allocator))
+    {
+        std::memcpy(cte_decoder_load(handle_), bytes.data(), bytes.size());
+    }
+
+    /**
+     * @brief Creates a decoder whose context and buffer come from `resource`,
+     * and loads a copy of `bytes` into it.
+     * @param bytes The encoded transaction (1 to `CTE_MAX_TRANSACTION_SIZE` bytes).
+     * @param resource The memory resource; it must outlive the decoder.
+     */
+    decoder(std::span<const uint8_t> bytes, std::pmr::memory_resource *resource)
+        : decoder(bytes, pmr_allocator(resource))
+    {
+    }
+
+    ~decoder() { cte_decoder_free(handle_); }
+
+    decoder(const decoder &) = delete;
+    decoder &operator=(const decoder &) = delete;
+
+    decoder(decoder &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    decoder &operator=(decoder &&other) noexcept
+    {
+        if (this != &other)
+        {
+            cte_decoder_free(handle_);
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    /** @brief Returns the underlying C context. */
+    cte_decoder_t *get() const noexcept { return handle_; }
+
+    /** @brief Rewinds to the first field after the version byte. */
+    void reset() { cte_decoder_reset(handle_); }
+
+    /** @brief Returns the next field's `CTE_PEEK_TYPE_*` identifier, or `CTE_PEEK_EOF`. */
+    int peek_type() { return cte_decoder_peek_type(handle_); }
+
+    /** @brief Reads the next field, whose type was returned by `peek_type()`. */
+    field_view read(int type)
+    {
+        field_view field;
+        read_field(handle_, type, field);
+        return field;
+    }
+
+    /**
+     * @brief Returns a range over the fields from the current position onward.
+     *
+     * Iterating the range does not move this decoder's own position.
+     */
+    field_range fields() const { return field_range(*handle_); }
+
+    /** @brief Reads a Public Key List field and returns all keys as one view. */
+    std::span<const uint8_t> read_public_key_list()
+    {
+        const uint8_t *data = cte_decoder_read_public_key_list_data(handle_);
+        return {data, handle_->last_list_count * detail::public_key_size[data[-1] & CTE_CRYPTO_TYPE_MASK]};
+    }
+
+    /** @brief Reads a Signature List field and returns all items as one view. */
+    std::span<const uint8_t> read_signature_list()
+    {
+        const uint8_t *data = cte_decoder_read_signature_list_data(handle_);
+        return {data, handle_->last_list_count * detail::signature_item_size[data[-1] & CTE_CRYPTO_TYPE_MASK]};
+    }
+
+    /** @brief Reads a Command Data field and returns its payload. */
+    std::span<const uint8_t> read_command_data()
+    {
+        const uint8_t *data = cte_decoder_read_command_data_payload(handle_);
+        return {data, handle_->last_cmd_len};
+    }
+
+    size_t last_list_count() const { return cte_decoder_get_last_list_count(handle_); }
+
+    uint8_t read_index_reference() { return cte_decoder_read_ixdata_index_reference(handle_); }
+    void read_varint_zero() { cte_decoder_read_ixdata_varint_zero(handle_); }
+    uint64_t read_uleb128() { return cte_decoder_read_ixdata_uleb128(handle_); }
+    int64_t read_sleb128() { return cte_decoder_read_ixdata_sleb128(handle_); }
+    int8_t read_int8() { return cte_decoder_read_ixdata_int8(handle_); }
+    int16_t read_int16() { return cte_decoder_read_ixdata_int16(handle_); }
+    int32_t read_int32() { return cte_decoder_read_ixdata_int32(handle_); }
+    int64_t read_int64() { return cte_decoder_read_ixdata_int64(handle_); }
+    uint8_t read_uint8() { return cte_decoder_read_ixdata_uint8(handle_); }
+    uint16_t read_uint16() { return cte_decoder_read_ixdata_uint16(handle_); }
+    uint32_t read_uint32() { return cte_decoder_read_ixdata_uint32(handle_); }
+    uint64_t read_uint64() { return cte_decoder_read_ixdata_uint64(handle_); }
+    float read_float32() { return cte_decoder_read_ixdata_float32(handle_); }
+    double read_float64() { return cte_decoder_read_ixdata_float64(handle_); }
+    bool read_boolean() { return cte_decoder_read_ixdata_boolean(handle_); }
+
+private:
+    cte_decoder_t *handle_;
+};
+
+/**
+ * @brief Checking policy with every check made by decoder.c.
+ *
+ * Use this for anything that decides validity, such as consensus.
+ */
+struct strict_checks
+{
+    static constexpr bool version = true;      /**< Verify the leading version byte. */
+    static constexpr bool tags = true;         /**< Verify tag, sub-type and code in typed reads (`CHECK_TAG`). */
+    static constexpr bool padding = true;      /**< Reject non-zero padding bits. */
+    static constexpr bool reserved = true;     /**< Reject reserved codes, empty lists and out-of-range lengths. */
+    static constexpr bool leb_overflow = true; /**< Reject LEB128 values wider than 64 bits. */
+};
+
+/**
+ * @brief Checking policy for re-reading data that was already validated.
+ *
+ * Only the checks that keep reads inside the buffer remain: bounds, and the
+ * reserved codes whose size cannot be determined. Everything else is trusted.
+ */
+struct minimal_checks
+{
+    static constexpr bool version = false;
+    static constexpr bool tags = false;
+    static constexpr bool padding = false;
+    static constexpr bool reserved = false;
+    static constexpr bool leb_overflow = false;
+};
+
+/**
+ * @brief A self-contained decoder whose validation is chosen at compile time.
+ *
+ * `Policy` is a type with the `static constexpr bool` members of
+ * `strict_checks`. Every check is guarded by `if constexpr`, so one source
+ * yields a fully checking decoder and a minimal one without runtime cost for
+ * the disabled checks. On valid input all policies return identical results;
+ * with `strict_checks` invalid input aborts with the same messages as
+ * decoder.c.
+ *
+ * Unlike `decoder`, this class does not call into the C library: it borrows
+ * the buffer, keeps its own position, and classifies and reads a field in a
+ * single step through `next()`. Bounds are always checked.
+ *
+ * @code
+ * cte::basic_decoder<cte::minimal_checks> dec(bytes);
+ * for (cte::field_view f; dec.next(f);)
+ *     index(f);
+ * @endcode
+ */
+template <typename Policy>
+class basic_decoder
+{
+public:
+    /**
+     * @brief Creates a decoder over `bytes`, which must outlive it.
+     * @param bytes The encoded transaction, starting with the version byte.
+     */
+    explicit basic_decoder(std::span<const uint8_t> bytes) : data_(bytes.data()), size_(bytes.size()) {}
+
+    /** @brief Rewinds to the start of the transaction. */
+    void reset() noexcept { position_ = 0; }
+
+    /** @brief Returns the current offset in the transaction. */
+    size_t position() const noexcept { return position_; }
+
+    /**
+     * @brief Reads the next field into `out`.
+     * @return `false` at the end of the transaction, with `out.type` set to `CTE_PEEK_EOF`.
+     */
+    CTE_HPP_INLINE bool next(field_view &out)
+    {
+        skip_version();
+        out.offset = position_;
+        out.count = 0;
+        out.bytes = {};
+        if (position_ >= size_)
+        {
+            out.type = CTE_PEEK_EOF;
+            return false;
+        }
+        uint8_t header = data_[position_];
+        switch (header & CTE_TAG_MASK)
+        {
+        case CTE_TAG_PUBLIC_KEY_LIST:
+            out.type = CTE_PEEK_TYPE_PK_LIST_ED25519 + (header & CTE_CRYPTO_TYPE_MASK);
+            out.bytes = take_list(header, detail::public_key_size, "Invalid public key list length read (N must be 1-15)");
+            out.count = (header >> 2) & 0x0F;
+            break;
+        case CTE_TAG_SIGNATURE_LIST:
+            out.type = CTE_PEEK_TYPE_SIG_LIST_ED25519 + (header & CTE_CRYPTO_TYPE_MASK);
+            out.bytes = take_list(header, detail::signature_item_size, "Invalid signature list length read (N must be 1-15)");
+            out.count = (header >> 2) & 0x0F;
+            break;
+        case CTE_TAG_IXDATA_FIELD:
+            take_ixdata(header, out);
+            break;
+        default:
+            out.type = (header & CTE_COMMAND_FORMAT_FLAG_MASK) ? CTE_PEEK_TYPE_CMD_EXTENDED : CTE_PEEK_TYPE_CMD_SHORT;
+            out.bytes = take_command(header);
+            break;
+        }
+        return true;
+    }
+
+    /** @brief Reads a Public Key List field and returns all keys as one view. */
+    std::span<const uint8_t> read_public_key_list()
+    {
+        uint8_t header = expect(CTE_TAG_MASK, CTE_TAG_PUBLIC_KEY_LIST, "Unexpected field tag");
+        last_list_count_ = (header >> 2) & 0x0F;
+        return take_list(header, detail::public_key_size, "Invalid public key list length read (N must be 1-15)");
+    }
+
+    /** @brief Reads a Signature List field and returns all items as one view. */
+    std::span<const uint8_t> read_signature_list()
+    {
+        uint8_t header = expect(CTE_TAG_MASK, CTE_TAG_SIGNATURE_LIST, "Unexpected field tag");
+        last_list_count_ = (header >> 2) & 0x0F;
+        return take_list(header, detail::signature_item_size, "Invalid signature list length read (N must be 1-15)");
+    }
+
+    /** @brief Reads a Command Data field and returns its payload. */
+    std::span<const uint8_t> read_command_data()
+    {
+        return take_command(expect(CTE_TAG_MASK, CTE_TAG_COMMAND_DATA, "Unexpected field tag"));
+    }
+
+    /** @brief Returns the item count of the last list read through `read_*_list()`. */
+    size_t last_list_count() const noexcept { return last_list_count_; }
+
+    uint8_t read_index_reference()
+    {
+        uint8_t header = expect_ixdata(CTE_IXDATA_SUBTYPE_LEGACY_INDEX);
+        position_++;
+        return (header >> 2) & 0x0F;
+    }
+
+    void read_varint_zero()
+    {
+        expect_code(CTE_IXDATA_VARINT_ENC_ZERO, CTE_IXDATA_SUBTYPE_VARINT, "Expected Varint encoding scheme 0 (ZERO)");
+        position_++;
+    }
+
+    uint64_t read_uleb128()
+    {
+        expect_code(CTE_IXDATA_VARINT_ENC_ULEB128, CTE_IXDATA_SUBTYPE_VARINT,
+                    "Expected Varint encoding scheme 1 (ULEB128)");
+        position_++;
+        return take_uleb128();
+    }
+
+    int64_t read_sleb128()
+    {
+        expect_code(CTE_IXDATA_VARINT_ENC_SLEB128, CTE_IXDATA_SUBTYPE_VARINT,
+                    "Expected Varint encoding scheme 2 (SLEB128)");
+        position_++;
+        return take_sleb128();
+    }
+
+    bool read_boolean()
+    {
+        uint8_t code = (expect_ixdata(CTE_IXDATA_SUBTYPE_CONSTANT) >> 2) & 0x0F;
+        if constexpr (Policy::reserved)
+        {
+            if (code > CTE_IXDATA_CONST_VAL_TRUE)
+            {
+                lea_abort("Reserved IxData Constant value code encountered");
+            }
+        }
+        position_++;
+        return code != CTE_IXDATA_CONST_VAL_FALSE;
+    }
+
+    int8_t read_int8() { return read_fixed<int8_t>(CTE_IXDATA_FIXED_TYPE_INT8); }
+    int16_t read_int16() { return read_fixed<int16_t>(CTE_IXDATA_FIXED_TYPE_INT16); }
+    int32_t read_int32() { return read_fixed<int32_t>(CTE_IXDATA_FIXED_TYPE_INT32); }
+    int64_t read_int64() { return read_fixed<int64_t>(CTE_IXDATA_FIXED_TYPE_INT64); }
+    uint8_t read_uint8() { return read_fixed<uint8_t>(CTE_IXDATA_FIXED_TYPE_UINT8); }
+    uint16_t read_uint16() { return read_fixed<uint16_t>(CTE_IXDATA_FIXED_TYPE_UINT16); }
+    uint32_t read_uint32() { return read_fixed<uint32_t>(CTE_IXDATA_FIXED_TYPE_UINT32); }
+    uint64_t read_uint64() { return read_fixed<uint64_t>(CTE_IXDATA_FIXED_TYPE_UINT64); }
+    float read_float32() { return read_fixed<float>(CTE_IXDATA_FIXED_TYPE_FLOAT32); }
+    double read_float64() { return read_fixed<double>(CTE_IXDATA_FIXED_TYPE_FLOAT64); }
+
+private:
+    CTE_HPP_INLINE void need(size_t bytes) const
+    {
+        if (size_ - position_ < bytes)
+        {
+            lea_abort("Read past end of buffer");
+        }
+    }
+
+    CTE_HPP_INLINE void skip_version()
+    {
+        if (position_ == 0 && size_ != 0)
+        {
+            if constexpr (Policy::version)
+            {
+                if (data_[0] != CTE_VERSION_BYTE)
+                {
+                    lea_abort("Invalid version byte");
+                }
+            }
+            position_ = 1;
+        }
+    }
+
+    /** @brief Returns the next header byte, checking `(header & mask) == value` if the policy asks for it. */
+    CTE_HPP_INLINE uint8_t expect(uint8_t mask, uint8_t value, const char *message)
+    {
+        skip_version();
+        need(1);
+        uint8_t header = data_[position_];
+        if constexpr (Policy::tags)
+        {
+            if ((header & mask) != value)
+            {
+                lea_abort(message);
+            }
+        }
+        return header;
+    }
+
+    CTE_HPP_INLINE uint8_t expect_ixdata(uint8_t subtype)
+    {
+        uint8_t header = expect(CTE_TAG_MASK, CTE_TAG_IXDATA_FIELD, "Unexpected field tag");
+        if constexpr (Policy::tags)
+        {
+            if ((header & CTE_IXDATA_SUBTYPE_MASK) != subtype)
+            {
+                lea_abort("Unexpected IxData subtype");
+            }
+        }
+        return header;
+    }
+
+    CTE_HPP_INLINE void expect_code(uint8_t code, uint8_t subtype, const char *message)
+    {
+        uint8_t header = expect_ixdata(subtype);
+        if constexpr (Policy::tags)
+        {
+            if (((header >> 2) & 0x0F) != code)
+            {
+                lea_abort(message);
+            }
+        }
+    }
+
+    template <typename T>
+    CTE_HPP_INLINE T read_fixed(uint8_t code)
+    {
+        expect_code(code, CTE_IXDATA_SUBTYPE_FIXED, "Unexpected IxData Fixed type code");
+        need(1 + sizeof(T));
+        T value;
+        std::memcpy(&value, data_ + position_ + 1, sizeof(T));
+        position_ += 1 + sizeof(T);
+        return value;
+    }
+
+    CTE_HPP_INLINE std::span<const uint8_t> take_list(uint8_t header, const uint8_t (&item_size)[4], const char *message)
+    {
+        size_t count = (header >> 2) & 0x0F;
+        if constexpr (Policy::reserved)
+        {
+            if (count == 0)
+            {
+                lea_abort(message);
+            }
+        }
+        size_t total = count * item_size[header & CTE_CRYPTO_TYPE_MASK];
+        need(1 + total);
+        const uint8_t *items = data_ + position_ + 1;
+        position_ += 1 + total;
+        return {items, total};
+    }
+
+    CTE_HPP_INLINE std::span<const uint8_t> take_command(uint8_t header)
+    {
+        size_t header_size = 1;
+        size_t length = header & CTE_COMMAND_SHORT_MAX_LEN;
+        if (header & CTE_COMMAND_FORMAT_FLAG_MASK)
+        {
+            if constexpr (Policy::padding)
+            {
+                if (header & 0x03)
+                {
+                    lea_abort("Non-zero padding bits in Command Data Extended Header Byte 1");
+                }
+            }
+            need(2);
+            header_size = 2;
+            length = ((size_t)((header >> 2) & 0x07) << 8) | data_[position_ + 1];
+            if constexpr (Policy::reserved)
+            {
+                if (length < CTE_COMMAND_EXTENDED_MIN_LEN || length > CTE_COMMAND_EXTENDED_MAX_LEN)
+                {
+                    lea_abort("Invalid extended command data length");
+                }
+            }
+        }
+        need(header_size + length);
+        const uint8_t *payload = data_ + position_ + header_size;
+        position_ += header_size + length;
+        return {payload, length};
+    }
+
+    CTE_HPP_INLINE uint64_t take_uleb128()
+    {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 70; shift += 7)
+        {
+            need(1);
+            uint8_t byte = data_[position_++];
+            if constexpr (Policy::leb_overflow)
+            {
+                if (shift == 63 && (byte & 0xFE) != 0)
+                {
+                    lea_abort("ULEB128 overflow detected (value > 64 bits)");
+                }
+            }
+            result |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+            {
+                return result;
+            }
+        }
+        lea_abort("Invalid ULEB128 encoding (unterminated sequence > 10 bytes)");
+    }
+
+    CTE_HPP_INLINE int64_t take_sleb128()
+    {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 70; shift += 7)
+        {
+            need(1);
+            uint8_t byte = data_[position_++];
+            result |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+            {
+                if (shift + 7 < 64 && (byte & 0x40))
+                {
+                    result |= ~(uint64_t)0 << (shift + 7);
+                }
+                return (int64_t)result;
+            }
+            if constexpr (Policy::leb_overflow)
+            {
+                if (shift + 7 >= 64)
+                {
+                    lea_abort("Invalid SLEB128 encoding (too many bytes/overflow)");
+                }
+            }
+        }
+        lea_abort("Invalid SLEB128 encoding (unterminated sequence > 10 bytes)");
+    }
+
+    CTE_HPP_INLINE void take_ixdata(uint8_t header, field_view &out)
+    {
+        uint8_t code = (header >> 2) & 0x0F;
+        position_++;
+        switch (header & CTE_IXDATA_SUBTYPE_MASK)
+        {
+        case CTE_IXDATA_SUBTYPE_LEGACY_INDEX:
+            out.type = CTE_PEEK_TYPE_IXDATA_LEGACY_INDEX;
+            out.value.u64 = code;
+            return;
+        case CTE_IXDATA_SUBTYPE_VARINT:
+            switch (code)
+            {
+            case CTE_IXDATA_VARINT_ENC_ZERO:
+                out.type = CTE_PEEK_TYPE_IXDATA_VARINT_ZERO;
+                out.value.u64 = 0;
+                return;
+            case CTE_IXDATA_VARINT_ENC_ULEB128:
+                out.type = CTE_PEEK_TYPE_IXDATA_ULEB128;
+                out.value.u64 = take_uleb128();
+                return;
+            case CTE_IXDATA_VARINT_ENC_SLEB128:
+                out.type = CTE_PEEK_TYPE_IXDATA_SLEB128;
+                out.value.i64 = take_sleb128();
+                return;
+            }
+            lea_abort("Reserved IxData Varint encoding scheme encountered");
+        case CTE_IXDATA_SUBTYPE_FIXED:
+            if (code > CTE_IXDATA_FIXED_TYPE_FLOAT64)
+            {
+                lea_abort("Reserved IxData Fixed type code encountered");
+            }
+            out.type = CTE_PEEK_TYPE_IXDATA_INT8 + code;
+            switch (code)
+            {
+            case CTE_IXDATA_FIXED_TYPE_INT8:
+                out.value.i64 = take_fixed<int8_t>();
+                return;
+            case CTE_IXDATA_FIXED_TYPE_INT16:
+                out.value.i64 = take_fixed<int16_t>();
+                return;
+            case CTE_IXDATA_FIXED_TYPE_INT32:
+                out.value.i64 = take_fixed<int32_t>();
+                return;
+            case CTE_IXDATA_FIXED_TYPE_INT64:
+                out.value.i64 = take_fixed<int64_t>();
+                return;
+            case CTE_IXDATA_FIXED_TYPE_UINT8:
+                out.value.u64 = take_fixed<uint8_t>();
+                return;
+            case CTE_IXDATA_FIXED_TYPE_UINT16:
+                out.value.u64 = take_fixed<uint16_t>();
+                return;
+            case CTE_IXDATA_FIXED_TYPE_UINT32:
+                out.value.u64 = take_fixed<uint32_t>();
+                return;
+            case CTE_IXDATA_FIXED_TYPE_UINT64:
+                out.value.u64 = take_fixed<uint64_t>();
+                return;
+            case CTE_IXDATA_FIXED_TYPE_FLOAT32:
+                out.value.f32 = take_fixed<float>();
+                return;
+            default:
+                out.value.f64 = take_fixed<double>();
+                return;
+            }
+        default:
+            if constexpr (Policy::reserved)
+            {
+                if (code > CTE_IXDATA_CONST_VAL_TRUE)
+                {
+                    lea_abort("Reserved IxData Constant value code encountered");
+                }
+            }
+            out.value.boolean = code != CTE_IXDATA_CONST_VAL_FALSE;
+            out.type = out.value.boolean ? CTE_PEEK_TYPE_IXDATA_CONST_TRUE : CTE_PEEK_TYPE_IXDATA_CONST_FALSE;
+            return;
+        }
+    }
+
+    template <typename T>
+    CTE_HPP_INLINE T take_fixed()
+    {
+        need(sizeof(T));
+        T value;
+        std::memcpy(&value, data_ + position_, sizeof(T));
+        position_ += sizeof(T);
+        return value;
+    }
+
+    const uint8_t *data_;
+    size_t size_;
+    size_t position_ = 0;
+    size_t last_list_count_ = 0;
+};
+
+/** @brief A `basic_decoder` with every check of the C decoder. */
+using strict_decoder = basic_decoder<strict_checks>;
+
+/** @brief A `basic_decoder` for input that has already been validated. */
+using minimal_decoder = basic_decoder<minimal_checks>;
+
+} // namespace cte
+
+#endif // CTE_HPP
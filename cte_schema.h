@@ -0,0 +1,235 @@
+#ifndef CTE_SCHEMA_H
+#define CTE_SCHEMA_H
+
+#include "cte_struct.h"
+#include "decoder.h"
+#include <stdlea.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file cte_schema.h
+ * @brief Field schemas compiled into dedicated, non-aborting decoders.
+ *
+ * A schema names the expected field sequence of one instruction type using
+ * the `CTE_PEEK_TYPE_*` names without their prefix:
+ *
+ * @code
+ * #define TRANSFER_SCHEMA(X)       \
+ *     X(PK_LIST_ED25519, signers)  \
+ *     X(SIG_LIST_ED25519, sigs)    \
+ *     X(IXDATA_ULEB128, amount)    \
+ *     X(IXDATA_ULEB128, fee)       \
+ *     X(IXDATA_BOOLEAN, urgent)    \
+ *     X(CMD, memo)
+ *
+ * CTE_SCHEMA_DEFINE(transfer, TRANSFER_SCHEMA)
+ * @endcode
+ *
+ * This declares `struct transfer` with one typed member per field and
+ * `bool transfer_try_decode(cte_decoder_t *dec, struct transfer *out)`. The
+ * generated function reads the fields in order without any dispatch: each
+ * header byte is compared against the value (or mask) the schema implies and
+ * each payload is bounds-checked once.
+ *
+ * If the input does not have this shape, or is malformed anywhere inside it,
+ * the function returns `false` and leaves the decoder untouched, so the
+ * caller can fall back to the generic `cte_decoder_peek_type()` loop, which
+ * then reports any error as usual:
+ *
+ * @code
+ * struct transfer t;
+ * if (!transfer_try_decode(dec, &t))
+ * {
+ *     decode_generic(dec);
+ * }
+ * @endcode
+ *
+ * On success the decoder is positioned after the last schema field; a schema
+ * describing a whole transaction should check `dec->position == dec->size`.
+ *
+ * | kind                                  | member type       |
+ * |---------------------------------------|-------------------|
+ * | `PK_LIST_<scheme>`, `SIG_LIST_<scheme>` | `cte_list_view_t` |
+ * | `IXDATA_LEGACY_INDEX`                 | `uint8_t`         |
+ * | `IXDATA_VARINT_ZERO`, `IXDATA_ULEB128` | `uint64_t`        |
+ * | `IXDATA_SLEB128`                      | `int64_t`         |
+ * | `IXDATA_INT8` ... `IXDATA_FLOAT64`    | matching C type   |
+ * | `IXDATA_BOOLEAN` (either constant)    | `bool`            |
+ * | `CMD` (short or extended)             | `cte_bytes_t`     |
+ *
+ * List and command members point into the decoder's buffer.
+ *
+ * All kinds except lists and Varint Zero are the cte_struct.h readers run
+ * with `CTE_SCHEMA_FAIL`, so both headers apply the same checks.
+ */
+
+/**
+ * @struct cte_list_view
+ * @brief A borrowed view of the items of a Public Key or Signature List.
+ */
+typedef struct cte_list_view
+{
+    const uint8_t *data; /**< @param data Pointer to the first item. */
+    uint8_t count;       /**< @param count Number of items (1-15). */
+} cte_list_view_t;
+
+/**
+ * @name Runtime helpers
+ * @brief Internal helper for the list kinds, which cte_struct.h does not
+ * have; it returns `false` instead of aborting.
+ * @{
+ */
+static inline bool cte_schema_get_list(const uint8_t **pp, const uint8_t *end, uint8_t expected, size_t item_size,
+                                       cte_list_view_t *out)
+{
+    const uint8_t *p = *pp;
+    if (p == end || (*p & (CTE_TAG_MASK | CTE_CRYPTO_TYPE_MASK)) != expected)
+    {
+        return false;
+    }
+    uint8_t count = (*p >> 2) & 0x0F;
+    size_t total = count * item_size;
+    if (count == 0 || (size_t)(end - p) < 1 + total)
+    {
+        return false;
+    }
+    out->data = p + 1;
+    out->count = count;
+    *pp = p + 1 + total;
+    return true;
+}
+/** @} */
+
+/**
+ * @name Field kinds
+ * @brief `CTE_SCHEMA_DECL_K(member)` declares the member for kind `K`;
+ * `CTE_SCHEMA_GET_K(p, end, value)` reads it or returns `false` from the
+ * enclosing generated function.
+ * @{
+ */
+#define CTE_SCHEMA_REQUIRE(condition) \
+    if (!(condition))                 \
+    {                                 \
+        return false;                 \
+    }
+
+/** @brief Failure action for the cte_struct.h readers: the message is dropped. */
+#define CTE_SCHEMA_FAIL(message) return false
+
+#define CTE_SCHEMA_DECL_PK_LIST_ED25519(member) cte_list_view_t member;
+#define CTE_SCHEMA_DECL_PK_LIST_SLH_128F(member) cte_list_view_t member;
+#define CTE_SCHEMA_DECL_PK_LIST_SLH_192F(member) cte_list_view_t member;
+#define CTE_SCHEMA_DECL_PK_LIST_SLH_256F(member) cte_list_view_t member;
+#define CTE_SCHEMA_GET_PK_LIST_ED25519(p, end, value) \
+    CTE_SCHEMA_REQUIRE(cte_schema_get_list(&(p), (end), CTE_TAG_PUBLIC_KEY_LIST | CTE_CRYPTO_TYPE_ED25519, CTE_PUBKEY_SIZE_ED25519, &(value)))
+#define CTE_SCHEMA_GET_PK_LIST_SLH_128F(p, end, value) \
+    CTE_SCHEMA_REQUIRE(cte_schema_get_list(&(p), (end), CTE_TAG_PUBLIC_KEY_LIST | CTE_CRYPTO_TYPE_SLH_DSA_128F, CTE_PUBKEY_SIZE_SLH_128F, &(value)))
+#define CTE_SCHEMA_GET_PK_LIST_SLH_192F(p, end, value) \
+    CTE_SCHEMA_REQUIRE(cte_schema_get_list(&(p), (end), CTE_TAG_PUBLIC_KEY_LIST | CTE_CRYPTO_TYPE_SLH_DSA_192F, CTE_PUBKEY_SIZE_SLH_192F, &(value)))
+#define CTE_SCHEMA_GET_PK_LIST_SLH_256F(p, end, value) \
+    CTE_SCHEMA_REQUIRE(cte_schema_get_list(&(p), (end), CTE_TAG_PUBLIC_KEY_LIST | CTE_CRYPTO_TYPE_SLH_DSA_256F, CTE_PUBKEY_SIZE_SLH_256F, &(value)))
+
+#define CTE_SCHEMA_DECL_SIG_LIST_ED25519(member) cte_list_view_t member;
+#define CTE_SCHEMA_DECL_SIG_LIST_SLH_128F(member) cte_list_view_t member;
+#define CTE_SCHEMA_DECL_SIG_LIST_SLH_192F(member) cte_list_view_t member;
+#define CTE_SCHEMA_DECL_SIG_LIST_SLH_256F(member) cte_list_view_t member;
+#define CTE_SCHEMA_GET_SIG_LIST_ED25519(p, end, value) \
+    CTE_SCHEMA_REQUIRE(cte_schema_get_list(&(p), (end), CTE_TAG_SIGNATURE_LIST | CTE_CRYPTO_TYPE_ED25519, CTE_SIGNATURE_SIZE_ED25519, &(value)))
+#define CTE_SCHEMA_GET_SIG_LIST_SLH_128F(p, end, value) \
+    CTE_SCHEMA_REQUIRE(cte_schema_get_list(&(p), (end), CTE_TAG_SIGNATURE_LIST | CTE_CRYPTO_TYPE_SLH_DSA_128F, CTE_SIGNATURE_HASH_SIZE_PQC, &(value)))
+#define CTE_SCHEMA_GET_SIG_LIST_SLH_192F(p, end, value) \
+    CTE_SCHEMA_REQUIRE(cte_schema_get_list(&(p), (end), CTE_TAG_SIGNATURE_LIST | CTE_CRYPTO_TYPE_SLH_DSA_192F, CTE_SIGNATURE_HASH_SIZE_PQC, &(value)))
+#define CTE_SCHEMA_GET_SIG_LIST_SLH_256F(p, end, value) \
+    CTE_SCHEMA_REQUIRE(cte_schema_get_list(&(p), (end), CTE_TAG_SIGNATURE_LIST | CTE_CRYPTO_TYPE_SLH_DSA_256F, CTE_SIGNATURE_HASH_SIZE_PQC, &(value)))
+
+#define CTE_SCHEMA_DECL_IXDATA_LEGACY_INDEX(member) CTE_STRUCT_DECL_INDEX(member)
+#define CTE_SCHEMA_GET_IXDATA_LEGACY_INDEX(p, end, value) CTE_STRUCT_READ_INDEX(p, end, value, CTE_SCHEMA_FAIL);
+
+#define CTE_SCHEMA_DECL_IXDATA_VARINT_ZERO(member) uint64_t member;
+#define CTE_SCHEMA_GET_IXDATA_VARINT_ZERO(p, end, value)                                                          \
+    CTE_STRUCT_NEED((p), (end), 1, CTE_SCHEMA_FAIL)                                                               \
+    CTE_STRUCT_EXPECT(*(p)++, CTE_IXDATA_HEADER(CTE_IXDATA_VARINT_ENC_ZERO, CTE_IXDATA_SUBTYPE_VARINT), CTE_SCHEMA_FAIL) \
+    (value) = 0;
+
+#define CTE_SCHEMA_DECL_IXDATA_ULEB128(member) CTE_STRUCT_DECL_ULEB128(member)
+#define CTE_SCHEMA_GET_IXDATA_ULEB128(p, end, value) CTE_STRUCT_READ_ULEB128(p, end, value, CTE_SCHEMA_FAIL);
+
+#define CTE_SCHEMA_DECL_IXDATA_SLEB128(member) CTE_STRUCT_DECL_SLEB128(member)
+#define CTE_SCHEMA_GET_IXDATA_SLEB128(p, end, value) CTE_STRUCT_READ_SLEB128(p, end, value, CTE_SCHEMA_FAIL);
+
+#define CTE_SCHEMA_DECL_IXDATA_INT8(member) CTE_STRUCT_DECL_INT8(member)
+#define CTE_SCHEMA_DECL_IXDATA_INT16(member) CTE_STRUCT_DECL_INT16(member)
+#define CTE_SCHEMA_DECL_IXDATA_INT32(member) CTE_STRUCT_DECL_INT32(member)
+#define CTE_SCHEMA_DECL_IXDATA_INT64(member) CTE_STRUCT_DECL_INT64(member)
+#define CTE_SCHEMA_DECL_IXDATA_UINT8(member) CTE_STRUCT_DECL_UINT8(member)
+#define CTE_SCHEMA_DECL_IXDATA_UINT16(member) CTE_STRUCT_DECL_UINT16(member)
+#define CTE_SCHEMA_DECL_IXDATA_UINT32(member) CTE_STRUCT_DECL_UINT32(member)
+#define CTE_SCHEMA_DECL_IXDATA_UINT64(member) CTE_STRUCT_DECL_UINT64(member)
+#define CTE_SCHEMA_DECL_IXDATA_FLOAT32(member) CTE_STRUCT_DECL_FLOAT32(member)
+#define CTE_SCHEMA_DECL_IXDATA_FLOAT64(member) CTE_STRUCT_DECL_FLOAT64(member)
+#define CTE_SCHEMA_GET_IXDATA_INT8(p, end, value) CTE_STRUCT_READ_INT8(p, end, value, CTE_SCHEMA_FAIL);
+#define CTE_SCHEMA_GET_IXDATA_INT16(p, end, value) CTE_STRUCT_READ_INT16(p, end, value, CTE_SCHEMA_FAIL);
+#define CTE_SCHEMA_GET_IXDATA_INT32(p, end, value) CTE_STRUCT_READ_INT32(p, end, value, CTE_SCHEMA_FAIL);
+#define CTE_SCHEMA_GET_IXDATA_INT64(p, end, value) CTE_STRUCT_READ_INT64(p, end, value, CTE_SCHEMA_FAIL);
+#define CTE_SCHEMA_GET_IXDATA_UINT8(p, end, value) CTE_STRUCT_READ_UINT8(p, end, value, CTE_SCHEMA_FAIL);
+#define CTE_SCHEMA_GET_IXDATA_UINT16(p, end, value) CTE_STRUCT_READ_UINT16(p, end, value, CTE_SCHEMA_FAIL);
+#define CTE_SCHEMA_GET_IXDATA_UINT32(p, end, value) CTE_STRUCT_READ_UINT32(p, end, value, CTE_SCHEMA_FAIL);
+#define CTE_SCHEMA_GET_IXDATA_UINT64(p, end, value) CTE_STRUCT_READ_UINT64(p, end, value, CTE_SCHEMA_FAIL);
+#define CTE_SCHEMA_GET_IXDATA_FLOAT32(p, end, value) CTE_STRUCT_READ_FLOAT32(p, end, value, CTE_SCHEMA_FAIL);
+#define CTE_SCHEMA_GET_IXDATA_FLOAT64(p, end, value) CTE_STRUCT_READ_FLOAT64(p, end, value, CTE_SCHEMA_FAIL);
+
+#define CTE_SCHEMA_DECL_IXDATA_BOOLEAN(member) CTE_STRUCT_DECL_BOOL(member)
+#define CTE_SCHEMA_GET_IXDATA_BOOLEAN(p, end, value) CTE_STRUCT_READ_BOOL(p, end, value, CTE_SCHEMA_FAIL);
+
+#define CTE_SCHEMA_DECL_CMD(member) CTE_STRUCT_DECL_COMMAND(member)
+#define CTE_SCHEMA_GET_CMD(p, end, value) CTE_STRUCT_READ_COMMAND(p, end, value, CTE_SCHEMA_FAIL)
+/** @} */
+
+/**
+ * @name Generators
+ * @{
+ */
+#define CTE_SCHEMA_X_DECL(kind, member) CTE_SCHEMA_DECL_##kind(member)
+#define CTE_SCHEMA_X_GET(kind, member) CTE_SCHEMA_GET_##kind(p, end, out->member)
+
+/**
+ * @def CTE_SCHEMA_DECODER
+ * @brief Generates `bool <name>_try_decode(cte_decoder_t *, struct name *)`
+ * for an existing `struct name` described by the schema list `FIELDS`.
+ */
+#define CTE_SCHEMA_DECODER(name, FIELDS)                                                   \
+    static inline bool name##_try_decode(cte_decoder_t *dec, struct name *out)             \
+    {                                                                                      \
+        const uint8_t *p = dec->data + dec->position;                                      \
+        const uint8_t *end = dec->data + dec->size;                                        \
+        if (dec->position == 0)                                                            \
+        {                                                                                  \
+            CTE_SCHEMA_REQUIRE(p != end && *p == CTE_VERSION_BYTE)                         \
+            p++;                                                                           \
+        }                                                                                  \
+        FIELDS(CTE_SCHEMA_X_GET)                                                           \
+        dec->position = (size_t)(p - dec->data);                                           \
+        return true;                                                                       \
+    }
+
+/**
+ * @def CTE_SCHEMA_DEFINE
+ * @brief Declares `struct name` with one typed member per schema field and
+ * generates its decoder (see `CTE_SCHEMA_DECODER`).
+ */
+#define CTE_SCHEMA_DEFINE(name, FIELDS) \
+    struct name                         \
+    {                                   \
+        FIELDS(CTE_SCHEMA_X_DECL)       \
+    };                                  \
+    CTE_SCHEMA_DECODER(name, FIELDS)
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CTE_SCHEMA_H
@@ -0,0 +1,553 @@
+#ifndef CTE_STRUCT_H
+#define CTE_STRUCT_H
+
+#include "decoder.h"
+#include "encoder.h"
+#include <stdlea.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file cte_struct.h
+ * @brief Declarative mapping between C structs and CTE field sequences.
+ *
+ * A struct is described once as an X-macro list of `X(kind, member)` pairs,
+ * and the macros in this file generate a matched set of functions from it:
+ *
+ * @code
+ * #define TRANSFER_FIELDS(X)      \
+ *     X(PUBKEY_ED25519, recipient) \
+ *     X(ULEB128, amount)           \
+ *     X(BOOL, urgent)              \
+ *     X(COMMAND, memo)
+ *
+ * CTE_STRUCT_DEFINE(transfer, TRANSFER_FIELDS)
+ * @endcode
+ *
+ * `CTE_STRUCT_DEFINE` declares `struct transfer` and generates:
+ * - `size_t transfer_encoded_size(const struct transfer *s)`
+ * - `void transfer_encode(cte_encoder_t *enc, const struct transfer *s)`
+ * - `void transfer_decode(cte_decoder_t *dec, struct transfer *s)`
+ *
+ * `CTE_STRUCT_CODEC` generates only the functions, for an existing struct
+ * whose members have the types listed below.
+ *
+ * Encoding computes the total size once, reserves it with a single capacity
+ * check and then writes every field straight through. Decoding compares each
+ * header byte against a constant computed at compile time and checks bounds
+ * once per field; there is no peek/switch dispatch. Both abort via `lea_abort`
+ * on invalid values or unexpected input, like the rest of the library.
+ *
+ * Every kind's reader takes the failure action as a parameter, so
+ * cte_schema.h builds its non-aborting decoders from the same readers.
+ *
+ * | kind                 | member type                    | CTE field                        |
+ * |----------------------|--------------------------------|----------------------------------|
+ * | `INT8` ... `INT64`   | `int8_t` ... `int64_t`         | IxData fixed                     |
+ * | `UINT8` ... `UINT64` | `uint8_t` ... `uint64_t`       | IxData fixed                     |
+ * | `FLOAT32`, `FLOAT64` | `float`, `double`              | IxData fixed                     |
+ * | `ULEB128`, `SLEB128` | `uint64_t`, `int64_t`          | IxData varint                    |
+ * | `BOOL`               | `bool`                         | IxData constant                  |
+ * | `INDEX`              | `uint8_t` (0-15)               | IxData legacy index              |
+ * | `PUBKEY_<scheme>`    | `uint8_t[key size]`            | Public Key List with one key     |
+ * | `SIGNATURE_<scheme>` | `uint8_t[item size]`           | Signature List with one item     |
+ * | `COMMAND`            | `cte_bytes_t`                  | Command Data (short or extended) |
+ *
+ * `<scheme>` is one of `ED25519`, `SLH_128F`, `SLH_192F`, `SLH_256F`. A
+ * decoded `COMMAND` member points into the decoder's buffer.
+ */
+
+/**
+ * @struct cte_bytes
+ * @brief A borrowed byte range, used for Command Data payloads.
+ */
+typedef struct cte_bytes
+{
+    const uint8_t *data; /**< @param data Pointer to the first byte. */
+    size_t length;       /**< @param length Number of bytes. */
+} cte_bytes_t;
+
+/**
+ * @name Runtime helpers
+ * @brief Internal helpers used by the generated functions. The `read`
+ * helpers return NULL on success, or the message to fail with.
+ * @{
+ */
+
+static inline size_t cte_struct_uleb128_size(uint64_t value)
+{
+    size_t size = 1;
+    while (value >>= 7)
+    {
+        size++;
+    }
+    return size;
+}
+
+static inline size_t cte_struct_sleb128_size(int64_t value)
+{
+    size_t size = 1;
+    for (;;)
+    {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        if ((value == 0 && !(byte & 0x40)) || (value == -1 && (byte & 0x40)))
+        {
+            return size;
+        }
+        size++;
+    }
+}
+
+static inline uint8_t *cte_struct_put_uleb128(uint8_t *p, uint64_t value)
+{
+    do
+    {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        *p++ = value != 0 ? (byte | 0x80) : byte;
+    } while (value != 0);
+    return p;
+}
+
+static inline uint8_t *cte_struct_put_sleb128(uint8_t *p, int64_t value)
+{
+    for (;;)
+    {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        if ((value == 0 && !(byte & 0x40)) || (value == -1 && (byte & 0x40)))
+        {
+            *p++ = byte;
+            return p;
+        }
+        *p++ = byte | 0x80;
+    }
+}
+
+/* Same limits and error messages as `_decode_uleb128` in decoder.c. */
+static inline const char *cte_struct_read_uleb128(const uint8_t **pp, const uint8_t *end, uint64_t *out)
+{
+    const uint8_t *p = *pp;
+    uint64_t result = 0;
+    int shift = 0;
+    for (size_t i = 0; i < 10; ++i)
+    {
+        if (p == end)
+        {
+            return "Read past end of buffer";
+        }
+        uint8_t byte = *p++;
+        if (shift >= 64 || (shift == 63 && (byte & 0xFE) != 0))
+        {
+            return "ULEB128 overflow detected (value > 64 bits)";
+        }
+        result |= ((uint64_t)(byte & 0x7F)) << shift;
+        if (!(byte & 0x80))
+        {
+            *out = result;
+            *pp = p;
+            return NULL;
+        }
+        shift += 7;
+    }
+    return "Invalid ULEB128 encoding (unterminated sequence > 10 bytes)";
+}
+
+/* Same limits and error messages as `_decode_sleb128` in decoder.c. */
+static inline const char *cte_struct_read_sleb128(const uint8_t **pp, const uint8_t *end, int64_t *out)
+{
+    const uint8_t *p = *pp;
+    int64_t result = 0;
+    int shift = 0;
+    for (size_t i = 0; i < 10; ++i)
+    {
+        if (p == end)
+        {
+            return "Read past end of buffer";
+        }
+        uint8_t byte = *p++;
+        result |= ((int64_t)(byte & 0x7F)) << shift;
+        shift += 7;
+        if (!(byte & 0x80))
+        {
+            if ((shift < 64) && (byte & 0x40))
+            {
+                result |= -((int64_t)1 << shift);
+            }
+            *out = result;
+            *pp = p;
+            return NULL;
+        }
+        if (shift >= 64)
+        {
+            return "Invalid SLEB128 encoding (too many bytes/overflow)";
+        }
+    }
+    return "Invalid SLEB128 encoding (unterminated sequence > 10 bytes)";
+}
+
+static inline uint8_t cte_struct_index_header(uint8_t index)
+{
+    if (index > CTE_LEGACY_INDEX_MAX_VALUE)
+    {
+        lea_abort("Legacy index value out of range (0-15)");
+    }
+    return CTE_IXDATA_HEADER(index, CTE_IXDATA_SUBTYPE_LEGACY_INDEX);
+}
+
+static inline size_t cte_struct_command_size(cte_bytes_t value)
+{
+    return (value.length <= CTE_COMMAND_SHORT_MAX_LEN ? 1 : 2) + value.length;
+}
+
+static inline uint8_t *cte_struct_put_command(uint8_t *p, cte_bytes_t value)
+{
+    if (value.length <= CTE_COMMAND_SHORT_MAX_LEN)
+    {
+        *p++ = CTE_COMMAND_SHORT_HEADER(value.length);
+    }
+    else if (value.length <= CTE_COMMAND_EXTENDED_MAX_LEN)
+    {
+        *p++ = CTE_COMMAND_EXTENDED_HEADER1(value.length);
+        *p++ = CTE_COMMAND_EXTENDED_HEADER2(value.length);
+    }
+    else
+    {
+        lea_abort("Command data length out of range (0-1197)");
+    }
+    memcpy(p, value.data, value.length);
+    return p + value.length;
+}
+
+/* Same checks and error messages as `_parse_command_data_header` in decoder.c. */
+static inline const char *cte_struct_read_command(const uint8_t **pp, const uint8_t *end, cte_bytes_t *out)
+{
+    const uint8_t *p = *pp;
+    size_t length;
+    if (p == end)
+    {
+        return "Read past end of buffer";
+    }
+    uint8_t header1 = *p++;
+    if ((header1 & CTE_TAG_MASK) != CTE_TAG_COMMAND_DATA)
+    {
+        return "Unexpected field tag";
+    }
+    if ((header1 & CTE_COMMAND_FORMAT_FLAG_MASK) == CTE_COMMAND_FORMAT_SHORT)
+    {
+        length = header1 & CTE_COMMAND_SHORT_MAX_LEN;
+    }
+    else
+    {
+        if ((header1 & 0x03) != 0)
+        {
+            return "Non-zero padding bits in Command Data Extended Header Byte 1";
+        }
+        if (p == end)
+        {
+            return "Read past end of buffer";
+        }
+        length = ((size_t)((header1 >> 2) & 0x07) << 8) | *p++;
+        if (length < CTE_COMMAND_EXTENDED_MIN_LEN || length > CTE_COMMAND_EXTENDED_MAX_LEN)
+        {
+            return "Invalid extended command data length";
+        }
+    }
+    if ((size_t)(end - p) < length)
+    {
+        return "Read past end of buffer";
+    }
+    out->data = p;
+    out->length = length;
+    *pp = p + length;
+    return NULL;
+}
+/** @} */
+
+/**
+ * @name Field kinds
+ * @brief Per-kind member declaration, size, encode and decode macros.
+ *
+ * Each kind `K` provides `CTE_STRUCT_DECL_K(member)`, `CTE_STRUCT_SIZE_K(value)`,
+ * `CTE_STRUCT_PUT_K(p, value)` and `CTE_STRUCT_READ_K(p, end, value, FAIL)`, where
+ * `p` is the write or read cursor and `end` the end of the readable data. A
+ * reader runs the statement `FAIL(message)` on bad input and may have moved
+ * `p` by then; `value` is only complete once it succeeds.
+ * @{
+ */
+#define CTE_STRUCT_ABORT(message) lea_abort(message)
+
+#define CTE_STRUCT_NEED(p, end, needed, FAIL)       \
+    if ((size_t)((end) - (p)) < (size_t)(needed))  \
+    {                                              \
+        FAIL("Read past end of buffer");           \
+    }
+
+#define CTE_STRUCT_EXPECT(header, expected, FAIL) \
+    if ((header) != (expected))                    \
+    {                                              \
+        FAIL("Unexpected field header");           \
+    }
+
+#define CTE_STRUCT_READ_WITH(call, FAIL)    \
+    {                                      \
+        const char *cte_error_ = (call);   \
+        if (cte_error_)                    \
+        {                                  \
+            FAIL(cte_error_);              \
+        }                                  \
+    }
+#define CTE_STRUCT_PUT_FIXED(p, type_code, value)                                  \
+    do                                                                             \
+    {                                                                              \
+        *(p)++ = CTE_IXDATA_HEADER((type_code), CTE_IXDATA_SUBTYPE_FIXED);         \
+        memcpy((p), &(value), sizeof(value));                                      \
+        (p) += sizeof(value);                                                      \
+    } while (0)
+
+#define CTE_STRUCT_READ_FIXED(p, end, type_code, value, FAIL)                                  \
+    do                                                                                        \
+    {                                                                                         \
+        CTE_STRUCT_NEED((p), (end), 1 + sizeof(value), FAIL)                                  \
+        CTE_STRUCT_EXPECT(*(p)++, CTE_IXDATA_HEADER((type_code), CTE_IXDATA_SUBTYPE_FIXED), FAIL) \
+        memcpy(&(value), (p), sizeof(value));                                                 \
+        (p) += sizeof(value);                                                                 \
+    } while (0)
+
+#define CTE_STRUCT_PUT_LIST(p, tag, type_code, value)                  \
+    do                                                                 \
+    {                                                                  \
+        *(p)++ = CTE_LIST_HEADER((tag), 1, (type_code));               \
+        memcpy((p), (value), sizeof(value));                           \
+        (p) += sizeof(value);                                          \
+    } while (0)
+
+#define CTE_STRUCT_READ_LIST(p, end, tag, type_code, value, FAIL)                           \
+    do                                                                                     \
+    {                                                                                      \
+        CTE_STRUCT_NEED((p), (end), 1 + sizeof(value), FAIL)                               \
+        CTE_STRUCT_EXPECT(*(p)++, CTE_LIST_HEADER((tag), 1, (type_code)), FAIL)            \
+        memcpy((value), (p), sizeof(value));                                               \
+        (p) += sizeof(value);                                                              \
+    } while (0)
+
+#define CTE_STRUCT_DECL_INT8(member) int8_t member;
+#define CTE_STRUCT_SIZE_INT8(value) 2
+#define CTE_STRUCT_PUT_INT8(p, value) CTE_STRUCT_PUT_FIXED(p, CTE_IXDATA_FIXED_TYPE_INT8, value)
+#define CTE_STRUCT_READ_INT8(p, end, value, FAIL) CTE_STRUCT_READ_FIXED(p, end, CTE_IXDATA_FIXED_TYPE_INT8, value, FAIL)
+
+#define CTE_STRUCT_DECL_INT16(member) int16_t member;
+#define CTE_STRUCT_SIZE_INT16(value) 3
+#define CTE_STRUCT_PUT_INT16(p, value) CTE_STRUCT_PUT_FIXED(p, CTE_IXDATA_FIXED_TYPE_INT16, value)
+#define CTE_STRUCT_READ_INT16(p, end, value, FAIL) CTE_STRUCT_READ_FIXED(p, end, CTE_IXDATA_FIXED_TYPE_INT16, value, FAIL)
+
+#define CTE_STRUCT_DECL_INT32(member) int32_t member;
+#define CTE_STRUCT_SIZE_INT32(value) 5
+#define CTE_STRUCT_PUT_INT32(p, value) CTE_STRUCT_PUT_FIXED(p, CTE_IXDATA_FIXED_TYPE_INT32, value)
+#define CTE_STRUCT_READ_INT32(p, end, value, FAIL) CTE_STRUCT_READ_FIXED(p, end, CTE_IXDATA_FIXED_TYPE_INT32, value, FAIL)
+
+#define CTE_STRUCT_DECL_INT64(member) int64_t member;
+#define CTE_STRUCT_SIZE_INT64(value) 9
+#define CTE_STRUCT_PUT_INT64(p, value) CTE_STRUCT_PUT_FIXED(p, CTE_IXDATA_FIXED_TYPE_INT64, value)
+#define CTE_STRUCT_READ_INT64(p, end, value, FAIL) CTE_STRUCT_READ_FIXED(p, end, CTE_IXDATA_FIXED_TYPE_INT64, value, FAIL)
+
+#define CTE_STRUCT_DECL_UINT8(member) uint8_t member;
+#define CTE_STRUCT_SIZE_UINT8(value) 2
+#define CTE_STRUCT_PUT_UINT8(p, value) CTE_STRUCT_PUT_FIXED(p, CTE_IXDATA_FIXED_TYPE_UINT8, value)
+#define CTE_STRUCT_READ_UINT8(p, end, value, FAIL) CTE_STRUCT_READ_FIXED(p, end, CTE_IXDATA_FIXED_TYPE_UINT8, value, FAIL)
+
+#define CTE_STRUCT_DECL_UINT16(member) uint16_t member;
+#define CTE_STRUCT_SIZE_UINT16(value) 3
+#define CTE_STRUCT_PUT_UINT16(p, value) CTE_STRUCT_PUT_FIXED(p, CTE_IXDATA_FIXED_TYPE_UINT16, value)
+#define CTE_STRUCT_READ_UINT16(p, end, value, FAIL) CTE_STRUCT_READ_FIXED(p, end, CTE_IXDATA_FIXED_TYPE_UINT16, value, FAIL)
+
+#define CTE_STRUCT_DECL_UINT32(member) uint32_t member;
+#define CTE_STRUCT_SIZE_UINT32(value) 5
+#define CTE_STRUCT_PUT_UINT32(p, value) CTE_STRUCT_PUT_FIXED(p, CTE_IXDATA_FIXED_TYPE_UINT32, value)
+#define CTE_STRUCT_READ_UINT32(p, end, value, FAIL) CTE_STRUCT_READ_FIXED(p, end, CTE_IXDATA_FIXED_TYPE_UINT32, value, FAIL)
+
+#define CTE_STRUCT_DECL_UINT64(member) uint64_t member;
+#define CTE_STRUCT_SIZE_UINT64(value) 9
+#define CTE_STRUCT_PUT_UINT64(p, value) CTE_STRUCT_PUT_FIXED(p, CTE_IXDATA_FIXED_TYPE_UINT64, value)
+#define CTE_STRUCT_READ_UINT64(p, end, value, FAIL) CTE_STRUCT_READ_FIXED(p, end, CTE_IXDATA_FIXED_TYPE_UINT64, value, FAIL)
+
+#define CTE_STRUCT_DECL_FLOAT32(member) float member;
+#define CTE_STRUCT_SIZE_FLOAT32(value) 5
+#define CTE_STRUCT_PUT_FLOAT32(p, value) CTE_STRUCT_PUT_FIXED(p, CTE_IXDATA_FIXED_TYPE_FLOAT32, value)
+#define CTE_STRUCT_READ_FLOAT32(p, end, value, FAIL) CTE_STRUCT_READ_FIXED(p, end, CTE_IXDATA_FIXED_TYPE_FLOAT32, value, FAIL)
+
+#define CTE_STRUCT_DECL_FLOAT64(member) double member;
+#define CTE_STRUCT_SIZE_FLOAT64(value) 9
+#define CTE_STRUCT_PUT_FLOAT64(p, value) CTE_STRUCT_PUT_FIXED(p, CTE_IXDATA_FIXED_TYPE_FLOAT64, value)
+#define CTE_STRUCT_READ_FLOAT64(p, end, value, FAIL) CTE_STRUCT_READ_FIXED(p, end, CTE_IXDATA_FIXED_TYPE_FLOAT64, value, FAIL)
+
+#define CTE_STRUCT_DECL_ULEB128(member) uint64_t member;
+#define CTE_STRUCT_SIZE_ULEB128(value) (1 + cte_struct_uleb128_size(value))
+#define CTE_STRUCT_PUT_ULEB128(p, value)                                                          \
+    do                                                                                            \
+    {                                                                                             \
+        *(p)++ = CTE_IXDATA_HEADER(CTE_IXDATA_VARINT_ENC_ULEB128, CTE_IXDATA_SUBTYPE_VARINT);     \
+        (p) = cte_struct_put_uleb128((p), (value));                                               \
+    } while (0)
+#define CTE_STRUCT_READ_ULEB128(p, end, value, FAIL)                                                               \
+    do                                                                                                            \
+    {                                                                                                             \
+        CTE_STRUCT_NEED((p), (end), 1, FAIL)                                                                      \
+        CTE_STRUCT_EXPECT(*(p)++, CTE_IXDATA_HEADER(CTE_IXDATA_VARINT_ENC_ULEB128, CTE_IXDATA_SUBTYPE_VARINT), FAIL)   \
+        CTE_STRUCT_READ_WITH(cte_struct_read_uleb128(&(p), (end), &(value)), FAIL)                                \
+    } while (0)
+
+#define CTE_STRUCT_DECL_SLEB128(member) int64_t member;
+#define CTE_STRUCT_SIZE_SLEB128(value) (1 + cte_struct_sleb128_size(value))
+#define CTE_STRUCT_PUT_SLEB128(p, value)                                                          \
+    do                                                                                            \
+    {                                                                                             \
+        *(p)++ = CTE_IXDATA_HEADER(CTE_IXDATA_VARINT_ENC_SLEB128, CTE_IXDATA_SUBTYPE_VARINT);     \
+        (p) = cte_struct_put_sleb128((p), (value));                                               \
+    } while (0)
+#define CTE_STRUCT_READ_SLEB128(p, end, value, FAIL)                                                               \
+    do                                                                                                            \
+    {                                                                                                             \
+        CTE_STRUCT_NEED((p), (end), 1, FAIL)                                                                      \
+        CTE_STRUCT_EXPECT(*(p)++, CTE_IXDATA_HEADER(CTE_IXDATA_VARINT_ENC_SLEB128, CTE_IXDATA_SUBTYPE_VARINT), FAIL)   \
+        CTE_STRUCT_READ_WITH(cte_struct_read_sleb128(&(p), (end), &(value)), FAIL)                                \
+    } while (0)
+
+#define CTE_STRUCT_DECL_BOOL(member) bool member;
+#define CTE_STRUCT_SIZE_BOOL(value) 1
+#define CTE_STRUCT_PUT_BOOL(p, value) \
+    (*(p)++ = CTE_IXDATA_HEADER((value) ? CTE_IXDATA_CONST_VAL_TRUE : CTE_IXDATA_CONST_VAL_FALSE, CTE_IXDATA_SUBTYPE_CONSTANT))
+/* FALSE and TRUE differ only in bit 2, so one masked compare accepts both. */
+#define CTE_STRUCT_READ_BOOL(p, end, value, FAIL)                                                       \
+    do                                                                                                  \
+    {                                                                                                   \
+        CTE_STRUCT_NEED((p), (end), 1, FAIL)                                                            \
+        CTE_STRUCT_EXPECT(*(p) & ~0x04, CTE_IXDATA_HEADER(CTE_IXDATA_CONST_VAL_FALSE, CTE_IXDATA_SUBTYPE_CONSTANT), FAIL) \
+        (value) = (*(p)++ & 0x04) != 0;                                                                 \
+    } while (0)
+
+#define CTE_STRUCT_DECL_INDEX(member) uint8_t member;
+#define CTE_STRUCT_SIZE_INDEX(value) 1
+#define CTE_STRUCT_PUT_INDEX(p, value) (*(p)++ = cte_struct_index_header(value))
+#define CTE_STRUCT_READ_INDEX(p, end, value, FAIL)                                                      \
+    do                                                                                                  \
+    {                                                                                                   \
+        CTE_STRUCT_NEED((p), (end), 1, FAIL)                                                            \
+        CTE_STRUCT_EXPECT(*(p) & (CTE_TAG_MASK | CTE_IXDATA_SUBTYPE_MASK),                              \
+                          CTE_TAG_IXDATA_FIELD | CTE_IXDATA_SUBTYPE_LEGACY_INDEX, FAIL)                 \
+        (value) = (*(p)++ >> 2) & 0x0F;                                                                 \
+    } while (0)
+
+#define CTE_STRUCT_DECL_COMMAND(member) cte_bytes_t member;
+#define CTE_STRUCT_SIZE_COMMAND(value) cte_struct_command_size(value)
+#define CTE_STRUCT_PUT_COMMAND(p, value) ((p) = cte_struct_put_command((p), (value)))
+#define CTE_STRUCT_READ_COMMAND(p, end, value, FAIL) CTE_STRUCT_READ_WITH(cte_struct_read_command(&(p), (end), &(value)), FAIL)
+
+#define CTE_STRUCT_DECL_PUBKEY_ED25519(member) uint8_t member[CTE_PUBKEY_SIZE_ED25519];
+#define CTE_STRUCT_SIZE_PUBKEY_ED25519(value) (1 + CTE_PUBKEY_SIZE_ED25519)
+#define CTE_STRUCT_PUT_PUBKEY_ED25519(p, value) CTE_STRUCT_PUT_LIST(p, CTE_TAG_PUBLIC_KEY_LIST, CTE_CRYPTO_TYPE_ED25519, value)
+#define CTE_STRUCT_READ_PUBKEY_ED25519(p, end, value, FAIL) CTE_STRUCT_READ_LIST(p, end, CTE_TAG_PUBLIC_KEY_LIST, CTE_CRYPTO_TYPE_ED25519, value, FAIL)
+
+#define CTE_STRUCT_DECL_PUBKEY_SLH_128F(member) uint8_t member[CTE_PUBKEY_SIZE_SLH_128F];
+#define CTE_STRUCT_SIZE_PUBKEY_SLH_128F(value) (1 + CTE_PUBKEY_SIZE_SLH_128F)
+#define CTE_STRUCT_PUT_PUBKEY_SLH_128F(p, value) CTE_STRUCT_PUT_LIST(p, CTE_TAG_PUBLIC_KEY_LIST, CTE_CRYPTO_TYPE_SLH_DSA_128F, value)
+#define CTE_STRUCT_READ_PUBKEY_SLH_128F(p, end, value, FAIL) CTE_STRUCT_READ_LIST(p, end, CTE_TAG_PUBLIC_KEY_LIST, CTE_CRYPTO_TYPE_SLH_DSA_128F, value, FAIL)
+
+#define CTE_STRUCT_DECL_PUBKEY_SLH_192F(member) uint8_t member[CTE_PUBKEY_SIZE_SLH_192F];
+#define CTE_STRUCT_SIZE_PUBKEY_SLH_192F(value) (1 + CTE_PUBKEY_SIZE_SLH_192F)
+#define CTE_STRUCT_PUT_PUBKEY_SLH_192F(p, value) CTE_STRUCT_PUT_LIST(p, CTE_TAG_PUBLIC_KEY_LIST, CTE_CRYPTO_TYPE_SLH_DSA_192F, value)
+#define CTE_STRUCT_READ_PUBKEY_SLH_192F(p, end, value, FAIL) CTE_STRUCT_READ_LIST(p, end, CTE_TAG_PUBLIC_KEY_LIST, CTE_CRYPTO_TYPE_SLH_DSA_192F, value, FAIL)
+
+#define CTE_STRUCT_DECL_PUBKEY_SLH_256F(member) uint8_t member[CTE_PUBKEY_SIZE_SLH_256F];
+#define CTE_STRUCT_SIZE_PUBKEY_SLH_256F(value) (1 + CTE_PUBKEY_SIZE_SLH_256F)
+#define CTE_STRUCT_PUT_PUBKEY_SLH_256F(p, value) CTE_STRUCT_PUT_LIST(p, CTE_TAG_PUBLIC_KEY_LIST, CTE_CRYPTO_TYPE_SLH_DSA_256F, value)
+#define CTE_STRUCT_READ_PUBKEY_SLH_256F(p, end, value, FAIL) CTE_STRUCT_READ_LIST(p, end, CTE_TAG_PUBLIC_KEY_LIST, CTE_CRYPTO_TYPE_SLH_DSA_256F, value, FAIL)
+
+#define CTE_STRUCT_DECL_SIGNATURE_ED25519(member) uint8_t member[CTE_SIGNATURE_SIZE_ED25519];
+#define CTE_STRUCT_SIZE_SIGNATURE_ED25519(value) (1 + CTE_SIGNATURE_SIZE_ED25519)
+#define CTE_STRUCT_PUT_SIGNATURE_ED25519(p, value) CTE_STRUCT_PUT_LIST(p, CTE_TAG_SIGNATURE_LIST, CTE_CRYPTO_TYPE_ED25519, value)
+#define CTE_STRUCT_READ_SIGNATURE_ED25519(p, end, value, FAIL) CTE_STRUCT_READ_LIST(p, end, CTE_TAG_SIGNATURE_LIST, CTE_CRYPTO_TYPE_ED25519, value, FAIL)
+
+#define CTE_STRUCT_DECL_SIGNATURE_SLH_128F(member) uint8_t member[CTE_SIGNATURE_HASH_SIZE_PQC];
+#define CTE_STRUCT_SIZE_SIGNATURE_SLH_128F(value) (1 + CTE_SIGNATURE_HASH_SIZE_PQC)
+#define CTE_STRUCT_PUT_SIGNATURE_SLH_128F(p, value) CTE_STRUCT_PUT_LIST(p, CTE_TAG_SIGNATURE_LIST, CTE_CRYPTO_TYPE_SLH_DSA_128F, value)
+#define CTE_STRUCT_READ_SIGNATURE_SLH_128F(p, end, value, FAIL) CTE_STRUCT_READ_LIST(p, end, CTE_TAG_SIGNATURE_LIST, CTE_CRYPTO_TYPE_SLH_DSA_128F, value, FAIL)
+
+#define CTE_STRUCT_DECL_SIGNATURE_SLH_192F(member) uint8_t member[CTE_SIGNATURE_HASH_SIZE_PQC];
+#define CTE_STRUCT_SIZE_SIGNATURE_SLH_192F(value) (1 + CTE_SIGNATURE_HASH_SIZE_PQC)
+#define CTE_STRUCT_PUT_SIGNATURE_SLH_192F(p, value) CTE_STRUCT_PUT_LIST(p, CTE_TAG_SIGNATURE_LIST, CTE_CRYPTO_TYPE_SLH_DSA_192F, value)
+#define CTE_STRUCT_READ_SIGNATURE_SLH_192F(p, end, value, FAIL) CTE_STRUCT_READ_LIST(p, end, CTE_TAG_SIGNATURE_LIST, CTE_CRYPTO_TYPE_SLH_DSA_192F, value, FAIL)
+
+#define CTE_STRUCT_DECL_SIGNATURE_SLH_256F(member) uint8_t member[CTE_SIGNATURE_HASH_SIZE_PQC];
+#define CTE_STRUCT_SIZE_SIGNATURE_SLH_256F(value) (1 + CTE_SIGNATURE_HASH_SIZE_PQC)
+#define CTE_STRUCT_PUT_SIGNATURE_SLH_256F(p, value) CTE_STRUCT_PUT_LIST(p, CTE_TAG_SIGNATURE_LIST, CTE_CRYPTO_TYPE_SLH_DSA_256F, value)
+#define CTE_STRUCT_READ_SIGNATURE_SLH_256F(p, end, value, FAIL) CTE_STRUCT_READ_LIST(p, end, CTE_TAG_SIGNATURE_LIST, CTE_CRYPTO_TYPE_SLH_DSA_256F, value, FAIL)
+/** @} */
+
+/**
+ * @name Generators
+ * @{
+ */
+#define CTE_STRUCT_X_DECL(kind, member) CTE_STRUCT_DECL_##kind(member)
+#define CTE_STRUCT_X_SIZE(kind, member) +CTE_STRUCT_SIZE_##kind(s->member)
+#define CTE_STRUCT_X_PUT(kind, member) CTE_STRUCT_PUT_##kind(p, s->member);
+#define CTE_STRUCT_X_GET(kind, member) CTE_STRUCT_READ_##kind(p, end, s->member, CTE_STRUCT_ABORT);
+
+/**
+ * @def CTE_STRUCT_CODEC
+ * @brief Generates `<name>_encoded_size`, `<name>_encode` and `<name>_decode`
+ * for an existing `struct name` described by the X-macro list `FIELDS`.
+ */
+#define CTE_STRUCT_CODEC(name, FIELDS)                                                     \
+    static inline size_t name##_encoded_size(const struct name *s)                         \
+    {                                                                                      \
+        (void)s;                                                                           \
+        return 0 FIELDS(CTE_STRUCT_X_SIZE);                                                \
+    }                                                                                      \
+                                                                                           \
+    static inline void name##_encode(cte_encoder_t *enc, const struct name *s)             \
+    {                                                                                      \
+        uint8_t *p = (uint8_t *)cte_encoder_reserve_raw(enc, name##_encoded_size(s));      \
+        FIELDS(CTE_STRUCT_X_PUT)                                                           \
+        (void)p;                                                                           \
+    }                                                                                      \
+                                                                                           \
+    static inline void name##_decode(cte_decoder_t *dec, struct name *s)                   \
+    {                                                                                      \
+        if (dec->position == 0)                                                            \
+        {                                                                                  \
+            CTE_STRUCT_NEED(dec->data, dec->data + dec->size, 1, CTE_STRUCT_ABORT)         \
+            if (dec->data[0] != CTE_VERSION_BYTE)                                          \
+            {                                                                              \
+                lea_abort("Invalid version byte");                                         \
+            }                                                                              \
+            dec->position = 1;                                                             \
+        }                                                                                  \
+        const uint8_t *p = dec->data + dec->position;                                      \
+        const uint8_t *end = dec->data + dec->size;                                        \
+        FIELDS(CTE_STRUCT_X_GET)                                                           \
+        (void)end;                                                                         \
+        dec->position = (size_t)(p - dec->data);                                           \
+    }
+
+/**
+ * @def CTE_STRUCT_DEFINE
+ * @brief Declares `struct name` with one member per entry of `FIELDS` and
+ * generates its codec functions (see `CTE_STRUCT_CODEC`).
+ */
+#define CTE_STRUCT_DEFINE(name, FIELDS) \
+    struct name                         \
+    {                                   \
+        FIELDS(CTE_STRUCT_X_DECL)       \
+    };                                  \
+    CTE_STRUCT_CODEC(name, FIELDS)
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CTE_STRUCT_H
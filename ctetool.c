@@ -2,12 +2,50 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdarg.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <stdatomic.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+#endif
 #include "encoder.h"
 #include "decoder.h"
+#include "hex_codec.h"
+#include "base58_codec.h"
+#include "base64_codec.h"
+#include "json_transcoder.h"
+#include "number_format.h"
+#include "container.h"
+#include "transaction_log.h"
+#include "field_index.h"
 
 #define DEFAULT_BUFFER_SIZE 4096
 #define MAX_BUFFER_SIZE 16777216 // 16 MB
+#define BATCH_LINES 16384         // Spec lines encoded per round in 'batch'
+#define MAX_FRAME_SIZE (2 + CTE_MAX_TRANSACTION_SIZE) // ULEB128 length (2 bytes) plus transaction
+#define OUT_BUFFER_SIZE (1 << 20)   // Bytes buffered before 'read' writes to stdout
+#define VERIFY_CHUNK 256            // Transactions a 'verify' worker claims at a time
+#define VERIFY_SPLITS 16            // Container ranges per 'verify' worker, for load balancing
+#define DEFAULT_SYNC_INTERVAL 1024  // Records per sync block written by 'pack'
+#define MAX_LOG_PRODUCERS 1024    // Largest producer thread count for 'log'
+#define MAX_INGEST_DEPTH 4096       // Largest io_uring buffer count for 'verify -q'
+#define INGEST_SLOT_SIZE ((CTE_MAX_TRANSACTION_SIZE + 64) & ~63) // One file plus a byte to detect oversize
+#define SERVE_MAX_MESSAGE 65536     // Largest 'serve' request or reply payload
+#define SERVE_FIELD_ROOM (CTE_COMMAND_EXTENDED_MAX_LEN + 3) // Largest single encoded field
+#define MAX_BASE64_LINE_SIZE ((CTE_MAX_TRANSACTION_SIZE + 2) / 3 * 4 + 1) // Base64 transaction plus newline
 
 /**
  * @brief Prints the command-line usage instructions for the tool.
@@ -17,14 +55,83 @@ void print_usage() {
     printf("Commands:\n");
     printf("  write   Create a CTE file from a sequence of fields.\n");
     printf("  read    Read a CTE file and print its contents.\n");
+    printf("  batch   Encode one transaction per input line into a prefix-framed stream.\n");
+    printf("  verify  Validate every transaction of an archive, container or directory.\n");
+    printf("  pack    Convert a prefix-framed stream into an indexed container file.\n");
+    printf("  log     Append a prefix-framed stream to a durable transaction log.\n");
+    printf("  index   Query fields through an archive's persisted field index.\n");
+    printf("  serve   Answer encode, decode and validate requests on a Unix socket.\n");
     printf("  help    Show this help message.\n\n");
     printf("Options for 'write' and 'read':\n");
-    printf("  -b <size>   Use a buffer of the specified size in bytes (max %dMB).\n\n", MAX_BUFFER_SIZE / (1024 * 1024));
+    printf("  -b <size>   Use a buffer of the specified size in bytes (max %dMB).\n", MAX_BUFFER_SIZE / (1024 * 1024));
+    printf("              'read' maps regular files and only buffers pipes.\n\n");
     printf("Options for 'write':\n");
-    printf("  -o <file>   Write to the specified file instead of stdout.\n\n");
+    printf("  -o <file>   Write to the specified file instead of stdout.\n");
+    printf("  -e base64   Write the transaction as Base64 text instead of binary.\n\n");
     printf("Options for 'read':\n");
-    printf("  -i <file>   Read from the specified file instead of stdin.\n\n");
-    printf("Field Formats for 'write':\n");
+    printf("  -i <file>   Read from the specified file instead of stdin.\n");
+    printf("  -e base64   The input is Base64 text; trailing whitespace is ignored.\n");
+    printf("  -f <fmt>    Output format:\n");
+    printf("                text     labelled fields (default)\n");
+    printf("                json     one JSON line per transaction\n");
+    printf("                compact  one line of 'batch' field specs per transaction\n");
+    printf("                tsv      one row per field: transaction, field, offset, type, value\n");
+    printf("  -j <n>      Render JSON with n worker threads (default: online CPUs).\n");
+    printf("  -s <mode>   Decode a stream of back-to-back transactions. <mode> is the framing:\n");
+    printf("                prefix  each transaction is preceded by its ULEB128 length\n");
+    printf("                walk    transactions are split at version bytes between fields\n");
+    printf("              Container files (see 'pack') are recognised without -s.\n\n");
+    printf("Options for 'batch':\n");
+    printf("  -i <file>   Read the spec from the specified file instead of stdin.\n");
+    printf("  -o <file>   Write to the specified file instead of stdout.\n");
+    printf("  -j <n>      Encode with n worker threads (default: online CPUs).\n");
+    printf("  -e base64   Write one Base64 transaction per line instead of a framed stream.\n");
+    printf("  -f <fmt>    Input format: spec (default) or json, as written by 'read -f json'.\n");
+    printf("  Each spec line holds the whitespace-separated fields of one transaction;\n");
+    printf("  empty lines and lines starting with '#' are skipped. Read the output\n");
+    printf("  back with 'read -s prefix'.\n\n");
+    printf("Options for 'verify':\n");
+    printf("  -i <file>   Verify the prefix-framed archive or container in <file>\n");
+    printf("              instead of stdin.\n");
+    printf("  -d <dir>    Verify every .cte file in <dir>, one transaction per file.\n");
+    printf("  -j <n>      Verify with n worker threads (default: online CPUs).\n");
+    printf("  -q <depth>  With -d, read files through io_uring using <depth> buffers,\n");
+    printf("              feeding the workers through a bounded queue, and report\n");
+    printf("              per-stage throughput and queue depths.\n");
+    printf("  Every failure is reported with its position and reason; the exit\n");
+    printf("  status is 1 if any transaction failed.\n\n");
+    printf("Options for 'pack':\n");
+    printf("  -i <file>   Read the prefix-framed stream from <file> instead of stdin.\n");
+    printf("  -o <file>   Write the container to <file> instead of stdout.\n");
+    printf("  -k <n>      Write a sync marker every n records (default: %d).\n", DEFAULT_SYNC_INTERVAL);
+    printf("  -c <mode>   Record checksums: crc32c (default) or none.\n\n");
+    printf("Options for 'log':\n");
+    printf("  -d <dir>    Append to the log in <dir>, creating or recovering it (required).\n");
+    printf("  -i <file>   Read the prefix-framed stream from <file> instead of stdin.\n");
+    printf("  -j <n>      Append from n producer threads (default: 1).\n");
+    printf("  -a <ack>    When producers wait for durability: end (default), once after\n");
+    printf("              their last append, or each, after every append.\n");
+    printf("  -w <us>     Write a batch at the latest this long after its first append\n");
+    printf("              (default: 1000).\n");
+    printf("  -m <MiB>    Start a new segment file at this size (default: 64).\n");
+    printf("  -c <mode>   Record checksums: crc32c (default) or none.\n");
+    printf("  Reports throughput and how many transactions each sync covered.\n\n");
+    printf("Options for 'index':\n");
+    printf("  -i <file>   The prefix-framed archive or container (required). Its field\n");
+    printf("              index <file>%s is built if missing or stale.\n", CTE_FIELD_INDEX_SUFFIX);
+    printf("  -t <type>   Print every field of a 'write' field type, e.g. cmd.\n");
+    printf("  -f <n>:<k>  Print field k of transaction n, both from 0.\n");
+    printf("  Fields are printed as rows: transaction, field, offset, type and the\n");
+    printf("  value bytes in hex. Without -t or -f only the index is checked.\n\n");
+    printf("Options for 'serve':\n");
+    printf("  -s <path>   Listen on the Unix socket <path> (required).\n");
+    printf("  -j <n>      Answer with n worker threads (default: online CPUs).\n");
+    printf("  Connections are multiplexed, so idle clients do not hold a thread.\n");
+    printf("  A request is a ULEB128 length followed by that many bytes: a type byte\n");
+    printf("  ('E' field specs, 'T' text, 'C' compact, 'J' JSON, 'V' validate) and\n");
+    printf("  its payload. Each reply is a ULEB128 length, a status byte (0 = ok,\n");
+    printf("  1 = error) and the result or error message.\n\n");
+    printf("Field Formats for 'write' and 'batch':\n");
     printf("  Type:Value                                Examples:\n");
     printf("  ----------------------------------------------------------------\n");
     printf("  uint8:<val>      (val: 0-255 or 0x00-0xFF)  uint8:255, uint8:0xFF\n");
@@ -42,8 +149,11 @@ void print_usage() {
     printf("  bool:<true|false>                           bool:true\n");
     printf("  index:<0-15>                                index:5\n");
     printf("  cmd:<hex_string>                            cmd:AABBCCDD\n");
+    printf("  cmd:base64:<string>                         cmd:qrvM3Q==\n");
     printf("  pk-list-[type]:<hex_string>                 pk-list-ed25519:112233FF\n");
+    printf("  pk-list-[type]:base58:<key>[,<key>...]      pk-list-ed25519:base58:1111...\n");
     printf("  sig-list-[type]:<hex_string>                sig-list-slh128f:AABBCCEE\n");
+    printf("  sig-list-[type]:base58:<item>[,<item>...]   sig-list-ed25519:base58:5xyz...\n");
     printf("    [type] can be: ed25519, slh128f, slh192f, slh256f\n");
 }
 
@@ -59,13 +169,255 @@ size_t hex_string_to_bytes(const char *hex_str, uint8_t *byte_array, size_t max_
     if (len % 2 != 0) return 0; // Invalid hex string
     size_t byte_len = len / 2;
     if (byte_len > max_bytes) return 0; // Too long
+    if (!cte_hex_decode(hex_str, len, byte_array)) return 0; // Invalid digit
 
-    for (size_t i = 0; i < byte_len; i++) {
-        sscanf(hex_str + 2 * i, "%2hhx", &byte_array[i]);
-    }
     return byte_len;
 }
 
+/**
+ * @brief Maps a list scheme name to its crypto type code.
+ * @param name One of "ed25519", "slh128f", "slh192f" or "slh256f".
+ * @return The `CTE_CRYPTO_TYPE_*` code, or -1 if the name is unknown.
+ */
+int crypto_type_from_name(const char *name) {
+    if (strcmp(name, "ed25519") == 0) return CTE_CRYPTO_TYPE_ED25519;
+    if (strcmp(name, "slh128f") == 0) return CTE_CRYPTO_TYPE_SLH_DSA_128F;
+    if (strcmp(name, "slh192f") == 0) return CTE_CRYPTO_TYPE_SLH_DSA_192F;
+    if (strcmp(name, "slh256f") == 0) return CTE_CRYPTO_TYPE_SLH_DSA_256F;
+    return -1;
+}
+
+/**
+ * @brief Formats a field error message.
+ * @param error Receives the message.
+ * @param error_size The size of `error`.
+ * @param format The printf format of the message.
+ * @return false, so callers can `return field_error(...)`.
+ */
+bool field_error(char *error, size_t error_size, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(error, error_size, format, args);
+    va_end(args);
+    return false;
+}
+
+/**
+ * @brief Encodes a `pk-list-<type>` or `sig-list-<type>` value into `enc`.
+ * @param enc The encoder to append to.
+ * @param type The full field type, used in error messages.
+ * @param scheme The scheme name following the list prefix.
+ * @param value The concatenated items as a hex string.
+ * @param signatures `true` for a signature list, `false` for a public key list.
+ * @param error Receives the error message on failure.
+ * @param error_size The size of `error`.
+ * @return true on success.
+ */
+bool encode_list_field(cte_encoder_t *enc, const char *type, const char *scheme, const char *value, bool signatures,
+                       char *error, size_t error_size) {
+    int type_code = crypto_type_from_name(scheme);
+    if (type_code < 0) {
+        return field_error(error, error_size, "Unknown list type '%s'.", type);
+    }
+
+    uint8_t buffer[CTE_LIST_MAX_LEN * CTE_SIGNATURE_SIZE_ED25519];
+    size_t item_size = signatures ? get_signature_item_size((uint8_t)type_code) : get_public_key_size((uint8_t)type_code);
+    size_t len = 0;
+    if (strncmp(value, "base58:", 7) == 0) {
+        // Comma-separated Base58 items, each exactly item_size bytes.
+        const char *item = value + 7;
+        for (;;) {
+            size_t item_len = strcspn(item, ",");
+            if (len / item_size >= CTE_LIST_MAX_LEN || !cte_base58_decode(item, item_len, buffer + len, item_size)) {
+                return field_error(error, error_size, "Invalid Base58 item for %s: %.*s", type, (int)item_len, item);
+            }
+            len += item_size;
+            if (item[item_len] == '\0') break;
+            item += item_len + 1;
+        }
+    } else {
+        len = hex_string_to_bytes(value, buffer, sizeof(buffer));
+    }
+    if (len == 0 || len % item_size != 0 || len / item_size > CTE_LIST_MAX_LEN) {
+        return field_error(error, error_size, "Invalid hex string for %s: expected 1-%d items of %zu bytes.", type,
+                           CTE_LIST_MAX_LEN, item_size);
+    }
+
+    uint8_t count = (uint8_t)(len / item_size);
+    void *ptr = signatures ? cte_encoder_begin_signature_list(enc, count, (uint8_t)type_code)
+                           : cte_encoder_begin_public_key_list(enc, count, (uint8_t)type_code);
+    memcpy(ptr, buffer, len);
+    return true;
+}
+
+/**
+ * @brief Encodes one `type:value` token into `enc` without exiting.
+ *
+ * The value is fully validated before anything is written, so a failed
+ * field leaves the encoder unchanged.
+ *
+ * @param enc The encoder to append to; it needs room for one more field.
+ * @param arg The token; it is modified in place.
+ * @param error Receives the error message on failure.
+ * @param error_size The size of `error`.
+ * @return true on success.
+ */
+bool parse_field(cte_encoder_t *enc, char *arg, char *error, size_t error_size) {
+    char *colon = strchr(arg, ':');
+    if (!colon) {
+        return field_error(error, error_size, "Invalid field format '%s'. Expected 'type:value'.", arg);
+    }
+    *colon = '\0'; // Split the string
+    const char *type = arg;
+    const char *value = colon + 1;
+    char *endptr;
+
+    errno = 0;
+
+    if (strcmp(type, "uint8") == 0) {
+        unsigned long val = strtoul(value, &endptr, 0);
+        if (*endptr != '\0' || errno != 0 || val > UINT8_MAX) {
+            return field_error(error, error_size, "Invalid value for uint8: %s", value);
+        }
+        cte_encoder_write_ixdata_uint8(enc, (uint8_t)val);
+    } else if (strcmp(type, "uint16") == 0) {
+        unsigned long val = strtoul(value, &endptr, 0);
+        if (*endptr != '\0' || errno != 0 || val > UINT16_MAX) {
+            return field_error(error, error_size, "Invalid value for uint16: %s", value);
+        }
+        cte_encoder_write_ixdata_uint16(enc, (uint16_t)val);
+    } else if (strcmp(type, "uint32") == 0) {
+        unsigned long val = strtoul(value, &endptr, 0);
+        if (*endptr != '\0' || errno != 0 || val > UINT32_MAX) {
+            return field_error(error, error_size, "Invalid value for uint32: %s", value);
+        }
+        cte_encoder_write_ixdata_uint32(enc, (uint32_t)val);
+    } else if (strcmp(type, "uint64") == 0) {
+        unsigned long long val = strtoull(value, &endptr, 0);
+        if (*endptr != '\0' || errno != 0) {
+            return field_error(error, error_size, "Invalid value for uint64: %s", value);
+        }
+        cte_encoder_write_ixdata_uint64(enc, val);
+    } else if (strcmp(type, "int8") == 0) {
+        long val = strtol(value, &endptr, 0);
+        if (*endptr != '\0' || errno != 0 || val < INT8_MIN || val > INT8_MAX) {
+            return field_error(error, error_size, "Invalid value for int8: %s", value);
+        }
+        cte_encoder_write_ixdata_int8(enc, (int8_t)val);
+    } else if (strcmp(type, "int16") == 0) {
+        long val = strtol(value, &endptr, 0);
+        if (*endptr != '\0' || errno != 0 || val < INT16_MIN || val > INT16_MAX) {
+            return field_error(error, error_size, "Invalid value for int16: %s", value);
+        }
+        cte_encoder_write_ixdata_int16(enc, (int16_t)val);
+    } else if (strcmp(type, "int32") == 0) {
+        long val = strtol(value, &endptr, 0);
+        if (*endptr != '\0' || errno != 0 || val < INT32_MIN || val > INT32_MAX) {
+            return field_error(error, error_size, "Invalid value for int32: %s", value);
+        }
+        cte_encoder_write_ixdata_int32(enc, (int32_t)val);
+    } else if (strcmp(type, "int64") == 0) {
+        long long val = strtoll(value, &endptr, 0);
+        if (*endptr != '\0' || errno != 0) {
+            return field_error(error, error_size, "Invalid value for int64: %s", value);
+        }
+        cte_encoder_write_ixdata_int64(enc, val);
+    } else if (strcmp(type, "uleb") == 0) {
+        unsigned long long val = strtoull(value, &endptr, 0);
+        if (*endptr != '\0' || errno != 0) {
+            return field_error(error, error_size, "Invalid value for uleb: %s", value);
+        }
+        cte_encoder_write_ixdata_uleb128(enc, val);
+    } else if (strcmp(type, "sleb") == 0) {
+        long long val = strtoll(value, &endptr, 0);
+        if (*endptr != '\0' || errno != 0) {
+            return field_error(error, error_size, "Invalid value for sleb: %s", value);
+        }
+        cte_encoder_write_ixdata_sleb128(enc, val);
+    } else if (strcmp(type, "float") == 0) {
+        float val = strtof(value, &endptr);
+        if (*endptr != '\0' || errno != 0) {
+            return field_error(error, error_size, "Invalid value for float: %s", value);
+        }
+        cte_encoder_write_ixdata_float32(enc, val);
+    } else if (strcmp(type, "double") == 0) {
+        double val = strtod(value, &endptr);
+        if (*endptr != '\0' || errno != 0) {
+            return field_error(error, error_size, "Invalid value for double: %s", value);
+        }
+        cte_encoder_write_ixdata_float64(enc, val);
+    } else if (strcmp(type, "bool") == 0) {
+        if (strcmp(value, "true") != 0 && strcmp(value, "false") != 0) {
+            return field_error(error, error_size, "Invalid value for bool: %s", value);
+        }
+        cte_encoder_write_ixdata_boolean(enc, strcmp(value, "true") == 0);
+    } else if (strcmp(type, "index") == 0) {
+        unsigned long val = strtoul(value, &endptr, 0);
+        if (*endptr != '\0' || errno != 0 || val > 15) {
+            return field_error(error, error_size, "Invalid value for index: %s", value);
+        }
+        cte_encoder_write_ixdata_index_reference(enc, (uint8_t)val);
+    } else if (strcmp(type, "cmd") == 0 && strncmp(value, "base64:", 7) == 0) {
+        uint8_t buffer[DEFAULT_BUFFER_SIZE];
+        size_t text_len = strlen(value + 7);
+        size_t len = 0;
+        if (text_len / 4 * 3 > sizeof(buffer) || !cte_base64_decode(value + 7, text_len, buffer, &len)) {
+            return field_error(error, error_size, "Invalid Base64 string for cmd: %s", value + 7);
+        }
+        if (len > CTE_COMMAND_EXTENDED_MAX_LEN) {
+            return field_error(error, error_size, "cmd payload of %zu bytes exceeds %d", len, CTE_COMMAND_EXTENDED_MAX_LEN);
+        }
+        void *ptr = cte_encoder_begin_command_data(enc, len);
+        memcpy(ptr, buffer, len);
+    } else if (strcmp(type, "cmd") == 0) {
+        uint8_t buffer[DEFAULT_BUFFER_SIZE];
+        size_t len = hex_string_to_bytes(value, buffer, DEFAULT_BUFFER_SIZE);
+        if (len == 0 && strlen(value) > 0) {
+            return field_error(error, error_size, "Invalid hex string for cmd: %s", value);
+        }
+        if (len > CTE_COMMAND_EXTENDED_MAX_LEN) {
+            return field_error(error, error_size, "cmd payload of %zu bytes exceeds %d", len, CTE_COMMAND_EXTENDED_MAX_LEN);
+        }
+        void *ptr = cte_encoder_begin_command_data(enc, len);
+        memcpy(ptr, buffer, len);
+    } else if (strncmp(type, "pk-list-", 8) == 0) {
+        return encode_list_field(enc, type, type + 8, value, false, error, error_size);
+    } else if (strncmp(type, "sig-list-", 9) == 0) {
+        return encode_list_field(enc, type, type + 9, value, true, error, error_size);
+    } else {
+        return field_error(error, error_size, "Unknown field type '%s'.", type);
+    }
+    return true;
+}
+
+/**
+ * @brief Encodes one `type:value` token into `enc`.
+ * @param enc The encoder to append to.
+ * @param arg The token; it is modified in place.
+ * @note This function exits on error.
+ */
+void encode_field(cte_encoder_t *enc, char *arg) {
+    char error[256];
+    if (!parse_field(enc, arg, error, sizeof(error))) {
+        fprintf(stderr, "Error: %s\n", error);
+        exit(1);
+    }
+}
+
+/**
+ * @brief Parses the argument of an `-e` option.
+ * @param name The encoding name; only "base64" is supported.
+ * @return `true` for Base64.
+ * @note This function exits on error.
+ */
+bool parse_encoding(const char *name) {
+    if (strcmp(name, "base64") != 0) {
+        fprintf(stderr, "Error: Unknown encoding '%s'.\n", name);
+        exit(1);
+    }
+    return true;
+}
+
 /**
  * @brief Handles the 'write' command for the CTE tool.
  * @param argc The argument count from main.
@@ -75,6 +427,7 @@ size_t hex_string_to_bytes(const char *hex_str, uint8_t *byte_array, size_t max_
 void do_write(int argc, char *argv[]) {
     const char *output_file = NULL;
     size_t buffer_size = DEFAULT_BUFFER_SIZE;
+    bool base64 = false;
     int first_field_index = 2;
 
     // Parse options
@@ -97,6 +450,13 @@ void do_write(int argc, char *argv[]) {
                 exit(1);
             }
             first_field_index += 2;
+        } else if (strcmp(argv[first_field_index], "-e") == 0) {
+            if (first_field_index + 1 >= argc) {
+                fprintf(stderr, "Error: -e option requires an encoding.\n");
+                exit(1);
+            }
+            base64 = parse_encoding(argv[first_field_index + 1]);
+            first_field_index += 2;
         } else {
             fprintf(stderr, "Error: Unknown option '%s'.\n", argv[first_field_index]);
             exit(1);
@@ -116,135 +476,25 @@ void do_write(int argc, char *argv[]) {
             fprintf(stderr, "Error: Out of memory.\n");
             exit(1);
         }
-        char *colon = strchr(arg, ':');
-        if (!colon) {
-            fprintf(stderr, "Error: Invalid field format '%s'. Expected 'type:value'.\n", arg);
-            free(arg);
-            exit(1);
-        }
-        *colon = '\0'; // Split the string
-        const char *type = arg;
-        const char *value = colon + 1;
-        char *endptr;
-
-        errno = 0;
-
-        if (strcmp(type, "uint8") == 0) {
-            unsigned long val = strtoul(value, &endptr, 0);
-            if (*endptr != '\0' || errno != 0 || val > UINT8_MAX) {
-                fprintf(stderr, "Error: Invalid value for uint8: %s\n", value);
-                exit(1);
-            }
-            cte_encoder_write_ixdata_uint8(enc, (uint8_t)val);
-        } else if (strcmp(type, "uint16") == 0) {
-            unsigned long val = strtoul(value, &endptr, 0);
-            if (*endptr != '\0' || errno != 0 || val > UINT16_MAX) {
-                fprintf(stderr, "Error: Invalid value for uint16: %s\n", value);
-                exit(1);
-            }
-            cte_encoder_write_ixdata_uint16(enc, (uint16_t)val);
-        } else if (strcmp(type, "uint32") == 0) {
-            unsigned long val = strtoul(value, &endptr, 0);
-            if (*endptr != '\0' || errno != 0 || val > UINT32_MAX) {
-                fprintf(stderr, "Error: Invalid value for uint32: %s\n", value);
-                exit(1);
-            }
-            cte_encoder_write_ixdata_uint32(enc, (uint32_t)val);
-        } else if (strcmp(type, "uint64") == 0) {
-            unsigned long long val = strtoull(value, &endptr, 0);
-            if (*endptr != '\0' || errno != 0) {
-                fprintf(stderr, "Error: Invalid value for uint64: %s\n", value);
-                exit(1);
-            }
-            cte_encoder_write_ixdata_uint64(enc, val);
-        } else if (strcmp(type, "int8") == 0) {
-            long val = strtol(value, &endptr, 0);
-            if (*endptr != '\0' || errno != 0 || val < INT8_MIN || val > INT8_MAX) {
-                fprintf(stderr, "Error: Invalid value for int8: %s\n", value);
-                exit(1);
-            }
-            cte_encoder_write_ixdata_int8(enc, (int8_t)val);
-        } else if (strcmp(type, "int16") == 0) {
-            long val = strtol(value, &endptr, 0);
-            if (*endptr != '\0' || errno != 0 || val < INT16_MIN || val > INT16_MAX) {
-                fprintf(stderr, "Error: Invalid value for int16: %s\n", value);
-                exit(1);
-            }
-            cte_encoder_write_ixdata_int16(enc, (int16_t)val);
-        } else if (strcmp(type, "int32") == 0) {
-            long val = strtol(value, &endptr, 0);
-            if (*endptr != '\0' || errno != 0 || val < INT32_MIN || val > INT32_MAX) {
-                fprintf(stderr, "Error: Invalid value for int32: %s\n", value);
-                exit(1);
-            }
-            cte_encoder_write_ixdata_int32(enc, (int32_t)val);
-        } else if (strcmp(type, "int64") == 0) {
-            long long val = strtoll(value, &endptr, 0);
-            if (*endptr != '\0' || errno != 0) {
-                fprintf(stderr, "Error: Invalid value for int64: %s\n", value);
-                exit(1);
-            }
-            cte_encoder_write_ixdata_int64(enc, val);
-        } else if (strcmp(type, "uleb") == 0) {
-            unsigned long long val = strtoull(value, &endptr, 0);
-            if (*endptr != '\0' || errno != 0) {
-                fprintf(stderr, "Error: Invalid value for uleb: %s\n", value);
-                exit(1);
-            }
-            cte_encoder_write_ixdata_uleb128(enc, val);
-        } else if (strcmp(type, "sleb") == 0) {
-            long long val = strtoll(value, &endptr, 0);
-            if (*endptr != '\0' || errno != 0) {
-                fprintf(stderr, "Error: Invalid value for sleb: %s\n", value);
-                exit(1);
-            }
-            cte_encoder_write_ixdata_sleb128(enc, val);
-        } else if (strcmp(type, "float") == 0) {
-            float val = strtof(value, &endptr);
-            if (*endptr != '\0' || errno != 0) {
-                fprintf(stderr, "Error: Invalid value for float: %s\n", value);
-                exit(1);
-            }
-            cte_encoder_write_ixdata_float32(enc, val);
-        } else if (strcmp(type, "double") == 0) {
-            double val = strtod(value, &endptr);
-            if (*endptr != '\0' || errno != 0) {
-                fprintf(stderr, "Error: Invalid value for double: %s\n", value);
-                exit(1);
-            }
-            cte_encoder_write_ixdata_float64(enc, val);
-        } else if (strcmp(type, "bool") == 0) {
-            if (strcmp(value, "true") != 0 && strcmp(value, "false") != 0) {
-                fprintf(stderr, "Error: Invalid value for bool: %s\n", value);
-                exit(1);
-            }
-            cte_encoder_write_ixdata_boolean(enc, strcmp(value, "true") == 0);
-        } else if (strcmp(type, "index") == 0) {
-            unsigned long val = strtoul(value, &endptr, 0);
-            if (*endptr != '\0' || errno != 0 || val > 15) {
-                fprintf(stderr, "Error: Invalid value for index: %s\n", value);
-                exit(1);
-            }
-            cte_encoder_write_ixdata_index_reference(enc, (uint8_t)val);
-        } else if (strcmp(type, "cmd") == 0) {
-            uint8_t buffer[DEFAULT_BUFFER_SIZE];
-            size_t len = hex_string_to_bytes(value, buffer, DEFAULT_BUFFER_SIZE);
-            if (len == 0 && strlen(value) > 0) {
-                fprintf(stderr, "Error: Invalid hex string for cmd: %s\n", value);
-                exit(1);
-            }
-            void *ptr = cte_encoder_begin_command_data(enc, len);
-            memcpy(ptr, buffer, len);
-        } else {
-            fprintf(stderr, "Error: Unknown field type '%s'.\n", type);
-            free(arg);
-            exit(1);
-        }
+        encode_field(enc, arg);
         free(arg);
     }
 
     const uint8_t *data = cte_encoder_get_data(enc);
     size_t size = cte_encoder_get_size(enc);
+    char *text = NULL;
+    if (base64) {
+        size_t text_size = cte_base64_encoded_length(size);
+        text = malloc(text_size + 1);
+        if (!text) {
+            fprintf(stderr, "Error: Out of memory.\n");
+            exit(1);
+        }
+        cte_base64_encode(data, size, text);
+        text[text_size] = '\n';
+        data = (const uint8_t *)text;
+        size = text_size + 1;
+    }
 
     if (output_file) {
         FILE *fp = fopen(output_file, "wb");
@@ -258,47 +508,42 @@ void do_write(int argc, char *argv[]) {
     } else {
         fwrite(data, 1, size, stdout);
     }
+    free(text);
 }
 
 /**
- * @brief Handles the 'read' command for the CTE tool.
- * @param argc The argument count from main.
- * @param argv The argument vector from main.
- * @note This function exits on error.
+ * @brief Input bytes for 'read': a read-only mapping of a regular file, or a
+ * heap buffer filled from a pipe.
  */
-void do_read(int argc, char *argv[]) {
-    const char *input_file = NULL;
-    size_t buffer_size = DEFAULT_BUFFER_SIZE;
-    FILE *fp = stdin;
-    int first_arg_index = 2;
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    bool mapped;
+    cte_container_t container; /**< The container view, when the input is a container file. */
+} input_t;
 
-    while (first_arg_index < argc && argv[first_arg_index][0] == '-') {
-        if (strcmp(argv[first_arg_index], "-i") == 0) {
-            if (first_arg_index + 1 >= argc) {
-                fprintf(stderr, "Error: -i option requires a filename.\n");
-                exit(1);
-            }
-            input_file = argv[first_arg_index + 1];
-            fp = fopen(input_file, "rb");
-            if (!fp) {
-                perror("Error opening input file");
-                exit(1);
-            }
-            first_arg_index += 2;
-        } else if (strcmp(argv[first_arg_index], "-b") == 0) {
-            if (first_arg_index + 1 >= argc) {
-                fprintf(stderr, "Error: -b option requires a size.\n");
-                exit(1);
-            }
-            buffer_size = (size_t)strtoul(argv[first_arg_index + 1], NULL, 0);
-            if (buffer_size == 0 || buffer_size > MAX_BUFFER_SIZE) {
-                fprintf(stderr, "Error: Invalid buffer size. Must be > 0 and <= %d.\n", MAX_BUFFER_SIZE);
-                exit(1);
-            }
-            first_arg_index += 2;
-        } else {
-            fprintf(stderr, "Error: Unknown option '%s'.\n", argv[first_arg_index]);
-            exit(1);
+/**
+ * @brief Maps `fd` if it is a non-empty regular file, otherwise reads it into
+ * a buffer of at most `buffer_size` bytes.
+ * @param fd The open input descriptor.
+ * @param buffer_size The limit for non-mappable input.
+ * @param input Receives the bytes.
+ * @note This function exits on error.
+ */
+void open_input(int fd, size_t buffer_size, input_t *input) {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            // Hints only: failures (e.g. no huge pages for this filesystem) are harmless.
+            madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+            madvise(map, (size_t)st.st_size, MADV_HUGEPAGE);
+#endif
+            input->data = map;
+            input->size = (size_t)st.st_size;
+            input->mapped = true;
+            return;
         }
     }
 
@@ -307,129 +552,2836 @@ void do_read(int argc, char *argv[]) {
         fprintf(stderr, "Error: Failed to allocate buffer of size %zu.\n", buffer_size);
         exit(1);
     }
-    
+
     size_t total_read = 0;
-    size_t bytes_read;
+    ssize_t bytes_read;
 
-    while ((bytes_read = fread(buffer + total_read, 1, buffer_size - total_read, fp)) > 0) {
-        total_read += bytes_read;
-        if (total_read >= buffer_size && !feof(fp)) {
-            fprintf(stderr, "Error: Input data exceeds buffer size of %zu bytes.\n", buffer_size);
-            free(buffer);
-            exit(1);
+    while ((bytes_read = read(fd, buffer + total_read, buffer_size - total_read)) > 0) {
+        total_read += (size_t)bytes_read;
+        if (total_read == buffer_size) {
+            char probe;
+            if (read(fd, &probe, 1) > 0) {
+                fprintf(stderr, "Error: Input data exceeds buffer size of %zu bytes.\n", buffer_size);
+                free(buffer);
+                exit(1);
+            }
+            break;
         }
     }
+    if (bytes_read < 0) {
+        perror("Error reading input");
+        free(buffer);
+        exit(1);
+    }
 
-    if (input_file) {
-        fclose(fp);
+    input->data = buffer;
+    input->size = total_read;
+    input->mapped = false;
+}
+
+/**
+ * @brief Releases the mapping or buffer behind `input`.
+ * @param input The input to release.
+ */
+void close_input(input_t *input) {
+    if (input->mapped) {
+        munmap((void *)input->data, input->size);
+    } else {
+        free((void *)input->data);
     }
+}
 
-    if (total_read == 0) {
-        fprintf(stderr, "Error: No data read from input.\n");
-        free(buffer);
+/**
+ * @brief Replaces Base64 text input with the bytes it encodes.
+ * @param input The input; on return it holds the decoded bytes in a heap buffer.
+ * @note This function exits on error.
+ */
+void decode_base64_input(input_t *input) {
+    size_t length = input->size;
+    while (length > 0 && strchr(" \t\r\n", input->data[length - 1])) {
+        length--;
+    }
+    uint8_t *bytes = malloc(length / 4 * 3 + 1);
+    size_t size = 0;
+    if (!bytes) {
+        fprintf(stderr, "Error: Out of memory.\n");
+        exit(1);
+    }
+    if (!cte_base64_decode((const char *)input->data, length, bytes, &size)) {
+        fprintf(stderr, "Error: Input is not valid Base64.\n");
+        exit(1);
+    }
+    close_input(input);
+    input->data = bytes;
+    input->size = size;
+    input->mapped = false;
+}
+
+/**
+ * @brief How 'read' prints what it decodes.
+ */
+typedef enum {
+    FORMAT_TEXT,    /**< Labelled lines for people. */
+    FORMAT_JSON,    /**< One JSON line per transaction (see json_transcoder.h). */
+    FORMAT_COMPACT, /**< One line of 'batch' field specs per transaction. */
+    FORMAT_TSV,     /**< One tab-separated row per field, after a header row. */
+} format_t;
+
+/**
+ * @brief Output buffered in large blocks, so 'read' makes few write calls
+ * and never goes through printf's locale-aware formatting.
+ */
+typedef struct {
+    char data[OUT_BUFFER_SIZE];
+    size_t size;
+} out_buffer_t;
+
+/**
+ * @brief Writes the buffered output to stdout.
+ * @param out The buffer.
+ * @note This function exits on error.
+ */
+void out_flush(out_buffer_t *out) {
+    if (out->size > 0 && fwrite(out->data, 1, out->size, stdout) != out->size) {
+        perror("Error writing output");
         exit(1);
     }
+    out->size = 0;
+}
+
+/**
+ * @brief Returns room for `n` more bytes, flushing first if needed.
+ * @param out The buffer.
+ * @param n The number of bytes; at most OUT_BUFFER_SIZE.
+ * @return Where to write; advance `out->size` by the bytes written.
+ */
+char *out_reserve(out_buffer_t *out, size_t n) {
+    if (OUT_BUFFER_SIZE - out->size < n) {
+        out_flush(out);
+    }
+    return out->data + out->size;
+}
+
+/**
+ * @brief Appends `n` bytes.
+ * @param out The buffer.
+ * @param text The bytes.
+ * @param n The number of bytes; at most OUT_BUFFER_SIZE.
+ */
+void out_bytes(out_buffer_t *out, const char *text, size_t n) {
+    memcpy(out_reserve(out, n), text, n);
+    out->size += n;
+}
+
+/**
+ * @brief Appends a NUL-terminated string.
+ * @param out The buffer.
+ * @param text The string.
+ */
+void out_text(out_buffer_t *out, const char *text) {
+    out_bytes(out, text, strlen(text));
+}
+
+/**
+ * @brief Appends an unsigned decimal integer.
+ * @param out The buffer.
+ * @param value The value.
+ */
+void out_uint(out_buffer_t *out, uint64_t value) {
+    out->size += cte_format_uint64(value, out_reserve(out, CTE_NUMBER_MAX_LENGTH));
+}
+
+/**
+ * @brief Appends bytes as upper-case hex.
+ * @param out The buffer.
+ * @param data The bytes.
+ * @param size The number of bytes; at most CTE_MAX_TRANSACTION_SIZE.
+ */
+void out_hex(out_buffer_t *out, const uint8_t *data, size_t size) {
+    cte_hex_encode(data, size, out_reserve(out, 2 * size));
+    out->size += 2 * size;
+}
+
+/** @brief Text-mode label for each IxData CTE_PEEK_TYPE_*, starting at the Legacy Index. */
+static const char *const ixdata_labels[] = {
+    "IxData Legacy Index", "IxData Varint Zero", "IxData ULEB128", "IxData SLEB128", "IxData int8",
+    "IxData int16", "IxData int32", "IxData int64", "IxData uint8", "IxData uint16",
+    "IxData uint32", "IxData uint64", "IxData float32", "IxData float64", "IxData boolean",
+    "IxData boolean",
+};
+
+/**
+ * @brief Appends a field's value: hex for lists and Command Data, decimal
+ * for integers, shortest round-trip form for floats, true/false for booleans.
+ * @param out The buffer.
+ * @param field The field.
+ */
+void out_value(out_buffer_t *out, const cte_field_t *field) {
+    switch (field->type) {
+        case CTE_PEEK_TYPE_IXDATA_SLEB128:
+        case CTE_PEEK_TYPE_IXDATA_INT8:
+        case CTE_PEEK_TYPE_IXDATA_INT16:
+        case CTE_PEEK_TYPE_IXDATA_INT32:
+        case CTE_PEEK_TYPE_IXDATA_INT64:
+            out->size += cte_format_int64(field->value.i64, out_reserve(out, CTE_NUMBER_MAX_LENGTH));
+            break;
+        case CTE_PEEK_TYPE_IXDATA_FLOAT32:
+            out->size += cte_format_float(field->value.f32, out_reserve(out, CTE_NUMBER_MAX_LENGTH));
+            break;
+        case CTE_PEEK_TYPE_IXDATA_FLOAT64:
+            out->size += cte_format_double(field->value.f64, out_reserve(out, CTE_NUMBER_MAX_LENGTH));
+            break;
+        case CTE_PEEK_TYPE_IXDATA_CONST_FALSE:
+        case CTE_PEEK_TYPE_IXDATA_CONST_TRUE:
+            out_text(out, field->value.boolean ? "true" : "false");
+            break;
+        default:
+            if (field->type < CTE_PEEK_TYPE_IXDATA_LEGACY_INDEX || field->type >= CTE_PEEK_TYPE_CMD_SHORT) {
+                out_hex(out, field->data, field->length);
+            } else {
+                out_uint(out, field->value.u64);
+            }
+            break;
+    }
+}
 
-    cte_decoder_t *dec = cte_decoder_init(total_read);
-    uint8_t *load_ptr = cte_decoder_load(dec);
-    memcpy(load_ptr, buffer, total_read);
-    free(buffer);
+/**
+ * @brief Appends one field in `format` (text, compact or TSV).
+ * @param out The buffer.
+ * @param format The output format.
+ * @param transaction Zero-based transaction number, for TSV.
+ * @param index Zero-based field number within the transaction.
+ * @param field The field.
+ */
+void out_field(out_buffer_t *out, format_t format, size_t transaction, size_t index, const cte_field_t *field) {
+    int type = field->type;
+    if (format == FORMAT_COMPACT) {
+        if (index > 0) {
+            out_bytes(out, " ", 1);
+        }
+        out_text(out, cte_json_field_name(type));
+        out_bytes(out, ":", 1);
+        out_value(out, field);
+        return;
+    }
+    if (format == FORMAT_TSV) {
+        out_uint(out, transaction);
+        out_bytes(out, "\t", 1);
+        out_uint(out, index);
+        out_bytes(out, "\t", 1);
+        out_uint(out, field->offset);
+        out_bytes(out, "\t", 1);
+        out_text(out, cte_json_field_name(type));
+        out_bytes(out, "\t", 1);
+        out_value(out, field);
+        out_bytes(out, "\n", 1);
+        return;
+    }
 
-    printf("Reading from %s (%zu bytes).....\n", input_file ? input_file : "stdin", total_read);
-    printf("--------------------------------------\n");
+    out_text(out, "Type: ");
+    out_uint(out, (uint64_t)type);
+    out_text(out, ", ");
+    if (type <= CTE_PEEK_TYPE_SIG_LIST_SLH_256F) {
+        out_text(out, type <= CTE_PEEK_TYPE_PK_LIST_SLH_256F ? "Public Key List, Count: " : "Signature List, Count: ");
+        out_uint(out, field->count);
+        out_text(out, ", Data: ");
+        out_value(out, field);
+    } else if (type >= CTE_PEEK_TYPE_CMD_SHORT) {
+        out_text(out, "Command Data, Length: ");
+        out_uint(out, field->length);
+        out_text(out, ", Data: ");
+        out_value(out, field);
+    } else {
+        out_text(out, ixdata_labels[type - CTE_PEEK_TYPE_IXDATA_LEGACY_INDEX]);
+        if (type != CTE_PEEK_TYPE_IXDATA_VARINT_ZERO) {
+            out_text(out, ", Value: ");
+            out_value(out, field);
+        }
+    }
+    out_bytes(out, "\n", 1);
+}
 
-    while (dec->position < dec->size) {
-        int type = cte_decoder_peek_type(dec);
+/**
+ * @brief Decodes one transaction and appends its fields in `format`.
+ * @param out The buffer.
+ * @param format FORMAT_TEXT, FORMAT_COMPACT or FORMAT_TSV.
+ * @param transaction Zero-based transaction number, for TSV.
+ * @param data The transaction.
+ * @param size The size of the transaction.
+ * @note This function exits on error.
+ */
+void out_transaction(out_buffer_t *out, format_t format, size_t transaction, const uint8_t *data, size_t size) {
+    // Decode in place through a borrowed view.
+    cte_decoder_t dec = cte_decoder_view(data, size, 0);
+    cte_field_t field;
+    for (size_t index = 0;; index++) {
+        int type = cte_decoder_peek_type(&dec);
         if (type == CTE_PEEK_EOF) {
             break;
         }
+        if (type < 0) {
+            out_flush(out);
+            fprintf(stderr, "Error: Reserved or invalid field type 0x%02X at offset %zu.\n", data[dec.position],
+                    dec.position);
+            exit(1);
+        }
+        if (!cte_decoder_try_read_field(&dec, type, &field)) {
+            out_flush(out);
+            fprintf(stderr, "Error: Malformed or truncated %s field at offset %zu.\n", cte_json_field_name(type), dec.position);
+            exit(1);
+        }
+        out_field(out, format, transaction, index, &field);
+    }
+    if (format == FORMAT_COMPACT) {
+        out_bytes(out, "\n", 1);
+    }
+}
 
-        printf("Type: %d, ", type);
+/**
+ * @brief How 'read' splits its input into transactions.
+ */
+typedef enum {
+    FRAMING_NONE,   /**< The whole input is one transaction. */
+    FRAMING_PREFIX, /**< Each transaction is preceded by its ULEB128 length. */
+    FRAMING_WALK,   /**< Transactions follow each other directly. */
+    FRAMING_CONTAINER, /**< Records of a container file (see container.h). */
+} framing_t;
 
-        switch (type) {
-            case CTE_PEEK_TYPE_PK_LIST_ED25519:
-            case CTE_PEEK_TYPE_PK_LIST_SLH_128F:
-            case CTE_PEEK_TYPE_PK_LIST_SLH_192F:
-            case CTE_PEEK_TYPE_PK_LIST_SLH_256F:
-                {
-                    cte_decoder_read_public_key_list_data(dec);
-                    size_t count = cte_decoder_get_last_list_count(dec);
-                    printf("Public Key List, Count: %zu\n", count);
-                    break;
-                }
-            case CTE_PEEK_TYPE_SIG_LIST_ED25519:
-            case CTE_PEEK_TYPE_SIG_LIST_SLH_128F:
-            case CTE_PEEK_TYPE_SIG_LIST_SLH_192F:
-            case CTE_PEEK_TYPE_SIG_LIST_SLH_256F:
-                {
-                    cte_decoder_read_signature_list_data(dec);
-                    size_t count = cte_decoder_get_last_list_count(dec);
-                    printf("Signature List, Count: %zu\n", count);
-                    break;
-                }
-            case CTE_PEEK_TYPE_IXDATA_LEGACY_INDEX:
-                printf("IxData Legacy Index, Value: %u\n", cte_decoder_read_ixdata_index_reference(dec));
-                break;
-            case CTE_PEEK_TYPE_IXDATA_VARINT_ZERO:
-                cte_decoder_read_ixdata_varint_zero(dec);
-                printf("IxData Varint Zero\n");
-                break;
-            case CTE_PEEK_TYPE_IXDATA_ULEB128:
-                printf("IxData ULEB128, Value: %llu\n", (unsigned long long)cte_decoder_read_ixdata_uleb128(dec));
-                break;
-            case CTE_PEEK_TYPE_IXDATA_SLEB128:
-                printf("IxData SLEB128, Value: %lld\n", (long long)cte_decoder_read_ixdata_sleb128(dec));
-                break;
-            case CTE_PEEK_TYPE_IXDATA_INT8:
-                printf("IxData int8, Value: %d\n", cte_decoder_read_ixdata_int8(dec));
-                break;
-            case CTE_PEEK_TYPE_IXDATA_INT16:
-                printf("IxData int16, Value: %d\n", cte_decoder_read_ixdata_int16(dec));
-                break;
-            case CTE_PEEK_TYPE_IXDATA_INT32:
-                printf("IxData int32, Value: %d\n", cte_decoder_read_ixdata_int32(dec));
-                break;
-            case CTE_PEEK_TYPE_IXDATA_INT64:
-                printf("IxData int64, Value: %lld\n", (long long)cte_decoder_read_ixdata_int64(dec));
-                break;
-            case CTE_PEEK_TYPE_IXDATA_UINT8:
-                printf("IxData uint8, Value: %u\n", cte_decoder_read_ixdata_uint8(dec));
-                break;
-            case CTE_PEEK_TYPE_IXDATA_UINT16:
-                printf("IxData uint16, Value: %u\n", cte_decoder_read_ixdata_uint16(dec));
-                break;
-            case CTE_PEEK_TYPE_IXDATA_UINT32:
-                printf("IxData uint32, Value: %u\n", cte_decoder_read_ixdata_uint32(dec));
-                break;
-            case CTE_PEEK_TYPE_IXDATA_UINT64:
-                printf("IxData uint64, Value: %llu\n", (unsigned long long)cte_decoder_read_ixdata_uint64(dec));
-                break;
-            case CTE_PEEK_TYPE_IXDATA_FLOAT32:
-                printf("IxData float32, Value: %f\n", cte_decoder_read_ixdata_float32(dec));
-                break;
-            case CTE_PEEK_TYPE_IXDATA_FLOAT64:
-                printf("IxData float64, Value: %f\n", cte_decoder_read_ixdata_float64(dec));
-                break;
-            case CTE_PEEK_TYPE_IXDATA_CONST_FALSE:
-            case CTE_PEEK_TYPE_IXDATA_CONST_TRUE:
-                printf("IxData boolean, Value: %s\n", cte_decoder_read_ixdata_boolean(dec) ? "true" : "false");
-                break;
-            case CTE_PEEK_TYPE_CMD_SHORT:
-            case CTE_PEEK_TYPE_CMD_EXTENDED:
-                {
-                    cte_decoder_read_command_data_payload(dec);
-                    size_t len = cte_decoder_get_last_command_payload_length(dec);
-                    printf("Command Data, Length: %zu\n", len);
-                    break;
-                }
+/**
+ * @brief Reads a ULEB128 frame length.
+ * @param data The input bytes.
+ * @param size The number of input bytes.
+ * @param offset The offset of the length; advanced past it.
+ * @param length Receives the decoded length.
+ * @return true on success, false if the length is truncated or too large.
+ */
+bool read_frame_length(const uint8_t *data, size_t size, size_t *offset, size_t *length) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64 && *offset < size; shift += 7) {
+        uint8_t byte = data[(*offset)++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *length = (size_t)value;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Finds the transaction at `*offset` and advances past it.
+ *
+ * In walk mode a transaction ends where the next one's version byte appears
+ * at a field boundary. The version byte is never a valid field header (it
+ * would be an extended Command Data header with non-zero padding), so the
+ * split is unambiguous. Container records are checked against their
+ * checksums.
+ *
+ * @param input The input bytes.
+ * @param framing FRAMING_PREFIX, FRAMING_WALK or FRAMING_CONTAINER.
+ * @param offset The offset of the next frame; advanced past it.
+ * @param start Receives the offset of the transaction's version byte.
+ * @param fields Receives the number of fields in the transaction.
+ * @return The size of the transaction in bytes.
+ * @note This function exits on error; malformed fields abort in the decoder.
+ */
+size_t next_transaction(const input_t *input, framing_t framing, size_t *offset, size_t *start, size_t *fields) {
+    size_t frame_offset = *offset;
+    size_t limit = input->size - *offset;
+    size_t after = 0;
+    if (framing == FRAMING_CONTAINER) {
+        uint64_t index = 0;
+        cte_container_record_t record;
+        after = *offset;
+        cte_container_status_t status = cte_container_next(&input->container, &after, &index, &record);
+        if (status != CTE_CONTAINER_OK) {
+            fprintf(stderr, "Error: %s record at offset %zu.\n",
+                    status == CTE_CONTAINER_CHECKSUM ? "Checksum mismatch in" : "Damaged", frame_offset);
+            exit(1);
+        }
+        *offset = (size_t)(record.data - input->data);
+        limit = record.size;
+    } else if (framing == FRAMING_PREFIX) {
+        if (!read_frame_length(input->data, input->size, offset, &limit) || limit == 0 ||
+            limit > CTE_MAX_TRANSACTION_SIZE || limit > input->size - *offset) {
+            fprintf(stderr, "Error: Invalid frame length at offset %zu.\n", frame_offset);
+            exit(1);
+        }
+    } else if (limit > CTE_MAX_TRANSACTION_SIZE) {
+        limit = CTE_MAX_TRANSACTION_SIZE;
+    }
+    if (input->data[*offset] != CTE_VERSION_BYTE) {
+        fprintf(stderr, "Error: Expected a version byte at offset %zu.\n", *offset);
+        exit(1);
+    }
+
+    cte_decoder_t dec = cte_decoder_view(input->data + *offset, limit, 0);
+    cte_field_t field;
+    *fields = 0;
+    for (;;) {
+        if (framing == FRAMING_WALK && dec.position > 0 && dec.position < dec.size &&
+            dec.data[dec.position] == CTE_VERSION_BYTE) {
+            break;
+        }
+        int type = cte_decoder_peek_type(&dec);
+        if (type == CTE_PEEK_EOF) {
+            break;
+        }
+        cte_decoder_read_field(&dec, type, &field);
+        (*fields)++;
+    }
+    if (framing == FRAMING_WALK && dec.position == CTE_MAX_TRANSACTION_SIZE &&
+        *offset + dec.position < input->size && input->data[*offset + dec.position] != CTE_VERSION_BYTE) {
+        fprintf(stderr, "Error: Transaction at offset %zu exceeds the maximum transaction size of %d bytes.\n",
+                *offset, CTE_MAX_TRANSACTION_SIZE);
+        exit(1);
+    }
+
+    *start = *offset;
+    *offset = framing == FRAMING_CONTAINER ? after : *offset + dec.position;
+    return dec.position;
+}
+
+/**
+ * @brief Returns the part of `input` that holds transactions.
+ * @param input The input bytes.
+ * @param framing How the input is split into transactions.
+ * @param begin Receives the offset of the first frame.
+ * @param end Receives the offset where the frames end.
+ */
+void transaction_range(const input_t *input, framing_t framing, size_t *begin, size_t *end) {
+    *begin = framing == FRAMING_CONTAINER ? CTE_CONTAINER_HEADER_SIZE : 0;
+    *end = framing == FRAMING_CONTAINER ? input->container.body_end : input->size;
+}
+
+/**
+ * @brief Decodes every transaction in `input` and prints it in `format`.
+ *
+ * Text mode prints a summary line per transaction plus totals and
+ * throughput. Compact and TSV print every field and send the totals to
+ * stderr, so stdout is the same on every run.
+ *
+ * @param input The input bytes.
+ * @param name The input name for the banner.
+ * @param framing FRAMING_PREFIX, FRAMING_WALK or FRAMING_CONTAINER.
+ * @param format FORMAT_TEXT, FORMAT_COMPACT or FORMAT_TSV.
+ * @note This function exits on error; malformed fields abort in the decoder.
+ */
+void decode_stream(const input_t *input, const char *name, framing_t framing, format_t format) {
+    static out_buffer_t out;
+    struct timespec started, finished;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+
+    if (format == FORMAT_TEXT) {
+        printf("Reading transactions from %s (%zu bytes, %s framing).....\n", name, input->size,
+               framing == FRAMING_PREFIX ? "prefix" : framing == FRAMING_WALK ? "walk" : "container");
+        printf("--------------------------------------\n");
+    } else if (format == FORMAT_TSV) {
+        out_text(&out, "transaction\tfield\toffset\ttype\tvalue\n");
+    }
+
+    size_t offset, end;
+    size_t count = 0;
+    size_t total_fields = 0;
+    transaction_range(input, framing, &offset, &end);
+    while (offset < end) {
+        size_t start, fields;
+        size_t size = next_transaction(input, framing, &offset, &start, &fields);
+        if (format == FORMAT_TEXT) {
+            out_text(&out, "Transaction ");
+            out_uint(&out, count);
+            out_text(&out, ": offset ");
+            out_uint(&out, start);
+            out_text(&out, ", ");
+            out_uint(&out, size);
+            out_text(&out, " bytes, ");
+            out_uint(&out, fields);
+            out_text(&out, " fields\n");
+        } else {
+            out_transaction(&out, format, count, input->data + start, size);
+        }
+        total_fields += fields;
+        count++;
+    }
+    out_flush(&out);
+
+    clock_gettime(CLOCK_MONOTONIC, &finished);
+    double seconds = (double)(finished.tv_sec - started.tv_sec) + (double)(finished.tv_nsec - started.tv_nsec) / 1e9;
+    if (seconds <= 0) {
+        seconds = 1e-9;
+    }
+
+    FILE *summary = format == FORMAT_TEXT ? stdout : stderr;
+    if (format == FORMAT_TEXT) {
+        printf("--------------------------------------\n");
+    }
+    fprintf(summary, "Decoded %zu transactions (%zu fields, %zu bytes) in %.3f s: %.0f tx/s, %.1f MB/s\n", count,
+            total_fields, input->size, seconds, count / seconds, input->size / seconds / 1e6);
+}
+
+/**
+ * @brief One JSON rendering worker: a contiguous block of transactions.
+ */
+typedef struct {
+    pthread_t thread;
+    const uint8_t *data;  /**< The input bytes. */
+    const size_t *starts; /**< Offset of each transaction in the block. */
+    const size_t *sizes;  /**< Size of each transaction in the block. */
+    size_t count;         /**< Number of transactions in the block. */
+    char *out;            /**< JSON lines, in transaction order. */
+    size_t out_capacity;  /**< Size of `out`. */
+    size_t out_size;      /**< Bytes used in `out`. */
+    bool failed;          /**< A transaction could not be rendered. */
+} json_worker_t;
+
+/**
+ * @brief Renders the worker's block of transactions as JSON lines.
+ * @param arg The `json_worker_t`.
+ * @return NULL.
+ */
+void *json_worker(void *arg) {
+    json_worker_t *worker = arg;
+    worker->out_size = 0;
+    worker->failed = false;
+    for (size_t i = 0; i < worker->count; i++) {
+        char *line = worker->out + worker->out_size;
+        size_t length = cte_json_from_cte(worker->data + worker->starts[i], worker->sizes[i], line,
+                                          worker->out_capacity - worker->out_size);
+        if (length == 0) {
+            worker->failed = true;
+            return NULL;
+        }
+        line[length] = '\n';
+        worker->out_size += length + 1;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Prints every transaction in `input` as one line of JSON.
+ *
+ * Transactions are split sequentially, then rendered in rounds of up to
+ * BATCH_LINES on `thread_count` workers, each taking a contiguous block.
+ * Output stays in input order. A summary goes to stderr so stdout is pure
+ * newline-delimited JSON.
+ *
+ * @param input The input bytes.
+ * @param framing How the input is split into transactions.
+ * @param thread_count The number of worker threads.
+ * @note This function exits on error.
+ */
+void render_json(const input_t *input, framing_t framing, long thread_count) {
+    struct timespec started, finished;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+
+    size_t *starts = malloc(BATCH_LINES * sizeof(size_t));
+    size_t *sizes = malloc(BATCH_LINES * sizeof(size_t));
+    json_worker_t *workers = calloc((size_t)thread_count, sizeof(json_worker_t));
+    if (!starts || !sizes || !workers) {
+        fprintf(stderr, "Error: Out of memory.\n");
+        exit(1);
+    }
+
+    size_t offset, end;
+    size_t total = 0;
+    transaction_range(input, framing, &offset, &end);
+    while (offset < end) {
+        size_t count = 0;
+        if (framing == FRAMING_NONE) {
+            starts[0] = 0;
+            sizes[0] = input->size;
+            offset = input->size;
+            count = 1;
+        }
+        for (; count < BATCH_LINES && offset < end; count++) {
+            size_t fields;
+            sizes[count] = next_transaction(input, framing, &offset, &starts[count], &fields);
+        }
+
+        for (long t = 0; t < thread_count; t++) {
+            json_worker_t *worker = &workers[t];
+            size_t first = count * (size_t)t / (size_t)thread_count;
+            size_t last = count * (size_t)(t + 1) / (size_t)thread_count;
+            size_t capacity = 1;
+            for (size_t i = first; i < last; i++) {
+                capacity += 16 * sizes[i] + 3; // CTE_JSON_MAX_LENGTH scaled to the transaction, plus newline
+            }
+            if (capacity > worker->out_capacity) {
+                free(worker->out);
+                worker->out = malloc(capacity);
+                worker->out_capacity = capacity;
+                if (!worker->out) {
+                    fprintf(stderr, "Error: Out of memory.\n");
+                    exit(1);
+                }
+            }
+            worker->data = input->data;
+            worker->starts = starts + first;
+            worker->sizes = sizes + first;
+            worker->count = last - first;
+            if (pthread_create(&worker->thread, NULL, json_worker, worker) != 0) {
+                fprintf(stderr, "Error: Failed to start worker thread.\n");
+                exit(1);
+            }
+        }
+        for (long t = 0; t < thread_count; t++) {
+            pthread_join(workers[t].thread, NULL);
+        }
+        for (long t = 0; t < thread_count; t++) {
+            if (workers[t].failed) {
+                fprintf(stderr, "Error: Malformed transaction in block starting at offset %zu.\n",
+                        workers[t].count ? workers[t].starts[0] : 0);
+                exit(1);
+            }
+            fwrite(workers[t].out, 1, workers[t].out_size, stdout);
+        }
+        total += count;
+    }
+    fflush(stdout);
+
+    clock_gettime(CLOCK_MONOTONIC, &finished);
+    double seconds = (double)(finished.tv_sec - started.tv_sec) + (double)(finished.tv_nsec - started.tv_nsec) / 1e9;
+    if (seconds <= 0) {
+        seconds = 1e-9;
+    }
+    fprintf(stderr, "Rendered %zu transactions (%zu bytes) in %.3f s: %.0f tx/s, %.1f MB/s\n", total, input->size,
+            seconds, total / seconds, input->size / seconds / 1e6);
+
+    for (long t = 0; t < thread_count; t++) {
+        free(workers[t].out);
+    }
+    free(workers);
+    free(starts);
+    free(sizes);
+}
+
+/**
+ * @brief Handles the 'read' command for the CTE tool.
+ * @param argc The argument count from main.
+ * @param argv The argument vector from main.
+ * @note This function exits on error.
+ */
+void do_read(int argc, char *argv[]) {
+    const char *input_file = NULL;
+    size_t buffer_size = DEFAULT_BUFFER_SIZE;
+    int fd = STDIN_FILENO;
+    framing_t framing = FRAMING_NONE;
+    bool base64 = false;
+    format_t format = FORMAT_TEXT;
+    long thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+    int first_arg_index = 2;
+
+    while (first_arg_index < argc && argv[first_arg_index][0] == '-') {
+        if (strcmp(argv[first_arg_index], "-i") == 0) {
+            if (first_arg_index + 1 >= argc) {
+                fprintf(stderr, "Error: -i option requires a filename.\n");
+                exit(1);
+            }
+            input_file = argv[first_arg_index + 1];
+            fd = open(input_file, O_RDONLY);
+            if (fd < 0) {
+                perror("Error opening input file");
+                exit(1);
+            }
+            first_arg_index += 2;
+        } else if (strcmp(argv[first_arg_index], "-b") == 0) {
+            if (first_arg_index + 1 >= argc) {
+                fprintf(stderr, "Error: -b option requires a size.\n");
+                exit(1);
+            }
+            buffer_size = (size_t)strtoul(argv[first_arg_index + 1], NULL, 0);
+            if (buffer_size == 0 || buffer_size > MAX_BUFFER_SIZE) {
+                fprintf(stderr, "Error: Invalid buffer size. Must be > 0 and <= %d.\n", MAX_BUFFER_SIZE);
+                exit(1);
+            }
+            first_arg_index += 2;
+        } else if (strcmp(argv[first_arg_index], "-s") == 0) {
+            if (first_arg_index + 1 >= argc) {
+                fprintf(stderr, "Error: -s option requires a framing mode.\n");
+                exit(1);
+            }
+            if (strcmp(argv[first_arg_index + 1], "prefix") == 0) {
+                framing = FRAMING_PREFIX;
+            } else if (strcmp(argv[first_arg_index + 1], "walk") == 0) {
+                framing = FRAMING_WALK;
+            } else {
+                fprintf(stderr, "Error: Unknown framing mode '%s'.\n", argv[first_arg_index + 1]);
+                exit(1);
+            }
+            first_arg_index += 2;
+        } else if (strcmp(argv[first_arg_index], "-e") == 0) {
+            if (first_arg_index + 1 >= argc) {
+                fprintf(stderr, "Error: -e option requires an encoding.\n");
+                exit(1);
+            }
+            base64 = parse_encoding(argv[first_arg_index + 1]);
+            first_arg_index += 2;
+        } else if (strcmp(argv[first_arg_index], "-f") == 0) {
+            if (first_arg_index + 1 >= argc) {
+                fprintf(stderr, "Error: -f option requires an output format.\n");
+                exit(1);
+            }
+            const char *name = argv[first_arg_index + 1];
+            if (strcmp(name, "text") == 0) {
+                format = FORMAT_TEXT;
+            } else if (strcmp(name, "json") == 0) {
+                format = FORMAT_JSON;
+            } else if (strcmp(name, "compact") == 0) {
+                format = FORMAT_COMPACT;
+            } else if (strcmp(name, "tsv") == 0) {
+                format = FORMAT_TSV;
+            } else {
+                fprintf(stderr, "Error: Unknown output format '%s'.\n", name);
+                exit(1);
+            }
+            first_arg_index += 2;
+        } else if (strcmp(argv[first_arg_index], "-j") == 0) {
+            if (first_arg_index + 1 >= argc) {
+                fprintf(stderr, "Error: -j option requires a thread count.\n");
+                exit(1);
+            }
+            thread_count = strtol(argv[first_arg_index + 1], NULL, 0);
+            if (thread_count < 1 || thread_count > 256) {
+                fprintf(stderr, "Error: Invalid thread count. Must be between 1 and 256.\n");
+                exit(1);
+            }
+            first_arg_index += 2;
+        } else {
+            fprintf(stderr, "Error: Unknown option '%s'.\n", argv[first_arg_index]);
+            exit(1);
+        }
+    }
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+
+    input_t input;
+    open_input(fd, buffer_size, &input);
+
+    if (input_file) {
+        close(fd); // a mapping stays valid after its descriptor is closed
+    }
+    if (base64) {
+        decode_base64_input(&input);
+    }
+
+    if (input.size == 0) {
+        fprintf(stderr, "Error: No data read from input.\n");
+        close_input(&input);
+        exit(1);
+    }
+    if (cte_container_open(&input.container, input.data, input.size)) {
+        framing = FRAMING_CONTAINER; // detected by its magic, whatever -s says
+    }
+    if (framing == FRAMING_NONE && input.size > CTE_MAX_TRANSACTION_SIZE) {
+        fprintf(stderr, "Error: Input of %zu bytes exceeds the maximum transaction size of %d bytes.\n",
+                input.size, CTE_MAX_TRANSACTION_SIZE);
+        close_input(&input);
+        exit(1);
+    }
+    if (format == FORMAT_JSON) {
+        render_json(&input, framing, framing == FRAMING_NONE ? 1 : thread_count);
+    } else if (framing != FRAMING_NONE) {
+        decode_stream(&input, input_file ? input_file : "stdin", framing, format);
+    } else if (format == FORMAT_TEXT) {
+        static out_buffer_t out;
+        printf("Reading from %s (%zu bytes).....\n", input_file ? input_file : "stdin", input.size);
+        printf("--------------------------------------\n");
+        out_transaction(&out, format, 0, input.data, input.size);
+        out_flush(&out);
+        printf("--------------------------------------\n");
+        printf("Successfully decoded all fields.\n");
+    } else {
+        static out_buffer_t out;
+        if (format == FORMAT_TSV) {
+            out_text(&out, "transaction\tfield\toffset\ttype\tvalue\n");
+        }
+        out_transaction(&out, format, 0, input.data, input.size);
+        out_flush(&out);
+    }
+    close_input(&input);
+}
+
+/**
+ * @brief One 'batch' worker: a reusable encoder and the framed output for a
+ * contiguous block of spec lines.
+ */
+typedef struct {
+    pthread_t thread;
+    cte_encoder_t *enc;
+    char **lines;       /**< First line of the block. */
+    size_t line_count;  /**< Number of lines in the block. */
+    uint8_t *out;       /**< Framed transactions, in line order. */
+    size_t out_size;    /**< Bytes used in `out`. */
+    size_t transactions;
+    bool base64;        /**< Write Base64 lines instead of length-prefixed frames. */
+    bool json;          /**< Lines are JSON transactions instead of field specs. */
+    size_t first_line;  /**< Zero-based input line number of `lines[0]`, for errors. */
+    size_t error_line;  /**< One-based line number of the first bad line, or 0. */
+    char error[320];    /**< Why `error_line` was rejected. */
+} batch_worker_t;
+
+/**
+ * @brief Encodes the worker's block of lines into prefix-framed transactions.
+ *
+ * Stops at the first bad line and records it in `error_line` and `error`;
+ * the main thread reports it once every worker has been joined.
+ *
+ * @param arg The `batch_worker_t`.
+ * @return NULL.
+ */
+void *batch_worker(void *arg) {
+    batch_worker_t *worker = arg;
+    worker->out_size = 0;
+    worker->transactions = 0;
+    worker->error_line = 0;
+    for (size_t i = 0; i < worker->line_count; i++) {
+        char *line = worker->lines[i];
+        size_t line_number = worker->first_line + i + 1;
+        if (worker->json) {
+            size_t skip = strspn(line, " \t\r\n");
+            if (line[skip] == '\0' || line[skip] == '#') {
+                continue;
+            }
+            // No JSON field encodes to more bytes than its text, so the encoder holds any line within the limit.
+            size_t length = strlen(line);
+            if (length > CTE_JSON_MAX_LENGTH) {
+                worker->error_line = line_number;
+                snprintf(worker->error, sizeof(worker->error), "Line exceeds %d characters", CTE_JSON_MAX_LENGTH);
+                return NULL;
+            }
+            cte_json_error_t error;
+            cte_encoder_reset(worker->enc);
+            if (!cte_json_to_cte(worker->enc, line, length, &error)) {
+                worker->error_line = line_number;
+                snprintf(worker->error, sizeof(worker->error), "%s at column %zu", error.message, error.offset + 1);
+                return NULL;
+            }
+        } else {
+            char *save = NULL;
+            char *token = strtok_r(line, " \t\r\n", &save);
+            if (!token || token[0] == '#') {
+                continue;
+            }
+            cte_encoder_reset(worker->enc);
+            for (; token; token = strtok_r(NULL, " \t\r\n", &save)) {
+                // The encoder has room for one field past the limit, so it can never overflow.
+                if (cte_encoder_get_size(worker->enc) > CTE_MAX_TRANSACTION_SIZE) {
+                    break;
+                }
+                if (!parse_field(worker->enc, token, worker->error, sizeof(worker->error))) {
+                    worker->error_line = line_number;
+                    return NULL;
+                }
+            }
+        }
+
+        size_t size = cte_encoder_get_size(worker->enc);
+        if (size > CTE_MAX_TRANSACTION_SIZE) {
+            worker->error_line = line_number;
+            snprintf(worker->error, sizeof(worker->error), "Transaction exceeds %d bytes", CTE_MAX_TRANSACTION_SIZE);
+            return NULL;
+        }
+        if (worker->base64) {
+            char *line_out = (char *)worker->out + worker->out_size;
+            size_t length = cte_base64_encoded_length(size);
+            cte_base64_encode(cte_encoder_get_data(worker->enc), size, line_out);
+            line_out[length] = '\n';
+            worker->out_size += length + 1;
+            worker->transactions++;
+            continue;
+        }
+        uint8_t *frame = worker->out + worker->out_size;
+        size_t header = 0;
+        size_t length = size;
+        do {
+            frame[header] = (uint8_t)((length & 0x7F) | (length > 0x7F ? 0x80 : 0));
+            length >>= 7;
+            header++;
+        } while (length);
+        memcpy(frame + header, cte_encoder_get_data(worker->enc), size);
+        worker->out_size += header + size;
+        worker->transactions++;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Handles the 'batch' command for the CTE tool.
+ *
+ * Lines are read in rounds of up to BATCH_LINES. Each round is split into
+ * contiguous blocks, one per worker, and the workers' outputs are written in
+ * block order, so the output follows the input order.
+ *
+ * @param argc The argument count from main.
+ * @param argv The argument vector from main.
+ * @note This function exits on error.
+ */
+void do_batch(int argc, char *argv[]) {
+    const char *input_file = NULL;
+    const char *output_file = NULL;
+    long thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+    bool base64 = false;
+    bool json = false;
+    FILE *in = stdin;
+    FILE *out = stdout;
+    int first_arg_index = 2;
+
+    while (first_arg_index < argc && argv[first_arg_index][0] == '-') {
+        if (first_arg_index + 1 >= argc) {
+            fprintf(stderr, "Error: %s option requires an argument.\n", argv[first_arg_index]);
+            exit(1);
+        }
+        if (strcmp(argv[first_arg_index], "-i") == 0) {
+            input_file = argv[first_arg_index + 1];
+        } else if (strcmp(argv[first_arg_index], "-o") == 0) {
+            output_file = argv[first_arg_index + 1];
+        } else if (strcmp(argv[first_arg_index], "-j") == 0) {
+            thread_count = strtol(argv[first_arg_index + 1], NULL, 0);
+            if (thread_count < 1 || thread_count > 256) {
+                fprintf(stderr, "Error: Invalid thread count. Must be between 1 and 256.\n");
+                exit(1);
+            }
+        } else if (strcmp(argv[first_arg_index], "-e") == 0) {
+            base64 = parse_encoding(argv[first_arg_index + 1]);
+        } else if (strcmp(argv[first_arg_index], "-f") == 0) {
+            if (strcmp(argv[first_arg_index + 1], "json") == 0) {
+                json = true;
+            } else if (strcmp(argv[first_arg_index + 1], "spec") != 0) {
+                fprintf(stderr, "Error: Unknown input format '%s'.\n", argv[first_arg_index + 1]);
+                exit(1);
+            }
+        } else {
+            fprintf(stderr, "Error: Unknown option '%s'.\n", argv[first_arg_index]);
+            exit(1);
+        }
+        first_arg_index += 2;
+    }
+    if (first_arg_index < argc) {
+        fprintf(stderr, "Error: Unexpected argument '%s'.\n", argv[first_arg_index]);
+        exit(1);
+    }
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+
+    if (input_file && !(in = fopen(input_file, "r"))) {
+        perror("Error opening input file");
+        exit(1);
+    }
+    if (output_file && !(out = fopen(output_file, "wb"))) {
+        perror("Error opening output file");
+        exit(1);
+    }
+
+    size_t per_worker = (BATCH_LINES + (size_t)thread_count - 1) / (size_t)thread_count;
+    char **lines = calloc(BATCH_LINES, sizeof(char *));
+    size_t *capacities = calloc(BATCH_LINES, sizeof(size_t));
+    batch_worker_t *workers = calloc((size_t)thread_count, sizeof(batch_worker_t));
+    if (!lines || !capacities || !workers) {
+        fprintf(stderr, "Error: Out of memory.\n");
+        exit(1);
+    }
+    for (long t = 0; t < thread_count; t++) {
+        workers[t].enc = cte_encoder_init(json ? CTE_JSON_MAX_LENGTH : CTE_MAX_TRANSACTION_SIZE + SERVE_FIELD_ROOM);
+        workers[t].base64 = base64;
+        workers[t].json = json;
+        workers[t].out = malloc(per_worker * (base64 ? MAX_BASE64_LINE_SIZE : MAX_FRAME_SIZE));
+        if (!workers[t].out) {
+            fprintf(stderr, "Error: Out of memory.\n");
+            exit(1);
+        }
+    }
+
+    size_t total_transactions = 0;
+    size_t total_bytes = 0;
+    size_t total_lines = 0;
+    bool done = false;
+    while (!done) {
+        size_t count = 0;
+        while (count < BATCH_LINES) {
+            if (getline(&lines[count], &capacities[count], in) < 0) {
+                done = true;
+                break;
+            }
+            count++;
+        }
+
+        for (long t = 0; t < thread_count; t++) {
+            size_t first = count * (size_t)t / (size_t)thread_count;
+            size_t last = count * (size_t)(t + 1) / (size_t)thread_count;
+            workers[t].lines = lines + first;
+            workers[t].line_count = last - first;
+            workers[t].first_line = total_lines + first;
+            if (pthread_create(&workers[t].thread, NULL, batch_worker, &workers[t]) != 0) {
+                fprintf(stderr, "Error: Failed to start worker thread.\n");
+                exit(1);
+            }
+        }
+        for (long t = 0; t < thread_count; t++) {
+            pthread_join(workers[t].thread, NULL);
+        }
+        for (long t = 0; t < thread_count; t++) {
+            if (workers[t].error_line != 0) {
+                fprintf(stderr, "Error: Line %zu: %s\n", workers[t].error_line, workers[t].error);
+                exit(1);
+            }
+        }
+        for (long t = 0; t < thread_count; t++) {
+            if (fwrite(workers[t].out, 1, workers[t].out_size, out) != workers[t].out_size) {
+                perror("Error writing output");
+                exit(1);
+            }
+            total_transactions += workers[t].transactions;
+            total_bytes += workers[t].out_size;
+        }
+        total_lines += count;
+    }
+
+    for (long t = 0; t < thread_count; t++) {
+        cte_encoder_free(workers[t].enc);
+        free(workers[t].out);
+    }
+    for (size_t i = 0; i < BATCH_LINES; i++) {
+        free(lines[i]);
+    }
+    free(lines);
+    free(capacities);
+    free(workers);
+    if (input_file) {
+        fclose(in);
+    }
+    if (output_file) {
+        fclose(out);
+        printf("Wrote %zu transactions (%zu bytes) to %s\n", total_transactions, total_bytes, output_file);
+    } else {
+        fflush(out);
+    }
+}
+
+/**
+ * @brief Validates one transaction without aborting.
+ * @param data The transaction.
+ * @param size The size of the transaction.
+ * @param offset Receives the offset of the first bad field on failure.
+ * @param reason Receives a description of the problem on failure.
+ * @param reason_size The size of `reason`.
+ * @return true if every field decodes.
+ */
+bool verify_transaction(const uint8_t *data, size_t size, size_t *offset, char *reason, size_t reason_size) {
+    if (cte_decoder_validate(data, size, offset)) {
+        return true;
+    }
+    if (size == 0) {
+        snprintf(reason, reason_size, "Empty transaction");
+    } else if (size > CTE_MAX_TRANSACTION_SIZE) {
+        snprintf(reason, reason_size, "%zu bytes exceeds the maximum transaction size", size);
+    } else if (data[0] != CTE_VERSION_BYTE) {
+        snprintf(reason, reason_size, "Invalid version byte 0x%02X", data[0]);
+    } else {
+        // Name the field that failed; peeking past the version byte never aborts.
+        cte_decoder_t dec = cte_decoder_view(data, size, *offset);
+        int type = cte_decoder_peek_type(&dec);
+        if (type < 0) {
+            snprintf(reason, reason_size, "Reserved field header 0x%02X", data[*offset]);
+        } else {
+            snprintf(reason, reason_size, "Malformed or truncated %s field", cte_json_field_name(type));
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief A transaction that failed verification.
+ */
+typedef struct {
+    size_t index;     /**< Transaction number, or file number in directory mode. */
+    size_t start;     /**< Offset of the transaction's frame in the archive. */
+    size_t offset;    /**< Offset of the problem within the transaction. */
+    char reason[96];
+} verify_failure_t;
+
+/**
+ * @brief The transactions to verify and the shared work counter.
+ *
+ * Workers claim VERIFY_CHUNK transactions (or one container range) at a
+ * time from `next`, so a worker that hits slow files or large transactions
+ * simply claims fewer.
+ */
+typedef struct {
+    const uint8_t *data;  /**< Archive mode: the archive bytes. */
+    const size_t *starts; /**< Archive mode: offset of each transaction. */
+    const size_t *sizes;  /**< Archive mode: size of each transaction. */
+    char **paths;         /**< Directory mode: path of each file. */
+    const cte_container_t *container; /**< Container mode: the container view. */
+    size_t count;         /**< Number of transactions, files or container ranges. */
+    atomic_size_t next;   /**< First unclaimed transaction (or range). */
+} verify_job_t;
+
+/**
+ * @brief One 'verify' worker and the failures it found.
+ */
+typedef struct {
+    pthread_t thread;
+    verify_job_t *job;
+    verify_failure_t *failures;
+    size_t failure_count;
+    size_t failure_capacity;
+    size_t bytes;        /**< Bytes of transactions verified. */
+    size_t transactions; /**< Container mode: records verified. */
+} verify_worker_t;
+
+/**
+ * @brief Appends a failure to the worker's list.
+ * @return The new entry.
+ * @note This function exits on error.
+ */
+verify_failure_t *add_failure(verify_worker_t *worker, size_t index, size_t start, size_t offset) {
+    if (worker->failure_count == worker->failure_capacity) {
+        worker->failure_capacity = worker->failure_capacity ? 2 * worker->failure_capacity : 64;
+        worker->failures = realloc(worker->failures, worker->failure_capacity * sizeof(verify_failure_t));
+        if (!worker->failures) {
+            fprintf(stderr, "Error: Out of memory.\n");
+            exit(1);
+        }
+    }
+    verify_failure_t *failure = &worker->failures[worker->failure_count++];
+    failure->index = index;
+    failure->start = start;
+    failure->offset = offset;
+    return failure;
+}
+
+/**
+ * @brief Reads a whole file of at most CTE_MAX_TRANSACTION_SIZE bytes.
+ * @param path The file.
+ * @param buffer Receives the bytes; holds CTE_MAX_TRANSACTION_SIZE + 1.
+ * @param size Receives the number of bytes, one more than the limit if the file is larger.
+ * @return 0 on success, or an errno value.
+ */
+int read_transaction_file(const char *path, uint8_t *buffer, size_t *size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return errno;
+    }
+    *size = 0;
+    while (*size <= CTE_MAX_TRANSACTION_SIZE) {
+        ssize_t n = read(fd, buffer + *size, CTE_MAX_TRANSACTION_SIZE + 1 - *size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            int error = errno;
+            close(fd);
+            return error;
+        }
+        if (n == 0) {
+            break;
+        }
+        *size += (size_t)n;
+    }
+    close(fd);
+    return 0;
+}
+
+/**
+ * @brief Verifies the records of one range of a container.
+ *
+ * A record with damaged framing is reported and skipped by resuming at the
+ * next sync marker.
+ *
+ * @param worker The worker collecting failures.
+ * @param container The container view.
+ * @param part The range, 0 to `parts - 1`.
+ * @param parts The number of ranges.
+ */
+void verify_range(verify_worker_t *worker, const cte_container_t *container, size_t part, size_t parts) {
+    size_t offset, end;
+    uint64_t index = 0;
+    cte_container_record_t record;
+    char reason[96];
+    cte_container_split(container, (unsigned)part, (unsigned)parts, &offset, &end);
+    while (offset < end) {
+        cte_container_status_t status = cte_container_next(container, &offset, &index, &record);
+        worker->transactions++;
+        if (status == CTE_CONTAINER_MALFORMED) {
+            snprintf(add_failure(worker, index, offset, 0)->reason, sizeof(reason),
+                     "Damaged record framing; resumed at the next sync marker");
+            offset = cte_container_sync(container, offset + 1, &index);
+            continue;
+        }
+        size_t field;
+        if (status == CTE_CONTAINER_CHECKSUM) {
+            snprintf(add_failure(worker, record.index, record.offset, 0)->reason, sizeof(reason), "Checksum mismatch");
+        } else if (!verify_transaction(record.data, record.size, &field, reason, sizeof(reason))) {
+            memcpy(add_failure(worker, record.index, record.offset, field)->reason, reason, sizeof(reason));
+        }
+        worker->bytes += record.size;
+    }
+}
+
+/**
+ * @brief Verifies chunks of the job until none are left.
+ * @param arg The `verify_worker_t`.
+ * @return NULL.
+ */
+void *verify_worker(void *arg) {
+    verify_worker_t *worker = arg;
+    verify_job_t *job = worker->job;
+    uint8_t buffer[CTE_MAX_TRANSACTION_SIZE + 1];
+    char reason[96];
+    while (job->container) {
+        size_t part = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed);
+        if (part >= job->count) {
+            return NULL;
+        }
+        verify_range(worker, job->container, part, job->count);
+    }
+    for (;;) {
+        size_t first = atomic_fetch_add_explicit(&job->next, VERIFY_CHUNK, memory_order_relaxed);
+        if (first >= job->count) {
+            return NULL;
+        }
+        size_t last = first + VERIFY_CHUNK < job->count ? first + VERIFY_CHUNK : job->count;
+        for (size_t i = first; i < last; i++) {
+            const uint8_t *data;
+            size_t size;
+            if (job->paths) {
+                int error = read_transaction_file(job->paths[i], buffer, &size);
+                if (error != 0) {
+                    snprintf(add_failure(worker, i, 0, 0)->reason, sizeof(reason), "%s", strerror(error));
+                    continue;
+                }
+                data = buffer;
+            } else {
+                data = job->data + job->starts[i];
+                size = job->sizes[i];
+            }
+            size_t offset;
+            if (!verify_transaction(data, size, &offset, reason, sizeof(reason))) {
+                memcpy(add_failure(worker, i, job->paths ? 0 : job->starts[i], offset)->reason, reason, sizeof(reason));
+            }
+            worker->bytes += size;
+        }
+    }
+}
+
+/**
+ * @brief Orders failures by transaction number.
+ */
+int compare_failures(const void *a, const void *b) {
+    size_t x = ((const verify_failure_t *)a)->index;
+    size_t y = ((const verify_failure_t *)b)->index;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Orders path strings.
+ */
+int compare_paths(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/**
+ * @brief Lists the .cte files in a directory, sorted by name.
+ * @param dir The directory.
+ * @param count Receives the number of files.
+ * @return The paths; free each and the array.
+ * @note This function exits on error.
+ */
+char **list_transaction_files(const char *dir, size_t *count) {
+    DIR *handle = opendir(dir);
+    if (!handle) {
+        perror("Error opening directory");
+        exit(1);
+    }
+    char **paths = NULL;
+    size_t capacity = 0;
+    *count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(handle)) != NULL) {
+        size_t length = strlen(entry->d_name);
+        if (length <= 4 || strcmp(entry->d_name + length - 4, ".cte") != 0) {
+            continue;
+        }
+        if (*count == capacity) {
+            capacity = capacity ? 2 * capacity : 1024;
+            paths = realloc(paths, capacity * sizeof(char *));
+        }
+        char *path = malloc(strlen(dir) + length + 2);
+        if (!paths || !path) {
+            fprintf(stderr, "Error: Out of memory.\n");
+            exit(1);
+        }
+        sprintf(path, "%s/%s", dir, entry->d_name);
+        paths[(*count)++] = path;
+    }
+    closedir(handle);
+    qsort(paths, *count, sizeof(char *), compare_paths);
+    return paths;
+}
+
+#ifdef __linux__
+/**
+ * @brief A minimal io_uring instance driven through the raw system calls.
+ *
+ * Only one thread submits and reaps, so the local tail and head need no
+ * synchronisation; the shared ring indices are published with release and
+ * read with acquire ordering as the kernel ABI requires.
+ */
+typedef struct {
+    int fd;
+    unsigned sq_tail;  /**< Next SQE to fill; published on submit. */
+    unsigned pending;  /**< SQEs filled but not yet submitted. */
+    _Atomic unsigned *sq_head_shared;
+    _Atomic unsigned *sq_tail_shared;
+    _Atomic unsigned *cq_head_shared;
+    _Atomic unsigned *cq_tail_shared;
+    unsigned sq_mask;
+    unsigned cq_mask;
+    unsigned *sq_array;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_ring;
+    void *cq_ring;
+    size_t sq_ring_size;
+    size_t cq_ring_size;
+    size_t sqes_size;
+} uring_t;
+
+/**
+ * @brief Unmaps and closes a ring set up by `uring_open`.
+ */
+void uring_close(uring_t *ring) {
+    if (ring->sqes && ring->sqes != MAP_FAILED) {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_ring && ring->cq_ring != MAP_FAILED && ring->cq_ring != ring->sq_ring) {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    if (ring->sq_ring && ring->sq_ring != MAP_FAILED) {
+        munmap(ring->sq_ring, ring->sq_ring_size);
+    }
+    close(ring->fd);
+}
+
+/**
+ * @brief Checks with IORING_REGISTER_PROBE that the kernel supports every opcode in `ops`.
+ * @return true if all are supported; false with errno set to EOPNOTSUPP otherwise.
+ */
+bool uring_supports(int fd, const uint8_t *ops, size_t op_count) {
+    enum { PROBE_OPS = 256 };
+    struct io_uring_probe *probe = calloc(1, sizeof(struct io_uring_probe) + PROBE_OPS * sizeof(struct io_uring_probe_op));
+    if (!probe) {
+        errno = ENOMEM;
+        return false;
+    }
+    // Kernels too old to probe also predate IORING_OP_OPENAT, so a failed probe counts as unsupported.
+    bool supported = syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, PROBE_OPS) == 0;
+    for (size_t i = 0; supported && i < op_count; i++) {
+        supported = ops[i] < probe->ops_len && (probe->ops[ops[i]].flags & IO_URING_OP_SUPPORTED);
+    }
+    free(probe);
+    if (!supported) {
+        errno = EOPNOTSUPP;
+    }
+    return supported;
+}
+
+/**
+ * @brief Creates an io_uring with at least `entries` submission slots.
+ * @param ring Receives the ring.
+ * @param entries The number of submission slots wanted.
+ * @param ops The opcodes the caller submits; the ring is refused if the kernel lacks any.
+ * @param op_count The number of opcodes in `ops`.
+ * @return true on success; on failure errno describes the problem.
+ */
+bool uring_open(uring_t *ring, unsigned entries, const uint8_t *ops, size_t op_count) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd < 0) {
+        return false;
+    }
+    if (!uring_supports(ring->fd, ops, op_count)) {
+        close(ring->fd);
+        errno = EOPNOTSUPP;
+        return false;
+    }
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap && ring->cq_ring_size > ring->sq_ring_size) {
+        ring->sq_ring_size = ring->cq_ring_size;
+    }
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                         IORING_OFF_SQ_RING);
+    ring->cq_ring = single_mmap ? ring->sq_ring
+                                : mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                       ring->fd, IORING_OFF_CQ_RING);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                      IORING_OFF_SQES);
+    if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        int error = errno;
+        uring_close(ring);
+        errno = error;
+        return false;
+    }
+
+    uint8_t *sq = ring->sq_ring;
+    uint8_t *cq = ring->cq_ring;
+    ring->sq_head_shared = (_Atomic unsigned *)(sq + params.sq_off.head);
+    ring->sq_tail_shared = (_Atomic unsigned *)(sq + params.sq_off.tail);
+    ring->sq_mask = *(unsigned *)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+    ring->cq_head_shared = (_Atomic unsigned *)(cq + params.cq_off.head);
+    ring->cq_tail_shared = (_Atomic unsigned *)(cq + params.cq_off.tail);
+    ring->cq_mask = *(unsigned *)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    ring->sq_tail = atomic_load_explicit(ring->sq_tail_shared, memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Returns the next cleared submission entry.
+ * @note The caller keeps the number of operations in flight within the ring size.
+ */
+struct io_uring_sqe *uring_sqe(uring_t *ring, uint8_t opcode, uint64_t user_data) {
+    unsigned index = ring->sq_tail & ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->user_data = user_data;
+    ring->sq_array[index] = index;
+    ring->sq_tail++;
+    ring->pending++;
+    return sqe;
+}
+
+/**
+ * @brief Submits the pending entries and optionally waits for a completion.
+ * @note This function exits on error.
+ */
+void uring_submit(uring_t *ring, unsigned wait) {
+    atomic_store_explicit(ring->sq_tail_shared, ring->sq_tail, memory_order_release);
+    while (ring->pending > 0 || wait > 0) {
+        long submitted = syscall(__NR_io_uring_enter, ring->fd, ring->pending, wait,
+                                 wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+        if (submitted < 0 && errno == EINTR) {
+            continue;
+        }
+        if (submitted < 0) {
+            perror("Error submitting to io_uring");
+            exit(1);
+        }
+        ring->pending -= (unsigned)submitted;
+        wait = 0;
+    }
+}
+
+/**
+ * @brief A file moving through the 'verify -q' pipeline and its buffer.
+ */
+typedef struct {
+    size_t file; /**< Index into the job's paths. */
+    int fd;
+    int error;   /**< errno from opening or reading, or 0. */
+    size_t size; /**< Bytes read into the slot's buffer. */
+} ingest_slot_t;
+
+/**
+ * @brief State shared between the io_uring reader and the decode workers.
+ *
+ * Every buffer is either owned by the reader (free or in flight) or queued
+ * on `ready` / held by a worker, so the ready queue is bounded by `depth`
+ * and the reader stalls when the workers fall behind.
+ */
+typedef struct {
+    verify_job_t *job;
+    uint8_t *buffers;      /**< `depth` buffers of INGEST_SLOT_SIZE bytes. */
+    ingest_slot_t *slots;
+    unsigned depth;
+    pthread_mutex_t lock;
+    pthread_cond_t ready_cond; /**< Signalled when `ready` gains a slot or the reader finishes. */
+    pthread_cond_t free_cond;  /**< Signalled when a worker returns a slot. */
+    unsigned *ready;           /**< FIFO of slots whose files are read. */
+    unsigned ready_head;
+    unsigned ready_count;
+    unsigned *free_slots;      /**< Stack of slots the reader may reuse. */
+    unsigned free_count;
+    bool done;
+    size_t ready_samples;      /**< Ready queue depth statistics, sampled on every hand-off. */
+    size_t ready_depth_sum;
+    unsigned ready_depth_max;
+    size_t reader_stalls;      /**< Times the reader waited for a free buffer. */
+    size_t worker_stalls;      /**< Times a worker found the ready queue empty and had to wait. */
+} ingest_t;
+
+/**
+ * @brief A decode worker of the 'verify -q' pipeline.
+ */
+typedef struct {
+    pthread_t thread;
+    ingest_t *ingest;
+    verify_worker_t *worker; /**< Collects failures and byte counts. */
+    double busy;             /**< Seconds spent verifying. */
+} ingest_worker_t;
+
+/**
+ * @brief Verifies files from the ready queue until the reader is done.
+ * @param arg The `ingest_worker_t`.
+ * @return NULL.
+ */
+void *ingest_worker(void *arg) {
+    ingest_worker_t *self = arg;
+    ingest_t *ingest = self->ingest;
+    char reason[96];
+    for (;;) {
+        pthread_mutex_lock(&ingest->lock);
+        if (ingest->ready_count == 0 && !ingest->done) {
+            ingest->worker_stalls++;
+            do {
+                pthread_cond_wait(&ingest->ready_cond, &ingest->lock);
+            } while (ingest->ready_count == 0 && !ingest->done);
+        }
+        if (ingest->ready_count == 0) {
+            pthread_mutex_unlock(&ingest->lock);
+            return NULL;
+        }
+        unsigned slot = ingest->ready[ingest->ready_head];
+        ingest->ready_head = (ingest->ready_head + 1) % ingest->depth;
+        ingest->ready_count--;
+        pthread_mutex_unlock(&ingest->lock);
+
+        struct timespec started, finished;
+        clock_gettime(CLOCK_MONOTONIC, &started);
+        const ingest_slot_t *entry = &ingest->slots[slot];
+        size_t offset;
+        if (entry->error != 0) {
+            snprintf(add_failure(self->worker, entry->file, 0, 0)->reason, sizeof(reason), "%s",
+                     strerror(entry->error));
+        } else if (!verify_transaction(ingest->buffers + (size_t)slot * INGEST_SLOT_SIZE, entry->size, &offset, reason,
+                                       sizeof(reason))) {
+            memcpy(add_failure(self->worker, entry->file, 0, offset)->reason, reason, sizeof(reason));
+        }
+        self->worker->bytes += entry->size;
+        clock_gettime(CLOCK_MONOTONIC, &finished);
+        self->busy += (double)(finished.tv_sec - started.tv_sec) + (double)(finished.tv_nsec - started.tv_nsec) / 1e9;
+
+        pthread_mutex_lock(&ingest->lock);
+        ingest->free_slots[ingest->free_count++] = slot;
+        pthread_cond_signal(&ingest->free_cond);
+        pthread_mutex_unlock(&ingest->lock);
+    }
+}
+
+// Operation tags stored in the low bits of an SQE's user_data; the slot number is above them.
+enum { INGEST_OPEN, INGEST_READ, INGEST_CLOSE };
+
+/**
+ * @brief Queues a read of the rest of a slot's file, after the `entry->size` bytes already read.
+ * @param buffer The slot's buffer.
+ * @param registered The buffer is registered, so IORING_OP_READ_FIXED is used.
+ */
+void ingest_read(uring_t *ring, const ingest_slot_t *entry, unsigned slot, uint8_t *buffer, bool registered) {
+    struct io_uring_sqe *sqe = uring_sqe(ring, registered ? IORING_OP_READ_FIXED : IORING_OP_READ,
+                                         (uint64_t)slot << 2 | INGEST_READ);
+    sqe->fd = entry->fd;
+    sqe->off = entry->size;
+    sqe->addr = (uint64_t)(uintptr_t)(buffer + entry->size);
+    sqe->len = (unsigned)(CTE_MAX_TRANSACTION_SIZE + 1 - entry->size);
+    sqe->buf_index = registered ? (uint16_t)slot : 0;
+}
+
+/**
+ * @brief Verifies a directory's files, reading them through io_uring.
+ *
+ * The calling thread is the reader: it keeps up to `depth` files moving
+ * through openat, read (into registered buffers when the kernel allows)
+ * and close, and hands each completed read to the decode workers through
+ * a bounded queue, so disk and CPU work overlap. Statistics for both
+ * stages are printed when the pipeline drains.
+ *
+ * @param job The directory job; `job->paths` must be set.
+ * @param workers One failure collector per decode thread.
+ * @param thread_count The number of decode threads.
+ * @param depth The number of file buffers.
+ * @return false, after printing a note, if io_uring is unavailable; the caller then falls back to reading synchronously.
+ * @note This function exits on other errors.
+ */
+bool ingest_directory(verify_job_t *job, verify_worker_t *workers, long thread_count, unsigned depth) {
+    // A slot can have its close and the next file's open in flight at once.
+    static const uint8_t ops[] = {IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_READ_FIXED, IORING_OP_CLOSE};
+    uring_t ring;
+    if (!uring_open(&ring, 2 * depth, ops, sizeof(ops))) {
+        fprintf(stderr, "Note: io_uring unavailable (%s); reading files synchronously.\n", strerror(errno));
+        return false;
+    }
+
+    ingest_t ingest = {0};
+    ingest.job = job;
+    ingest.depth = depth;
+    ingest.buffers = aligned_alloc(4096, ((size_t)depth * INGEST_SLOT_SIZE + 4095) & ~(size_t)4095);
+    ingest.slots = calloc(depth, sizeof(ingest_slot_t));
+    ingest.ready = malloc(depth * sizeof(unsigned));
+    ingest.free_slots = malloc(depth * sizeof(unsigned));
+    struct iovec *iovecs = malloc(depth * sizeof(struct iovec));
+    ingest_worker_t *threads = calloc((size_t)thread_count, sizeof(ingest_worker_t));
+    unsigned *handed = malloc(depth * sizeof(unsigned));
+    if (!ingest.buffers || !ingest.slots || !ingest.ready || !ingest.free_slots || !iovecs || !threads || !handed) {
+        fprintf(stderr, "Error: Out of memory.\n");
+        exit(1);
+    }
+    for (unsigned i = 0; i < depth; i++) {
+        iovecs[i].iov_base = ingest.buffers + (size_t)i * INGEST_SLOT_SIZE;
+        iovecs[i].iov_len = INGEST_SLOT_SIZE;
+        ingest.free_slots[i] = depth - 1 - i;
+    }
+    ingest.free_count = depth;
+    // Registration pins the buffers so reads skip the per-I/O page mapping; plain reads still work without it.
+    bool registered = syscall(__NR_io_uring_register, ring.fd, IORING_REGISTER_BUFFERS, iovecs, depth) == 0;
+    pthread_mutex_init(&ingest.lock, NULL);
+    pthread_cond_init(&ingest.ready_cond, NULL);
+    pthread_cond_init(&ingest.free_cond, NULL);
+
+    for (long t = 0; t < thread_count; t++) {
+        threads[t].ingest = &ingest;
+        threads[t].worker = &workers[t];
+        if (pthread_create(&threads[t].thread, NULL, ingest_worker, &threads[t]) != 0) {
+            fprintf(stderr, "Error: Failed to start worker thread.\n");
+            exit(1);
+        }
+    }
+
+    struct timespec started, finished;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    size_t next_file = 0;
+    size_t handed_off = 0;
+    size_t bytes_read = 0;
+    unsigned in_flight = 0;
+    unsigned in_flight_max = 0;
+    size_t in_flight_samples = 0;
+    size_t in_flight_sum = 0;
+    while (handed_off < job->count || in_flight > 0) {
+        // Start an open for every free buffer, waiting for one only if nothing else can make progress.
+        pthread_mutex_lock(&ingest.lock);
+        while (ingest.free_count == 0 && in_flight == 0) {
+            ingest.reader_stalls++;
+            pthread_cond_wait(&ingest.free_cond, &ingest.lock);
+        }
+        while (ingest.free_count > 0 && next_file < job->count) {
+            unsigned slot = ingest.free_slots[--ingest.free_count];
+            ingest.slots[slot].file = next_file;
+            ingest.slots[slot].error = 0;
+            ingest.slots[slot].size = 0;
+            struct io_uring_sqe *sqe = uring_sqe(&ring, IORING_OP_OPENAT, (uint64_t)slot << 2 | INGEST_OPEN);
+            sqe->fd = AT_FDCWD;
+            sqe->addr = (uint64_t)(uintptr_t)job->paths[next_file];
+            sqe->open_flags = O_RDONLY;
+            next_file++;
+            in_flight++;
+        }
+        pthread_mutex_unlock(&ingest.lock);
+
+        in_flight_samples++;
+        in_flight_sum += in_flight;
+        if (in_flight > in_flight_max) {
+            in_flight_max = in_flight;
+        }
+        uring_submit(&ring, in_flight > 0 ? 1 : 0);
+
+        // Reap every completion, queueing follow-up operations and collecting finished files.
+        unsigned handed_count = 0;
+        unsigned head = atomic_load_explicit(ring.cq_head_shared, memory_order_relaxed);
+        unsigned tail = atomic_load_explicit(ring.cq_tail_shared, memory_order_acquire);
+        for (; head != tail; head++) {
+            const struct io_uring_cqe *cqe = &ring.cqes[head & ring.cq_mask];
+            unsigned slot = (unsigned)(cqe->user_data >> 2);
+            ingest_slot_t *entry = &ingest.slots[slot];
+            in_flight--;
+            switch (cqe->user_data & 3) {
+            case INGEST_OPEN:
+                if (cqe->res < 0) {
+                    entry->error = -cqe->res;
+                    handed[handed_count++] = slot;
+                    break;
+                }
+                entry->fd = cqe->res;
+                ingest_read(&ring, entry, slot, iovecs[slot].iov_base, registered);
+                in_flight++;
+                break;
+            case INGEST_READ:
+                if (cqe->res < 0) {
+                    entry->error = -cqe->res;
+                } else if (cqe->res > 0) {
+                    // Like read_transaction_file, read until end of file or one byte past the limit.
+                    entry->size += (size_t)cqe->res;
+                    bytes_read += (size_t)cqe->res;
+                    if (entry->size <= CTE_MAX_TRANSACTION_SIZE) {
+                        ingest_read(&ring, entry, slot, iovecs[slot].iov_base, registered);
+                        in_flight++;
+                        break;
+                    }
+                }
+                uring_sqe(&ring, IORING_OP_CLOSE, (uint64_t)slot << 2 | INGEST_CLOSE)->fd = entry->fd;
+                in_flight++;
+                handed[handed_count++] = slot;
+                break;
             default:
-                fprintf(stderr, "Read for type %d not implemented yet. Aborting.\n", type);
+                break;
+            }
+        }
+        atomic_store_explicit(ring.cq_head_shared, head, memory_order_release);
+
+        if (handed_count > 0) {
+            pthread_mutex_lock(&ingest.lock);
+            for (unsigned i = 0; i < handed_count; i++) {
+                ingest.ready[(ingest.ready_head + ingest.ready_count) % depth] = handed[i];
+                ingest.ready_count++;
+            }
+            ingest.ready_samples++;
+            ingest.ready_depth_sum += ingest.ready_count;
+            if (ingest.ready_count > ingest.ready_depth_max) {
+                ingest.ready_depth_max = ingest.ready_count;
+            }
+            pthread_cond_broadcast(&ingest.ready_cond);
+            pthread_mutex_unlock(&ingest.lock);
+            handed_off += handed_count;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finished);
+
+    pthread_mutex_lock(&ingest.lock);
+    ingest.done = true;
+    pthread_cond_broadcast(&ingest.ready_cond);
+    pthread_mutex_unlock(&ingest.lock);
+    double busy = 0;
+    for (long t = 0; t < thread_count; t++) {
+        pthread_join(threads[t].thread, NULL);
+        busy += threads[t].busy;
+    }
+
+    double seconds = (double)(finished.tv_sec - started.tv_sec) + (double)(finished.tv_nsec - started.tv_nsec) / 1e9;
+    if (seconds <= 0) {
+        seconds = 1e-9;
+    }
+    printf("Read stage: %zu files (%zu bytes) in %.3f s: %.0f files/s, %.1f MB/s; %s buffers, "
+           "in flight avg %.1f max %u; waited for a free buffer %zu times\n",
+           job->count, bytes_read, seconds, job->count / seconds, bytes_read / seconds / 1e6,
+           registered ? "registered" : "unregistered", in_flight_samples ? (double)in_flight_sum / in_flight_samples : 0.0,
+           in_flight_max, ingest.reader_stalls);
+    printf("Decode stage: %ld workers busy %.3f s: %.0f files per busy second; "
+           "ready queue avg %.1f max %u of %u; workers waited for input %zu times\n",
+           thread_count, busy, busy > 0 ? job->count / busy : 0.0,
+           ingest.ready_samples ? (double)ingest.ready_depth_sum / ingest.ready_samples : 0.0, ingest.ready_depth_max,
+           depth, ingest.worker_stalls);
+
+    pthread_cond_destroy(&ingest.free_cond);
+    pthread_cond_destroy(&ingest.ready_cond);
+    pthread_mutex_destroy(&ingest.lock);
+    uring_close(&ring);
+    free(handed);
+    free(threads);
+    free(iovecs);
+    free(ingest.free_slots);
+    free(ingest.ready);
+    free(ingest.slots);
+    free(ingest.buffers);
+    return true;
+}
+#else
+bool ingest_directory(verify_job_t *job, verify_worker_t *workers, long thread_count, unsigned depth) {
+    (void)job;
+    (void)workers;
+    (void)thread_count;
+    (void)depth;
+    fprintf(stderr, "Note: io_uring is only available on Linux; reading files synchronously.\n");
+    return false;
+}
+#endif
+
+/**
+ * @brief Handles the 'verify' command for the CTE tool.
+ *
+ * An archive is first split into frames sequentially (only the length
+ * prefixes are read), then the transactions are validated in parallel.
+ * A bad frame length ends the split, since later frames cannot be found;
+ * it is reported like any other failure. A container file is recognised
+ * by its header and split at its sync markers instead, which needs no
+ * sequential pass; damaged records are skipped to the next marker.
+ *
+ * @param argc The argument count from main.
+ * @param argv The argument vector from main.
+ * @note This function exits with status 1 if any transaction failed.
+ */
+void do_verify(int argc, char *argv[]) {
+    const char *input_file = NULL;
+    const char *dir = NULL;
+    long thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+    long depth = 0;
+    int first_arg_index = 2;
+
+    while (first_arg_index < argc && argv[first_arg_index][0] == '-') {
+        if (first_arg_index + 1 >= argc) {
+            fprintf(stderr, "Error: %s option requires an argument.\n", argv[first_arg_index]);
+            exit(1);
+        }
+        if (strcmp(argv[first_arg_index], "-i") == 0) {
+            input_file = argv[first_arg_index + 1];
+        } else if (strcmp(argv[first_arg_index], "-d") == 0) {
+            dir = argv[first_arg_index + 1];
+        } else if (strcmp(argv[first_arg_index], "-q") == 0) {
+            depth = strtol(argv[first_arg_index + 1], NULL, 0);
+            if (depth < 1 || depth > MAX_INGEST_DEPTH) {
+                fprintf(stderr, "Error: Invalid queue depth. Must be between 1 and %d.\n", MAX_INGEST_DEPTH);
+                exit(1);
+            }
+        } else if (strcmp(argv[first_arg_index], "-j") == 0) {
+            thread_count = strtol(argv[first_arg_index + 1], NULL, 0);
+            if (thread_count < 1 || thread_count > 256) {
+                fprintf(stderr, "Error: Invalid thread count. Must be between 1 and 256.\n");
+                exit(1);
+            }
+        } else {
+            fprintf(stderr, "Error: Unknown option '%s'.\n", argv[first_arg_index]);
+            exit(1);
+        }
+        first_arg_index += 2;
+    }
+    if (first_arg_index < argc || (input_file && dir)) {
+        fprintf(stderr, "Error: 'verify' takes either -i <file> or -d <dir>.\n");
+        exit(1);
+    }
+    if (depth > 0 && !dir) {
+        fprintf(stderr, "Error: -q requires -d <dir>.\n");
+        exit(1);
+    }
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+
+    struct timespec started, finished;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+
+    verify_job_t job = {0};
+    input_t input = {0};
+    size_t *starts = NULL;
+    size_t *sizes = NULL;
+    verify_failure_t frame_failure;
+    bool frame_failed = false;
+    if (dir) {
+        job.paths = list_transaction_files(dir, &job.count);
+    } else {
+        int fd = input_file ? open(input_file, O_RDONLY) : STDIN_FILENO;
+        if (fd < 0) {
+            perror("Error opening input file");
+            exit(1);
+        }
+        open_input(fd, MAX_BUFFER_SIZE, &input);
+        if (input_file) {
+            close(fd);
+        }
+        if (cte_container_open(&input.container, input.data, input.size)) {
+            job.container = &input.container;
+            job.count = (size_t)thread_count * VERIFY_SPLITS;
+            if (!input.container.indexed) {
+                fprintf(stderr, "Note: The container has no intact index; records are found through sync markers.\n");
+            }
+        }
+
+        size_t capacity = 0;
+        size_t offset = 0;
+        while (!job.container && offset < input.size) {
+            size_t frame_offset = offset;
+            size_t length;
+            if (!read_frame_length(input.data, input.size, &offset, &length) || length > input.size - offset) {
+                frame_failure.index = job.count;
+                frame_failure.start = frame_offset;
+                frame_failure.offset = 0;
+                snprintf(frame_failure.reason, sizeof(frame_failure.reason),
+                         "Invalid or truncated frame length; %zu trailing bytes not verified",
+                         input.size - frame_offset);
+                frame_failed = true;
+                break;
+            }
+            if (job.count == capacity) {
+                capacity = capacity ? 2 * capacity : 4096;
+                starts = realloc(starts, capacity * sizeof(size_t));
+                sizes = realloc(sizes, capacity * sizeof(size_t));
+                if (!starts || !sizes) {
+                    fprintf(stderr, "Error: Out of memory.\n");
+                    exit(1);
+                }
+            }
+            starts[job.count] = offset;
+            sizes[job.count] = length;
+            job.count++;
+            offset += length;
+        }
+        job.data = input.data;
+        job.starts = starts;
+        job.sizes = sizes;
+    }
+    atomic_init(&job.next, 0);
+
+    verify_worker_t *workers = calloc((size_t)thread_count, sizeof(verify_worker_t));
+    if (!workers) {
+        fprintf(stderr, "Error: Out of memory.\n");
+        exit(1);
+    }
+    bool ingested = depth > 0 && ingest_directory(&job, workers, thread_count, (unsigned)depth);
+    for (long t = 0; !ingested && t < thread_count; t++) {
+        workers[t].job = &job;
+        if (pthread_create(&workers[t].thread, NULL, verify_worker, &workers[t]) != 0) {
+            fprintf(stderr, "Error: Failed to start worker thread.\n");
+            exit(1);
+        }
+    }
+
+    // Gather every worker's failures and report them in transaction order.
+    size_t failure_count = frame_failed;
+    size_t bytes = 0;
+    size_t transactions = job.container ? 0 : job.count;
+    for (long t = 0; t < thread_count; t++) {
+        if (!ingested) {
+            pthread_join(workers[t].thread, NULL);
+        }
+        failure_count += workers[t].failure_count;
+        bytes += workers[t].bytes;
+        transactions += workers[t].transactions;
+    }
+    verify_failure_t *failures = malloc((failure_count + 1) * sizeof(verify_failure_t));
+    if (!failures) {
+        fprintf(stderr, "Error: Out of memory.\n");
+        exit(1);
+    }
+    size_t n = 0;
+    for (long t = 0; t < thread_count; t++) {
+        memcpy(failures + n, workers[t].failures, workers[t].failure_count * sizeof(verify_failure_t));
+        n += workers[t].failure_count;
+        free(workers[t].failures);
+    }
+    qsort(failures, n, sizeof(verify_failure_t), compare_failures);
+    if (frame_failed) {
+        failures[n++] = frame_failure; // always after the last complete frame
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        const verify_failure_t *failure = &failures[i];
+        if (dir) {
+            printf("FAIL %s: byte %zu: %s\n", job.paths[failure->index], failure->offset, failure->reason);
+        } else if (frame_failed && i == n - 1) {
+            printf("FAIL frame %zu at offset %zu: %s\n", failure->index, failure->start, failure->reason);
+        } else {
+            printf("FAIL transaction %zu at offset %zu: byte %zu: %s\n", failure->index, failure->start,
+                   failure->offset, failure->reason);
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finished);
+    double seconds = (double)(finished.tv_sec - started.tv_sec) + (double)(finished.tv_nsec - started.tv_nsec) / 1e9;
+    if (seconds <= 0) {
+        seconds = 1e-9;
+    }
+    printf("Verified %zu transactions (%zu bytes) on %ld threads in %.3f s: %.0f tx/s, %.1f MB/s; %zu failed\n",
+           transactions, bytes, thread_count, seconds, transactions / seconds, bytes / seconds / 1e6, n);
+
+    if (dir) {
+        for (size_t i = 0; i < job.count; i++) {
+            free(job.paths[i]);
+        }
+        free(job.paths);
+    } else {
+        close_input(&input);
+    }
+    free(starts);
+    free(sizes);
+    free(failures);
+    free(workers);
+    if (n > 0) {
+        exit(1);
+    }
+}
+
+/**
+ * @brief Passes container bytes to a stdio stream.
+ * @param context The `FILE`.
+ * @return false on a write error.
+ */
+bool file_sink(void *context, const uint8_t *data, size_t size) {
+    return fwrite(data, 1, size, context) == size;
+}
+
+/**
+ * @brief Handles the 'pack' command for the CTE tool.
+ *
+ * Copies each frame of a prefix-framed stream into a container record
+ * without decoding it; run 'verify' on the result to validate it.
+ *
+ * @param argc The argument count from main.
+ * @param argv The argument vector from main.
+ * @note This function exits on error.
+ */
+void do_pack(int argc, char *argv[]) {
+    const char *input_file = NULL;
+    const char *output_file = NULL;
+    long sync_interval = DEFAULT_SYNC_INTERVAL;
+    uint8_t flags = CTE_CONTAINER_CHECKSUMS;
+    int first_arg_index = 2;
+
+    while (first_arg_index < argc && argv[first_arg_index][0] == '-') {
+        if (first_arg_index + 1 >= argc) {
+            fprintf(stderr, "Error: %s option requires an argument.\n", argv[first_arg_index]);
+            exit(1);
+        }
+        const char *value = argv[first_arg_index + 1];
+        if (strcmp(argv[first_arg_index], "-i") == 0) {
+            input_file = value;
+        } else if (strcmp(argv[first_arg_index], "-o") == 0) {
+            output_file = value;
+        } else if (strcmp(argv[first_arg_index], "-k") == 0) {
+            sync_interval = strtol(value, NULL, 0);
+            if (sync_interval < 1 || sync_interval > (long)CTE_CONTAINER_MAX_SYNC_INTERVAL) {
+                fprintf(stderr, "Error: Invalid sync interval. Must be between 1 and %u.\n",
+                        CTE_CONTAINER_MAX_SYNC_INTERVAL);
+                exit(1);
+            }
+        } else if (strcmp(argv[first_arg_index], "-c") == 0) {
+            if (strcmp(value, "crc32c") == 0) {
+                flags = CTE_CONTAINER_CHECKSUMS;
+            } else if (strcmp(value, "none") == 0) {
+                flags = 0;
+            } else {
+                fprintf(stderr, "Error: Unknown checksum mode '%s'.\n", value);
+                exit(1);
+            }
+        } else {
+            fprintf(stderr, "Error: Unknown option '%s'.\n", argv[first_arg_index]);
+            exit(1);
+        }
+        first_arg_index += 2;
+    }
+    if (first_arg_index < argc) {
+        fprintf(stderr, "Error: Unexpected argument '%s'.\n", argv[first_arg_index]);
+        exit(1);
+    }
+
+    int fd = input_file ? open(input_file, O_RDONLY) : STDIN_FILENO;
+    if (fd < 0) {
+        perror("Error opening input file");
+        exit(1);
+    }
+    input_t input;
+    open_input(fd, MAX_BUFFER_SIZE, &input);
+    if (input_file) {
+        close(fd);
+    }
+    if (cte_container_open(&input.container, input.data, input.size)) {
+        fprintf(stderr, "Error: The input is already a container.\n");
+        exit(1);
+    }
+    FILE *out = output_file ? fopen(output_file, "wb") : stdout;
+    if (!out) {
+        perror("Error opening output file");
+        exit(1);
+    }
+
+    cte_container_writer_t *writer = cte_container_writer_init((uint32_t)sync_interval, flags, file_sink, out, NULL);
+    size_t offset = 0;
+    bool written = true;
+    while (written && offset < input.size) {
+        size_t frame_offset = offset;
+        size_t length;
+        if (!read_frame_length(input.data, input.size, &offset, &length) || length == 0 ||
+            length > CTE_MAX_TRANSACTION_SIZE || length > input.size - offset) {
+            fprintf(stderr, "Error: Invalid frame length at offset %zu.\n", frame_offset);
+            exit(1);
+        }
+        written = cte_container_writer_append(writer, input.data + offset, length);
+        offset += length;
+    }
+    uint64_t count = cte_container_writer_count(writer);
+    if (!cte_container_writer_finish(writer) || fflush(out) != 0 || (output_file && fclose(out) != 0)) {
+        perror("Error writing output");
+        exit(1);
+    }
+    cte_container_writer_free(writer);
+    fprintf(stderr, "Packed %llu transactions (%zu bytes) into %s: sync every %ld records, %s.\n",
+            (unsigned long long)count, input.size, output_file ? output_file : "stdout", sync_interval,
+            flags ? "CRC-32C checksums" : "no checksums");
+    close_input(&input);
+}
+
+/**
+ * @brief One 'log' producer thread and its share of the input.
+ */
+typedef struct {
+    pthread_t thread;
+    cte_log_t *log;
+    const uint8_t *data;
+    const size_t *starts;
+    const size_t *sizes;
+    size_t count;
+    bool each;   /**< Wait for durability after every append. */
+    int error;   /**< errno of the first failed append or sync, or 0. */
+} log_producer_t;
+
+/**
+ * @brief Appends a producer's transactions, waiting for durability as configured.
+ * @param arg The `log_producer_t`.
+ * @return NULL.
+ */
+void *log_producer(void *arg) {
+    log_producer_t *producer = arg;
+    uint64_t sequence = 0;
+    for (size_t i = 0; i < producer->count; i++) {
+        if (!cte_log_append(producer->log, producer->data + producer->starts[i], producer->sizes[i], &sequence) ||
+            (producer->each && !cte_log_sync(producer->log, sequence))) {
+            producer->error = errno;
+            return NULL;
+        }
+    }
+    if (producer->count > 0 && !cte_log_sync(producer->log, sequence)) {
+        producer->error = errno;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Handles the 'log' command for the CTE tool.
+ *
+ * Appends every frame of a prefix-framed stream to a transaction log from
+ * one or more producer threads, like a node persisting accepted
+ * transactions, and reports the group-commit throughput.
+ *
+ * @param argc The argument count from main.
+ * @param argv The argument vector from main.
+ * @note This function exits on error.
+ */
+void do_log(int argc, char *argv[]) {
+    const char *input_file = NULL;
+    const char *dir = NULL;
+    long producer_count = 1;
+    bool each = false;
+    cte_log_options_t options;
+    cte_log_default_options(&options);
+    int first_arg_index = 2;
+
+    while (first_arg_index < argc && argv[first_arg_index][0] == '-') {
+        if (first_arg_index + 1 >= argc) {
+            fprintf(stderr, "Error: %s option requires an argument.\n", argv[first_arg_index]);
+            exit(1);
+        }
+        const char *value = argv[first_arg_index + 1];
+        if (strcmp(argv[first_arg_index], "-i") == 0) {
+            input_file = value;
+        } else if (strcmp(argv[first_arg_index], "-d") == 0) {
+            dir = value;
+        } else if (strcmp(argv[first_arg_index], "-j") == 0) {
+            producer_count = strtol(value, NULL, 0);
+            if (producer_count < 1 || producer_count > MAX_LOG_PRODUCERS) {
+                fprintf(stderr, "Error: Invalid producer count. Must be between 1 and %d.\n", MAX_LOG_PRODUCERS);
+                exit(1);
+            }
+        } else if (strcmp(argv[first_arg_index], "-a") == 0) {
+            if (strcmp(value, "each") == 0) {
+                each = true;
+            } else if (strcmp(value, "end") == 0) {
+                each = false;
+            } else {
+                fprintf(stderr, "Error: Unknown acknowledgement mode '%s'.\n", value);
+                exit(1);
+            }
+        } else if (strcmp(argv[first_arg_index], "-w") == 0) {
+            long delay = strtol(value, NULL, 0);
+            if (delay < 0 || delay > 1000000) {
+                fprintf(stderr, "Error: Invalid batch delay. Must be between 0 and 1000000 us.\n");
+                exit(1);
+            }
+            options.max_delay_us = (uint32_t)delay;
+        } else if (strcmp(argv[first_arg_index], "-m") == 0) {
+            long mebibytes = strtol(value, NULL, 0);
+            if (mebibytes < 1 || mebibytes > 4096) {
+                fprintf(stderr, "Error: Invalid segment size. Must be between 1 and 4096 MiB.\n");
+                exit(1);
+            }
+            options.segment_size = (size_t)mebibytes << 20;
+        } else if (strcmp(argv[first_arg_index], "-c") == 0) {
+            if (strcmp(value, "crc32c") == 0) {
+                options.checksums = true;
+            } else if (strcmp(value, "none") == 0) {
+                options.checksums = false;
+            } else {
+                fprintf(stderr, "Error: Unknown checksum mode '%s'.\n", value);
+                exit(1);
+            }
+        } else {
+            fprintf(stderr, "Error: Unknown option '%s'.\n", argv[first_arg_index]);
+            exit(1);
+        }
+        first_arg_index += 2;
+    }
+    if (first_arg_index < argc || !dir) {
+        fprintf(stderr, "Error: 'log' requires -d <dir> and takes no other arguments.\n");
+        exit(1);
+    }
+
+    int fd = input_file ? open(input_file, O_RDONLY) : STDIN_FILENO;
+    if (fd < 0) {
+        perror("Error opening input file");
+        exit(1);
+    }
+    input_t input;
+    open_input(fd, MAX_BUFFER_SIZE, &input);
+    if (input_file) {
+        close(fd);
+    }
+    size_t count = 0;
+    size_t capacity = 0;
+    size_t *starts = NULL;
+    size_t *sizes = NULL;
+    size_t offset = 0;
+    while (offset < input.size) {
+        size_t frame_offset = offset;
+        size_t length;
+        if (!read_frame_length(input.data, input.size, &offset, &length) || length == 0 ||
+            length > CTE_MAX_TRANSACTION_SIZE || length > input.size - offset) {
+            fprintf(stderr, "Error: Invalid frame length at offset %zu.\n", frame_offset);
+            exit(1);
+        }
+        if (count == capacity) {
+            capacity = capacity ? 2 * capacity : 4096;
+            starts = realloc(starts, capacity * sizeof(size_t));
+            sizes = realloc(sizes, capacity * sizeof(size_t));
+            if (!starts || !sizes) {
+                fprintf(stderr, "Error: Out of memory.\n");
+                exit(1);
+            }
+        }
+        starts[count] = offset;
+        sizes[count] = length;
+        count++;
+        offset += length;
+    }
+
+    cte_log_recovery_t recovery;
+    cte_log_t *log = cte_log_open(dir, &options, &recovery);
+    if (!log) {
+        perror(errno == EBADMSG ? "Error: The log is damaged before its last segment" : "Error opening log");
+        exit(1);
+    }
+    if (recovery.truncated_bytes > 0) {
+        fprintf(stderr, "Note: Recovery cut off %llu bytes of torn or damaged records.\n",
+                (unsigned long long)recovery.truncated_bytes);
+    }
+
+    struct timespec started, finished;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    log_producer_t *producers = calloc((size_t)producer_count, sizeof(log_producer_t));
+    if (!producers) {
+        fprintf(stderr, "Error: Out of memory.\n");
+        exit(1);
+    }
+    for (long t = 0; t < producer_count; t++) {
+        size_t first = count * (size_t)t / (size_t)producer_count;
+        size_t last = count * (size_t)(t + 1) / (size_t)producer_count;
+        producers[t] = (log_producer_t){0, log, input.data, starts + first, sizes + first, last - first, each, 0};
+        if (pthread_create(&producers[t].thread, NULL, log_producer, &producers[t]) != 0) {
+            fprintf(stderr, "Error: Could not start producer thread.\n");
+            exit(1);
+        }
+    }
+    int error = 0;
+    for (long t = 0; t < producer_count; t++) {
+        pthread_join(producers[t].thread, NULL);
+        if (!error) {
+            error = producers[t].error;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finished);
+    cte_log_stats_t stats;
+    cte_log_stats(log, &stats);
+    if (!cte_log_close(log) && !error) {
+        error = errno;
+    }
+    if (error) {
+        errno = error;
+        perror(error == EINVAL ? "Error: A transaction does not decode" : "Error writing log");
+        exit(1);
+    }
+
+    double seconds = (double)(finished.tv_sec - started.tv_sec) + (double)(finished.tv_nsec - started.tv_nsec) / 1e9;
+    if (seconds <= 0) {
+        seconds = 1e-9;
+    }
+    fprintf(stderr,
+            "Logged %zu transactions (sequence %llu-%llu) from %ld producers in %.3f s: %.0f tx/s, %.1f MB/s\n",
+            count, (unsigned long long)recovery.next_sequence,
+            (unsigned long long)(recovery.next_sequence + count - (count > 0)), producer_count, seconds,
+            count / seconds, stats.bytes / seconds / 1e6);
+    fprintf(stderr, "Group commit: %llu syncs, %.1f transactions per sync; %llu new segments\n",
+            (unsigned long long)stats.batches, stats.batches ? (double)stats.durable / stats.batches : 0.0,
+            (unsigned long long)stats.segments);
+
+    free(producers);
+    free(starts);
+    free(sizes);
+    close_input(&input);
+}
+
+/**
+ * @brief Appends one 'index' result row.
+ * @param out The buffer.
+ * @param archive The archive bytes.
+ * @param field The field.
+ */
+void out_indexed_field(out_buffer_t *out, const uint8_t *archive, const cte_field_index_field_t *field) {
+    out_uint(out, field->transaction);
+    out_bytes(out, "\t", 1);
+    out_uint(out, field->number);
+    out_bytes(out, "\t", 1);
+    out_uint(out, field->offset);
+    out_bytes(out, "\t", 1);
+    out_text(out, cte_json_field_name(field->type));
+    out_bytes(out, "\t", 1);
+    out_hex(out, archive + field->value, field->length);
+    out_bytes(out, "\n", 1);
+}
+
+/**
+ * @brief Handles the 'index' command for the CTE tool.
+ *
+ * Loads the archive's field index, rebuilding the sidecar when it is
+ * missing or stale, and answers the query from the index alone.
+ *
+ * @param argc The argument count from main.
+ * @param argv The argument vector from main.
+ * @note This function exits on error.
+ */
+void do_index(int argc, char *argv[]) {
+    const char *input_file = NULL;
+    const char *type_name = NULL;
+    const char *position = NULL;
+    int first_arg_index = 2;
+
+    while (first_arg_index < argc && argv[first_arg_index][0] == '-') {
+        if (first_arg_index + 1 >= argc) {
+            fprintf(stderr, "Error: %s option requires an argument.\n", argv[first_arg_index]);
+            exit(1);
+        }
+        const char *value = argv[first_arg_index + 1];
+        if (strcmp(argv[first_arg_index], "-i") == 0) {
+            input_file = value;
+        } else if (strcmp(argv[first_arg_index], "-t") == 0) {
+            type_name = value;
+        } else if (strcmp(argv[first_arg_index], "-f") == 0) {
+            position = value;
+        } else {
+            fprintf(stderr, "Error: Unknown option '%s'.\n", argv[first_arg_index]);
+            exit(1);
+        }
+        first_arg_index += 2;
+    }
+    if (first_arg_index < argc || !input_file || (type_name && position)) {
+        fprintf(stderr, "Error: 'index' requires -i <file> and takes at most one of -t and -f.\n");
+        exit(1);
+    }
+
+    uint32_t types = 0;
+    if (type_name) {
+        for (int t = 0; t <= CTE_PEEK_TYPE_CMD_EXTENDED; t++) {
+            if (strcmp(cte_json_field_name(t), type_name) == 0) {
+                types |= 1u << t;
+            }
+        }
+        if (!types) {
+            fprintf(stderr, "Error: Unknown field type '%s'.\n", type_name);
+            exit(1);
+        }
+    }
+    unsigned long long n = 0;
+    unsigned long k = 0;
+    if (position) {
+        char *end;
+        n = strtoull(position, &end, 10);
+        if (end == position || *end != ':' || (k = strtoul(end + 1, &end, 10), *end != '\0')) {
+            fprintf(stderr, "Error: Invalid field position '%s'; expected <n>:<k>.\n", position);
+            exit(1);
+        }
+    }
+
+    struct timespec started, loaded;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    cte_field_index_file_t file;
+    if (!cte_field_index_load(&file, input_file)) {
+        perror("Error loading field index");
+        exit(1);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &loaded);
+    double seconds = (double)(loaded.tv_sec - started.tv_sec) + (double)(loaded.tv_nsec - started.tv_nsec) / 1e9;
+    fprintf(stderr, "Field index of %s: %llu transactions, %llu fields (%zu bytes), %s in %.3f s.\n", input_file,
+            (unsigned long long)file.index.transaction_count, (unsigned long long)file.index.field_count,
+            file.index.size, file.rebuilt ? "rebuilt" : "up to date", seconds);
+    if (file.rebuilt && !file.persisted) {
+        fprintf(stderr, "Note: Could not write %s%s; the index was built in memory only.\n", input_file,
+                CTE_FIELD_INDEX_SUFFIX);
+    }
+    if (file.index.flags & CTE_FIELD_INDEX_PARTIAL) {
+        fprintf(stderr, "Note: Framing damage stopped indexing before the end of the archive.\n");
+    }
+
+    static out_buffer_t out;
+    cte_field_index_field_t field;
+    if (types) {
+        cte_field_index_cursor_t cursor = {0};
+        while (cte_field_index_next(&file.index, &cursor, types, &field)) {
+            out_indexed_field(&out, file.archive, &field);
+        }
+    } else if (position) {
+        if (!cte_field_index_get_field(&file.index, n, k, &field)) {
+            fprintf(stderr, "Error: Transaction %llu has no field %lu.\n", n, k);
+            exit(1);
+        }
+        out_indexed_field(&out, file.archive, &field);
+    }
+    out_flush(&out);
+    cte_field_index_unload(&file);
+}
+
+/**
+ * @brief Request types of the 'serve' protocol.
+ */
+enum {
+    SERVE_ENCODE = 'E',   /**< Payload: one line of field specs. Reply: the transaction. */
+    SERVE_TEXT = 'T',     /**< Payload: a transaction. Reply: labelled text lines. */
+    SERVE_COMPACT = 'C',  /**< Payload: a transaction. Reply: one line of field specs. */
+    SERVE_JSON = 'J',     /**< Payload: a transaction. Reply: one JSON line. */
+    SERVE_VALIDATE = 'V', /**< Payload: a transaction. Reply: empty. */
+};
+
+/**
+ * @brief One 'serve' thread and the contexts it reuses for every request.
+ */
+typedef struct {
+    pthread_t thread;
+    int listener;
+    int poll;             /**< The epoll instance shared by all workers. */
+    cte_encoder_t *enc;   /**< Room for a maximum transaction plus one more field. */
+    out_buffer_t *render; /**< Decoded output of the current request. */
+    uint8_t *reply;       /**< Replies not yet sent. */
+    size_t reply_size;
+    char *spec;           /**< NUL-terminated copy of an encode request. */
+} serve_worker_t;
+
+// Requests served by all threads, for the shutdown summary.
+static atomic_size_t serve_requests;
+static atomic_size_t serve_connections;
+
+/**
+ * @brief One 'serve' client connection.
+ *
+ * Registered with EPOLLONESHOT, so only the worker that took its readiness
+ * touches it until that worker re-arms it.
+ */
+typedef struct {
+    int fd;
+    uint8_t *in;     /**< Bytes received but not yet answered. */
+    size_t have;     /**< Bytes used in `in`. */
+    size_t capacity; /**< Allocated size of `in`; grows up to SERVE_IN_SIZE. */
+} serve_client_t;
+
+/** @brief Largest input buffer: one request of the largest size and its length. */
+#define SERVE_IN_SIZE (SERVE_MAX_MESSAGE + 16)
+/** @brief Smallest free space in a client's input buffer before a read. */
+#define SERVE_READ_SIZE 4096
+/** @brief Seconds a reply may wait for a client that does not read before it is dropped. */
+#define SERVE_SEND_TIMEOUT 10
+/** @brief Reply buffer size; replies to pipelined requests are sent together. */
+#define SERVE_REPLY_SIZE (4 * SERVE_MAX_MESSAGE)
+
+/**
+ * @brief Sends all bytes, retrying short writes.
+ * @return false if the peer went away.
+ */
+bool send_all(int fd, const uint8_t *data, size_t size) {
+    while (size > 0) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * @brief Appends one framed reply.
+ * @param worker The worker; its reply buffer has room for SERVE_MAX_MESSAGE + 4 bytes.
+ * @param status 0 for success, 1 for an error.
+ * @param body The result or error message.
+ * @param size The size of `body`, at most SERVE_MAX_MESSAGE - 1.
+ */
+void serve_reply(serve_worker_t *worker, uint8_t status, const void *body, size_t size) {
+    uint8_t *frame = worker->reply + worker->reply_size;
+    size_t length = size + 1;
+    size_t header = 0;
+    do {
+        frame[header] = (uint8_t)((length & 0x7F) | (length > 0x7F ? 0x80 : 0));
+        length >>= 7;
+        header++;
+    } while (length);
+    frame[header] = status;
+    memcpy(frame + header + 1, body, size);
+    worker->reply_size += header + 1 + size;
+}
+
+/**
+ * @brief Appends an error reply with a formatted message.
+ */
+void serve_error(serve_worker_t *worker, const char *format, ...) {
+    char message[320];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    if (length < 0) {
+        length = 0;
+    }
+    serve_reply(worker, 1, message, (size_t)length < sizeof(message) ? (size_t)length : sizeof(message) - 1);
+}
+
+/**
+ * @brief Answers one request; errors are replies, never exits.
+ * @param worker The worker.
+ * @param request The type byte followed by the payload.
+ * @param size The size of `request`, at most SERVE_MAX_MESSAGE.
+ */
+void serve_request(serve_worker_t *worker, const uint8_t *request, size_t size) {
+    atomic_fetch_add_explicit(&serve_requests, 1, memory_order_relaxed);
+    if (size == 0) {
+        serve_error(worker, "Empty request");
+        return;
+    }
+    const uint8_t *data = request + 1;
+    size--;
+
+    if (request[0] == SERVE_ENCODE) {
+        char error[256];
+        memcpy(worker->spec, data, size);
+        worker->spec[size] = '\0';
+        cte_encoder_reset(worker->enc);
+        char *save = NULL;
+        for (char *token = strtok_r(worker->spec, " \t\r\n", &save); token; token = strtok_r(NULL, " \t\r\n", &save)) {
+            // The encoder has room for one field past the limit, so it can never overflow.
+            if (cte_encoder_get_size(worker->enc) > CTE_MAX_TRANSACTION_SIZE) {
+                break;
+            }
+            if (!parse_field(worker->enc, token, error, sizeof(error))) {
+                serve_error(worker, "%s", error);
+                return;
+            }
+        }
+        size_t encoded = cte_encoder_get_size(worker->enc);
+        if (encoded > CTE_MAX_TRANSACTION_SIZE) {
+            serve_error(worker, "Transaction exceeds %d bytes", CTE_MAX_TRANSACTION_SIZE);
+            return;
+        }
+        serve_reply(worker, 0, cte_encoder_get_data(worker->enc), encoded);
+        return;
+    }
+
+    if (request[0] != SERVE_TEXT && request[0] != SERVE_COMPACT && request[0] != SERVE_JSON &&
+        request[0] != SERVE_VALIDATE) {
+        serve_error(worker, "Unknown request type 0x%02X", request[0]);
+        return;
+    }
+    // Validating first means the aborting decoder reads below cannot fail.
+    char reason[96];
+    size_t offset;
+    if (!verify_transaction(data, size, &offset, reason, sizeof(reason))) {
+        serve_error(worker, "Byte %zu: %s", offset, reason);
+        return;
+    }
+    out_buffer_t *render = worker->render;
+    render->size = 0;
+    if (request[0] == SERVE_JSON) {
+        render->size = cte_json_from_cte(data, size, render->data, OUT_BUFFER_SIZE);
+    } else if (request[0] != SERVE_VALIDATE) {
+        out_transaction(render, request[0] == SERVE_TEXT ? FORMAT_TEXT : FORMAT_COMPACT, 0, data, size);
+    }
+    if (render->size >= SERVE_MAX_MESSAGE) {
+        serve_error(worker, "Reply exceeds %d bytes", SERVE_MAX_MESSAGE);
+        return;
+    }
+    serve_reply(worker, 0, render->data, render->size);
+}
+
+/**
+ * @brief Reads what a client has sent and answers every complete request.
+ *
+ * Every complete request in a read is answered, and the replies are sent
+ * with one write, so pipelining clients need few system calls. The read
+ * does not wait: a partial request stays buffered until more arrives.
+ *
+ * @return false if the connection is closed or broken and should be dropped.
+ */
+bool serve_client_input(serve_worker_t *worker, serve_client_t *client) {
+    if (client->capacity - client->have < SERVE_READ_SIZE && client->capacity < SERVE_IN_SIZE) {
+        size_t capacity = client->capacity ? 2 * client->capacity : SERVE_READ_SIZE;
+        capacity = capacity < SERVE_IN_SIZE ? capacity : SERVE_IN_SIZE;
+        uint8_t *in = realloc(client->in, capacity);
+        if (!in) {
+            return false;
+        }
+        client->in = in;
+        client->capacity = capacity;
+    }
+    ssize_t n = recv(client->fd, client->in + client->have, client->capacity - client->have, MSG_DONTWAIT);
+    if (n < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    if (n == 0) {
+        return false;
+    }
+    client->have += (size_t)n;
+
+    size_t offset = 0;
+    bool fatal = false;
+    worker->reply_size = 0;
+    while (offset < client->have) {
+        size_t start = offset;
+        size_t length;
+        if (!read_frame_length(client->in, client->have, &offset, &length)) {
+            // Fewer than 10 bytes may just be an incomplete length.
+            fatal = client->have - start >= 10;
+            offset = start;
+            break;
+        }
+        if (length > SERVE_MAX_MESSAGE) {
+            serve_error(worker, "Request exceeds %d bytes", SERVE_MAX_MESSAGE);
+            fatal = true;
+            break;
+        }
+        if (length > client->have - offset) {
+            offset = start;
+            break;
+        }
+        serve_request(worker, client->in + offset, length);
+        offset += length;
+        if (SERVE_REPLY_SIZE - worker->reply_size < SERVE_MAX_MESSAGE + 4) {
+            if (!send_all(client->fd, worker->reply, worker->reply_size)) {
+                return false;
+            }
+            worker->reply_size = 0;
+        }
+    }
+    if (!send_all(client->fd, worker->reply, worker->reply_size) || fatal) {
+        return false;
+    }
+    memmove(client->in, client->in + offset, client->have - offset);
+    client->have -= offset;
+    return true;
+}
+
+/**
+ * @brief Accepts every pending connection and registers it for input.
+ * @param worker The worker whose turn it is to accept.
+ * @note This function exits on error.
+ */
+void serve_accept(serve_worker_t *worker) {
+    for (;;) {
+        int fd = accept(worker->listener, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EMFILE || errno == ENFILE) {
+                return;
+            }
+            perror("Error accepting connection");
+            exit(1);
+        }
+        // Replies are sent blocking; a client that stops reading them is dropped rather than holding a worker.
+        struct timeval timeout = {SERVE_SEND_TIMEOUT, 0};
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        serve_client_t *client = calloc(1, sizeof(serve_client_t));
+        struct epoll_event event = {EPOLLIN | EPOLLRDHUP | EPOLLONESHOT, {.ptr = client}};
+        if (!client || epoll_ctl(worker->poll, EPOLL_CTL_ADD, fd, &event) != 0) {
+            free(client);
+            close(fd);
+            continue;
+        }
+        client->fd = fd;
+        atomic_fetch_add_explicit(&serve_connections, 1, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Waits for a new connection or a client with input, and serves it.
+ *
+ * All workers wait on one epoll instance. A client is armed for a single
+ * event at a time, so its requests are answered in order by whichever
+ * worker is free, and an idle client costs no thread.
+ *
+ * @param arg The `serve_worker_t`.
+ * @return NULL.
+ */
+void *serve_worker(void *arg) {
+    serve_worker_t *worker = arg;
+    for (;;) {
+        struct epoll_event event;
+        int ready = epoll_wait(worker->poll, &event, 1, -1);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready < 0) {
+            perror("Error waiting for connections");
+            exit(1);
+        }
+        serve_client_t *client = event.data.ptr;
+        if (!client) {
+            serve_accept(worker);
+            continue;
+        }
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        if (!serve_client_input(worker, client) ||
+            epoll_ctl(worker->poll, EPOLL_CTL_MOD, client->fd, &event) != 0) {
+            close(client->fd);
+            free(client->in);
+            free(client);
+        }
+    }
+}
+
+/**
+ * @brief Handles the 'serve' command for the CTE tool.
+ *
+ * Each thread owns an encoder and output buffers that it reuses for every
+ * request, so a request costs a read, the codec work and a write. The
+ * threads share one epoll instance holding the listener and every client,
+ * so any number of open connections is served by the pool; clients should
+ * keep connections open rather than connect per request.
+ * SIGINT or SIGTERM removes the socket and exits.
+ *
+ * @param argc The argument count from main.
+ * @param argv The argument vector from main.
+ * @note This function exits on error and does not return.
+ */
+void do_serve(int argc, char *argv[]) {
+    const char *socket_path = NULL;
+    long thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+    int first_arg_index = 2;
+
+    while (first_arg_index < argc && argv[first_arg_index][0] == '-') {
+        if (first_arg_index + 1 >= argc) {
+            fprintf(stderr, "Error: %s option requires an argument.\n", argv[first_arg_index]);
+            exit(1);
+        }
+        if (strcmp(argv[first_arg_index], "-s") == 0) {
+            socket_path = argv[first_arg_index + 1];
+        } else if (strcmp(argv[first_arg_index], "-j") == 0) {
+            thread_count = strtol(argv[first_arg_index + 1], NULL, 0);
+            if (thread_count < 1 || thread_count > 256) {
+                fprintf(stderr, "Error: Invalid thread count. Must be between 1 and 256.\n");
                 exit(1);
+            }
+        } else {
+            fprintf(stderr, "Error: Unknown option '%s'.\n", argv[first_arg_index]);
+            exit(1);
+        }
+        first_arg_index += 2;
+    }
+    if (first_arg_index < argc || !socket_path) {
+        fprintf(stderr, "Error: 'serve' requires -s <path>.\n");
+        exit(1);
+    }
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Error: Socket path is too long.\n");
+        exit(1);
+    }
+    strcpy(address.sun_path, socket_path);
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (listener < 0) {
+        perror("Error creating socket");
+        exit(1);
+    }
+    // Replace a socket left behind by a daemon that died, but not a live one.
+    struct stat st;
+    if (stat(socket_path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (probe >= 0 && connect(probe, (struct sockaddr *)&address, sizeof(address)) == 0) {
+            fprintf(stderr, "Error: Another process is serving on '%s'.\n", socket_path);
+            exit(1);
+        }
+        if (probe >= 0) {
+            close(probe);
+        }
+        unlink(socket_path);
+    }
+    if (bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0) {
+        perror("Error binding socket");
+        exit(1);
+    }
+
+    // Only one worker is woken per pending connection; the listener stays armed.
+    int poll = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event listen_event = {EPOLLIN | EPOLLEXCLUSIVE, {.ptr = NULL}};
+    if (poll < 0 || epoll_ctl(poll, EPOLL_CTL_ADD, listener, &listen_event) != 0) {
+        perror("Error creating epoll instance");
+        exit(1);
+    }
+
+    // Only this thread takes the shutdown signals; the workers inherit the mask.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+    serve_worker_t *workers = calloc((size_t)thread_count, sizeof(serve_worker_t));
+    if (!workers) {
+        fprintf(stderr, "Error: Out of memory.\n");
+        exit(1);
+    }
+    for (long t = 0; t < thread_count; t++) {
+        serve_worker_t *worker = &workers[t];
+        worker->listener = listener;
+        worker->poll = poll;
+        worker->enc = cte_encoder_init(CTE_MAX_TRANSACTION_SIZE + SERVE_FIELD_ROOM);
+        worker->render = malloc(sizeof(out_buffer_t));
+        worker->reply = malloc(SERVE_REPLY_SIZE);
+        worker->spec = malloc(SERVE_MAX_MESSAGE + 1);
+        if (!worker->render || !worker->reply || !worker->spec) {
+            fprintf(stderr, "Error: Out of memory.\n");
+            exit(1);
+        }
+        if (pthread_create(&worker->thread, NULL, serve_worker, worker) != 0) {
+            fprintf(stderr, "Error: Failed to start worker thread.\n");
+            exit(1);
         }
     }
+    fprintf(stderr, "Serving on %s with %ld threads.\n", socket_path, thread_count);
 
-    printf("--------------------------------------\n");
-    printf("Successfully decoded all fields.\n");
+    int signal_number;
+    sigwait(&signals, &signal_number);
+    unlink(socket_path);
+    fprintf(stderr, "Served %zu requests on %zu connections.\n", atomic_load(&serve_requests),
+            atomic_load(&serve_connections));
+    exit(0);
 }
 
 /**
@@ -450,6 +3402,18 @@ int main(int argc, char *argv[]) {
         do_write(argc, argv);
     } else if (strcmp(command, "read") == 0) {
         do_read(argc, argv);
+    } else if (strcmp(command, "batch") == 0) {
+        do_batch(argc, argv);
+    } else if (strcmp(command, "verify") == 0) {
+        do_verify(argc, argv);
+    } else if (strcmp(command, "pack") == 0) {
+        do_pack(argc, argv);
+    } else if (strcmp(command, "log") == 0) {
+        do_log(argc, argv);
+    } else if (strcmp(command, "index") == 0) {
+        do_index(argc, argv);
+    } else if (strcmp(command, "serve") == 0) {
+        do_serve(argc, argv);
     } else {
         fprintf(stderr, "Error: Unknown command '%s'\n", command);
         print_usage();
@@ -262,6 +262,18 @@ static size_t _parse_command_data_header(const cte_decoder_t *decoder, size_t *o
     return length;
 }
 
+/**
+ * @struct decoder_block
+ * @brief The allocation behind a decoder handle: the context followed by the
+ * allocator that owns it, so `cte_decoder_free()` can release both.
+ */
+typedef struct decoder_block
+{
+    cte_decoder_t handle; /**< Must stay first; the handle points here. */
+    bool has_allocator;
+    cte_allocator_t allocator;
+} decoder_block_t;
+
 /**
  * @brief Initializes a new CTE decoder context and its buffer.
  *
@@ -275,6 +287,24 @@ static size_t _parse_command_data_header(const cte_decoder_t *decoder, size_t *o
  */
 LEA_EXPORT(cte_decoder_init)
 cte_decoder_t *cte_decoder_init(size_t size)
+{
+    return cte_decoder_init_with_allocator(size, NULL);
+}
+
+/**
+ * @brief Initializes a new CTE decoder context using custom allocation hooks.
+ *
+ * The context and its buffer are both allocated through `allocator`, which is
+ * copied into the context and used again by `cte_decoder_free()`.
+ *
+ * @param size The exact size in bytes of the CTE data that will be loaded.
+ * @param allocator The allocation hooks, or NULL for stdlea `malloc`.
+ * @return A pointer to the newly created decoder context.
+ * @note This function will abort via `lea_abort` if size is 0 or exceeds
+ * `CTE_MAX_TRANSACTION_SIZE`, or if an allocation fails.
+ */
+LEA_EXPORT(cte_decoder_init_with_allocator)
+cte_decoder_t *cte_decoder_init_with_allocator(size_t size, const cte_allocator_t *allocator)
 {
     if (size == 0)
     {
@@ -285,8 +315,15 @@ cte_decoder_t *cte_decoder_init(size_t size)
         lea_abort("Initial buffer size exceeds max transaction size");
     }
 
-    cte_decoder_t *decoder = malloc(sizeof(cte_decoder_t));
-    decoder->data = malloc(size);
+    decoder_block_t *block = cte_allocate(allocator, sizeof(decoder_block_t), _Alignof(decoder_block_t));
+    block->has_allocator = allocator != NULL;
+    if (allocator)
+    {
+        block->allocator = *allocator;
+    }
+
+    cte_decoder_t *decoder = &block->handle;
+    decoder->data = cte_allocate(allocator, size, 1);
     decoder->size = size;
     decoder->position = 0;
     decoder->last_list_count = 0;
@@ -295,6 +332,69 @@ cte_decoder_t *cte_decoder_init(size_t size)
     return decoder;
 }
 
+/**
+ * @brief Releases a decoder context and its buffer.
+ *
+ * After this call the handle and any pointers returned by the read functions
+ * (list data, command payloads) are invalid. Passing NULL is a no-op.
+ *
+ * @param decoder A pointer to the decoder context to release.
+ */
+LEA_EXPORT(cte_decoder_free)
+void cte_decoder_free(cte_decoder_t *decoder)
+{
+    if (!decoder)
+    {
+        return;
+    }
+    decoder_block_t *block = (decoder_block_t *)decoder;
+    cte_allocator_t allocator;
+    const cte_allocator_t *hooks = NULL;
+    if (block->has_allocator)
+    {
+        allocator = block->allocator;
+        hooks = &allocator;
+    }
+    cte_deallocate(hooks, decoder->data, decoder->size, 1);
+    cte_deallocate(hooks, block, sizeof(decoder_block_t), _Alignof(decoder_block_t));
+}
+
+/**
+ * @brief Returns a decoder that reads caller-owned bytes in place.
+ *
+ * The view borrows `data`: nothing is copied or allocated, and the decoder
+ * never writes through its data pointer. Use it instead of initializing a
+ * `cte_decoder_t` by hand. A view must not be passed to `cte_decoder_free()`
+ * or `cte_decoder_load()`, which only apply to contexts from `cte_decoder_init()`.
+ *
+ * @param data The encoded transaction; it must outlive the view.
+ * @param size The number of bytes at `data`.
+ * @param position The read position: 0 to validate the version byte on the
+ * first peek, 1 to start after a version byte already checked, or the offset
+ * of any field.
+ * @return The view, with no list or command read yet.
+ * @note Aborts via `lea_abort` if `data` is NULL or `position` lies past `size`.
+ */
+LEA_EXPORT(cte_decoder_view)
+cte_decoder_t cte_decoder_view(const uint8_t *data, size_t size, size_t position)
+{
+    if (!data)
+    {
+        lea_abort("Null data in decoder_view");
+    }
+    if (position > size)
+    {
+        lea_abort("View position past end of buffer");
+    }
+    cte_decoder_t view;
+    view.data = (uint8_t *)data;
+    view.size = size;
+    view.position = position;
+    view.last_list_count = 0;
+    view.last_cmd_len = 0;
+    return view;
+}
+
 /**
  * @brief Returns a writable pointer to the decoder's internal buffer.
  *
@@ -863,3 +963,699 @@ size_t cte_decoder_get_last_command_payload_length(const cte_decoder_t *decoder)
     }
     return decoder->last_cmd_len;
 }
+
+/**
+ * @brief Reads and consumes the next field into a generic descriptor.
+ *
+ * Dispatches on a type from `cte_decoder_peek_type()` to the matching typed
+ * read and fills `field` with its offset, list count, payload pointer and
+ * length, or scalar value. Payload and list pointers refer to the decoder's
+ * buffer.
+ *
+ * @param decoder A pointer to the decoder context.
+ * @param type The `CTE_PEEK_TYPE_*` identifier of the next field.
+ * @param field Receives the field; members that do not apply to `type` are zeroed.
+ * @note Aborts via `lea_abort` on a reserved or mismatched type, malformed
+ * data or insufficient data, like the typed reads.
+ */
+LEA_EXPORT(cte_decoder_read_field)
+void cte_decoder_read_field(cte_decoder_t *decoder, int type, cte_field_t *field)
+{
+    if (!decoder || !field)
+    {
+        lea_abort("Null argument to read_field");
+    }
+    field->type = type;
+    field->offset = decoder->position;
+    field->count = 0;
+    field->data = NULL;
+    field->length = 0;
+    field->value.u64 = 0;
+
+    switch (type)
+    {
+    case CTE_PEEK_TYPE_PK_LIST_ED25519:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_128F:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_192F:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_256F:
+        field->data = cte_decoder_read_public_key_list_data(decoder);
+        field->count = decoder->last_list_count;
+        field->length = decoder->position - field->offset - 1;
+        break;
+    case CTE_PEEK_TYPE_SIG_LIST_ED25519:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_128F:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_192F:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_256F:
+        field->data = cte_decoder_read_signature_list_data(decoder);
+        field->count = decoder->last_list_count;
+        field->length = decoder->position - field->offset - 1;
+        break;
+    case CTE_PEEK_TYPE_IXDATA_LEGACY_INDEX:
+        field->value.u64 = cte_decoder_read_ixdata_index_reference(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_VARINT_ZERO:
+        cte_decoder_read_ixdata_varint_zero(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_ULEB128:
+        field->value.u64 = cte_decoder_read_ixdata_uleb128(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_SLEB128:
+        field->value.i64 = cte_decoder_read_ixdata_sleb128(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_INT8:
+        field->value.i64 = cte_decoder_read_ixdata_int8(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_INT16:
+        field->value.i64 = cte_decoder_read_ixdata_int16(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_INT32:
+        field->value.i64 = cte_decoder_read_ixdata_int32(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_INT64:
+        field->value.i64 = cte_decoder_read_ixdata_int64(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_UINT8:
+        field->value.u64 = cte_decoder_read_ixdata_uint8(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_UINT16:
+        field->value.u64 = cte_decoder_read_ixdata_uint16(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_UINT32:
+        field->value.u64 = cte_decoder_read_ixdata_uint32(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_UINT64:
+        field->value.u64 = cte_decoder_read_ixdata_uint64(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_FLOAT32:
+        field->value.f32 = cte_decoder_read_ixdata_float32(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_FLOAT64:
+        field->value.f64 = cte_decoder_read_ixdata_float64(decoder);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_CONST_FALSE:
+    case CTE_PEEK_TYPE_IXDATA_CONST_TRUE:
+        field->value.boolean = cte_decoder_read_ixdata_boolean(decoder);
+        break;
+    case CTE_PEEK_TYPE_CMD_SHORT:
+    case CTE_PEEK_TYPE_CMD_EXTENDED:
+        field->data = cte_decoder_read_command_data_payload(decoder);
+        field->length = decoder->last_cmd_len;
+        break;
+    default:
+        lea_abort("Reserved or unknown field type");
+    }
+}
+
+/**
+ * @brief Captures the decoder's position and last list/command lengths.
+ *
+ * Together with `cte_decoder_restore()` this lets a caller read ahead, for
+ * example to try one layout and fall back to another, then rewind.
+ *
+ * @param decoder A pointer to the decoder context.
+ * @return The snapshot; it is only valid for the same decoder and buffer.
+ * @note Aborts via `lea_abort` if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_snapshot)
+cte_decoder_snapshot_t cte_decoder_snapshot(const cte_decoder_t *decoder)
+{
+    if (!decoder)
+    {
+        lea_abort("Null decoder handle in snapshot");
+    }
+    cte_decoder_snapshot_t snapshot = {decoder->position, decoder->last_list_count, decoder->last_cmd_len};
+    return snapshot;
+}
+
+/**
+ * @brief Rewinds the decoder to a state taken by `cte_decoder_snapshot()`.
+ * @param decoder A pointer to the decoder context.
+ * @param snapshot A snapshot of the same decoder.
+ * @note Aborts via `lea_abort` if `decoder` is NULL or the snapshot lies past the end of its buffer.
+ */
+LEA_EXPORT(cte_decoder_restore)
+void cte_decoder_restore(cte_decoder_t *decoder, cte_decoder_snapshot_t snapshot)
+{
+    if (!decoder)
+    {
+        lea_abort("Null decoder handle in restore");
+    }
+    if (snapshot.position > decoder->size)
+    {
+        lea_abort("Snapshot position past end of buffer");
+    }
+    decoder->position = snapshot.position;
+    decoder->last_list_count = snapshot.last_list_count;
+    decoder->last_cmd_len = snapshot.last_cmd_len;
+}
+
+/**
+ * @brief Returns the size of a terminated LEB128 sequence of at most 10 bytes.
+ * @param data The first byte of the sequence.
+ * @param available The number of bytes at `data`.
+ * @param is_signed Whether the value is SLEB128 (no 64-bit overflow check on the last byte).
+ * @return The number of bytes, or 0 if the sequence is truncated or invalid.
+ * @note Internal helper function. Mirrors `_decode_uleb128()` / `_decode_sleb128()`.
+ */
+static size_t _leb128_size(const uint8_t *data, size_t available, bool is_signed)
+{
+    for (size_t i = 0; i < 10 && i < available; ++i)
+    {
+        if (!is_signed && i == 9 && (data[i] & 0xFE) != 0)
+        {
+            return 0;
+        }
+        if (!(data[i] & 0x80))
+        {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/** @brief Value sizes of the IxData fixed types, indexed from `CTE_PEEK_TYPE_IXDATA_INT8`. */
+static const uint8_t fixed_type_size[10] = {1, 2, 4, 8, 1, 2, 4, 8, 4, 8};
+
+/**
+ * @brief Checks, without aborting, that the next field is well-formed and its
+ * peek type lies in [`first_type`, `last_type`].
+ * @return `true` if the matching read function cannot abort.
+ * @note Internal helper function. On success a decoder still at position 0 is
+ * moved past the version byte; on failure the decoder is untouched.
+ */
+static bool _try_field(cte_decoder_t *decoder, int first_type, int last_type)
+{
+    if (!decoder)
+    {
+        lea_abort("Null decoder handle in try_read");
+    }
+    // CTE_PEEK_EOF and reserved codes (-1) are never a readable field, even if the caller asks for one.
+    if (first_type < 0 || last_type > CTE_PEEK_TYPE_CMD_EXTENDED)
+    {
+        return false;
+    }
+    size_t position = decoder->position;
+    if (position == 0)
+    {
+        if (decoder->size == 0 || decoder->data[0] != CTE_VERSION_BYTE)
+        {
+            return false;
+        }
+        position = 1;
+    }
+    cte_decoder_t probe = cte_decoder_view(decoder->data, decoder->size, position);
+    int type = cte_decoder_peek_type(&probe);
+    if (type < first_type || type > last_type)
+    {
+        return false; // also rejects CTE_PEEK_EOF and reserved codes (-1)
+    }
+
+    const uint8_t *p = decoder->data + position;
+    size_t available = decoder->size - position;
+    uint8_t N = (p[0] >> 2) & 0x0F;
+    size_t needed = 1;
+    switch (type)
+    {
+    case CTE_PEEK_TYPE_PK_LIST_ED25519:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_128F:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_192F:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_256F:
+        needed += N * get_public_key_size(p[0] & CTE_CRYPTO_TYPE_MASK);
+        if (N == 0)
+        {
+            return false;
+        }
+        break;
+    case CTE_PEEK_TYPE_SIG_LIST_ED25519:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_128F:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_192F:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_256F:
+        needed += N * get_signature_item_size(p[0] & CTE_CRYPTO_TYPE_MASK);
+        if (N == 0)
+        {
+            return false;
+        }
+        break;
+    case CTE_PEEK_TYPE_IXDATA_ULEB128:
+    case CTE_PEEK_TYPE_IXDATA_SLEB128:
+    {
+        size_t varint_size = _leb128_size(p + 1, available - 1, type == CTE_PEEK_TYPE_IXDATA_SLEB128);
+        if (varint_size == 0)
+        {
+            return false;
+        }
+        needed += varint_size;
+        break;
+    }
+    case CTE_PEEK_TYPE_CMD_SHORT:
+        needed += p[0] & CTE_COMMAND_SHORT_MAX_LEN;
+        break;
+    case CTE_PEEK_TYPE_CMD_EXTENDED:
+    {
+        if (!CHECK_PADDING_ZERO_PEEK(p[0], 0x03) || available < 2)
+        {
+            return false;
+        }
+        size_t length = ((size_t)(p[0] >> 2) & 0x07) << 8 | p[1];
+        if (length < CTE_COMMAND_EXTENDED_MIN_LEN || length > CTE_COMMAND_EXTENDED_MAX_LEN)
+        {
+            return false;
+        }
+        needed = 2 + length;
+        break;
+    }
+    default:
+        if (type >= CTE_PEEK_TYPE_IXDATA_INT8 && type <= CTE_PEEK_TYPE_IXDATA_FLOAT64)
+        {
+            needed += fixed_type_size[type - CTE_PEEK_TYPE_IXDATA_INT8];
+        }
+        break;
+    }
+    if (needed > available)
+    {
+        return false;
+    }
+    decoder->position = position;
+    return true;
+}
+
+/**
+ * @brief Reads the next field into a generic descriptor without aborting.
+ *
+ * The non-aborting counterpart of `cte_decoder_read_field()`: the field is
+ * checked in full (type, header, length and bounds) before anything is consumed.
+ *
+ * @param decoder A pointer to the decoder context.
+ * @param type The expected `CTE_PEEK_TYPE_*` identifier.
+ * @param field Receives the field on success.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, reserved, malformed or truncated, in which case the decoder position
+ * is unchanged and `field` is not written.
+ * @note A decoder still at position 0 is moved past the version byte only on success.
+ * Aborts via `lea_abort` only if `decoder` or `field` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_field)
+bool cte_decoder_try_read_field(cte_decoder_t *decoder, int type, cte_field_t *field)
+{
+    if (!field)
+    {
+        lea_abort("Null argument to try_read_field");
+    }
+    if (!_try_field(decoder, type, type))
+    {
+        return false;
+    }
+    cte_decoder_read_field(decoder, type, field);
+    return true;
+}
+
+/**
+ * @brief Reads a Public Key List field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives a read-only pointer to the key data within the decoder's buffer.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_public_key_list_data)
+bool cte_decoder_try_read_public_key_list_data(cte_decoder_t *decoder, const uint8_t **out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_PK_LIST_ED25519, CTE_PEEK_TYPE_PK_LIST_SLH_256F))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_public_key_list_data(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads a Signature List field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives a read-only pointer to the signature data within the decoder's buffer.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_signature_list_data)
+bool cte_decoder_try_read_signature_list_data(cte_decoder_t *decoder, const uint8_t **out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_SIG_LIST_ED25519, CTE_PEEK_TYPE_SIG_LIST_SLH_256F))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_signature_list_data(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads an IxData Legacy Index Reference field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives the index (0-15).
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_ixdata_index_reference)
+bool cte_decoder_try_read_ixdata_index_reference(cte_decoder_t *decoder, uint8_t *out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_IXDATA_LEGACY_INDEX, CTE_PEEK_TYPE_IXDATA_LEGACY_INDEX))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_ixdata_index_reference(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads an IxData Varint zero field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_ixdata_varint_zero)
+bool cte_decoder_try_read_ixdata_varint_zero(cte_decoder_t *decoder)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_IXDATA_VARINT_ZERO, CTE_PEEK_TYPE_IXDATA_VARINT_ZERO))
+    {
+        return false;
+    }
+    cte_decoder_read_ixdata_varint_zero(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads an IxData ULEB128 field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives the decoded value.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_ixdata_uleb128)
+bool cte_decoder_try_read_ixdata_uleb128(cte_decoder_t *decoder, uint64_t *out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_IXDATA_ULEB128, CTE_PEEK_TYPE_IXDATA_ULEB128))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_ixdata_uleb128(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads an IxData SLEB128 field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives the decoded value.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_ixdata_sleb128)
+bool cte_decoder_try_read_ixdata_sleb128(cte_decoder_t *decoder, int64_t *out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_IXDATA_SLEB128, CTE_PEEK_TYPE_IXDATA_SLEB128))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_ixdata_sleb128(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads an IxData signed 8-bit integer field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives the decoded value.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_ixdata_int8)
+bool cte_decoder_try_read_ixdata_int8(cte_decoder_t *decoder, int8_t *out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_IXDATA_INT8, CTE_PEEK_TYPE_IXDATA_INT8))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_ixdata_int8(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads an IxData signed 16-bit integer field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives the decoded value.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_ixdata_int16)
+bool cte_decoder_try_read_ixdata_int16(cte_decoder_t *decoder, int16_t *out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_IXDATA_INT16, CTE_PEEK_TYPE_IXDATA_INT16))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_ixdata_int16(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads an IxData signed 32-bit integer field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives the decoded value.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_ixdata_int32)
+bool cte_decoder_try_read_ixdata_int32(cte_decoder_t *decoder, int32_t *out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_IXDATA_INT32, CTE_PEEK_TYPE_IXDATA_INT32))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_ixdata_int32(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads an IxData signed 64-bit integer field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives the decoded value.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_ixdata_int64)
+bool cte_decoder_try_read_ixdata_int64(cte_decoder_t *decoder, int64_t *out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_IXDATA_INT64, CTE_PEEK_TYPE_IXDATA_INT64))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_ixdata_int64(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads an IxData unsigned 8-bit integer field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives the decoded value.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_ixdata_uint8)
+bool cte_decoder_try_read_ixdata_uint8(cte_decoder_t *decoder, uint8_t *out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_IXDATA_UINT8, CTE_PEEK_TYPE_IXDATA_UINT8))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_ixdata_uint8(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads an IxData unsigned 16-bit integer field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives the decoded value.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_ixdata_uint16)
+bool cte_decoder_try_read_ixdata_uint16(cte_decoder_t *decoder, uint16_t *out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_IXDATA_UINT16, CTE_PEEK_TYPE_IXDATA_UINT16))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_ixdata_uint16(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads an IxData unsigned 32-bit integer field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives the decoded value.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_ixdata_uint32)
+bool cte_decoder_try_read_ixdata_uint32(cte_decoder_t *decoder, uint32_t *out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_IXDATA_UINT32, CTE_PEEK_TYPE_IXDATA_UINT32))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_ixdata_uint32(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads an IxData unsigned 64-bit integer field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives the decoded value.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_ixdata_uint64)
+bool cte_decoder_try_read_ixdata_uint64(cte_decoder_t *decoder, uint64_t *out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_IXDATA_UINT64, CTE_PEEK_TYPE_IXDATA_UINT64))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_ixdata_uint64(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads an IxData 32-bit float field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives the decoded value.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_ixdata_float32)
+bool cte_decoder_try_read_ixdata_float32(cte_decoder_t *decoder, float *out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_IXDATA_FLOAT32, CTE_PEEK_TYPE_IXDATA_FLOAT32))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_ixdata_float32(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads an IxData 64-bit float field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives the decoded value.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_ixdata_float64)
+bool cte_decoder_try_read_ixdata_float64(cte_decoder_t *decoder, double *out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_IXDATA_FLOAT64, CTE_PEEK_TYPE_IXDATA_FLOAT64))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_ixdata_float64(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads an IxData boolean constant field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives the decoded value.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_ixdata_boolean)
+bool cte_decoder_try_read_ixdata_boolean(cte_decoder_t *decoder, bool *out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_IXDATA_CONST_FALSE, CTE_PEEK_TYPE_IXDATA_CONST_TRUE))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_ixdata_boolean(decoder);
+    return true;
+}
+
+/**
+ * @brief Reads a Command Data field without aborting.
+ * @param decoder A pointer to the decoder context.
+ * @param out Receives a read-only pointer to the payload within the decoder's buffer; its
+ * length is then available from `cte_decoder_get_last_command_payload_length()`.
+ * @return `true` on success; `false` if the next field is missing, of another
+ * type, malformed or truncated, in which case the decoder position is unchanged
+ * and `out` is not written.
+ * @note Never aborts on malformed input; aborts via `lea_abort` only if `decoder` is NULL.
+ */
+LEA_EXPORT(cte_decoder_try_read_command_data_payload)
+bool cte_decoder_try_read_command_data_payload(cte_decoder_t *decoder, const uint8_t **out)
+{
+    if (!_try_field(decoder, CTE_PEEK_TYPE_CMD_SHORT, CTE_PEEK_TYPE_CMD_EXTENDED))
+    {
+        return false;
+    }
+    *out = cte_decoder_read_command_data_payload(decoder);
+    return true;
+}
+
+LEA_EXPORT(cte_decoder_validate)
+bool cte_decoder_validate(const uint8_t *data, size_t size, size_t *offset)
+{
+    size_t position = 0;
+    bool valid = size >= 1 && size <= CTE_MAX_TRANSACTION_SIZE && data[0] == CTE_VERSION_BYTE;
+    if (valid)
+    {
+        // Past the version byte peeking never aborts, and the try reads reject what a read would abort on.
+        cte_decoder_t decoder = cte_decoder_view(data, size, 1);
+        cte_field_t field;
+        for (;;)
+        {
+            position = decoder.position;
+            int type = cte_decoder_peek_type(&decoder);
+            if (type == CTE_PEEK_EOF)
+            {
+                break;
+            }
+            if (!cte_decoder_try_read_field(&decoder, type, &field))
+            {
+                valid = false;
+                break;
+            }
+        }
+    }
+    if (offset)
+    {
+        *offset = valid ? 0 : position;
+    }
+    return valid;
+}
@@ -4,6 +4,10 @@
 #include "cte.h"
 #include <stdlea.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * @file decoder.h
  * @brief Defines the functions and structures for the CTE Decoder.
@@ -39,6 +43,51 @@ typedef struct
     size_t last_cmd_len;    /**< @param last_cmd_len Payload length of the last command data read. */
 } cte_decoder_t;
 
+/**
+ * @struct cte_decoder_snapshot
+ * @brief The mutable part of a decoder, saved for backtracking.
+ *
+ * Restoring a snapshot rewinds the decoder to the field it was taken at,
+ * including the last-read list count and command length.
+ */
+typedef struct cte_decoder_snapshot
+{
+    size_t position;        /**< @param position Saved read position. */
+    size_t last_list_count; /**< @param last_list_count Saved item count of the last list read. */
+    size_t last_cmd_len;    /**< @param last_cmd_len Saved payload length of the last command data read. */
+} cte_decoder_snapshot_t;
+
+/**
+ * @struct cte_field
+ * @brief A decoded field: its peek type plus a tagged view of its value.
+ *
+ * Which member is meaningful depends on `type`:
+ * - Public Key / Signature Lists: `count`, `data` and `length` (all items concatenated).
+ * - Command Data: `data` and `length` (the payload).
+ * - Legacy Index, Varint Zero, ULEB128 and unsigned fixed types: `value.u64`.
+ * - SLEB128 and signed fixed types: `value.i64`.
+ * - Float32 / Float64: `value.f32` / `value.f64`.
+ * - Boolean constants: `value.boolean`.
+ *
+ * `data` points into the decoder's buffer.
+ */
+typedef struct cte_field
+{
+    int type;            /**< @param type The `CTE_PEEK_TYPE_*` identifier of the field. */
+    size_t offset;       /**< @param offset Offset of the field's header byte in the transaction. */
+    size_t count;        /**< @param count Item count for lists. */
+    const uint8_t *data; /**< @param data List items or command payload, otherwise NULL. */
+    size_t length;       /**< @param length Number of bytes at `data`. */
+    union
+    {
+        uint64_t u64;
+        int64_t i64;
+        float f32;
+        double f64;
+        bool boolean;
+    } value; /**< @param value The scalar value, see above. */
+} cte_field_t;
+
 /**
  * @brief Initializes a new CTE decoder context and its buffer.
  *
@@ -52,6 +101,48 @@ typedef struct
  */
 cte_decoder_t *cte_decoder_init(size_t size);
 
+/**
+ * @brief Initializes a new CTE decoder context using custom allocation hooks.
+ *
+ * The context and its buffer are both allocated through `allocator`, which is
+ * copied into the context and used again by `cte_decoder_free()`.
+ *
+ * @param size The exact size in bytes of the CTE data that will be loaded.
+ * @param allocator The allocation hooks, or NULL for stdlea `malloc`.
+ * @return A pointer to the newly created decoder context.
+ * @note This function will abort via `lea_abort` if size is 0 or exceeds
+ * `CTE_MAX_TRANSACTION_SIZE`, or if an allocation fails.
+ */
+cte_decoder_t *cte_decoder_init_with_allocator(size_t size, const cte_allocator_t *allocator);
+
+/**
+ * @brief Releases a decoder context and its buffer.
+ *
+ * After this call the handle and any pointers returned by the read functions
+ * (list data, command payloads) are invalid. Passing NULL is a no-op.
+ *
+ * @param decoder A pointer to the decoder context to release.
+ */
+void cte_decoder_free(cte_decoder_t *decoder);
+
+/**
+ * @brief Returns a decoder that reads caller-owned bytes in place.
+ *
+ * The view borrows `data`: nothing is copied or allocated, and the decoder
+ * never writes through its data pointer. Use it instead of initializing a
+ * `cte_decoder_t` by hand. A view must not be passed to `cte_decoder_free()`
+ * or `cte_decoder_load()`, which only apply to contexts from `cte_decoder_init()`.
+ *
+ * @param data The encoded transaction; it must outlive the view.
+ * @param size The number of bytes at `data`.
+ * @param position The read position: 0 to validate the version byte on the
+ * first peek, 1 to start after a version byte already checked, or the offset
+ * of any field.
+ * @return The view, with no list or command read yet.
+ * @note Aborts via `lea_abort` if `data` is NULL or `position` lies past `size`.
+ */
+cte_decoder_t cte_decoder_view(const uint8_t *data, size_t size, size_t position);
+
 /**
  * @brief Returns a writable pointer to the decoder's internal buffer.
  *
@@ -116,6 +207,19 @@ size_t cte_decoder_get_last_list_count(const cte_decoder_t *decoder);
  */
 size_t cte_decoder_get_last_command_payload_length(const cte_decoder_t *decoder);
 
+/**
+ * @brief Reads the field of a given peek type into a `cte_field_t`.
+ *
+ * Dispatches to the matching `cte_decoder_read_*` function, so a generic
+ * decoding loop is just `peek_type` followed by this call.
+ *
+ * @param decoder A pointer to the decoder context.
+ * @param type The identifier returned by `cte_decoder_peek_type()` for this field.
+ * @param field The structure to fill.
+ * @warning Aborts on malformed data or if `type` is not a valid field type.
+ */
+void cte_decoder_read_field(cte_decoder_t *decoder, int type, cte_field_t *field);
+
 
 /**
  * @brief Peeks at a Public Key List header to read the key count.
@@ -250,4 +354,100 @@ bool cte_decoder_read_ixdata_boolean(cte_decoder_t *decoder);
  */
 const uint8_t *cte_decoder_read_command_data_payload(cte_decoder_t *decoder);
 
+/**
+ * @brief Saves the decoder's read state.
+ * @param decoder A pointer to the decoder context.
+ * @return The snapshot; pass it to `cte_decoder_restore()` to backtrack.
+ */
+cte_decoder_snapshot_t cte_decoder_snapshot(const cte_decoder_t *decoder);
+
+/**
+ * @brief Rewinds the decoder to a snapshot taken from it earlier.
+ * @param decoder A pointer to the decoder context.
+ * @param snapshot A snapshot returned by `cte_decoder_snapshot()` on the same decoder.
+ * @note Aborts via `lea_abort` if the snapshot lies outside the buffer.
+ */
+void cte_decoder_restore(cte_decoder_t *decoder, cte_decoder_snapshot_t snapshot);
+
+/**
+ * @name Non-aborting reads
+ * @brief Speculative counterparts of the read functions above.
+ *
+ * Each function checks, without aborting, that the next field has the
+ * expected type and is well-formed, with the same checks as the aborting
+ * read. If it is, the field is read and `true` is returned. Otherwise the
+ * function returns `false` and leaves the decoder untouched, so a parser can
+ * try another interpretation at the same position.
+ *
+ * Unlike the aborting reads, these may be called at position 0; the version
+ * byte is then validated and consumed together with the field.
+ * @{
+ */
+
+/**
+ * @brief Reads the next field if its peek type is exactly `type`.
+ * @param decoder A pointer to the decoder context.
+ * @param type The expected `CTE_PEEK_TYPE_*` identifier.
+ * @param field The structure to fill on success.
+ * @return `true` if the field was read.
+ */
+bool cte_decoder_try_read_field(cte_decoder_t *decoder, int type, cte_field_t *field);
+
+/** @brief Reads a Public Key List of any scheme; `*out` receives the key data. */
+bool cte_decoder_try_read_public_key_list_data(cte_decoder_t *decoder, const uint8_t **out);
+/** @brief Reads a Signature List of any scheme; `*out` receives the item data. */
+bool cte_decoder_try_read_signature_list_data(cte_decoder_t *decoder, const uint8_t **out);
+/** @brief Reads an IxData Legacy Index Reference field. */
+bool cte_decoder_try_read_ixdata_index_reference(cte_decoder_t *decoder, uint8_t *out);
+/** @brief Reads an IxData Varint Zero field. */
+bool cte_decoder_try_read_ixdata_varint_zero(cte_decoder_t *decoder);
+/** @brief Reads an IxData ULEB128 field. */
+bool cte_decoder_try_read_ixdata_uleb128(cte_decoder_t *decoder, uint64_t *out);
+/** @brief Reads an IxData SLEB128 field. */
+bool cte_decoder_try_read_ixdata_sleb128(cte_decoder_t *decoder, int64_t *out);
+/** @brief Reads an IxData signed 8-bit integer field. */
+bool cte_decoder_try_read_ixdata_int8(cte_decoder_t *decoder, int8_t *out);
+/** @brief Reads an IxData signed 16-bit integer field. */
+bool cte_decoder_try_read_ixdata_int16(cte_decoder_t *decoder, int16_t *out);
+/** @brief Reads an IxData signed 32-bit integer field. */
+bool cte_decoder_try_read_ixdata_int32(cte_decoder_t *decoder, int32_t *out);
+/** @brief Reads an IxData signed 64-bit integer field. */
+bool cte_decoder_try_read_ixdata_int64(cte_decoder_t *decoder, int64_t *out);
+/** @brief Reads an IxData unsigned 8-bit integer field. */
+bool cte_decoder_try_read_ixdata_uint8(cte_decoder_t *decoder, uint8_t *out);
+/** @brief Reads an IxData unsigned 16-bit integer field. */
+bool cte_decoder_try_read_ixdata_uint16(cte_decoder_t *decoder, uint16_t *out);
+/** @brief Reads an IxData unsigned 32-bit integer field. */
+bool cte_decoder_try_read_ixdata_uint32(cte_decoder_t *decoder, uint32_t *out);
+/** @brief Reads an IxData unsigned 64-bit integer field. */
+bool cte_decoder_try_read_ixdata_uint64(cte_decoder_t *decoder, uint64_t *out);
+/** @brief Reads an IxData 32-bit float field. */
+bool cte_decoder_try_read_ixdata_float32(cte_decoder_t *decoder, float *out);
+/** @brief Reads an IxData 64-bit double field. */
+bool cte_decoder_try_read_ixdata_float64(cte_decoder_t *decoder, double *out);
+/** @brief Reads an IxData boolean constant field of either value. */
+bool cte_decoder_try_read_ixdata_boolean(cte_decoder_t *decoder, bool *out);
+/** @brief Reads a Command Data field of either format; `*out` receives the payload. */
+bool cte_decoder_try_read_command_data_payload(cte_decoder_t *decoder, const uint8_t **out);
+/** @} */
+
+/**
+ * @brief Checks, without aborting, that a whole transaction decodes.
+ *
+ * The size must be 1 to `CTE_MAX_TRANSACTION_SIZE`, the first byte the
+ * version byte, and every field well-formed with no reserved headers. Once
+ * this returns `true`, the aborting reads cannot fail on the same bytes.
+ *
+ * @param data The transaction.
+ * @param size The size of the transaction.
+ * @param offset Receives the offset of the first field that does not decode,
+ * or 0 if the size or version byte is wrong; may be NULL.
+ * @return `true` if every field decodes.
+ */
+bool cte_decoder_validate(const uint8_t *data, size_t size, size_t *offset);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // DECODER_H
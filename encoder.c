@@ -94,13 +94,25 @@ static void write_fixed_data_internal(cte_encoder_t *handle, uint8_t type_code,
     size_t total_size = 1 + data_size;
     CHECK_CAPACITY(handle, total_size);
 
-    uint8_t header = CTE_TAG_IXDATA_FIELD | ((type_code & 0x0F) << 2) | CTE_IXDATA_SUBTYPE_FIXED;
+    uint8_t header = CTE_IXDATA_HEADER(type_code, CTE_IXDATA_SUBTYPE_FIXED);
     handle->buffer[handle->position++] = header;
 
     memcpy(handle->buffer + handle->position, data, data_size);
     handle->position += data_size;
 }
 
+/**
+ * @struct encoder_block
+ * @brief The allocation behind an encoder handle: the context followed by the
+ * allocator that owns it, so `cte_encoder_free()` can release both.
+ */
+typedef struct encoder_block
+{
+    cte_encoder_t handle; /**< Must stay first; the handle points here. */
+    bool has_allocator;
+    cte_allocator_t allocator;
+} encoder_block_t;
+
 /**
  * @brief Initializes a new CTE encoder context and its buffer.
  *
@@ -113,14 +125,38 @@ static void write_fixed_data_internal(cte_encoder_t *handle, uint8_t type_code,
  */
 LEA_EXPORT(cte_encoder_init)
 cte_encoder_t *cte_encoder_init(size_t capacity)
+{
+    return cte_encoder_init_with_allocator(capacity, NULL);
+}
+
+/**
+ * @brief Initializes a new CTE encoder context using custom allocation hooks.
+ *
+ * The context and its buffer are both allocated through `allocator`, which is
+ * copied into the context and used again by `cte_encoder_free()`.
+ *
+ * @param capacity The total size in bytes to allocate for the internal buffer.
+ * @param allocator The allocation hooks, or NULL for stdlea `malloc`.
+ * @return A pointer to the newly created encoder context.
+ * @note This function will abort via `lea_abort` if the capacity is less than 1 or an allocation fails.
+ */
+LEA_EXPORT(cte_encoder_init_with_allocator)
+cte_encoder_t *cte_encoder_init_with_allocator(size_t capacity, const cte_allocator_t *allocator)
 {
     if (capacity < 1)
     {
         lea_abort("Capacity must be at least 1 for the version byte");
     }
 
-    cte_encoder_t *handle = malloc(sizeof(cte_encoder_t));
-    handle->buffer = malloc(capacity);
+    encoder_block_t *block = cte_allocate(allocator, sizeof(encoder_block_t), _Alignof(encoder_block_t));
+    block->has_allocator = allocator != NULL;
+    if (allocator)
+    {
+        block->allocator = *allocator;
+    }
+
+    cte_encoder_t *handle = &block->handle;
+    handle->buffer = cte_allocate(allocator, capacity, 1);
     handle->capacity = capacity;
     handle->position = 0;
 
@@ -129,6 +165,33 @@ cte_encoder_t *cte_encoder_init(size_t capacity)
     return handle;
 }
 
+/**
+ * @brief Releases an encoder context and its buffer.
+ *
+ * After this call the handle and any pointers obtained from it (including
+ * `cte_encoder_get_data()`) are invalid. Passing NULL is a no-op.
+ *
+ * @param handle A pointer to the encoder context to release.
+ */
+LEA_EXPORT(cte_encoder_free)
+void cte_encoder_free(cte_encoder_t *handle)
+{
+    if (!handle)
+    {
+        return;
+    }
+    encoder_block_t *block = (encoder_block_t *)handle;
+    cte_allocator_t allocator;
+    const cte_allocator_t *hooks = NULL;
+    if (block->has_allocator)
+    {
+        allocator = block->allocator;
+        hooks = &allocator;
+    }
+    cte_deallocate(hooks, handle->buffer, handle->capacity, 1);
+    cte_deallocate(hooks, block, sizeof(encoder_block_t), _Alignof(encoder_block_t));
+}
+
 /**
  * @brief Resets an existing encoder for reuse.
  *
@@ -215,7 +278,7 @@ void *cte_encoder_begin_public_key_list(cte_encoder_t *handle, uint8_t key_count
 
     CHECK_CAPACITY(handle, total_field_size);
 
-    uint8_t header = CTE_TAG_PUBLIC_KEY_LIST | ((key_count & 0x0F) << 2) | (type_code & CTE_CRYPTO_TYPE_MASK);
+    uint8_t header = CTE_LIST_HEADER(CTE_TAG_PUBLIC_KEY_LIST, key_count, type_code);
     handle->buffer[handle->position] = header;
 
     void *write_ptr = handle->buffer + handle->position + 1;
@@ -254,7 +317,7 @@ void *cte_encoder_begin_signature_list(cte_encoder_t *handle, uint8_t sig_count,
 
     CHECK_CAPACITY(handle, total_field_size);
 
-    uint8_t header = CTE_TAG_SIGNATURE_LIST | ((sig_count & 0x0F) << 2) | (type_code & CTE_CRYPTO_TYPE_MASK);
+    uint8_t header = CTE_LIST_HEADER(CTE_TAG_SIGNATURE_LIST, sig_count, type_code);
     handle->buffer[handle->position] = header;
 
     void *write_ptr = handle->buffer + handle->position + 1;
@@ -283,7 +346,7 @@ void cte_encoder_write_ixdata_index_reference(cte_encoder_t *handle, uint8_t ind
     }
 
     CHECK_CAPACITY(handle, 1);
-    uint8_t header = CTE_TAG_IXDATA_FIELD | ((index & 0x0F) << 2) | CTE_IXDATA_SUBTYPE_LEGACY_INDEX;
+    uint8_t header = CTE_IXDATA_HEADER(index, CTE_IXDATA_SUBTYPE_LEGACY_INDEX);
     handle->buffer[handle->position++] = header;
 }
 
@@ -303,7 +366,7 @@ void cte_encoder_write_ixdata_uleb128(cte_encoder_t *handle, uint64_t value)
     }
     CHECK_CAPACITY(handle, 1);
 
-    uint8_t header = CTE_TAG_IXDATA_FIELD | (CTE_IXDATA_VARINT_ENC_ULEB128 << 2) | CTE_IXDATA_SUBTYPE_VARINT;
+    uint8_t header = CTE_IXDATA_HEADER(CTE_IXDATA_VARINT_ENC_ULEB128, CTE_IXDATA_SUBTYPE_VARINT);
     handle->buffer[handle->position] = header;
 
     size_t bytes_written = _encode_uleb128(handle, handle->position + 1, value);
@@ -326,7 +389,7 @@ void cte_encoder_write_ixdata_sleb128(cte_encoder_t *handle, int64_t value)
     }
     CHECK_CAPACITY(handle, 1);
 
-    uint8_t header = CTE_TAG_IXDATA_FIELD | (CTE_IXDATA_VARINT_ENC_SLEB128 << 2) | CTE_IXDATA_SUBTYPE_VARINT;
+    uint8_t header = CTE_IXDATA_HEADER(CTE_IXDATA_VARINT_ENC_SLEB128, CTE_IXDATA_SUBTYPE_VARINT);
     handle->buffer[handle->position] = header;
 
     size_t bytes_written = _encode_sleb128(handle, handle->position + 1, value);
@@ -465,10 +528,39 @@ void cte_encoder_write_ixdata_boolean(cte_encoder_t *handle, bool value)
         lea_abort("Attempted to write reserved IxData Constant value code");
     }
 
-    uint8_t header = CTE_TAG_IXDATA_FIELD | ((value_code & 0x0F) << 2) | CTE_IXDATA_SUBTYPE_CONSTANT;
+    uint8_t header = CTE_IXDATA_HEADER(value_code, CTE_IXDATA_SUBTYPE_CONSTANT);
     handle->buffer[handle->position++] = header;
 }
 
+/**
+ * @brief Reserves space for pre-encoded bytes.
+ *
+ * Advances the write position by `length` bytes without writing a header.
+ * This is used to splice in fragments that were encoded ahead of time (for
+ * example at compile time); the bytes are not validated, so the caller must
+ * copy in complete, well-formed fields.
+ *
+ * @param handle A pointer to the encoder context.
+ * @param length The number of bytes to reserve.
+ * @return A writable pointer to the start of the reserved space.
+ * @note The caller is responsible for `memcpy`ing the bytes into the returned pointer.
+ * @warning Aborts on invalid parameters or if the write would exceed buffer capacity.
+ */
+LEA_EXPORT(cte_encoder_reserve_raw)
+void *cte_encoder_reserve_raw(cte_encoder_t *handle, size_t length)
+{
+    if (!handle)
+    {
+        lea_abort("Null handle in reserve_raw");
+    }
+    CHECK_CAPACITY(handle, length);
+
+    void *write_ptr = handle->buffer + handle->position;
+    handle->position += length;
+
+    return write_ptr;
+}
+
 /**
  * @brief Begins a Command Data field.
  *
@@ -494,16 +586,15 @@ void *cte_encoder_begin_command_data(cte_encoder_t *handle, size_t length)
     {
         header_size = 1;
         CHECK_CAPACITY(handle, header_size + length);
-        uint8_t header = CTE_TAG_COMMAND_DATA | CTE_COMMAND_FORMAT_SHORT | (length & CTE_COMMAND_SHORT_MAX_LEN);
+        uint8_t header = CTE_COMMAND_SHORT_HEADER(length);
         handle->buffer[handle->position] = header;
     }
     else if (length >= CTE_COMMAND_EXTENDED_MIN_LEN && length <= CTE_COMMAND_EXTENDED_MAX_LEN)
     {
         header_size = 2;
         CHECK_CAPACITY(handle, header_size + length);
-        uint8_t LH = (length >> 8) & 0x07;
-        uint8_t header1 = CTE_TAG_COMMAND_DATA | CTE_COMMAND_FORMAT_EXTENDED | (LH << 2);
-        uint8_t header2 = length & 0xFF;
+        uint8_t header1 = CTE_COMMAND_EXTENDED_HEADER1(length);
+        uint8_t header2 = CTE_COMMAND_EXTENDED_HEADER2(length);
 
         handle->buffer[handle->position] = header1;
         handle->buffer[handle->position + 1] = header2;
@@ -4,6 +4,10 @@
 #include "cte.h"
 #include <stdlea.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * @file encoder.h
  * @brief Defines the functions and structures for the CTE Encoder.
@@ -39,6 +43,29 @@ typedef struct cte_encoder
  */
 cte_encoder_t *cte_encoder_init(size_t capacity);
 
+/**
+ * @brief Initializes a new CTE encoder context using custom allocation hooks.
+ *
+ * The context and its buffer are both allocated through `allocator`, which is
+ * copied into the context and used again by `cte_encoder_free()`.
+ *
+ * @param capacity The total size in bytes to allocate for the internal buffer.
+ * @param allocator The allocation hooks, or NULL for stdlea `malloc`.
+ * @return A pointer to the newly created encoder context.
+ * @note This function will abort via `lea_abort` if the capacity is less than 1 or an allocation fails.
+ */
+cte_encoder_t *cte_encoder_init_with_allocator(size_t capacity, const cte_allocator_t *allocator);
+
+/**
+ * @brief Releases an encoder context and its buffer.
+ *
+ * After this call the handle and any pointers obtained from it (including
+ * `cte_encoder_get_data()`) are invalid. Passing NULL is a no-op.
+ *
+ * @param handle A pointer to the encoder context to release.
+ */
+void cte_encoder_free(cte_encoder_t *handle);
+
 /**
  * @brief Resets an existing encoder for reuse.
  *
@@ -202,6 +229,22 @@ void cte_encoder_write_ixdata_float64(cte_encoder_t *handle, double value);
  */
 void cte_encoder_write_ixdata_boolean(cte_encoder_t *handle, bool value);
 
+/**
+ * @brief Reserves space for pre-encoded bytes.
+ *
+ * Advances the write position by `length` bytes without writing a header.
+ * This is used to splice in fragments that were encoded ahead of time (for
+ * example at compile time); the bytes are not validated, so the caller must
+ * copy in complete, well-formed fields.
+ *
+ * @param handle A pointer to the encoder context.
+ * @param length The number of bytes to reserve.
+ * @return A writable pointer to the start of the reserved space.
+ * @note The caller is responsible for `memcpy`ing the bytes into the returned pointer.
+ * @warning Aborts on invalid parameters or if the write would exceed buffer capacity.
+ */
+void *cte_encoder_reserve_raw(cte_encoder_t *handle, size_t length);
+
 /**
  * @brief Begins a Command Data field.
  *
@@ -216,4 +259,8 @@ void cte_encoder_write_ixdata_boolean(cte_encoder_t *handle, bool value);
  */
 void *cte_encoder_begin_command_data(cte_encoder_t *handle, size_t length);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif // ENCODER_H
@@ -0,0 +1,239 @@
+#include "field_grammar.h"
+#include <stdlea.h>
+
+/** @brief Number of distinct `CTE_PEEK_TYPE_*` identifiers (the DFA alphabet). */
+#define GRAMMAR_TYPE_COUNT 26
+
+/**
+ * @struct grammar_position
+ * @brief A counted position of the underlying NFA: `count` fields of `rule` seen so far.
+ */
+typedef struct grammar_position
+{
+    uint8_t rule;
+    uint8_t count;
+} grammar_position_t;
+
+struct cte_grammar
+{
+    size_t state_count;
+    bool accepting[CTE_GRAMMAR_MAX_STATES];
+    uint8_t next[CTE_GRAMMAR_MAX_STATES][GRAMMAR_TYPE_COUNT]; /**< `CTE_GRAMMAR_REJECT` if not allowed. */
+};
+
+/**
+ * @struct grammar_nfa
+ * @brief The rules laid out as counted positions, used only while compiling.
+ *
+ * Position sets are 64-bit masks; the extra bit after the last rule's
+ * positions is the "all rules satisfied" position.
+ */
+typedef struct grammar_nfa
+{
+    const cte_grammar_rule_t *rules;
+    size_t rule_count;
+    uint8_t first[CTE_GRAMMAR_MAX_POSITIONS + 1]; /**< First position of each rule, plus the final position. */
+    grammar_position_t positions[CTE_GRAMMAR_MAX_POSITIONS];
+    size_t position_count;
+} grammar_nfa_t;
+
+/**
+ * @brief Highest count tracked for a rule; unbounded rules stop counting at `min`.
+ * @note Internal helper function.
+ */
+static uint8_t _rule_cap(const cte_grammar_rule_t *rule)
+{
+    return rule->max == CTE_GRAMMAR_UNBOUNDED ? rule->min : rule->max;
+}
+
+/**
+ * @brief Adds every position reachable by skipping satisfied rules.
+ *
+ * Skips only lead to later positions, so one ascending pass is enough.
+ * @note Internal helper function.
+ */
+static uint64_t _closure(const grammar_nfa_t *nfa, uint64_t set)
+{
+    for (size_t i = 0; i < nfa->position_count; ++i)
+    {
+        const grammar_position_t *position = &nfa->positions[i];
+        if ((set >> i) & 1 && position->count >= nfa->rules[position->rule].min)
+        {
+            set |= (uint64_t)1 << nfa->first[position->rule + 1];
+        }
+    }
+    return set;
+}
+
+/**
+ * @brief Computes the position set after one field of type `type`.
+ * @note Internal helper function.
+ */
+static uint64_t _advance(const grammar_nfa_t *nfa, uint64_t set, int type)
+{
+    uint64_t next = 0;
+    for (size_t i = 0; i < nfa->position_count; ++i)
+    {
+        const grammar_position_t *position = &nfa->positions[i];
+        const cte_grammar_rule_t *rule = &nfa->rules[position->rule];
+        if (!((set >> i) & 1) || !(rule->types & CTE_GRAMMAR_TYPE(type)))
+        {
+            continue;
+        }
+        if (rule->max != CTE_GRAMMAR_UNBOUNDED && position->count == rule->max)
+        {
+            continue;
+        }
+        uint8_t count = position->count < _rule_cap(rule) ? position->count + 1 : position->count;
+        next |= (uint64_t)1 << (nfa->first[position->rule] + count);
+    }
+    return next ? _closure(nfa, next) : 0;
+}
+
+LEA_EXPORT(cte_grammar_compile)
+cte_grammar_t *cte_grammar_compile(const cte_grammar_rule_t *rules, size_t rule_count)
+{
+    if (!rules && rule_count != 0)
+    {
+        lea_abort("Null argument to grammar_compile");
+    }
+    if (rule_count > CTE_GRAMMAR_MAX_POSITIONS)
+    {
+        lea_abort("Grammar has too many positions");
+    }
+
+    grammar_nfa_t nfa;
+    nfa.rules = rules;
+    nfa.rule_count = rule_count;
+    nfa.position_count = 0;
+    for (size_t r = 0; r < rule_count; ++r)
+    {
+        const cte_grammar_rule_t *rule = &rules[r];
+        if (rule->types == 0 || (rule->types & ~CTE_GRAMMAR_ANY) || rule->max == 0 || rule->min > rule->max)
+        {
+            lea_abort("Invalid grammar rule");
+        }
+        if (nfa.position_count + _rule_cap(rule) + 1 > CTE_GRAMMAR_MAX_POSITIONS)
+        {
+            lea_abort("Grammar has too many positions");
+        }
+        nfa.first[r] = (uint8_t)nfa.position_count;
+        for (uint8_t count = 0; count <= _rule_cap(rule); ++count)
+        {
+            nfa.positions[nfa.position_count].rule = (uint8_t)r;
+            nfa.positions[nfa.position_count].count = count;
+            nfa.position_count++;
+        }
+    }
+    nfa.first[rule_count] = (uint8_t)nfa.position_count;
+    uint64_t final_bit = (uint64_t)1 << nfa.position_count;
+
+    // Subset construction; the states are discovered breadth first, so the
+    // start state is 0 and `sets` doubles as the work queue.
+    uint64_t sets[CTE_GRAMMAR_MAX_STATES];
+    cte_grammar_t *grammar = malloc(sizeof(cte_grammar_t));
+    sets[0] = _closure(&nfa, rule_count ? 1 : final_bit);
+    grammar->state_count = 1;
+    for (size_t s = 0; s < grammar->state_count; ++s)
+    {
+        grammar->accepting[s] = (sets[s] & final_bit) != 0;
+        for (int type = 0; type < GRAMMAR_TYPE_COUNT; ++type)
+        {
+            uint64_t next = _advance(&nfa, sets[s], type);
+            if (!next)
+            {
+                grammar->next[s][type] = CTE_GRAMMAR_REJECT;
+                continue;
+            }
+            size_t target = 0;
+            while (target < grammar->state_count && sets[target] != next)
+            {
+                target++;
+            }
+            if (target == grammar->state_count)
+            {
+                if (target == CTE_GRAMMAR_MAX_STATES)
+                {
+                    lea_abort("Grammar has too many states");
+                }
+                sets[grammar->state_count++] = next;
+            }
+            grammar->next[s][type] = (uint8_t)target;
+        }
+    }
+    return grammar;
+}
+
+LEA_EXPORT(cte_grammar_free)
+void cte_grammar_free(cte_grammar_t *grammar)
+{
+    if (!grammar)
+    {
+        return;
+    }
+    free(grammar);
+}
+
+LEA_EXPORT(cte_grammar_start)
+uint8_t cte_grammar_start(const cte_grammar_t *grammar)
+{
+    (void)grammar;
+    return 0;
+}
+
+LEA_EXPORT(cte_grammar_next)
+uint8_t cte_grammar_next(const cte_grammar_t *grammar, uint8_t state, int type)
+{
+    if (state == CTE_GRAMMAR_REJECT || type < 0 || type >= GRAMMAR_TYPE_COUNT)
+    {
+        return CTE_GRAMMAR_REJECT;
+    }
+    return grammar->next[state][type];
+}
+
+LEA_EXPORT(cte_grammar_accepts)
+bool cte_grammar_accepts(const cte_grammar_t *grammar, uint8_t state)
+{
+    return state != CTE_GRAMMAR_REJECT && grammar->accepting[state];
+}
+
+LEA_EXPORT(cte_grammar_validate)
+bool cte_grammar_validate(const cte_grammar_t *grammar, const uint8_t *data, size_t size, size_t *error_offset)
+{
+    if (!grammar || !data)
+    {
+        lea_abort("Null argument to grammar_validate");
+    }
+    if (size == 0)
+    {
+        lea_abort("Zero size buffer");
+    }
+
+    cte_decoder_t decoder = cte_decoder_view(data, size, 0);
+    cte_field_t field;
+    uint8_t state = 0;
+    for (int type = cte_decoder_peek_type(&decoder); type != CTE_PEEK_EOF; type = cte_decoder_peek_type(&decoder))
+    {
+        // Reserved header codes peek as negative types and are never part of a layout.
+        state = type < 0 ? CTE_GRAMMAR_REJECT : grammar->next[state][type];
+        if (state == CTE_GRAMMAR_REJECT)
+        {
+            if (error_offset)
+            {
+                *error_offset = decoder.position;
+            }
+            return false;
+        }
+        cte_decoder_read_field(&decoder, type, &field);
+    }
+
+    if (!grammar->accepting[state])
+    {
+        if (error_offset)
+        {
+            *error_offset = size;
+        }
+        return false;
+    }
+    return true;
+}
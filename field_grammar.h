@@ -0,0 +1,130 @@
+#ifndef FIELD_GRAMMAR_H
+#define FIELD_GRAMMAR_H
+
+#include "decoder.h"
+#include <stdlea.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file field_grammar.h
+ * @brief Field-order validation with a DFA compiled from a declarative grammar.
+ *
+ * A grammar is a sequence of rules. Each rule accepts a run of fields whose
+ * `CTE_PEEK_TYPE_*` identifiers belong to a type set, repeated between `min`
+ * and `max` times. The rules are compiled once into a deterministic automaton
+ * with one transition per (state, field type), so checking a field costs a
+ * single table lookup.
+ *
+ * The automaton can be driven from an existing decoding loop with
+ * `cte_grammar_next()` right after each `cte_decoder_peek_type()`, or run
+ * over a whole transaction with `cte_grammar_validate()`. Either way an
+ * out-of-order or excess field is rejected at its header byte, before its
+ * payload is read.
+ */
+
+/**
+ * @name Type sets
+ * @brief Bit sets of `CTE_PEEK_TYPE_*` identifiers for grammar rules.
+ * @{
+ */
+#define CTE_GRAMMAR_TYPE(type) ((uint32_t)1 << (type)) ///< A set holding a single field type.
+#define CTE_GRAMMAR_PK_LISTS 0x0000000Fu               ///< Every Public Key List type.
+#define CTE_GRAMMAR_SIG_LISTS 0x000000F0u              ///< Every Signature List type.
+#define CTE_GRAMMAR_IXDATA 0x00FFFF00u                 ///< Every IxData type.
+#define CTE_GRAMMAR_COMMANDS 0x03000000u               ///< Short and extended Command Data.
+#define CTE_GRAMMAR_ANY 0x03FFFFFFu                    ///< Every field type.
+/** @} */
+
+/** @brief `max` value for a rule without an upper bound. */
+#define CTE_GRAMMAR_UNBOUNDED 0xFF
+
+/** @brief State returned by `cte_grammar_next()` once a field has been rejected. */
+#define CTE_GRAMMAR_REJECT 0xFF
+
+/**
+ * @brief Maximum number of counted positions across all rules.
+ *
+ * A rule occupies `max + 1` positions, or `min + 1` if it is unbounded.
+ */
+#define CTE_GRAMMAR_MAX_POSITIONS 63
+
+/** @brief Maximum number of DFA states a grammar may compile to. */
+#define CTE_GRAMMAR_MAX_STATES 128
+
+/**
+ * @struct cte_grammar_rule
+ * @brief One element of a grammar: between `min` and `max` fields from `types`.
+ */
+typedef struct cte_grammar_rule
+{
+    uint32_t types; /**< @param types Accepted field types (`CTE_GRAMMAR_*` sets). */
+    uint8_t min;    /**< @param min Minimum number of fields. */
+    uint8_t max;    /**< @param max Maximum number of fields, or `CTE_GRAMMAR_UNBOUNDED`. */
+} cte_grammar_rule_t;
+
+/** @brief Opaque compiled grammar. */
+typedef struct cte_grammar cte_grammar_t;
+
+/**
+ * @brief Compiles a grammar into a DFA.
+ * @param rules The rules, in the order their fields must appear.
+ * @param rule_count The number of rules.
+ * @return A pointer to the compiled grammar.
+ * @note Aborts via `lea_abort` if a rule is empty or inconsistent, or if the
+ * grammar exceeds `CTE_GRAMMAR_MAX_POSITIONS` or `CTE_GRAMMAR_MAX_STATES`.
+ */
+cte_grammar_t *cte_grammar_compile(const cte_grammar_rule_t *rules, size_t rule_count);
+
+/**
+ * @brief Releases a compiled grammar. Passing NULL is a no-op.
+ * @param grammar The grammar to release.
+ */
+void cte_grammar_free(cte_grammar_t *grammar);
+
+/**
+ * @brief Returns the state before the first field. Always 0.
+ * @param grammar The compiled grammar.
+ */
+uint8_t cte_grammar_start(const cte_grammar_t *grammar);
+
+/**
+ * @brief Advances the automaton by one field.
+ * @param grammar The compiled grammar.
+ * @param state The current state.
+ * @param type The field's `CTE_PEEK_TYPE_*` identifier.
+ * @return The next state, or `CTE_GRAMMAR_REJECT` if the field is not allowed here.
+ */
+uint8_t cte_grammar_next(const cte_grammar_t *grammar, uint8_t state, int type);
+
+/**
+ * @brief Checks whether the transaction may end in `state`.
+ * @param grammar The compiled grammar.
+ * @param state The current state.
+ * @return True if every rule's minimum has been met.
+ */
+bool cte_grammar_accepts(const cte_grammar_t *grammar, uint8_t state);
+
+/**
+ * @brief Validates the field order of a whole transaction.
+ *
+ * Scans the headers with the decoder, advancing the automaton before each
+ * field's payload is read, and stops at the first rejected field.
+ *
+ * @param grammar The compiled grammar.
+ * @param data The encoded transaction, starting with the version byte.
+ * @param size The size of the transaction in bytes.
+ * @param error_offset Receives the offset of the first offending header byte,
+ * or `size` if required fields are missing at the end. May be NULL.
+ * @return True if the transaction matches the grammar.
+ * @warning Aborts on malformed data, like the decoder.
+ */
+bool cte_grammar_validate(const cte_grammar_t *grammar, const uint8_t *data, size_t size, size_t *error_offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIELD_GRAMMAR_H
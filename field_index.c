@@ -0,0 +1,568 @@
+#include "field_index.h"
+#include "decoder.h"
+#include <stdlea.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** @brief First bytes of a sidecar. */
+static const uint8_t file_magic[4] = {'C', 'T', 'E', 'F'};
+/** @brief Format version written in the header. */
+#define FIELD_INDEX_VERSION 1
+/** @brief Bytes sampled at each end of the archive for the stamp. */
+#define STAMP_SAMPLE 4096
+/** @brief Offset of the header CRC. */
+#define HEADER_CRC_OFFSET 28
+/** @brief Bit of the stored field count marking an invalid transaction. */
+#define INVALID_TRANSACTION 0x8000
+
+/**
+ * @brief Stores a 16-bit value little-endian.
+ * @note Internal helper function.
+ */
+static void _put16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief Stores a 32-bit value little-endian.
+ * @note Internal helper function.
+ */
+static void _put32(uint8_t *p, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        p[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+/**
+ * @brief Stores a 64-bit value little-endian.
+ * @note Internal helper function.
+ */
+static void _put64(uint8_t *p, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        p[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+/**
+ * @brief Loads a little-endian 16-bit value.
+ * @note Internal helper function.
+ */
+static uint16_t _get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+/**
+ * @brief Loads a little-endian 32-bit value.
+ * @note Internal helper function.
+ */
+static uint32_t _get32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+/**
+ * @brief Loads a little-endian 64-bit value.
+ * @note Internal helper function.
+ */
+static uint64_t _get64(const uint8_t *p)
+{
+    return (uint64_t)_get32(p) | (uint64_t)_get32(p + 4) << 32;
+}
+
+/**
+ * @brief CRC-32C of a header, taken with its CRC field zero.
+ * @note Internal helper function.
+ */
+static uint32_t _header_crc(const uint8_t *header)
+{
+    static const uint8_t zero[4] = {0};
+    uint32_t crc = cte_crc32c(0, header, HEADER_CRC_OFFSET);
+    crc = cte_crc32c(crc, zero, sizeof(zero));
+    return cte_crc32c(crc, header + HEADER_CRC_OFFSET + 4, CTE_FIELD_INDEX_HEADER_SIZE - HEADER_CRC_OFFSET - 4);
+}
+
+/**
+ * @brief The tables being built, as little-endian entries.
+ */
+typedef struct
+{
+    const cte_allocator_t *allocator;
+    uint8_t *transactions;
+    size_t transaction_capacity; /**< In bytes. */
+    uint64_t transaction_count;
+    uint8_t *fields;
+    size_t field_capacity;       /**< In bytes. */
+    uint64_t field_count;
+} builder_t;
+
+/**
+ * @brief Doubles a table until it holds `needed` bytes.
+ * @note Internal helper function.
+ */
+static uint8_t *_grow(builder_t *builder, uint8_t *table, size_t *capacity, size_t needed)
+{
+    if (needed <= *capacity)
+    {
+        return table;
+    }
+    size_t grown = *capacity ? 2 * *capacity : 64 * 1024;
+    while (grown < needed)
+    {
+        grown *= 2;
+    }
+    uint8_t *bigger = cte_allocate(builder->allocator, grown, 8);
+    if (table)
+    {
+        memcpy(bigger, table, *capacity);
+        cte_deallocate(builder->allocator, table, *capacity, 8);
+    }
+    *capacity = grown;
+    return bigger;
+}
+
+/**
+ * @brief Indexes the fields of one transaction, up to the first that does not decode.
+ * @note Internal helper function.
+ */
+static void _index_transaction(builder_t *builder, const uint8_t *data, size_t size, uint64_t offset, bool valid)
+{
+    uint64_t first = builder->field_count;
+    uint16_t count = 0;
+    // Every field before the first bad one decodes, so the aborting reads are safe up to it.
+    size_t end = 0;
+    if (cte_decoder_validate(data, size, &end))
+    {
+        end = size;
+    }
+    else
+    {
+        valid = false;
+    }
+    cte_decoder_t decoder = cte_decoder_view(data, end, 1);
+    cte_field_t field;
+    while (decoder.position < end)
+    {
+        size_t position = decoder.position;
+        int type = cte_decoder_peek_type(&decoder);
+        cte_decoder_read_field(&decoder, type, &field);
+        size_t used = (size_t)builder->field_count * CTE_FIELD_INDEX_FIELD_SIZE;
+        builder->fields = _grow(builder, builder->fields, &builder->field_capacity, used + CTE_FIELD_INDEX_FIELD_SIZE);
+        uint8_t *entry = builder->fields + used;
+        _put16(entry, (uint16_t)position);
+        _put16(entry + 2, (uint16_t)(decoder.position - position));
+        entry[4] = (uint8_t)type;
+        entry[5] = (uint8_t)(field.data ? (size_t)(field.data - (data + position)) : 1);
+        builder->field_count++;
+        count++;
+    }
+
+    size_t used = (size_t)builder->transaction_count * CTE_FIELD_INDEX_TRANSACTION_SIZE;
+    builder->transactions =
+        _grow(builder, builder->transactions, &builder->transaction_capacity, used + CTE_FIELD_INDEX_TRANSACTION_SIZE);
+    uint8_t *entry = builder->transactions + used;
+    _put64(entry, offset);
+    _put32(entry + 8, (uint32_t)first);
+    _put16(entry + 12, (uint16_t)size);
+    _put16(entry + 14, (uint16_t)(count | (valid ? 0 : INVALID_TRANSACTION)));
+    builder->transaction_count++;
+}
+
+/**
+ * @brief Fills a field from its entry, resolving offsets against the archive.
+ * @return `false` if the entry lies outside its transaction.
+ * @note Internal helper function.
+ */
+static bool _resolve_field(const cte_field_index_t *index, const cte_field_index_transaction_t *transaction,
+                           uint64_t n, size_t k, cte_field_index_field_t *field)
+{
+    const uint8_t *entry = index->data + CTE_FIELD_INDEX_HEADER_SIZE +
+                           index->transaction_count * CTE_FIELD_INDEX_TRANSACTION_SIZE +
+                           (transaction->first_field + k) * CTE_FIELD_INDEX_FIELD_SIZE;
+    size_t offset = _get16(entry);
+    size_t size = _get16(entry + 2);
+    size_t header = entry[5];
+    if (offset + size > transaction->size || header > size || entry[4] > CTE_PEEK_TYPE_CMD_EXTENDED)
+    {
+        return false;
+    }
+    field->type = entry[4];
+    field->transaction = n;
+    field->number = k;
+    field->offset = transaction->offset + offset;
+    field->size = size;
+    field->value = field->offset + header;
+    field->length = size - header;
+    return true;
+}
+
+LEA_EXPORT(cte_field_index_stamp)
+void cte_field_index_stamp(const uint8_t *archive, size_t size, int64_t mtime_ns, cte_field_index_stamp_t *stamp)
+{
+    size_t head = size < STAMP_SAMPLE ? size : STAMP_SAMPLE;
+    size_t tail = size - head < STAMP_SAMPLE ? size - head : STAMP_SAMPLE;
+    stamp->size = size;
+    stamp->mtime_ns = mtime_ns;
+    stamp->sample_crc = cte_crc32c(cte_crc32c(0, archive, head), archive + size - tail, tail);
+}
+
+LEA_EXPORT(cte_field_index_build)
+bool cte_field_index_build(const uint8_t *archive, size_t size, const cte_field_index_stamp_t *stamp,
+                           cte_container_sink_t sink, void *context, const cte_allocator_t *allocator)
+{
+    builder_t builder = {0};
+    builder.allocator = allocator;
+    uint8_t flags = 0;
+
+    cte_container_t container;
+    if (cte_container_open(&container, archive, size))
+    {
+        size_t offset = CTE_CONTAINER_HEADER_SIZE;
+        uint64_t record_index = 0;
+        cte_container_record_t record;
+        cte_container_status_t status;
+        while ((status = cte_container_next(&container, &offset, &record_index, &record)) != CTE_CONTAINER_END)
+        {
+            if (status == CTE_CONTAINER_MALFORMED)
+            {
+                offset = cte_container_sync(&container, offset + 1, &record_index);
+                continue;
+            }
+            _index_transaction(&builder, record.data, record.size, (uint64_t)(record.data - archive),
+                               status == CTE_CONTAINER_OK);
+        }
+    }
+    else
+    {
+        size_t offset = 0;
+        while (offset < size)
+        {
+            // ULEB128 length of at most two bytes, as CTE_MAX_TRANSACTION_SIZE needs.
+            size_t length = archive[offset] & 0x7F;
+            size_t prefix = 1;
+            if (archive[offset] & 0x80)
+            {
+                if (offset + 1 >= size || (archive[offset + 1] & 0x80))
+                {
+                    flags |= CTE_FIELD_INDEX_PARTIAL;
+                    break;
+                }
+                length |= (size_t)archive[offset + 1] << 7;
+                prefix = 2;
+            }
+            if (length == 0 || length > CTE_MAX_TRANSACTION_SIZE || length > size - offset - prefix)
+            {
+                flags |= CTE_FIELD_INDEX_PARTIAL;
+                break;
+            }
+            offset += prefix;
+            _index_transaction(&builder, archive + offset, length, offset, true);
+            offset += length;
+        }
+    }
+
+    bool written = builder.field_count <= UINT32_MAX;
+    if (written)
+    {
+        uint8_t header[CTE_FIELD_INDEX_HEADER_SIZE] = {0};
+        memcpy(header, file_magic, sizeof(file_magic));
+        header[4] = FIELD_INDEX_VERSION;
+        header[5] = flags;
+        _put64(header + 8, stamp->size);
+        _put64(header + 16, (uint64_t)stamp->mtime_ns);
+        _put32(header + 24, stamp->sample_crc);
+        _put64(header + 32, builder.transaction_count);
+        _put64(header + 40, builder.field_count);
+        _put32(header + HEADER_CRC_OFFSET, _header_crc(header));
+        written = sink(context, header, sizeof(header)) &&
+                  (builder.transaction_count == 0 ||
+                   sink(context, builder.transactions,
+                        (size_t)builder.transaction_count * CTE_FIELD_INDEX_TRANSACTION_SIZE)) &&
+                  (builder.field_count == 0 ||
+                   sink(context, builder.fields, (size_t)builder.field_count * CTE_FIELD_INDEX_FIELD_SIZE));
+    }
+    if (builder.transactions)
+    {
+        cte_deallocate(allocator, builder.transactions, builder.transaction_capacity, 8);
+    }
+    if (builder.fields)
+    {
+        cte_deallocate(allocator, builder.fields, builder.field_capacity, 8);
+    }
+    return written;
+}
+
+LEA_EXPORT(cte_field_index_open)
+bool cte_field_index_open(cte_field_index_t *index, const uint8_t *data, size_t size)
+{
+    if (size < CTE_FIELD_INDEX_HEADER_SIZE || memcmp(data, file_magic, sizeof(file_magic)) != 0 ||
+        data[4] != FIELD_INDEX_VERSION || (data[5] & ~CTE_FIELD_INDEX_PARTIAL) != 0 ||
+        _get32(data + HEADER_CRC_OFFSET) != _header_crc(data))
+    {
+        return false;
+    }
+    uint64_t transaction_count = _get64(data + 32);
+    uint64_t field_count = _get64(data + 40);
+    size_t tables = size - CTE_FIELD_INDEX_HEADER_SIZE;
+    if (transaction_count > tables / CTE_FIELD_INDEX_TRANSACTION_SIZE ||
+        field_count > (tables - transaction_count * CTE_FIELD_INDEX_TRANSACTION_SIZE) / CTE_FIELD_INDEX_FIELD_SIZE ||
+        transaction_count * CTE_FIELD_INDEX_TRANSACTION_SIZE + field_count * CTE_FIELD_INDEX_FIELD_SIZE != tables)
+    {
+        return false;
+    }
+    index->data = data;
+    index->size = size;
+    index->flags = data[5];
+    index->stamp.size = _get64(data + 8);
+    index->stamp.mtime_ns = (int64_t)_get64(data + 16);
+    index->stamp.sample_crc = _get32(data + 24);
+    index->transaction_count = transaction_count;
+    index->field_count = field_count;
+    return true;
+}
+
+LEA_EXPORT(cte_field_index_get_transaction)
+bool cte_field_index_get_transaction(const cte_field_index_t *index, uint64_t n,
+                                     cte_field_index_transaction_t *transaction)
+{
+    if (n >= index->transaction_count)
+    {
+        return false;
+    }
+    const uint8_t *entry = index->data + CTE_FIELD_INDEX_HEADER_SIZE + n * CTE_FIELD_INDEX_TRANSACTION_SIZE;
+    uint16_t count = _get16(entry + 14);
+    transaction->offset = _get64(entry);
+    transaction->size = _get16(entry + 12);
+    transaction->first_field = _get32(entry + 8);
+    transaction->field_count = count & ~INVALID_TRANSACTION;
+    transaction->valid = (count & INVALID_TRANSACTION) == 0;
+    // A damaged sidecar must not send readers outside the archive or the field table.
+    return transaction->offset <= index->stamp.size && transaction->size <= index->stamp.size - transaction->offset &&
+           transaction->first_field + transaction->field_count <= index->field_count;
+}
+
+LEA_EXPORT(cte_field_index_get_field)
+bool cte_field_index_get_field(const cte_field_index_t *index, uint64_t n, size_t k, cte_field_index_field_t *field)
+{
+    cte_field_index_transaction_t transaction;
+    return cte_field_index_get_transaction(index, n, &transaction) && k < transaction.field_count &&
+           _resolve_field(index, &transaction, n, k, field);
+}
+
+LEA_EXPORT(cte_field_index_next)
+bool cte_field_index_next(const cte_field_index_t *index, cte_field_index_cursor_t *cursor, uint32_t types,
+                          cte_field_index_field_t *field)
+{
+    const uint8_t *fields =
+        index->data + CTE_FIELD_INDEX_HEADER_SIZE + index->transaction_count * CTE_FIELD_INDEX_TRANSACTION_SIZE;
+    cte_field_index_transaction_t transaction;
+    bool loaded = false;
+    for (; cursor->field < index->field_count; cursor->field++)
+    {
+        // Only the type byte is read until a field matches.
+        uint8_t type = fields[cursor->field * CTE_FIELD_INDEX_FIELD_SIZE + 4];
+        if (type > CTE_PEEK_TYPE_CMD_EXTENDED || !(types & (1u << type)))
+        {
+            continue;
+        }
+        while (!loaded || cursor->field >= transaction.first_field + transaction.field_count)
+        {
+            if (loaded)
+            {
+                cursor->transaction++;
+            }
+            if (!cte_field_index_get_transaction(index, cursor->transaction, &transaction) ||
+                cursor->field < transaction.first_field)
+            {
+                cursor->field = index->field_count;
+                return false;
+            }
+            loaded = true;
+        }
+        if (!_resolve_field(index, &transaction, cursor->transaction,
+                            (size_t)(cursor->field - transaction.first_field), field))
+        {
+            cursor->field = index->field_count;
+            return false;
+        }
+        cursor->field++;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Container sink collecting a rebuilt sidecar in `file->buffer`.
+ * @note Internal helper function.
+ */
+static bool _buffer_sink(void *context, const uint8_t *data, size_t size)
+{
+    cte_field_index_file_t *file = context;
+    size_t used = file->index.size;
+    if (used + size > file->buffer_capacity)
+    {
+        size_t grown = file->buffer_capacity ? 2 * file->buffer_capacity : 64 * 1024;
+        while (grown < used + size)
+        {
+            grown *= 2;
+        }
+        uint8_t *bigger = cte_allocate(NULL, grown, 8);
+        if (file->buffer)
+        {
+            memcpy(bigger, file->buffer, used);
+            cte_deallocate(NULL, file->buffer, file->buffer_capacity, 8);
+        }
+        file->buffer = bigger;
+        file->buffer_capacity = grown;
+    }
+    memcpy(file->buffer + used, data, size);
+    file->index.size += size;
+    return true;
+}
+
+/**
+ * @brief Replaces the sidecar on disk: temporary file, sync, rename.
+ * @note Internal helper function.
+ */
+static bool _persist(const char *path, const uint8_t *data, size_t size)
+{
+    size_t length = strlen(path);
+    char *temporary = cte_allocate(NULL, length + 8, 1);
+    memcpy(temporary, path, length);
+    memcpy(temporary + length, ".XXXXXX", 8);
+    int fd = mkstemp(temporary);
+    bool persisted = fd >= 0;
+    if (persisted)
+    {
+        fchmod(fd, 0644);
+        for (size_t done = 0; persisted && done < size;)
+        {
+            ssize_t written = write(fd, data + done, size - done);
+            persisted = written > 0 || (written < 0 && errno == EINTR);
+            done += written > 0 ? (size_t)written : 0;
+        }
+        persisted = persisted && fsync(fd) == 0;
+        persisted = close(fd) == 0 && persisted && rename(temporary, path) == 0;
+        if (!persisted)
+        {
+            unlink(temporary);
+        }
+    }
+    cte_deallocate(NULL, temporary, length + 8, 1);
+    return persisted;
+}
+
+LEA_EXPORT(cte_field_index_load)
+bool cte_field_index_load(cte_field_index_file_t *file, const char *archive_path)
+{
+    memset(file, 0, sizeof(*file));
+    int fd = open(archive_path, O_RDONLY | O_CLOEXEC);
+    struct stat status;
+    if (fd < 0)
+    {
+        return false;
+    }
+    if (fstat(fd, &status) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    file->archive_size = (size_t)status.st_size;
+    if (file->archive_size > 0)
+    {
+        void *mapping = mmap(NULL, file->archive_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            close(fd);
+            return false;
+        }
+        file->archive = mapping;
+    }
+    close(fd);
+    cte_field_index_stamp_t stamp;
+    cte_field_index_stamp(file->archive, file->archive_size,
+                          (int64_t)status.st_mtim.tv_sec * 1000000000 + status.st_mtim.tv_nsec, &stamp);
+
+    size_t length = strlen(archive_path);
+    char *path = cte_allocate(NULL, length + sizeof(CTE_FIELD_INDEX_SUFFIX), 1);
+    memcpy(path, archive_path, length);
+    memcpy(path + length, CTE_FIELD_INDEX_SUFFIX, sizeof(CTE_FIELD_INDEX_SUFFIX));
+
+    // A current sidecar is used in place.
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        if (fstat(fd, &status) == 0 && status.st_size >= CTE_FIELD_INDEX_HEADER_SIZE)
+        {
+            void *mapping = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapping != MAP_FAILED)
+            {
+                if (cte_field_index_open(&file->index, mapping, (size_t)status.st_size) &&
+                    file->index.stamp.size == stamp.size && file->index.stamp.mtime_ns == stamp.mtime_ns &&
+                    file->index.stamp.sample_crc == stamp.sample_crc)
+                {
+                    file->sidecar_mapping = mapping;
+                    file->persisted = true;
+                }
+                else
+                {
+                    munmap(mapping, (size_t)status.st_size);
+                }
+            }
+        }
+        close(fd);
+    }
+
+    bool loaded = file->sidecar_mapping != NULL;
+    if (!loaded)
+    {
+        file->index.size = 0;
+        if (cte_field_index_build(file->archive, file->archive_size, &stamp, _buffer_sink, file, NULL))
+        {
+            size_t size = file->index.size;
+            loaded = cte_field_index_open(&file->index, file->buffer, size);
+            file->rebuilt = true;
+            file->persisted = _persist(path, file->buffer, size);
+        }
+        else
+        {
+            errno = EOVERFLOW;
+        }
+    }
+    cte_deallocate(NULL, path, length + sizeof(CTE_FIELD_INDEX_SUFFIX), 1);
+    if (!loaded)
+    {
+        int error = errno;
+        cte_field_index_unload(file);
+        errno = error;
+    }
+    return loaded;
+}
+
+LEA_EXPORT(cte_field_index_unload)
+void cte_field_index_unload(cte_field_index_file_t *file)
+{
+    if (file->sidecar_mapping)
+    {
+        munmap(file->sidecar_mapping, file->index.size);
+    }
+    if (file->buffer)
+    {
+        cte_deallocate(NULL, file->buffer, file->buffer_capacity, 8);
+    }
+    if (file->archive)
+    {
+        munmap((void *)file->archive, file->archive_size);
+    }
+    memset(file, 0, sizeof(*file));
+}
@@ -0,0 +1,224 @@
+#ifndef FIELD_INDEX_H
+#define FIELD_INDEX_H
+
+#include "container.h"
+#include <stdlea.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file field_index.h
+ * @brief Persisted per-field index of an archive, kept in a sidecar file.
+ *
+ * An archive (a container or a prefix-framed stream) is parsed once and
+ * the position of every field is written to `<archive>.fidx`. Readers map
+ * the sidecar and the archive and find "field k of transaction n" or every
+ * field of some types by table lookups, without decoding headers again.
+ *
+ * Layout (all integers little-endian, tables 8-byte aligned):
+ *
+ *     header       64 bytes: "CTEF", version 1, flags, 2 zero bytes, u64
+ *                  archive size, i64 archive mtime (ns), u32 CRC-32C of the
+ *                  archive's first and last 4 KiB, u32 CRC-32C of the header
+ *                  (taken with this field zero), u64 transaction count, u64
+ *                  field count, 16 zero bytes
+ *     transactions 16 bytes each: u64 offset in the archive, u32 number of
+ *                  the first field, u16 size, u16 field count (bit 15 set if
+ *                  the transaction is malformed or failed its checksum)
+ *     fields       6 bytes each: u16 offset in the transaction, u16 size,
+ *                  u8 peek type, u8 bytes before the value or payload
+ *
+ * Transactions are numbered in archive order. The fields of a malformed
+ * transaction are indexed up to the first one that fails to decode.
+ * The archive's size, mtime and sampled CRC are stored so that a
+ * sidecar that no longer matches its archive is detected and rebuilt.
+ */
+
+/** @brief Appended to the archive path to name its sidecar. */
+#define CTE_FIELD_INDEX_SUFFIX ".fidx"
+/** @brief Size of the sidecar header. */
+#define CTE_FIELD_INDEX_HEADER_SIZE 64
+/** @brief Size of a transaction entry. */
+#define CTE_FIELD_INDEX_TRANSACTION_SIZE 16
+/** @brief Size of a field entry. */
+#define CTE_FIELD_INDEX_FIELD_SIZE 6
+/** @brief Header flag: framing damage stopped indexing before the end of a prefix-framed archive. */
+#define CTE_FIELD_INDEX_PARTIAL 0x01
+
+/**
+ * @struct cte_field_index_stamp
+ * @brief Identifies the archive version a sidecar was built from.
+ */
+typedef struct cte_field_index_stamp
+{
+    uint64_t size;       /**< @param size Archive size in bytes. */
+    int64_t mtime_ns;    /**< @param mtime_ns Archive modification time in nanoseconds, or 0. */
+    uint32_t sample_crc; /**< @param sample_crc CRC-32C of the first and last 4 KiB of the archive. */
+} cte_field_index_stamp_t;
+
+/**
+ * @struct cte_field_index
+ * @brief A read-only view of a sidecar, filled by `cte_field_index_open()`.
+ */
+typedef struct cte_field_index
+{
+    const uint8_t *data;             /**< @param data The whole sidecar. */
+    size_t size;                     /**< @param size The size of the sidecar. */
+    uint8_t flags;                   /**< @param flags `CTE_FIELD_INDEX_*` header flags. */
+    cte_field_index_stamp_t stamp;   /**< @param stamp The archive the sidecar was built from. */
+    uint64_t transaction_count;      /**< @param transaction_count Number of transactions. */
+    uint64_t field_count;            /**< @param field_count Number of fields in all transactions. */
+} cte_field_index_t;
+
+/**
+ * @struct cte_field_index_transaction
+ * @brief One transaction entry.
+ */
+typedef struct cte_field_index_transaction
+{
+    uint64_t offset;      /**< @param offset Offset of the transaction in the archive. */
+    size_t size;          /**< @param size Size of the transaction. */
+    uint64_t first_field; /**< @param first_field Number of its first field among all fields. */
+    size_t field_count;   /**< @param field_count Number of fields indexed. */
+    bool valid;           /**< @param valid Every field decoded and the checksum (if any) matched. */
+} cte_field_index_transaction_t;
+
+/**
+ * @struct cte_field_index_field
+ * @brief One field entry, with offsets resolved against the archive.
+ */
+typedef struct cte_field_index_field
+{
+    int type;             /**< @param type The `CTE_PEEK_TYPE_*` identifier. */
+    uint64_t transaction; /**< @param transaction Number of the transaction holding the field. */
+    size_t number;        /**< @param number Position of the field in its transaction, from 0. */
+    uint64_t offset;      /**< @param offset Offset of the field's header byte in the archive. */
+    size_t size;          /**< @param size Size of the whole field. */
+    uint64_t value;       /**< @param value Offset in the archive of the list items, payload or scalar value. */
+    size_t length;        /**< @param length Number of bytes at `value`; 0 for header-only fields. */
+} cte_field_index_field_t;
+
+/**
+ * @struct cte_field_index_cursor
+ * @brief Position of `cte_field_index_next()`; start with all members 0.
+ */
+typedef struct cte_field_index_cursor
+{
+    uint64_t transaction; /**< @param transaction Transaction holding the next field. */
+    uint64_t field;       /**< @param field Number of the next field among all fields. */
+} cte_field_index_cursor_t;
+
+/**
+ * @struct cte_field_index_file
+ * @brief A sidecar and its archive, mapped by `cte_field_index_load()`.
+ */
+typedef struct cte_field_index_file
+{
+    cte_field_index_t index; /**< @param index View of the sidecar. */
+    const uint8_t *archive;  /**< @param archive The archive bytes. */
+    size_t archive_size;     /**< @param archive_size The size of the archive. */
+    bool rebuilt;            /**< @param rebuilt The sidecar was missing or stale and was rebuilt. */
+    bool persisted;          /**< @param persisted The sidecar on disk is current; `false` if it could not be written. */
+    void *sidecar_mapping;   /**< @param sidecar_mapping Private: the mapped sidecar, or NULL. */
+    uint8_t *buffer;         /**< @param buffer Private: the rebuilt sidecar, or NULL. */
+    size_t buffer_capacity;  /**< @param buffer_capacity Private: allocated size of `buffer`. */
+} cte_field_index_file_t;
+
+/**
+ * @brief Computes the stamp of an archive.
+ * @param archive The archive bytes.
+ * @param size The size of the archive.
+ * @param mtime_ns Its modification time in nanoseconds, or 0 if unknown.
+ * @param stamp Receives the stamp.
+ */
+void cte_field_index_stamp(const uint8_t *archive, size_t size, int64_t mtime_ns, cte_field_index_stamp_t *stamp);
+
+/**
+ * @brief Indexes every field of an archive and writes the sidecar.
+ *
+ * A container (see container.h) is read record by record, resuming at the
+ * next sync marker after damage. Anything else is read as a prefix-framed
+ * stream up to the first invalid frame, which sets `CTE_FIELD_INDEX_PARTIAL`.
+ *
+ * @param archive The archive bytes.
+ * @param size The size of the archive.
+ * @param stamp The archive's stamp, stored in the header.
+ * @param sink Receives the sidecar bytes in order.
+ * @param context Passed to `sink`.
+ * @param allocator The allocation hooks for the tables, or NULL for stdlea `malloc`.
+ * @return `false` if the sink failed, or the archive holds more than 2^32 fields.
+ */
+bool cte_field_index_build(const uint8_t *archive, size_t size, const cte_field_index_stamp_t *stamp,
+                           cte_container_sink_t sink, void *context, const cte_allocator_t *allocator);
+
+/**
+ * @brief Opens a view of a sidecar.
+ * @param index Receives the view.
+ * @param data The whole sidecar; it must stay valid while the view is used.
+ * @param size The size of the sidecar.
+ * @return `false` if the header is invalid or does not match the table sizes.
+ */
+bool cte_field_index_open(cte_field_index_t *index, const uint8_t *data, size_t size);
+
+/**
+ * @brief Reads a transaction entry.
+ * @param index The view.
+ * @param n The transaction number.
+ * @param transaction Receives the entry.
+ * @return `false` if `n` is out of range.
+ */
+bool cte_field_index_get_transaction(const cte_field_index_t *index, uint64_t n,
+                                     cte_field_index_transaction_t *transaction);
+
+/**
+ * @brief Reads field `k` of transaction `n`.
+ * @param index The view.
+ * @param n The transaction number.
+ * @param k The field's position in the transaction, from 0.
+ * @param field Receives the field.
+ * @return `false` if either number is out of range.
+ */
+bool cte_field_index_get_field(const cte_field_index_t *index, uint64_t n, size_t k, cte_field_index_field_t *field);
+
+/**
+ * @brief Finds the next field whose type is in a set, in archive order.
+ *
+ * For example, every Command Data payload is visited with `types` set to
+ * `1u << CTE_PEEK_TYPE_CMD_SHORT | 1u << CTE_PEEK_TYPE_CMD_EXTENDED`.
+ *
+ * @param index The view.
+ * @param cursor The position; advanced past the returned field.
+ * @param types Bit `1u << t` selects peek type `t`.
+ * @param field Receives the field.
+ * @return `false` when no fields are left.
+ */
+bool cte_field_index_next(const cte_field_index_t *index, cte_field_index_cursor_t *cursor, uint32_t types,
+                          cte_field_index_field_t *field);
+
+/**
+ * @brief Maps an archive and its sidecar, rebuilding the sidecar if it is missing or stale.
+ *
+ * A rebuilt sidecar is written to a temporary file, synced and renamed
+ * into place. If that fails (for example in a read-only directory) the
+ * index is still returned from memory and `persisted` is `false`.
+ *
+ * @param file Receives the mapped archive and index.
+ * @param archive_path Path of the archive.
+ * @return `false` with `errno` set if the archive cannot be read or the index cannot be built.
+ * @note POSIX only.
+ */
+bool cte_field_index_load(cte_field_index_file_t *file, const char *archive_path);
+
+/**
+ * @brief Unmaps an archive and sidecar loaded by `cte_field_index_load()`.
+ * @param file The loaded file.
+ */
+void cte_field_index_unload(cte_field_index_file_t *file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIELD_INDEX_H
@@ -0,0 +1,199 @@
+#include "hex_codec.h"
+#include <stdlea.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#include <immintrin.h>
+#define HEX_CODEC_X86 1
+#endif
+
+/** @brief Upper-case digit for each nibble. */
+static const char hex_digits[16] = "0123456789ABCDEF";
+
+/**
+ * @brief Returns the value of one hex digit, or -1 if it is not a digit.
+ * @note Internal helper function.
+ */
+static int _nibble(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    c |= 0x20; // fold 'A'-'F' onto 'a'-'f'
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief Decodes `count` bytes with the scalar loop.
+ * @note Internal helper function.
+ */
+static bool _decode_scalar(const char *hex, size_t count, uint8_t *out)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        int hi = _nibble(hex[2 * i]);
+        int lo = _nibble(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0)
+        {
+            return false;
+        }
+        out[i] = (uint8_t)(hi << 4 | lo);
+    }
+    return true;
+}
+
+/**
+ * @brief Encodes `size` bytes with the scalar loop.
+ * @note Internal helper function.
+ */
+static void _encode_scalar(const uint8_t *data, size_t size, char *out)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        out[2 * i] = hex_digits[data[i] >> 4];
+        out[2 * i + 1] = hex_digits[data[i] & 0x0F];
+    }
+}
+
+#ifdef HEX_CODEC_X86
+
+/*
+ * Digit classification with signed byte compares: adding 0x80 - '0' maps
+ * '0'..'9' onto -128..-119, so "is a decimal digit" becomes "< -118".
+ * Letters are case-folded with | 0x20 and classified the same way.
+ */
+
+/**
+ * @brief Decodes 16 digits into 8 bytes with SSE2.
+ * @return `false` if any of the digits is invalid.
+ * @note Internal helper function.
+ */
+static bool _decode_sse2_block(const char *hex, uint8_t *out)
+{
+    __m128i c = _mm_loadu_si128((const __m128i *)hex);
+    __m128i folded = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    __m128i digit = _mm_cmplt_epi8(_mm_add_epi8(c, _mm_set1_epi8((char)(0x80 - '0'))), _mm_set1_epi8(-118));
+    __m128i alpha = _mm_cmplt_epi8(_mm_add_epi8(folded, _mm_set1_epi8((char)(0x80 - 'a'))), _mm_set1_epi8(-122));
+    if (_mm_movemask_epi8(_mm_or_si128(digit, alpha)) != 0xFFFF)
+    {
+        return false;
+    }
+    __m128i nibbles = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+                                   _mm_and_si128(alpha, _mm_sub_epi8(folded, _mm_set1_epi8('a' - 10))));
+    // Each 16-bit lane holds (high nibble, low nibble) in memory order.
+    __m128i bytes = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4),
+                                 _mm_srli_epi16(nibbles, 8));
+    _mm_storel_epi64((__m128i *)out, _mm_packus_epi16(bytes, bytes));
+    return true;
+}
+
+/**
+ * @brief Encodes 8 bytes into 16 digits with SSE2.
+ * @note Internal helper function.
+ */
+static void _encode_sse2_block(const uint8_t *data, char *out)
+{
+    __m128i b = _mm_loadl_epi64((const __m128i *)data);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(b, 4), _mm_set1_epi8(0x0F));
+    __m128i lo = _mm_and_si128(b, _mm_set1_epi8(0x0F));
+    __m128i nibbles = _mm_unpacklo_epi8(hi, lo);
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('A' - '0' - 10));
+    _mm_storeu_si128((__m128i *)out, _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters));
+}
+
+/**
+ * @brief Decodes 32 digits into 16 bytes with AVX2.
+ * @return `false` if any of the digits is invalid.
+ * @note Internal helper function.
+ */
+__attribute__((target("avx2"))) static bool _decode_avx2_block(const char *hex, uint8_t *out)
+{
+    __m256i c = _mm256_loadu_si256((const __m256i *)hex);
+    __m256i folded = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+    __m256i digit =
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(-118), _mm256_add_epi8(c, _mm256_set1_epi8((char)(0x80 - '0'))));
+    __m256i alpha =
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(-122), _mm256_add_epi8(folded, _mm256_set1_epi8((char)(0x80 - 'a'))));
+    if ((uint32_t)_mm256_movemask_epi8(_mm256_or_si256(digit, alpha)) != 0xFFFFFFFFu)
+    {
+        return false;
+    }
+    __m256i nibbles = _mm256_or_si256(_mm256_and_si256(digit, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+                                      _mm256_and_si256(alpha, _mm256_sub_epi8(folded, _mm256_set1_epi8('a' - 10))));
+    __m256i bytes = _mm256_maddubs_epi16(nibbles, _mm256_set1_epi16(0x0110)); // high * 16 + low
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(bytes, bytes), 0x08);
+    _mm_storeu_si128((__m128i *)out, _mm256_castsi256_si128(packed));
+    return true;
+}
+
+/**
+ * @brief Encodes 16 bytes into 32 digits with AVX2.
+ * @note Internal helper function.
+ */
+__attribute__((target("avx2"))) static void _encode_avx2_block(const uint8_t *data, char *out)
+{
+    __m128i b = _mm_loadu_si128((const __m128i *)data);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(b, 4), _mm_set1_epi8(0x0F));
+    __m128i lo = _mm_and_si128(b, _mm_set1_epi8(0x0F));
+    __m256i nibbles = _mm256_set_m128i(_mm_unpackhi_epi8(hi, lo), _mm_unpacklo_epi8(hi, lo));
+    __m256i letters =
+        _mm256_and_si256(_mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9)), _mm256_set1_epi8('A' - '0' - 10));
+    _mm256_storeu_si256((__m256i *)out, _mm256_add_epi8(_mm256_add_epi8(nibbles, _mm256_set1_epi8('0')), letters));
+}
+
+#endif // HEX_CODEC_X86
+
+LEA_EXPORT(cte_hex_decode)
+bool cte_hex_decode(const char *hex, size_t length, uint8_t *out)
+{
+    if (length % 2 != 0)
+    {
+        return false;
+    }
+    size_t count = length / 2;
+    size_t done = 0;
+#ifdef HEX_CODEC_X86
+    if (__builtin_cpu_supports("avx2"))
+    {
+        for (; done + 16 <= count; done += 16)
+        {
+            if (!_decode_avx2_block(hex + 2 * done, out + done))
+            {
+                return false;
+            }
+        }
+    }
+    for (; done + 8 <= count; done += 8)
+    {
+        if (!_decode_sse2_block(hex + 2 * done, out + done))
+        {
+            return false;
+        }
+    }
+#endif
+    return _decode_scalar(hex + 2 * done, count - done, out + done);
+}
+
+LEA_EXPORT(cte_hex_encode)
+void cte_hex_encode(const uint8_t *data, size_t size, char *out)
+{
+    size_t done = 0;
+#ifdef HEX_CODEC_X86
+    if (__builtin_cpu_supports("avx2"))
+    {
+        for (; done + 16 <= size; done += 16)
+        {
+            _encode_avx2_block(data + done, out + 2 * done);
+        }
+    }
+    for (; done + 8 <= size; done += 8)
+    {
+        _encode_sse2_block(data + done, out + 2 * done);
+    }
+#endif
+    _encode_scalar(data + done, size - done, out + 2 * done);
+}
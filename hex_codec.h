@@ -0,0 +1,41 @@
+#ifndef HEX_CODEC_H
+#define HEX_CODEC_H
+
+#include <stdlea.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file hex_codec.h
+ * @brief Validated hexadecimal encoding and decoding of byte strings.
+ *
+ * On x86 the codec processes 32 digits per step with AVX2 when the CPU
+ * supports it (checked at run time) and 16 digits per step with SSE2
+ * otherwise; the tail and other targets use a scalar loop. All paths accept
+ * exactly the same input and produce the same output.
+ */
+
+/**
+ * @brief Decodes a string of hexadecimal digits.
+ * @param hex The digits (`0-9`, `a-f`, `A-F`); no prefix, separators or terminator.
+ * @param length The number of digits at `hex`; must be even.
+ * @param out Receives `length / 2` bytes. Its contents are unspecified on failure.
+ * @return `true` on success, `false` if `length` is odd or any digit is invalid.
+ */
+bool cte_hex_decode(const char *hex, size_t length, uint8_t *out);
+
+/**
+ * @brief Encodes bytes as upper-case hexadecimal digits.
+ * @param data The bytes to encode.
+ * @param size The number of bytes at `data`.
+ * @param out Receives `2 * size` digits; no terminator is written.
+ */
+void cte_hex_encode(const uint8_t *data, size_t size, char *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HEX_CODEC_H
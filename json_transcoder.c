@@ -0,0 +1,713 @@
+#include "json_transcoder.h"
+#include "decoder.h"
+#include "hex_codec.h"
+#include "number_format.h"
+#include <stdlib.h>
+#include <stdlea.h>
+
+/** @brief How a JSON member is encoded. */
+typedef enum
+{
+    KIND_UINT,
+    KIND_INT,
+    KIND_ULEB,
+    KIND_SLEB,
+    KIND_FLOAT32,
+    KIND_FLOAT64,
+    KIND_BOOL,
+    KIND_INDEX,
+    KIND_CMD,
+    KIND_PK_LIST,
+    KIND_SIG_LIST,
+} field_kind_t;
+
+/**
+ * @struct json_field
+ * @brief One member name and how to encode its value.
+ */
+typedef struct json_field
+{
+    const char *name;
+    field_kind_t kind;
+    uint8_t width;     /**< Byte width of fixed integers; crypto type code of lists. */
+} json_field_t;
+
+/** @brief Member names accepted by `cte_json_to_cte()`. */
+static const json_field_t json_fields[] = {
+    {"uint8", KIND_UINT, 1},
+    {"uint16", KIND_UINT, 2},
+    {"uint32", KIND_UINT, 4},
+    {"uint64", KIND_UINT, 8},
+    {"int8", KIND_INT, 1},
+    {"int16", KIND_INT, 2},
+    {"int32", KIND_INT, 4},
+    {"int64", KIND_INT, 8},
+    {"uleb", KIND_ULEB, 0},
+    {"sleb", KIND_SLEB, 0},
+    {"float", KIND_FLOAT32, 0},
+    {"double", KIND_FLOAT64, 0},
+    {"bool", KIND_BOOL, 0},
+    {"index", KIND_INDEX, 0},
+    {"cmd", KIND_CMD, 0},
+    {"pk-list-ed25519", KIND_PK_LIST, CTE_CRYPTO_TYPE_ED25519},
+    {"pk-list-slh128f", KIND_PK_LIST, CTE_CRYPTO_TYPE_SLH_DSA_128F},
+    {"pk-list-slh192f", KIND_PK_LIST, CTE_CRYPTO_TYPE_SLH_DSA_192F},
+    {"pk-list-slh256f", KIND_PK_LIST, CTE_CRYPTO_TYPE_SLH_DSA_256F},
+    {"sig-list-ed25519", KIND_SIG_LIST, CTE_CRYPTO_TYPE_ED25519},
+    {"sig-list-slh128f", KIND_SIG_LIST, CTE_CRYPTO_TYPE_SLH_DSA_128F},
+    {"sig-list-slh192f", KIND_SIG_LIST, CTE_CRYPTO_TYPE_SLH_DSA_192F},
+    {"sig-list-slh256f", KIND_SIG_LIST, CTE_CRYPTO_TYPE_SLH_DSA_256F},
+};
+
+/** @brief Member name for each `CTE_PEEK_TYPE_*` identifier; see `cte_json_field_name()`. */
+static const char *const peek_type_names[] = {
+    "pk-list-ed25519", "pk-list-slh128f", "pk-list-slh192f", "pk-list-slh256f", "sig-list-ed25519",
+    "sig-list-slh128f", "sig-list-slh192f", "sig-list-slh256f", "index", "uleb", "uleb", "sleb",
+    "int8", "int16", "int32", "int64", "uint8", "uint16", "uint32", "uint64",
+    "float", "double", "bool", "bool", "cmd", "cmd",
+};
+
+/**
+ * @struct json_parser
+ * @brief Cursor over the JSON text.
+ */
+typedef struct json_parser
+{
+    const char *json;
+    size_t length;
+    size_t position;
+    cte_json_error_t *error;
+} json_parser_t;
+
+/**
+ * @brief Records an error at the current position.
+ * @return `false`, for use in `return _fail(...)`.
+ * @note Internal helper function.
+ */
+static bool _fail(json_parser_t *parser, const char *message)
+{
+    if (parser->error)
+    {
+        parser->error->offset = parser->position;
+        parser->error->message = message;
+    }
+    return false;
+}
+
+/**
+ * @brief Skips JSON whitespace and returns the next character, or 0 at the end.
+ * @note Internal helper function.
+ */
+static char _peek(json_parser_t *parser)
+{
+    while (parser->position < parser->length)
+    {
+        char c = parser->json[parser->position];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+        {
+            return c;
+        }
+        parser->position++;
+    }
+    return 0;
+}
+
+/**
+ * @brief Consumes `c` after optional whitespace.
+ * @note Internal helper function.
+ */
+static bool _expect(json_parser_t *parser, char c, const char *message)
+{
+    if (_peek(parser) != c)
+    {
+        return _fail(parser, message);
+    }
+    parser->position++;
+    return true;
+}
+
+/**
+ * @brief Parses a string without escapes; member names and hex never need them.
+ * @param start Receives the first character inside the quotes.
+ * @param length Receives the number of characters inside the quotes.
+ * @note Internal helper function.
+ */
+static bool _parse_string(json_parser_t *parser, const char **start, size_t *length)
+{
+    if (!_expect(parser, '"', "Expected a string"))
+    {
+        return false;
+    }
+    size_t first = parser->position;
+    const char *end = memchr(parser->json + first, '"', parser->length - first);
+    if (!end)
+    {
+        parser->position = first - 1;
+        return _fail(parser, "Unterminated string");
+    }
+    size_t last = (size_t)(end - parser->json);
+    if (memchr(parser->json + first, '\\', last - first))
+    {
+        parser->position = first - 1;
+        return _fail(parser, "Escape sequences are not supported");
+    }
+    *start = parser->json + first;
+    *length = last - first;
+    parser->position = last + 1;
+    return true;
+}
+
+/**
+ * @brief Parses an integer literal as a sign and a 64-bit magnitude.
+ * @note Internal helper function.
+ */
+static bool _parse_integer(json_parser_t *parser, bool *negative, uint64_t *magnitude)
+{
+    _peek(parser);
+    const char *p = parser->json + parser->position;
+    const char *end = parser->json + parser->length;
+    *negative = p < end && *p == '-';
+    p += *negative;
+    if (p == end || *p < '0' || *p > '9')
+    {
+        return _fail(parser, "Expected an integer");
+    }
+    if (*p == '0' && p + 1 < end && p[1] >= '0' && p[1] <= '9')
+    {
+        return _fail(parser, "Leading zeros are not allowed");
+    }
+    uint64_t value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p)
+    {
+        uint64_t digit = (uint64_t)(*p - '0');
+        if (value > (UINT64_MAX - digit) / 10)
+        {
+            return _fail(parser, "Integer out of range");
+        }
+        value = value * 10 + digit;
+    }
+    if (p < end && (*p == '.' || *p == 'e' || *p == 'E'))
+    {
+        return _fail(parser, "Expected an integer");
+    }
+    parser->position = (size_t)(p - parser->json);
+    *magnitude = value;
+    return true;
+}
+
+/**
+ * @brief Parses an unsigned integer no larger than `max`.
+ * @note Internal helper function.
+ */
+static bool _parse_unsigned(json_parser_t *parser, uint64_t max, uint64_t *value)
+{
+    bool negative;
+    size_t start = _peek(parser) ? parser->position : parser->length;
+    if (!_parse_integer(parser, &negative, value))
+    {
+        return false;
+    }
+    if ((negative && *value != 0) || *value > max)
+    {
+        parser->position = start;
+        return _fail(parser, "Integer out of range");
+    }
+    return true;
+}
+
+/**
+ * @brief Parses a signed integer that fits in `width` bytes.
+ * @note Internal helper function.
+ */
+static bool _parse_signed(json_parser_t *parser, unsigned width, int64_t *value)
+{
+    bool negative;
+    uint64_t magnitude;
+    size_t start = _peek(parser) ? parser->position : parser->length;
+    if (!_parse_integer(parser, &negative, &magnitude))
+    {
+        return false;
+    }
+    uint64_t limit = (uint64_t)1 << (8 * width - 1); // |min|; max is one less
+    if (magnitude > (negative ? limit : limit - 1))
+    {
+        parser->position = start;
+        return _fail(parser, "Integer out of range");
+    }
+    *value = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+    return true;
+}
+
+/**
+ * @brief Parses a number, or "NaN", "Infinity" or "-Infinity".
+ * @param single Whether the value is stored as a float32, whose range a number must then fit.
+ * @note Internal helper function.
+ */
+static bool _parse_float(json_parser_t *parser, bool single, double *value)
+{
+    if (_peek(parser) == '"')
+    {
+        const char *text;
+        size_t length;
+        if (!_parse_string(parser, &text, &length))
+        {
+            return false;
+        }
+        if (length == 3 && memcmp(text, "NaN", 3) == 0)
+        {
+            *value = __builtin_nan("");
+        }
+        else if (length == 8 && memcmp(text, "Infinity", 8) == 0)
+        {
+            *value = __builtin_inf();
+        }
+        else if (length == 9 && memcmp(text, "-Infinity", 9) == 0)
+        {
+            *value = -__builtin_inf();
+        }
+        else
+        {
+            return _fail(parser, "Expected a number");
+        }
+        return true;
+    }
+
+    // strtod needs a terminated copy; JSON numbers have a restricted alphabet.
+    char number[64];
+    size_t length = 0;
+    while (parser->position + length < parser->length && length < sizeof(number) - 1 &&
+           strchr("0123456789+-.eE", parser->json[parser->position + length]) &&
+           parser->json[parser->position + length] != '\0')
+    {
+        number[length] = parser->json[parser->position + length];
+        length++;
+    }
+    number[length] = '\0';
+    // strtod is laxer than JSON: require a digit first, no leading zeros and digits after '.'.
+    const char *digits = number + (number[0] == '-');
+    const char *point = strchr(digits, '.');
+    bool strict = digits[0] >= '0' && digits[0] <= '9' && !(digits[0] == '0' && digits[1] >= '0' && digits[1] <= '9') &&
+                  !(point && (point[1] < '0' || point[1] > '9'));
+    char *end;
+    *value = strtod(number, &end);
+    if (!strict || end != number + length)
+    {
+        return _fail(parser, "Expected a number");
+    }
+    // A finite literal must stay finite; only the strings above produce infinities.
+    if (__builtin_isinf(*value) || (single && __builtin_isinf((float)*value)))
+    {
+        return _fail(parser, "Number out of range");
+    }
+    parser->position += length;
+    return true;
+}
+
+/**
+ * @brief Parses a hex string into a list or Command Data payload.
+ * @param out Receives the bytes.
+ * @param capacity The size of `out`.
+ * @param size Receives the number of bytes.
+ * @note Internal helper function.
+ */
+static bool _parse_hex(json_parser_t *parser, uint8_t *out, size_t capacity, size_t *size)
+{
+    const char *text;
+    size_t length;
+    size_t start = parser->position;
+    if (!_parse_string(parser, &text, &length))
+    {
+        return false;
+    }
+    if (length / 2 > capacity || !cte_hex_decode(text, length, out))
+    {
+        parser->position = start;
+        return _fail(parser, "Invalid hex string");
+    }
+    *size = length / 2;
+    return true;
+}
+
+/**
+ * @brief Parses the value of one member and writes the field.
+ * @note Internal helper function.
+ */
+static bool _parse_value(json_parser_t *parser, const json_field_t *field, cte_encoder_t *encoder)
+{
+    switch (field->kind)
+    {
+    case KIND_UINT:
+    case KIND_ULEB:
+    {
+        uint64_t max = field->width == 8 || field->kind == KIND_ULEB ? UINT64_MAX : ((uint64_t)1 << (8 * field->width)) - 1;
+        uint64_t value = 0;
+        if (!_parse_unsigned(parser, max, &value))
+        {
+            return false;
+        }
+        if (field->kind == KIND_ULEB)
+        {
+            cte_encoder_write_ixdata_uleb128(encoder, value);
+        }
+        else if (field->width == 1)
+        {
+            cte_encoder_write_ixdata_uint8(encoder, (uint8_t)value);
+        }
+        else if (field->width == 2)
+        {
+            cte_encoder_write_ixdata_uint16(encoder, (uint16_t)value);
+        }
+        else if (field->width == 4)
+        {
+            cte_encoder_write_ixdata_uint32(encoder, (uint32_t)value);
+        }
+        else
+        {
+            cte_encoder_write_ixdata_uint64(encoder, value);
+        }
+        return true;
+    }
+    case KIND_INT:
+    case KIND_SLEB:
+    {
+        int64_t value = 0;
+        if (!_parse_signed(parser, field->kind == KIND_SLEB ? 8 : field->width, &value))
+        {
+            return false;
+        }
+        if (field->kind == KIND_SLEB)
+        {
+            cte_encoder_write_ixdata_sleb128(encoder, value);
+        }
+        else if (field->width == 1)
+        {
+            cte_encoder_write_ixdata_int8(encoder, (int8_t)value);
+        }
+        else if (field->width == 2)
+        {
+            cte_encoder_write_ixdata_int16(encoder, (int16_t)value);
+        }
+        else if (field->width == 4)
+        {
+            cte_encoder_write_ixdata_int32(encoder, (int32_t)value);
+        }
+        else
+        {
+            cte_encoder_write_ixdata_int64(encoder, value);
+        }
+        return true;
+    }
+    case KIND_FLOAT32:
+    case KIND_FLOAT64:
+    {
+        double value = 0;
+        if (!_parse_float(parser, field->kind == KIND_FLOAT32, &value))
+        {
+            return false;
+        }
+        if (field->kind == KIND_FLOAT32)
+        {
+            cte_encoder_write_ixdata_float32(encoder, (float)value);
+        }
+        else
+        {
+            cte_encoder_write_ixdata_float64(encoder, value);
+        }
+        return true;
+    }
+    case KIND_BOOL:
+    {
+        char c = _peek(parser);
+        size_t rest = parser->length - parser->position;
+        if (c == 't' && rest >= 4 && memcmp(parser->json + parser->position, "true", 4) == 0)
+        {
+            parser->position += 4;
+            cte_encoder_write_ixdata_boolean(encoder, true);
+            return true;
+        }
+        if (c == 'f' && rest >= 5 && memcmp(parser->json + parser->position, "false", 5) == 0)
+        {
+            parser->position += 5;
+            cte_encoder_write_ixdata_boolean(encoder, false);
+            return true;
+        }
+        return _fail(parser, "Expected true or false");
+    }
+    case KIND_INDEX:
+    {
+        uint64_t value = 0;
+        if (!_parse_unsigned(parser, 15, &value))
+        {
+            return false;
+        }
+        cte_encoder_write_ixdata_index_reference(encoder, (uint8_t)value);
+        return true;
+    }
+    case KIND_CMD:
+    {
+        uint8_t payload[CTE_MAX_TRANSACTION_SIZE];
+        size_t size;
+        size_t start = _peek(parser) ? parser->position : parser->length;
+        if (!_parse_hex(parser, payload, sizeof(payload), &size))
+        {
+            return false;
+        }
+        if (size > CTE_COMMAND_EXTENDED_MAX_LEN)
+        {
+            parser->position = start;
+            return _fail(parser, "Command Data payload is longer than 1197 bytes");
+        }
+        memcpy(cte_encoder_begin_command_data(encoder, size), payload, size);
+        return true;
+    }
+    case KIND_PK_LIST:
+    case KIND_SIG_LIST:
+    {
+        uint8_t items[CTE_LIST_MAX_LEN * CTE_SIGNATURE_SIZE_ED25519];
+        size_t size;
+        size_t start = _peek(parser) ? parser->position : parser->length;
+        if (!_parse_hex(parser, items, sizeof(items), &size))
+        {
+            return false;
+        }
+        size_t item_size = field->kind == KIND_PK_LIST ? get_public_key_size(field->width)
+                                                       : get_signature_item_size(field->width);
+        size_t count = size / item_size;
+        if (size % item_size != 0 || count == 0 || count > CTE_LIST_MAX_LEN)
+        {
+            parser->position = start;
+            return _fail(parser, "List size is not 1-15 whole items");
+        }
+        void *out = field->kind == KIND_PK_LIST
+                        ? cte_encoder_begin_public_key_list(encoder, (uint8_t)count, field->width)
+                        : cte_encoder_begin_signature_list(encoder, (uint8_t)count, field->width);
+        memcpy(out, items, size);
+        return true;
+    }
+    }
+    return _fail(parser, "Unknown field type");
+}
+
+/**
+ * @brief Parses one `{"type": value}` object and writes its field.
+ * @note Internal helper function.
+ */
+static bool _parse_field(json_parser_t *parser, cte_encoder_t *encoder)
+{
+    if (!_expect(parser, '{', "Expected '{'"))
+    {
+        return false;
+    }
+    size_t name_offset = _peek(parser) ? parser->position : parser->length;
+    const char *name;
+    size_t name_length;
+    if (!_parse_string(parser, &name, &name_length))
+    {
+        return false;
+    }
+    const json_field_t *field = NULL;
+    for (size_t i = 0; i < sizeof(json_fields) / sizeof(json_fields[0]); ++i)
+    {
+        if (strlen(json_fields[i].name) == name_length && memcmp(json_fields[i].name, name, name_length) == 0)
+        {
+            field = &json_fields[i];
+            break;
+        }
+    }
+    if (!field)
+    {
+        parser->position = name_offset;
+        return _fail(parser, "Unknown field type");
+    }
+    return _expect(parser, ':', "Expected ':'") && _parse_value(parser, field, encoder) &&
+           _expect(parser, '}', "Expected '}'");
+}
+
+LEA_EXPORT(cte_json_to_cte)
+bool cte_json_to_cte(cte_encoder_t *encoder, const char *json, size_t length, cte_json_error_t *error)
+{
+    json_parser_t parser = {json, length, 0, error};
+    if (!_expect(&parser, '[', "Expected '['"))
+    {
+        return false;
+    }
+    if (_peek(&parser) == ']')
+    {
+        parser.position++;
+    }
+    else
+    {
+        for (;;)
+        {
+            if (!_parse_field(&parser, encoder))
+            {
+                return false;
+            }
+            char c = _peek(&parser);
+            parser.position++;
+            if (c == ']')
+            {
+                break;
+            }
+            if (c != ',')
+            {
+                parser.position--;
+                return _fail(&parser, "Expected ',' or ']'");
+            }
+        }
+    }
+    if (_peek(&parser) != 0)
+    {
+        return _fail(&parser, "Unexpected data after the transaction");
+    }
+    return true;
+}
+
+/**
+ * @struct json_writer
+ * @brief Bounded output buffer; `overflow` is set once anything did not fit.
+ */
+typedef struct json_writer
+{
+    char *out;
+    size_t capacity;
+    size_t length;
+    bool overflow;
+} json_writer_t;
+
+/**
+ * @brief Appends `size` characters.
+ * @note Internal helper function.
+ */
+static void _append(json_writer_t *writer, const char *text, size_t size)
+{
+    if (writer->overflow || writer->capacity - writer->length <= size)
+    {
+        writer->overflow = true;
+        return;
+    }
+    memcpy(writer->out + writer->length, text, size);
+    writer->length += size;
+}
+
+/**
+ * @brief Appends a float in its shortest round-trip form; 32-bit if `single`.
+ * @note Internal helper function.
+ */
+static void _append_float(json_writer_t *writer, double value, bool single)
+{
+    if (value != value)
+    {
+        _append(writer, "\"NaN\"", 5);
+        return;
+    }
+    if (value == __builtin_inf() || value == -__builtin_inf())
+    {
+        _append(writer, value > 0 ? "\"Infinity\"" : "\"-Infinity\"", value > 0 ? 10 : 11);
+        return;
+    }
+    char number[CTE_NUMBER_MAX_LENGTH];
+    _append(writer, number, single ? cte_format_float((float)value, number) : cte_format_double(value, number));
+}
+
+/**
+ * @brief Appends bytes as a quoted hex string.
+ * @note Internal helper function.
+ */
+static void _append_hex(json_writer_t *writer, const uint8_t *data, size_t size)
+{
+    if (writer->overflow || writer->capacity - writer->length <= 2 * size + 2)
+    {
+        writer->overflow = true;
+        return;
+    }
+    writer->out[writer->length++] = '"';
+    cte_hex_encode(data, size, writer->out + writer->length);
+    writer->length += 2 * size;
+    writer->out[writer->length++] = '"';
+}
+
+LEA_EXPORT(cte_json_from_cte)
+size_t cte_json_from_cte(const uint8_t *data, size_t size, char *out, size_t capacity)
+{
+    if (capacity == 0 || !cte_decoder_validate(data, size, NULL))
+    {
+        return 0;
+    }
+    // Validated, so the aborting reads below cannot fail.
+    cte_decoder_t decoder = cte_decoder_view(data, size, 1);
+    json_writer_t writer = {out, capacity, 0, false};
+    cte_field_t field;
+
+    _append(&writer, "[", 1);
+    for (size_t index = 0;; ++index)
+    {
+        int type = cte_decoder_peek_type(&decoder);
+        if (type == CTE_PEEK_EOF)
+        {
+            break;
+        }
+        cte_decoder_read_field(&decoder, type, &field);
+
+        if (index > 0)
+        {
+            _append(&writer, ",", 1);
+        }
+        _append(&writer, "{\"", 2);
+        _append(&writer, peek_type_names[type], strlen(peek_type_names[type]));
+        _append(&writer, "\":", 2);
+        switch (type)
+        {
+        case CTE_PEEK_TYPE_IXDATA_SLEB128:
+        case CTE_PEEK_TYPE_IXDATA_INT8:
+        case CTE_PEEK_TYPE_IXDATA_INT16:
+        case CTE_PEEK_TYPE_IXDATA_INT32:
+        case CTE_PEEK_TYPE_IXDATA_INT64:
+        {
+            char number[CTE_NUMBER_MAX_LENGTH];
+            _append(&writer, number, cte_format_int64(field.value.i64, number));
+            break;
+        }
+        case CTE_PEEK_TYPE_IXDATA_FLOAT32:
+            _append_float(&writer, field.value.f32, true);
+            break;
+        case CTE_PEEK_TYPE_IXDATA_FLOAT64:
+            _append_float(&writer, field.value.f64, false);
+            break;
+        case CTE_PEEK_TYPE_IXDATA_CONST_FALSE:
+        case CTE_PEEK_TYPE_IXDATA_CONST_TRUE:
+            _append(&writer, field.value.boolean ? "true" : "false", field.value.boolean ? 4 : 5);
+            break;
+        default:
+            if (type < CTE_PEEK_TYPE_IXDATA_LEGACY_INDEX || type >= CTE_PEEK_TYPE_CMD_SHORT)
+            {
+                _append_hex(&writer, field.data, field.length);
+            }
+            else
+            {
+                char number[CTE_NUMBER_MAX_LENGTH];
+                _append(&writer, number, cte_format_uint64(field.value.u64, number));
+            }
+            break;
+        }
+        _append(&writer, "}", 1);
+    }
+    _append(&writer, "]", 1);
+
+    if (writer.overflow)
+    {
+        return 0;
+    }
+    out[writer.length] = '\0';
+    return writer.length;
+}
+
+LEA_EXPORT(cte_json_field_name)
+const char *cte_json_field_name(int type)
+{
+    if (type < 0 || type > CTE_PEEK_TYPE_CMD_EXTENDED)
+    {
+        return NULL;
+    }
+    return peek_type_names[type];
+}
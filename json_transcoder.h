@@ -0,0 +1,88 @@
+#ifndef JSON_TRANSCODER_H
+#define JSON_TRANSCODER_H
+
+#include "encoder.h"
+#include <stdlea.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file json_transcoder.h
+ * @brief Conversion between CTE transactions and one-line JSON.
+ *
+ * A transaction is a JSON array of single-member objects, one per field, in
+ * wire order. Member names are the ctetool field types:
+ *
+ *     [{"uint8":255},{"sleb":-7},{"double":0.5},{"bool":true},
+ *      {"pk-list-ed25519":"<hex>"},{"cmd":"AABBCCDD"}]
+ *
+ * Integers are JSON numbers (no fraction or exponent), list items and
+ * Command Data payloads are hex strings, and floats are numbers in
+ * shortest round-trip form (see number_format.h) or one of "NaN",
+ * "Infinity" and "-Infinity". Numbers outside the range of their field
+ * type are rejected rather than saturated. Both directions stream: JSON is
+ * parsed straight into an encoder without building a tree, and output is
+ * rendered field by field from the decoder.
+ */
+
+/** @brief Upper bound on `cte_json_from_cte()` output for any valid transaction, excluding the terminator. */
+#define CTE_JSON_MAX_LENGTH (16 * CTE_MAX_TRANSACTION_SIZE + 2)
+
+/**
+ * @struct cte_json_error
+ * @brief Where and why `cte_json_to_cte()` rejected its input.
+ */
+typedef struct cte_json_error
+{
+    size_t offset;       /**< @param offset Offset of the offending character in the JSON text. */
+    const char *message; /**< @param message A static description of the problem. */
+} cte_json_error_t;
+
+/**
+ * @brief Parses one JSON transaction and appends its fields to an encoder.
+ *
+ * Whitespace around the array is allowed; anything else after it is an
+ * error. On failure the encoder holds the fields parsed so far.
+ *
+ * @param encoder The encoder to append to; usually freshly reset.
+ * @param json The JSON text; no terminator is required.
+ * @param length The number of characters at `json`.
+ * @param error Receives the error on failure; may be NULL.
+ * @return `true` on success.
+ * @note Aborts via `lea_abort` if the encoder runs out of capacity.
+ */
+bool cte_json_to_cte(cte_encoder_t *encoder, const char *json, size_t length, cte_json_error_t *error);
+
+/**
+ * @brief Renders a transaction as one line of JSON.
+ *
+ * Uses the non-aborting decoder reads, so malformed input is reported
+ * rather than aborting.
+ *
+ * @param data The encoded transaction.
+ * @param size The number of bytes at `data`, at most `CTE_MAX_TRANSACTION_SIZE`.
+ * @param out Receives the JSON (no newline) and a terminating NUL.
+ * @param capacity The size of `out`; `CTE_JSON_MAX_LENGTH + 1` always suffices.
+ * @return The length of the JSON, or 0 if the transaction is malformed or `out` is too small.
+ */
+size_t cte_json_from_cte(const uint8_t *data, size_t size, char *out, size_t capacity);
+
+/**
+ * @brief Returns the member name used for a field type, e.g. "uleb" or "pk-list-ed25519".
+ *
+ * These are also the field type names accepted by `cte_json_to_cte()`.
+ * Types that share a wire encoding (both Varint headers, both booleans,
+ * both Command Data forms) share a name.
+ *
+ * @param type A `CTE_PEEK_TYPE_*` identifier.
+ * @return A static string, or NULL if `type` is not a field type.
+ */
+const char *cte_json_field_name(int type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JSON_TRANSCODER_H
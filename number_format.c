@@ -0,0 +1,405 @@
+#include "number_format.h"
+#include <stdlea.h>
+
+/** @brief "00" to "99", for writing two digits per division. */
+static const char digit_pairs[200] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                                     "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                                     "8081828384858687888990919293949596979899";
+
+/** @brief Powers of ten that fit in 32 bits. */
+static const uint32_t pow10_32[10] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+/**
+ * @struct diy_fp
+ * @brief An unpacked float: `f * 2^e`.
+ */
+typedef struct diy_fp
+{
+    uint64_t f;
+    int e;
+} diy_fp_t;
+
+/** @brief Normalized 64-bit approximations of 1e-348, 1e-340, ..., 1e340. */
+static const diy_fp_t cached_powers[87] = {
+    {0xfa8fd5a0081c0288ull, -1220}, // 1e-348
+    {0xbaaee17fa23ebf76ull, -1193}, // 1e-340
+    {0x8b16fb203055ac76ull, -1166}, // 1e-332
+    {0xcf42894a5dce35eaull, -1140}, // 1e-324
+    {0x9a6bb0aa55653b2dull, -1113}, // 1e-316
+    {0xe61acf033d1a45dfull, -1087}, // 1e-308
+    {0xab70fe17c79ac6caull, -1060}, // 1e-300
+    {0xff77b1fcbebcdc4full, -1034}, // 1e-292
+    {0xbe5691ef416bd60cull, -1007}, // 1e-284
+    {0x8dd01fad907ffc3cull, -980}, // 1e-276
+    {0xd3515c2831559a83ull, -954}, // 1e-268
+    {0x9d71ac8fada6c9b5ull, -927}, // 1e-260
+    {0xea9c227723ee8bcbull, -901}, // 1e-252
+    {0xaecc49914078536dull, -874}, // 1e-244
+    {0x823c12795db6ce57ull, -847}, // 1e-236
+    {0xc21094364dfb5637ull, -821}, // 1e-228
+    {0x9096ea6f3848984full, -794}, // 1e-220
+    {0xd77485cb25823ac7ull, -768}, // 1e-212
+    {0xa086cfcd97bf97f4ull, -741}, // 1e-204
+    {0xef340a98172aace5ull, -715}, // 1e-196
+    {0xb23867fb2a35b28eull, -688}, // 1e-188
+    {0x84c8d4dfd2c63f3bull, -661}, // 1e-180
+    {0xc5dd44271ad3cdbaull, -635}, // 1e-172
+    {0x936b9fcebb25c996ull, -608}, // 1e-164
+    {0xdbac6c247d62a584ull, -582}, // 1e-156
+    {0xa3ab66580d5fdaf6ull, -555}, // 1e-148
+    {0xf3e2f893dec3f126ull, -529}, // 1e-140
+    {0xb5b5ada8aaff80b8ull, -502}, // 1e-132
+    {0x87625f056c7c4a8bull, -475}, // 1e-124
+    {0xc9bcff6034c13053ull, -449}, // 1e-116
+    {0x964e858c91ba2655ull, -422}, // 1e-108
+    {0xdff9772470297ebdull, -396}, // 1e-100
+    {0xa6dfbd9fb8e5b88full, -369}, // 1e-92
+    {0xf8a95fcf88747d94ull, -343}, // 1e-84
+    {0xb94470938fa89bcfull, -316}, // 1e-76
+    {0x8a08f0f8bf0f156bull, -289}, // 1e-68
+    {0xcdb02555653131b6ull, -263}, // 1e-60
+    {0x993fe2c6d07b7facull, -236}, // 1e-52
+    {0xe45c10c42a2b3b06ull, -210}, // 1e-44
+    {0xaa242499697392d3ull, -183}, // 1e-36
+    {0xfd87b5f28300ca0eull, -157}, // 1e-28
+    {0xbce5086492111aebull, -130}, // 1e-20
+    {0x8cbccc096f5088ccull, -103}, // 1e-12
+    {0xd1b71758e219652cull, -77}, // 1e-4
+    {0x9c40000000000000ull, -50}, // 1e4
+    {0xe8d4a51000000000ull, -24}, // 1e12
+    {0xad78ebc5ac620000ull, 3}, // 1e20
+    {0x813f3978f8940984ull, 30}, // 1e28
+    {0xc097ce7bc90715b3ull, 56}, // 1e36
+    {0x8f7e32ce7bea5c70ull, 83}, // 1e44
+    {0xd5d238a4abe98068ull, 109}, // 1e52
+    {0x9f4f2726179a2245ull, 136}, // 1e60
+    {0xed63a231d4c4fb27ull, 162}, // 1e68
+    {0xb0de65388cc8ada8ull, 189}, // 1e76
+    {0x83c7088e1aab65dbull, 216}, // 1e84
+    {0xc45d1df942711d9aull, 242}, // 1e92
+    {0x924d692ca61be758ull, 269}, // 1e100
+    {0xda01ee641a708deaull, 295}, // 1e108
+    {0xa26da3999aef774aull, 322}, // 1e116
+    {0xf209787bb47d6b85ull, 348}, // 1e124
+    {0xb454e4a179dd1877ull, 375}, // 1e132
+    {0x865b86925b9bc5c2ull, 402}, // 1e140
+    {0xc83553c5c8965d3dull, 428}, // 1e148
+    {0x952ab45cfa97a0b3ull, 455}, // 1e156
+    {0xde469fbd99a05fe3ull, 481}, // 1e164
+    {0xa59bc234db398c25ull, 508}, // 1e172
+    {0xf6c69a72a3989f5cull, 534}, // 1e180
+    {0xb7dcbf5354e9beceull, 561}, // 1e188
+    {0x88fcf317f22241e2ull, 588}, // 1e196
+    {0xcc20ce9bd35c78a5ull, 614}, // 1e204
+    {0x98165af37b2153dfull, 641}, // 1e212
+    {0xe2a0b5dc971f303aull, 667}, // 1e220
+    {0xa8d9d1535ce3b396ull, 694}, // 1e228
+    {0xfb9b7cd9a4a7443cull, 720}, // 1e236
+    {0xbb764c4ca7a44410ull, 747}, // 1e244
+    {0x8bab8eefb6409c1aull, 774}, // 1e252
+    {0xd01fef10a657842cull, 800}, // 1e260
+    {0x9b10a4e5e9913129ull, 827}, // 1e268
+    {0xe7109bfba19c0c9dull, 853}, // 1e276
+    {0xac2820d9623bf429ull, 880}, // 1e284
+    {0x80444b5e7aa7cf85ull, 907}, // 1e292
+    {0xbf21e44003acdd2dull, 933}, // 1e300
+    {0x8e679c2f5e44ff8full, 960}, // 1e308
+    {0xd433179d9c8cb841ull, 986}, // 1e316
+    {0x9e19db92b4e31ba9ull, 1013}, // 1e324
+    {0xeb96bf6ebadf77d9ull, 1039}, // 1e332
+    {0xaf87023b9bf0ee6bull, 1066}, // 1e340
+};
+
+LEA_EXPORT(cte_format_uint64)
+size_t cte_format_uint64(uint64_t value, char *out)
+{
+    char digits[20];
+    size_t i = sizeof(digits);
+    while (value >= 100)
+    {
+        unsigned pair = (unsigned)(value % 100) * 2;
+        value /= 100;
+        digits[--i] = digit_pairs[pair + 1];
+        digits[--i] = digit_pairs[pair];
+    }
+    if (value >= 10)
+    {
+        digits[--i] = digit_pairs[value * 2 + 1];
+        digits[--i] = digit_pairs[value * 2];
+    }
+    else
+    {
+        digits[--i] = (char)('0' + value);
+    }
+    size_t length = sizeof(digits) - i;
+    memcpy(out, digits + i, length);
+    return length;
+}
+
+LEA_EXPORT(cte_format_int64)
+size_t cte_format_int64(int64_t value, char *out)
+{
+    if (value < 0)
+    {
+        *out = '-';
+        return 1 + cte_format_uint64(0 - (uint64_t)value, out + 1);
+    }
+    return cte_format_uint64((uint64_t)value, out);
+}
+
+/**
+ * @brief Shifts `x` left until its top bit is set.
+ * @note Internal helper function.
+ */
+static diy_fp_t _normalize(diy_fp_t x)
+{
+    int shift = __builtin_clzll(x.f);
+    x.f <<= shift;
+    x.e -= shift;
+    return x;
+}
+
+/**
+ * @brief Multiplies two normalized values, rounding the 128-bit product to 64 bits.
+ * @note Internal helper function.
+ */
+static diy_fp_t _multiply(diy_fp_t x, diy_fp_t y)
+{
+    const uint64_t mask = 0xFFFFFFFFu;
+    uint64_t a = x.f >> 32, b = x.f & mask, c = y.f >> 32, d = y.f & mask;
+    uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    uint64_t middle = (bd >> 32) + (ad & mask) + (bc & mask) + (1u << 31); // round half up
+    diy_fp_t result = {ac + (ad >> 32) + (bc >> 32) + (middle >> 32), x.e + y.e + 64};
+    return result;
+}
+
+/**
+ * @brief Steps the last digit down while that moves closer to the exact value.
+ * @note Internal helper function.
+ */
+static void _round_weed(char *digits, size_t length, uint64_t delta, uint64_t rest, uint64_t ten_kappa,
+                        uint64_t distance)
+{
+    while (rest < distance && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < distance || distance - rest > rest + ten_kappa - distance))
+    {
+        digits[length - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+/**
+ * @brief Generates the shortest digits of a value inside the interval
+ * (`high` - `delta`, `high`), scaled by the cached power.
+ * @param w The scaled value.
+ * @param high The scaled upper boundary.
+ * @param delta Width of the interval.
+ * @param digits Receives the digits.
+ * @param k Decimal exponent of the last digit; adjusted in place.
+ * @return The number of digits.
+ * @note Internal helper function.
+ */
+static size_t _generate_digits(diy_fp_t w, diy_fp_t high, uint64_t delta, char *digits, int *k)
+{
+    const int shift = -high.e;
+    const uint64_t one = (uint64_t)1 << shift;
+    const uint64_t distance = high.f - w.f;
+    uint32_t integral = (uint32_t)(high.f >> shift);
+    uint64_t fraction = high.f & (one - 1);
+    size_t length = 0;
+
+    int kappa = 10;
+    while (kappa > 0 && pow10_32[kappa - 1] > integral)
+    {
+        kappa--;
+    }
+    while (kappa > 0)
+    {
+        uint32_t digit = integral / pow10_32[kappa - 1];
+        integral %= pow10_32[kappa - 1];
+        if (digit != 0 || length != 0)
+        {
+            digits[length++] = (char)('0' + digit);
+        }
+        kappa--;
+        uint64_t rest = ((uint64_t)integral << shift) + fraction;
+        if (rest <= delta)
+        {
+            *k += kappa;
+            _round_weed(digits, length, delta, rest, (uint64_t)pow10_32[kappa] << shift, distance);
+            return length;
+        }
+    }
+    for (;;)
+    {
+        fraction *= 10;
+        delta *= 10;
+        char digit = (char)(fraction >> shift);
+        if (digit != 0 || length != 0)
+        {
+            digits[length++] = (char)('0' + digit);
+        }
+        fraction &= one - 1;
+        kappa--;
+        if (fraction < delta)
+        {
+            *k += kappa;
+            int index = -kappa;
+            _round_weed(digits, length, delta, fraction, one, index < 10 ? distance * pow10_32[index] : 0);
+            return length;
+        }
+    }
+}
+
+/**
+ * @brief Runs Grisu2 on a positive value `f * 2^e`.
+ * @param lower_closer Whether the gap to the next smaller value is half the
+ * gap to the next larger one (the value is a power of two above the minimum exponent).
+ * @param digits Receives at least 17 digits.
+ * @param k Receives the decimal exponent of the last digit.
+ * @return The number of digits.
+ * @note Internal helper function.
+ */
+static size_t _grisu2(uint64_t f, int e, bool lower_closer, char *digits, int *k)
+{
+    diy_fp_t v = {f, e};
+    diy_fp_t high = _normalize((diy_fp_t){(f << 1) + 1, e - 1});
+    diy_fp_t low = lower_closer ? (diy_fp_t){(f << 2) - 1, e - 2} : (diy_fp_t){(f << 1) - 1, e - 1};
+    low.f <<= low.e - high.e;
+    low.e = high.e;
+
+    // Choose 10^-k so that the scaled upper boundary has a binary exponent in [-60, -32].
+    double dk = (-61 - high.e) * 0.30102999566398114 + 347;
+    int ik = (int)dk;
+    if (dk - ik > 0.0)
+    {
+        ik++;
+    }
+    unsigned index = (unsigned)((ik >> 3) + 1);
+    *k = -(-348 + (int)index * 8);
+    diy_fp_t c = cached_powers[index];
+
+    diy_fp_t w = _multiply(_normalize(v), c);
+    diy_fp_t scaled_high = _multiply(high, c);
+    diy_fp_t scaled_low = _multiply(low, c);
+    scaled_low.f++;
+    scaled_high.f--;
+    return _generate_digits(w, scaled_high, scaled_high.f - scaled_low.f, digits, k);
+}
+
+/**
+ * @brief Lays out `length` digits times 10^`k` in plain or exponent notation.
+ * @return The number of characters written.
+ * @note Internal helper function.
+ */
+static size_t _layout(const char *digits, size_t length, int k, char *out)
+{
+    int point = (int)length + k; // position of the decimal point relative to the first digit
+    if (point > 0 && point <= 21)
+    {
+        if (k >= 0)
+        {
+            memcpy(out, digits, length);
+            memset(out + length, '0', (size_t)k);
+            return length + (size_t)k;
+        }
+        memcpy(out, digits, (size_t)point);
+        out[point] = '.';
+        memcpy(out + point + 1, digits + point, length - (size_t)point);
+        return length + 1;
+    }
+    if (point <= 0 && point > -6)
+    {
+        out[0] = '0';
+        out[1] = '.';
+        memset(out + 2, '0', (size_t)-point);
+        memcpy(out + 2 - point, digits, length);
+        return 2 + (size_t)-point + length;
+    }
+    size_t n = 0;
+    out[n++] = digits[0];
+    if (length > 1)
+    {
+        out[n++] = '.';
+        memcpy(out + n, digits + 1, length - 1);
+        n += length - 1;
+    }
+    int exponent = point - 1;
+    out[n++] = 'e';
+    out[n++] = exponent < 0 ? '-' : '+';
+    return n + cte_format_uint64((uint64_t)(exponent < 0 ? -exponent : exponent), out + n);
+}
+
+/**
+ * @brief Formats the special cases shared by both precisions.
+ * @return The number of characters written, or 0 if `value` is finite and non-zero.
+ * @note Internal helper function.
+ */
+static size_t _format_special(double value, bool negative, char *out)
+{
+    if (value != value)
+    {
+        memcpy(out, "nan", 3);
+        return 3;
+    }
+    if (value == 0.0 || value == __builtin_inf() || value == -__builtin_inf())
+    {
+        const char *text = value == 0.0 ? "-0" : "-inf";
+        size_t length = value == 0.0 ? 2 : 4;
+        memcpy(out, text + !negative, length - !negative);
+        return length - !negative;
+    }
+    return 0;
+}
+
+LEA_EXPORT(cte_format_double)
+size_t cte_format_double(double value, char *out)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bool negative = bits >> 63;
+    size_t special = _format_special(value, negative, out);
+    if (special != 0)
+    {
+        return special;
+    }
+    if (negative)
+    {
+        *out++ = '-';
+    }
+
+    int biased = (int)((bits >> 52) & 0x7FF);
+    uint64_t fraction = bits & ((1ull << 52) - 1);
+    uint64_t f = biased ? fraction | 1ull << 52 : fraction;
+    int e = biased ? biased - 1075 : -1074;
+    char digits[20];
+    int k;
+    size_t length = _grisu2(f, e, biased > 1 && fraction == 0, digits, &k);
+    return (size_t)negative + _layout(digits, length, k, out);
+}
+
+LEA_EXPORT(cte_format_float)
+size_t cte_format_float(float value, char *out)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bool negative = bits >> 31;
+    size_t special = _format_special(value, negative, out);
+    if (special != 0)
+    {
+        return special;
+    }
+    if (negative)
+    {
+        *out++ = '-';
+    }
+
+    int biased = (int)((bits >> 23) & 0xFF);
+    uint32_t fraction = bits & ((1u << 23) - 1);
+    uint64_t f = biased ? fraction | 1u << 23 : fraction;
+    int e = biased ? biased - 150 : -149;
+    char digits[20];
+    int k;
+    size_t length = _grisu2(f, e, biased > 1 && fraction == 0, digits, &k);
+    return (size_t)negative + _layout(digits, length, k, out);
+}
@@ -0,0 +1,66 @@
+#ifndef NUMBER_FORMAT_H
+#define NUMBER_FORMAT_H
+
+#include <stdlea.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file number_format.h
+ * @brief Locale-independent decimal formatting of integers and floats.
+ *
+ * Integers are written two digits at a time from a lookup table. Floats use
+ * Grisu2 (Loitsch, "Printing Floating-Point Numbers Quickly and Accurately
+ * with Integers"): the output always parses back to the same value, and is
+ * the shortest such string for all but a small fraction of inputs. Output
+ * depends only on the value, never on locale or platform.
+ */
+
+/** @brief Buffer size sufficient for any call in this header. */
+#define CTE_NUMBER_MAX_LENGTH 32
+
+/**
+ * @brief Writes an unsigned integer in decimal.
+ * @param value The value.
+ * @param out Receives at most 20 characters; no terminator is written.
+ * @return The number of characters written.
+ */
+size_t cte_format_uint64(uint64_t value, char *out);
+
+/**
+ * @brief Writes a signed integer in decimal.
+ * @param value The value.
+ * @param out Receives at most 20 characters; no terminator is written.
+ * @return The number of characters written.
+ */
+size_t cte_format_int64(int64_t value, char *out);
+
+/**
+ * @brief Writes a double with the fewest digits that read back as the same value.
+ *
+ * Decimal exponents from -6 to 20 use plain notation ("0.001", "1500",
+ * "2.5"); others use "d.ddde+XX" form. NaN and infinities are written as
+ * "nan", "inf" and "-inf"; negative zero as "-0".
+ *
+ * @param value The value.
+ * @param out Receives at most `CTE_NUMBER_MAX_LENGTH` characters; no terminator is written.
+ * @return The number of characters written.
+ */
+size_t cte_format_double(double value, char *out);
+
+/**
+ * @brief Writes a float with the fewest digits that read back as the same float.
+ * @param value The value.
+ * @param out Receives at most `CTE_NUMBER_MAX_LENGTH` characters; no terminator is written.
+ * @return The number of characters written.
+ * @see cte_format_double() for the layout.
+ */
+size_t cte_format_float(float value, char *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NUMBER_FORMAT_H
@@ -0,0 +1,266 @@
+#include "segment_decoder.h"
+#include <stdlea.h>
+
+/** @brief Longest scalar field: an IxData header plus a 10-byte varint. */
+#define SCALAR_MAX_SIZE 11
+
+/**
+ * @brief Moves past exhausted (or empty) segments.
+ * @note Internal helper function.
+ */
+static void _normalize(cte_segment_decoder_t *decoder)
+{
+    while (decoder->segment < decoder->segment_count && decoder->offset == decoder->segments[decoder->segment].length)
+    {
+        decoder->segment++;
+        decoder->offset = 0;
+    }
+}
+
+/**
+ * @brief Copies `length` bytes starting at (`segment`, `offset`) into `out`.
+ * @note Internal helper function. The bytes must exist.
+ */
+static void _copy_from(const cte_segment_t *segments, size_t segment, size_t offset, uint8_t *out, size_t length)
+{
+    while (length > 0)
+    {
+        size_t take = segments[segment].length - offset;
+        take = take < length ? take : length;
+        // Empty segments may have a NULL base, which memcpy must not see even for zero bytes.
+        if (take)
+        {
+            memcpy(out, (const uint8_t *)segments[segment].base + offset, take);
+        }
+        out += take;
+        length -= take;
+        segment++;
+        offset = 0;
+    }
+}
+
+/**
+ * @brief Consumes `length` bytes.
+ * @note Internal helper function. The bytes must exist.
+ */
+static void _skip(cte_segment_decoder_t *decoder, size_t length)
+{
+    decoder->position += length;
+    while (length > 0)
+    {
+        size_t take = decoder->segments[decoder->segment].length - decoder->offset;
+        take = take < length ? take : length;
+        decoder->offset += take;
+        length -= take;
+        _normalize(decoder);
+    }
+}
+
+/**
+ * @brief Consumes a list or Command Data payload and records where it lies.
+ * @note Internal helper function.
+ */
+static void _take_payload(cte_segment_decoder_t *decoder, size_t header_size, size_t length,
+                          cte_segment_field_t *out)
+{
+    if (decoder->size - decoder->position < header_size + length)
+    {
+        lea_abort("Read past end of buffer");
+    }
+    _skip(decoder, header_size);
+    out->segment = decoder->segment;
+    out->segment_offset = decoder->offset;
+    out->field.length = length;
+    if (length == 0)
+    {
+        return;
+    }
+    if (decoder->segments[decoder->segment].length - decoder->offset >= length)
+    {
+        out->field.data = (const uint8_t *)decoder->segments[decoder->segment].base + decoder->offset;
+    }
+    _skip(decoder, length);
+}
+
+LEA_EXPORT(cte_segment_decoder_init)
+void cte_segment_decoder_init(cte_segment_decoder_t *decoder, const cte_segment_t *segments, size_t segment_count)
+{
+    if (!decoder || (!segments && segment_count != 0))
+    {
+        lea_abort("Null argument to segment_decoder_init");
+    }
+    size_t size = 0;
+    for (size_t i = 0; i < segment_count; ++i)
+    {
+        size += segments[i].length;
+    }
+    if (size == 0)
+    {
+        lea_abort("Zero size buffer");
+    }
+    if (size > CTE_MAX_TRANSACTION_SIZE)
+    {
+        lea_abort("Initial buffer size exceeds max transaction size");
+    }
+    decoder->segments = segments;
+    decoder->segment_count = segment_count;
+    decoder->segment = 0;
+    decoder->offset = 0;
+    decoder->position = 0;
+    decoder->size = size;
+    _normalize(decoder);
+}
+
+LEA_EXPORT(cte_segment_decoder_peek_type)
+int cte_segment_decoder_peek_type(cte_segment_decoder_t *decoder)
+{
+    if (decoder->position == 0)
+    {
+        if (((const uint8_t *)decoder->segments[decoder->segment].base)[decoder->offset] != CTE_VERSION_BYTE)
+        {
+            lea_abort("Invalid version byte");
+        }
+        _skip(decoder, 1);
+    }
+    if (decoder->position == decoder->size)
+    {
+        return CTE_PEEK_EOF;
+    }
+
+    const uint8_t *segment = decoder->segments[decoder->segment].base;
+    uint8_t scratch[2] = {CTE_VERSION_BYTE, segment[decoder->offset]};
+    cte_decoder_t header = cte_decoder_view(scratch, sizeof(scratch), 1);
+    return cte_decoder_peek_type(&header);
+}
+
+LEA_EXPORT(cte_segment_decoder_read_field)
+void cte_segment_decoder_read_field(cte_segment_decoder_t *decoder, int type, cte_segment_field_t *out)
+{
+    if (!decoder || !out)
+    {
+        lea_abort("Null argument to segment_decoder_read_field");
+    }
+    if (decoder->position == 0 || decoder->position == decoder->size)
+    {
+        lea_abort("Read past end of buffer");
+    }
+    memset(out, 0, sizeof(*out));
+    out->field.type = type;
+    out->field.offset = decoder->position;
+    out->segment = decoder->segment;
+    out->segment_offset = decoder->offset;
+
+    uint8_t header[2];
+    size_t available = decoder->size - decoder->position;
+    _copy_from(decoder->segments, decoder->segment, decoder->offset, header, available < 2 ? 1 : 2);
+    uint8_t count = (header[0] >> 2) & 0x0F;
+
+    switch (type)
+    {
+    case CTE_PEEK_TYPE_PK_LIST_ED25519:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_128F:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_192F:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_256F:
+        if ((header[0] & CTE_TAG_MASK) != CTE_TAG_PUBLIC_KEY_LIST)
+        {
+            lea_abort("Unexpected field tag");
+        }
+        if (count == 0)
+        {
+            lea_abort("Invalid public key list length read (N must be 1-15)");
+        }
+        out->field.count = count;
+        _take_payload(decoder, 1, count * get_public_key_size(header[0] & CTE_CRYPTO_TYPE_MASK), out);
+        return;
+    case CTE_PEEK_TYPE_SIG_LIST_ED25519:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_128F:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_192F:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_256F:
+        if ((header[0] & CTE_TAG_MASK) != CTE_TAG_SIGNATURE_LIST)
+        {
+            lea_abort("Unexpected field tag");
+        }
+        if (count == 0)
+        {
+            lea_abort("Invalid signature list length read (N must be 1-15)");
+        }
+        out->field.count = count;
+        _take_payload(decoder, 1, count * get_signature_item_size(header[0] & CTE_CRYPTO_TYPE_MASK), out);
+        return;
+    case CTE_PEEK_TYPE_CMD_SHORT:
+    case CTE_PEEK_TYPE_CMD_EXTENDED:
+        if ((header[0] & CTE_TAG_MASK) != CTE_TAG_COMMAND_DATA)
+        {
+            lea_abort("Expected Command Data tag in peek/parse");
+        }
+        if ((header[0] & CTE_COMMAND_FORMAT_FLAG_MASK) == CTE_COMMAND_FORMAT_SHORT)
+        {
+            _take_payload(decoder, 1, header[0] & CTE_COMMAND_SHORT_MAX_LEN, out);
+            return;
+        }
+        if (header[0] & 0x03)
+        {
+            lea_abort("Non-zero padding bits in Command Data Extended Header Byte 1");
+        }
+        if (available < 2)
+        {
+            lea_abort("Read past end of buffer");
+        }
+        size_t length = ((size_t)(header[0] >> 2) & 0x07) << 8 | header[1];
+        if (length < CTE_COMMAND_EXTENDED_MIN_LEN || length > CTE_COMMAND_EXTENDED_MAX_LEN)
+        {
+            lea_abort("Invalid extended command data length");
+        }
+        _take_payload(decoder, 2, length, out);
+        return;
+    default:
+        break;
+    }
+
+    // Scalars: reassemble the field behind a version byte and let decoder.c read it.
+    uint8_t scratch[1 + SCALAR_MAX_SIZE] = {CTE_VERSION_BYTE};
+    size_t gathered = available < SCALAR_MAX_SIZE ? available : SCALAR_MAX_SIZE;
+    _copy_from(decoder->segments, decoder->segment, decoder->offset, scratch + 1, gathered);
+    cte_decoder_t scalar = cte_decoder_view(scratch, 1 + gathered, 1);
+    cte_decoder_read_field(&scalar, type, &out->field);
+    out->field.offset = decoder->position;
+    _skip(decoder, scalar.position - 1);
+}
+
+LEA_EXPORT(cte_segment_decoder_copy_payload)
+void cte_segment_decoder_copy_payload(const cte_segment_decoder_t *decoder, const cte_segment_field_t *field,
+                                      uint8_t *out)
+{
+    if (field->field.length > 0)
+    {
+        _copy_from(decoder->segments, field->segment, field->segment_offset, out, field->field.length);
+    }
+}
+
+LEA_EXPORT(cte_segment_decoder_payload_segments)
+size_t cte_segment_decoder_payload_segments(const cte_segment_decoder_t *decoder, const cte_segment_field_t *field,
+                                            cte_segment_t *out, size_t max_segments)
+{
+    size_t remaining = field->field.length;
+    size_t segment = field->segment;
+    size_t offset = field->segment_offset;
+    size_t count = 0;
+    while (remaining > 0)
+    {
+        size_t take = decoder->segments[segment].length - offset;
+        take = take < remaining ? take : remaining;
+        if (take > 0)
+        {
+            if (count < max_segments)
+            {
+                out[count].base = (const uint8_t *)decoder->segments[segment].base + offset;
+                out[count].length = take;
+            }
+            count++;
+        }
+        remaining -= take;
+        segment++;
+        offset = 0;
+    }
+    return count;
+}
@@ -0,0 +1,120 @@
+#ifndef SEGMENT_DECODER_H
+#define SEGMENT_DECODER_H
+
+#include "decoder.h"
+#include <stdlea.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file segment_decoder.h
+ * @brief Decoder over a transaction split across a chain of segments.
+ *
+ * Transactions received as scatter lists or from a wrapping ring buffer are
+ * decoded in place, without first copying them into one contiguous buffer.
+ * Headers and scalar values that cross a segment boundary are reassembled
+ * in a few bytes of scratch space and decoded by decoder.c, so validation
+ * and error messages are identical to the contiguous decoder.
+ *
+ * List items and Command Data payloads that lie within one segment are
+ * returned zero-copy. Payloads that straddle a boundary are returned as a
+ * position in the chain; use `cte_segment_decoder_copy_payload()` to copy
+ * them out or `cte_segment_decoder_payload_segments()` for a segmented view.
+ */
+
+/**
+ * @struct cte_segment
+ * @brief One contiguous piece of a transaction.
+ *
+ * Has the same layout as POSIX `struct iovec`, so a received scatter list
+ * can be passed directly.
+ */
+typedef struct cte_segment
+{
+    const void *base; /**< @param base Start of the segment. */
+    size_t length;    /**< @param length Number of bytes in the segment; may be 0. */
+} cte_segment_t;
+
+/**
+ * @struct cte_segment_decoder
+ * @brief Read state over a segment chain. The chain is not copied and must
+ * outlive the decoder and every field read from it.
+ */
+typedef struct cte_segment_decoder
+{
+    const cte_segment_t *segments; /**< @param segments The chain. */
+    size_t segment_count;          /**< @param segment_count Number of segments in the chain. */
+    size_t segment;                /**< @param segment Index of the segment holding the next byte. */
+    size_t offset;                 /**< @param offset Offset of the next byte within that segment. */
+    size_t position;               /**< @param position Offset of the next byte in the transaction. */
+    size_t size;                   /**< @param size Total size of the transaction in bytes. */
+} cte_segment_decoder_t;
+
+/**
+ * @struct cte_segment_field
+ * @brief A field decoded from a segment chain.
+ *
+ * For lists and Command Data, `field.data` is NULL when the payload is empty
+ * or straddles a segment boundary; `segment` and `segment_offset` locate its
+ * first byte either way.
+ */
+typedef struct cte_segment_field
+{
+    cte_field_t field;     /**< @param field The decoded field (see `cte_field_t`). */
+    size_t segment;        /**< @param segment Segment holding the first payload byte. */
+    size_t segment_offset; /**< @param segment_offset Offset of the first payload byte in that segment. */
+} cte_segment_field_t;
+
+/**
+ * @brief Prepares a decoder over a segment chain.
+ * @param decoder The decoder to initialize.
+ * @param segments The chain, in transaction order.
+ * @param segment_count The number of segments.
+ * @note Aborts via `lea_abort` if the chain is empty or longer than `CTE_MAX_TRANSACTION_SIZE`.
+ */
+void cte_segment_decoder_init(cte_segment_decoder_t *decoder, const cte_segment_t *segments, size_t segment_count);
+
+/**
+ * @brief Identifies the next field without consuming it.
+ * @param decoder The segment decoder.
+ * @return The `CTE_PEEK_TYPE_*` identifier, or `CTE_PEEK_EOF` at the end of the chain.
+ * @note Validates the version byte on the first call, like `cte_decoder_peek_type()`.
+ */
+int cte_segment_decoder_peek_type(cte_segment_decoder_t *decoder);
+
+/**
+ * @brief Reads the next field, whose type was returned by `cte_segment_decoder_peek_type()`.
+ * @param decoder The segment decoder.
+ * @param type The field's `CTE_PEEK_TYPE_*` identifier.
+ * @param out Receives the field.
+ * @warning Aborts on malformed data, like the contiguous decoder.
+ */
+void cte_segment_decoder_read_field(cte_segment_decoder_t *decoder, int type, cte_segment_field_t *out);
+
+/**
+ * @brief Copies a list or Command Data payload out of the chain.
+ * @param decoder The decoder the field was read from.
+ * @param field The field.
+ * @param out Destination of `field->field.length` bytes.
+ */
+void cte_segment_decoder_copy_payload(const cte_segment_decoder_t *decoder, const cte_segment_field_t *field,
+                                      uint8_t *out);
+
+/**
+ * @brief Describes a list or Command Data payload as a sub-chain of segments.
+ * @param decoder The decoder the field was read from.
+ * @param field The field.
+ * @param out Receives up to `max_segments` segments covering the payload.
+ * @param max_segments The number of elements in `out`.
+ * @return The number of segments the payload spans, which may exceed `max_segments`.
+ */
+size_t cte_segment_decoder_payload_segments(const cte_segment_decoder_t *decoder, const cte_segment_field_t *field,
+                                            cte_segment_t *out, size_t max_segments);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEGMENT_DECODER_H
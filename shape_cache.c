@@ -0,0 +1,595 @@
+#include "shape_cache.h"
+#include <stdlea.h>
+
+/**
+ * @name Size table markers
+ * @brief Special entries of the per-header size table. Every other entry is
+ * the total size of the field (header plus payload).
+ * @{
+ */
+#define SIZE_INVALID 0x0000      /**< Reserved code or malformed header. */
+#define SIZE_VARINT 0xFFFF       /**< ULEB128/SLEB128: header plus a varint of unknown length. */
+#define SIZE_CMD_EXTENDED 0xFFFE /**< Extended Command Data: length is in the second header byte. */
+/** @} */
+
+/**
+ * @name Plan operations
+ * @{
+ */
+#define PLAN_OP_LIST 0         /**< Public Key or Signature List with a fixed item count. */
+#define PLAN_OP_CONSTANT 1     /**< Legacy index or Varint Zero; the value is stored in the plan. */
+#define PLAN_OP_BOOLEAN 2      /**< Boolean constant; the value is stored in the plan. */
+#define PLAN_OP_ULEB128 3      /**< ULEB128 following a one-byte header. */
+#define PLAN_OP_SLEB128 4      /**< SLEB128 following a one-byte header. */
+#define PLAN_OP_UNSIGNED 5     /**< Unsigned fixed-width integer. */
+#define PLAN_OP_SIGNED 6       /**< Signed fixed-width integer. */
+#define PLAN_OP_FLOAT32 7      /**< 32-bit float. */
+#define PLAN_OP_FLOAT64 8      /**< 64-bit float. */
+#define PLAN_OP_CMD_SHORT 9    /**< Short Command Data; length in the header. */
+#define PLAN_OP_CMD_EXTENDED 10 /**< Extended Command Data; length in both header bytes. */
+/** @} */
+
+/** @brief Plans per set. */
+#define SHAPE_WAYS 2
+
+/**
+ * @brief Mask that keeps the shape-defining bits of a header byte.
+ *
+ * Everything except the Command Data length bits; extended headers keep
+ * their padding bits so a plan only matches valid headers.
+ */
+#define SHAPE_MASK(header)                                         \
+    (((header) & CTE_TAG_MASK) != CTE_TAG_COMMAND_DATA ? 0xFF      \
+     : ((header) & CTE_COMMAND_FORMAT_FLAG_MASK)       ? 0xE3      \
+                                                       : 0xE0)
+
+/**
+ * @struct plan_step
+ * @brief How to check and decode one field of a known shape.
+ */
+typedef struct plan_step
+{
+    uint8_t op;       /**< One of the `PLAN_OP_*` values. */
+    uint8_t type;     /**< The field's `CTE_PEEK_TYPE_*` identifier. */
+    uint8_t header;   /**< Expected header byte, after `mask`. */
+    uint8_t mask;     /**< Shape-defining bits of the header (see `SHAPE_MASK`). */
+    uint8_t width;    /**< Payload size of fixed-width values. */
+    uint8_t count;    /**< Item count of lists. */
+    uint8_t constant; /**< Value of constant fields. */
+    uint16_t size;    /**< Total field size for fixed-size fields. */
+} plan_step_t;
+
+/**
+ * @struct shape_plan
+ * @brief A cached decode plan: one step per field of the shape it was learned from.
+ */
+typedef struct shape_plan
+{
+    bool used;
+    uint8_t field_count;
+    uint32_t last_used; /**< Cache clock at the last hit, for replacement. */
+    uint64_t key;       /**< Hash of the shape's masked headers. */
+    plan_step_t steps[CTE_SHAPE_MAX_FIELDS];
+} shape_plan_t;
+
+struct cte_shape_cache
+{
+    size_t set_mask;          /**< Set count minus one. */
+    shape_plan_t *plans;      /**< `SHAPE_WAYS` plans per set. */
+    uint32_t clock;           /**< Incremented on every lookup. */
+    cte_shape_stats_t stats;  /**< Counters. */
+    uint16_t field_size[256]; /**< Field size (or `SIZE_*` marker) by header byte. */
+};
+
+/** @brief Payload widths of the IxData fixed types, indexed by type code. */
+static const uint8_t fixed_width[10] = {1, 2, 4, 8, 1, 2, 4, 8, 4, 8};
+
+/**
+ * @brief Computes the size table entry for one header byte.
+ * @param header The header byte.
+ * @return The field size, or a `SIZE_*` marker.
+ * @note Internal helper function.
+ */
+static uint16_t _field_size(uint8_t header)
+{
+    uint8_t code = (header >> 2) & 0x0F;
+    switch (header & CTE_TAG_MASK)
+    {
+    case CTE_TAG_PUBLIC_KEY_LIST:
+        return code == 0 ? SIZE_INVALID : 1 + code * get_public_key_size(header & CTE_CRYPTO_TYPE_MASK);
+    case CTE_TAG_SIGNATURE_LIST:
+        return code == 0 ? SIZE_INVALID : 1 + code * get_signature_item_size(header & CTE_CRYPTO_TYPE_MASK);
+    case CTE_TAG_IXDATA_FIELD:
+        switch (header & CTE_IXDATA_SUBTYPE_MASK)
+        {
+        case CTE_IXDATA_SUBTYPE_LEGACY_INDEX:
+            return 1;
+        case CTE_IXDATA_SUBTYPE_VARINT:
+            if (code == CTE_IXDATA_VARINT_ENC_ZERO)
+            {
+                return 1;
+            }
+            return code <= CTE_IXDATA_VARINT_ENC_SLEB128 ? SIZE_VARINT : SIZE_INVALID;
+        case CTE_IXDATA_SUBTYPE_FIXED:
+            return code <= CTE_IXDATA_FIXED_TYPE_FLOAT64 ? 1 + fixed_width[code] : SIZE_INVALID;
+        default:
+            return code <= CTE_IXDATA_CONST_VAL_TRUE ? 1 : SIZE_INVALID;
+        }
+    default:
+        if ((header & CTE_COMMAND_FORMAT_FLAG_MASK) == CTE_COMMAND_FORMAT_SHORT)
+        {
+            return 1 + (header & CTE_COMMAND_SHORT_MAX_LEN);
+        }
+        return (header & 0x03) ? SIZE_INVALID : SIZE_CMD_EXTENDED;
+    }
+}
+
+LEA_EXPORT(cte_shape_cache_init)
+cte_shape_cache_t *cte_shape_cache_init(size_t capacity)
+{
+    if (capacity == 0)
+    {
+        lea_abort("Zero shape cache capacity");
+    }
+    size_t sets = 1;
+    while (sets * SHAPE_WAYS < capacity)
+    {
+        sets <<= 1;
+    }
+
+    cte_shape_cache_t *cache = malloc(sizeof(cte_shape_cache_t));
+    cache->set_mask = sets - 1;
+    cache->plans = calloc(sets * SHAPE_WAYS, sizeof(shape_plan_t));
+    cache->clock = 0;
+    memset(&cache->stats, 0, sizeof(cache->stats));
+    for (int header = 0; header < 256; ++header)
+    {
+        cache->field_size[header] = _field_size((uint8_t)header);
+    }
+    return cache;
+}
+
+LEA_EXPORT(cte_shape_cache_free)
+void cte_shape_cache_free(cte_shape_cache_t *cache)
+{
+    if (!cache)
+    {
+        return;
+    }
+    free(cache->plans);
+    free(cache);
+}
+
+/**
+ * @brief Returns the size of the LEB128 value at `p`, or 0 if it is
+ * unterminated within `available` bytes or longer than 10 bytes.
+ * @note Internal helper function.
+ */
+static size_t _leb128_size(const uint8_t *p, size_t available)
+{
+    size_t limit = available < 10 ? available : 10;
+    for (size_t i = 0; i < limit; ++i)
+    {
+        if (!(p[i] & 0x80))
+        {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Hashes the whole masked header sequence of a transaction.
+ *
+ * Fields are skipped using the size table only; no value is decoded. Layouts
+ * that share a prefix therefore still spread over different sets.
+ *
+ * @return `false` if a header is reserved, a field is truncated or there are
+ *         more than `CTE_SHAPE_MAX_FIELDS` fields, in which case the generic
+ *         path must decode (and diagnose) the transaction.
+ * @note Internal helper function.
+ */
+static bool _shape_key(const cte_shape_cache_t *cache, const uint8_t *data, size_t size, uint64_t *out_key)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    size_t pos = 1;
+    for (int n = 0; pos < size; ++n)
+    {
+        if (n == CTE_SHAPE_MAX_FIELDS)
+        {
+            return false;
+        }
+        uint8_t header = data[pos];
+        size_t field_size = cache->field_size[header];
+        if (field_size == SIZE_INVALID)
+        {
+            return false;
+        }
+        if (field_size == SIZE_VARINT)
+        {
+            field_size = 1 + _leb128_size(data + pos + 1, size - pos - 1);
+            if (field_size == 1)
+            {
+                return false;
+            }
+        }
+        else if (field_size == SIZE_CMD_EXTENDED)
+        {
+            if (size - pos < 2)
+            {
+                return false;
+            }
+            field_size = 2 + (((size_t)((header >> 2) & 0x07) << 8) | data[pos + 1]);
+        }
+        if (field_size > size - pos)
+        {
+            return false;
+        }
+        pos += field_size;
+        hash = (hash ^ (header & SHAPE_MASK(header))) * 0x100000001B3ULL;
+    }
+    *out_key = hash;
+    return true;
+}
+
+/**
+ * @brief Decodes a ULEB128 of known extent.
+ * @return `false` if the value is wider than 64 bits.
+ * @note Internal helper function.
+ */
+static bool _plan_uleb128(const uint8_t *p, size_t length, uint64_t *out)
+{
+    uint64_t result = 0;
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (i == 9 && (p[i] & 0xFE) != 0)
+        {
+            return false;
+        }
+        result |= ((uint64_t)(p[i] & 0x7F)) << (7 * i);
+    }
+    *out = result;
+    return true;
+}
+
+/**
+ * @brief Decodes an SLEB128 of known extent.
+ * @note Internal helper function.
+ */
+static int64_t _plan_sleb128(const uint8_t *p, size_t length)
+{
+    uint64_t result = 0;
+    for (size_t i = 0; i < length; ++i)
+    {
+        result |= ((uint64_t)(p[i] & 0x7F)) << (7 * i);
+    }
+    size_t shift = 7 * length;
+    if (shift < 64 && (p[length - 1] & 0x40))
+    {
+        result |= ~(uint64_t)0 << shift;
+    }
+    return (int64_t)result;
+}
+
+/**
+ * @brief Runs a cached plan, checking every header against it as it goes.
+ *
+ * @return `false` as soon as the transaction departs from the plan's shape
+ *         or fails a check; `fields` may then be partly written.
+ * @note Internal helper function.
+ */
+static bool _run_plan(const shape_plan_t *plan, const uint8_t *data, size_t size, cte_field_t *fields)
+{
+    size_t pos = 1;
+    for (size_t i = 0; i < plan->field_count; ++i)
+    {
+        const plan_step_t *step = &plan->steps[i];
+        if (pos >= size)
+        {
+            return false;
+        }
+        const uint8_t *p = data + pos;
+        size_t available = size - pos;
+        if ((p[0] & step->mask) != step->header)
+        {
+            return false;
+        }
+
+        cte_field_t *field = &fields[i];
+        field->type = step->type;
+        field->offset = pos;
+        field->count = 0;
+        field->data = NULL;
+        field->length = 0;
+        field->value.u64 = 0;
+
+        size_t field_size = step->size;
+        switch (step->op)
+        {
+        case PLAN_OP_LIST:
+            field->count = step->count;
+            field->data = p + 1;
+            field->length = field_size - 1;
+            break;
+        case PLAN_OP_CONSTANT:
+            field->value.u64 = step->constant;
+            break;
+        case PLAN_OP_BOOLEAN:
+            field->value.boolean = step->constant != 0;
+            break;
+        case PLAN_OP_ULEB128:
+        case PLAN_OP_SLEB128:
+        {
+            size_t length = _leb128_size(p + 1, available - 1);
+            if (length == 0)
+            {
+                return false;
+            }
+            if (step->op == PLAN_OP_SLEB128)
+            {
+                field->value.i64 = _plan_sleb128(p + 1, length);
+            }
+            else if (!_plan_uleb128(p + 1, length, &field->value.u64))
+            {
+                return false;
+            }
+            field_size = 1 + length;
+            break;
+        }
+        case PLAN_OP_CMD_SHORT:
+            field->length = p[0] & CTE_COMMAND_SHORT_MAX_LEN;
+            field->data = p + 1;
+            field_size = 1 + field->length;
+            break;
+        case PLAN_OP_CMD_EXTENDED:
+            if (available < 2)
+            {
+                return false;
+            }
+            field->length = ((size_t)((p[0] >> 2) & 0x07) << 8) | p[1];
+            if (field->length < CTE_COMMAND_EXTENDED_MIN_LEN || field->length > CTE_COMMAND_EXTENDED_MAX_LEN)
+            {
+                return false;
+            }
+            field->data = p + 2;
+            field_size = 2 + field->length;
+            break;
+        }
+        if (field_size > available)
+        {
+            return false;
+        }
+
+        switch (step->op)
+        {
+        case PLAN_OP_UNSIGNED:
+            switch (step->width)
+            {
+            case 1:
+                field->value.u64 = p[1];
+                break;
+            case 2:
+            {
+                uint16_t value;
+                memcpy(&value, p + 1, sizeof(value));
+                field->value.u64 = value;
+                break;
+            }
+            case 4:
+            {
+                uint32_t value;
+                memcpy(&value, p + 1, sizeof(value));
+                field->value.u64 = value;
+                break;
+            }
+            default:
+                memcpy(&field->value.u64, p + 1, sizeof(uint64_t));
+                break;
+            }
+            break;
+        case PLAN_OP_SIGNED:
+            switch (step->width)
+            {
+            case 1:
+                field->value.i64 = (int8_t)p[1];
+                break;
+            case 2:
+            {
+                int16_t value;
+                memcpy(&value, p + 1, sizeof(value));
+                field->value.i64 = value;
+                break;
+            }
+            case 4:
+            {
+                int32_t value;
+                memcpy(&value, p + 1, sizeof(value));
+                field->value.i64 = value;
+                break;
+            }
+            default:
+                memcpy(&field->value.i64, p + 1, sizeof(int64_t));
+                break;
+            }
+            break;
+        case PLAN_OP_FLOAT32:
+            memcpy(&field->value.f32, p + 1, sizeof(float));
+            break;
+        case PLAN_OP_FLOAT64:
+            memcpy(&field->value.f64, p + 1, sizeof(double));
+            break;
+        }
+        pos += field_size;
+    }
+    return pos == size;
+}
+
+/**
+ * @brief Derives a plan step from a field decoded by the generic path.
+ * @note Internal helper function.
+ */
+static void _learn_step(const cte_field_t *field, const uint8_t *data, plan_step_t *step)
+{
+    uint8_t header = data[field->offset];
+    uint8_t code = (header >> 2) & 0x0F;
+    step->type = (uint8_t)field->type;
+    step->mask = SHAPE_MASK(header);
+    step->header = header & step->mask;
+    step->width = 0;
+    step->count = (uint8_t)field->count;
+    step->constant = 0;
+    step->size = 1;
+
+    switch (field->type)
+    {
+    case CTE_PEEK_TYPE_PK_LIST_ED25519:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_128F:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_192F:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_256F:
+    case CTE_PEEK_TYPE_SIG_LIST_ED25519:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_128F:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_192F:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_256F:
+        step->op = PLAN_OP_LIST;
+        step->size = (uint16_t)(1 + field->length);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_LEGACY_INDEX:
+    case CTE_PEEK_TYPE_IXDATA_VARINT_ZERO:
+        step->op = PLAN_OP_CONSTANT;
+        step->constant = (uint8_t)field->value.u64;
+        break;
+    case CTE_PEEK_TYPE_IXDATA_CONST_FALSE:
+    case CTE_PEEK_TYPE_IXDATA_CONST_TRUE:
+        step->op = PLAN_OP_BOOLEAN;
+        step->constant = field->value.boolean;
+        break;
+    case CTE_PEEK_TYPE_IXDATA_ULEB128:
+        step->op = PLAN_OP_ULEB128;
+        break;
+    case CTE_PEEK_TYPE_IXDATA_SLEB128:
+        step->op = PLAN_OP_SLEB128;
+        break;
+    case CTE_PEEK_TYPE_IXDATA_INT8:
+    case CTE_PEEK_TYPE_IXDATA_INT16:
+    case CTE_PEEK_TYPE_IXDATA_INT32:
+    case CTE_PEEK_TYPE_IXDATA_INT64:
+        step->op = PLAN_OP_SIGNED;
+        step->width = fixed_width[code];
+        step->size = 1 + step->width;
+        break;
+    case CTE_PEEK_TYPE_IXDATA_UINT8:
+    case CTE_PEEK_TYPE_IXDATA_UINT16:
+    case CTE_PEEK_TYPE_IXDATA_UINT32:
+    case CTE_PEEK_TYPE_IXDATA_UINT64:
+        step->op = PLAN_OP_UNSIGNED;
+        step->width = fixed_width[code];
+        step->size = 1 + step->width;
+        break;
+    case CTE_PEEK_TYPE_IXDATA_FLOAT32:
+        step->op = PLAN_OP_FLOAT32;
+        step->size = 1 + sizeof(float);
+        break;
+    case CTE_PEEK_TYPE_IXDATA_FLOAT64:
+        step->op = PLAN_OP_FLOAT64;
+        step->size = 1 + sizeof(double);
+        break;
+    case CTE_PEEK_TYPE_CMD_SHORT:
+        step->op = PLAN_OP_CMD_SHORT;
+        break;
+    default:
+        step->op = PLAN_OP_CMD_EXTENDED;
+        break;
+    }
+}
+
+LEA_EXPORT(cte_shape_cache_decode)
+size_t cte_shape_cache_decode(cte_shape_cache_t *cache, const uint8_t *data, size_t size, cte_field_t *fields,
+                              size_t max_fields)
+{
+    if (!cache || !data || !fields)
+    {
+        lea_abort("Null argument to shape_cache_decode");
+    }
+    if (size == 0)
+    {
+        lea_abort("Zero size buffer");
+    }
+    if (data[0] != CTE_VERSION_BYTE)
+    {
+        lea_abort("Invalid version byte");
+    }
+    cache->stats.lookups++;
+    cache->clock++;
+
+    uint64_t key = 0;
+    shape_plan_t *set = NULL;
+    if (_shape_key(cache, data, size, &key))
+    {
+        set = &cache->plans[(key & cache->set_mask) * SHAPE_WAYS];
+        for (int way = 0; way < SHAPE_WAYS; ++way)
+        {
+            shape_plan_t *plan = &set[way];
+            if (plan->used && plan->key == key && plan->field_count <= max_fields &&
+                _run_plan(plan, data, size, fields))
+            {
+                plan->last_used = cache->clock;
+                cache->stats.hits++;
+                return plan->field_count;
+            }
+        }
+    }
+
+    // Generic path: peek/read through decoder.c, which also reports any error.
+    cte_decoder_t decoder = cte_decoder_view(data, size, 0);
+    size_t count = 0;
+    for (int type = cte_decoder_peek_type(&decoder); type != CTE_PEEK_EOF; type = cte_decoder_peek_type(&decoder))
+    {
+        if (count == max_fields)
+        {
+            lea_abort("Field array too small for transaction");
+        }
+        cte_decoder_read_field(&decoder, type, &fields[count++]);
+    }
+
+    if (!set || count > CTE_SHAPE_MAX_FIELDS)
+    {
+        cache->stats.uncacheable++;
+        return count;
+    }
+    cache->stats.misses++;
+
+    // Learn: replace an empty way, or else the least recently used one.
+    shape_plan_t *victim = &set[0];
+    for (int way = 1; way < SHAPE_WAYS && victim->used; ++way)
+    {
+        if (!set[way].used || set[way].last_used < victim->last_used)
+        {
+            victim = &set[way];
+        }
+    }
+    if (victim->used)
+    {
+        cache->stats.evictions++;
+    }
+    victim->used = true;
+    victim->key = key;
+    victim->last_used = cache->clock;
+    victim->field_count = (uint8_t)count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        _learn_step(&fields[i], data, &victim->steps[i]);
+    }
+    return count;
+}
+
+LEA_EXPORT(cte_shape_cache_get_stats)
+void cte_shape_cache_get_stats(const cte_shape_cache_t *cache, cte_shape_stats_t *out)
+{
+    *out = cache->stats;
+}
+
+LEA_EXPORT(cte_shape_cache_reset_stats)
+void cte_shape_cache_reset_stats(cte_shape_cache_t *cache)
+{
+    memset(&cache->stats, 0, sizeof(cache->stats));
+}
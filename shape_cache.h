@@ -0,0 +1,102 @@
+#ifndef SHAPE_CACHE_H
+#define SHAPE_CACHE_H
+
+#include "decoder.h"
+#include <stdlea.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file shape_cache.h
+ * @brief Adaptive decoder that recognises recurring transaction layouts.
+ *
+ * The "shape" of a transaction is its sequence of header bytes, with the
+ * length bits of Command Data headers masked out so that payload sizes do
+ * not split otherwise identical layouts. The masked headers of all fields
+ * are hashed to select a set in a bounded, 2-way set-associative table of
+ * decode plans.
+ *
+ * - On a hit, the stored plan (a flat array of per-field operations) checks
+ *   each header against the recorded one and fills the output in a single
+ *   pass, without classifying any header.
+ * - On a miss, or when a plan does not match the whole transaction, it is
+ *   decoded by the generic peek/read loop and the resulting plan replaces
+ *   the least recently used plan of its set.
+ *
+ * Both paths apply the same checks as decoder.c and abort via `lea_abort`
+ * on invalid input. A cache is not thread-safe; use one per thread.
+ */
+
+/**
+ * @brief Maximum number of fields in a cacheable shape.
+ *
+ * Longer transactions are still decoded, always by the generic path.
+ */
+#define CTE_SHAPE_MAX_FIELDS 32
+
+/**
+ * @struct cte_shape_stats
+ * @brief Counters describing how well the cache is working.
+ *
+ * The hit rate is `hits / lookups`.
+ */
+typedef struct cte_shape_stats
+{
+    uint64_t lookups;     /**< @param lookups Transactions passed to `cte_shape_cache_decode()`. */
+    uint64_t hits;        /**< @param hits Transactions decoded through a cached plan. */
+    uint64_t misses;      /**< @param misses Cacheable transactions whose plan was not cached. */
+    uint64_t evictions;   /**< @param evictions Plans replaced by a different shape. */
+    uint64_t uncacheable; /**< @param uncacheable Transactions with too many fields or invalid headers. */
+} cte_shape_stats_t;
+
+/** @brief Opaque shape cache. */
+typedef struct cte_shape_cache cte_shape_cache_t;
+
+/**
+ * @brief Creates a shape cache.
+ * @param capacity Minimum number of plan slots; the set count is rounded up to a power of two.
+ * @return A pointer to the new cache.
+ * @note Aborts via `lea_abort` if capacity is 0.
+ */
+cte_shape_cache_t *cte_shape_cache_init(size_t capacity);
+
+/**
+ * @brief Releases a shape cache. Passing NULL is a no-op.
+ * @param cache The cache to release.
+ */
+void cte_shape_cache_free(cte_shape_cache_t *cache);
+
+/**
+ * @brief Decodes every field of a transaction.
+ *
+ * @param cache The shape cache.
+ * @param data The encoded transaction, starting with the version byte.
+ * @param size The size of the transaction in bytes.
+ * @param fields The output array; list and command views point into `data`.
+ * @param max_fields The number of elements in `fields`.
+ * @return The number of fields decoded.
+ * @warning Aborts on malformed data or if the transaction has more than `max_fields` fields.
+ */
+size_t cte_shape_cache_decode(cte_shape_cache_t *cache, const uint8_t *data, size_t size, cte_field_t *fields,
+                              size_t max_fields);
+
+/**
+ * @brief Copies the cache's counters into `out`.
+ * @param cache The shape cache.
+ * @param out The structure to fill.
+ */
+void cte_shape_cache_get_stats(const cte_shape_cache_t *cache, cte_shape_stats_t *out);
+
+/**
+ * @brief Resets the cache's counters without discarding any plan.
+ * @param cache The shape cache.
+ */
+void cte_shape_cache_reset_stats(cte_shape_cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SHAPE_CACHE_H
@@ -0,0 +1,193 @@
+#include "stream_decoder.h"
+#include <stdlea.h>
+
+/** @brief Longest ULEB128/SLEB128 encoding the decoder accepts. */
+#define LEB128_MAX_BYTES 10
+
+struct cte_stream_decoder
+{
+    cte_decoder_t decoder; /**< Reads `buffer`; `size` is the number of bytes received. */
+    bool finished;         /**< No more bytes will be appended. */
+    bool has_allocator;
+    cte_allocator_t allocator;
+    uint8_t buffer[CTE_MAX_TRANSACTION_SIZE];
+};
+
+/** @brief Payload widths of the IxData fixed types, indexed by type code. */
+static const uint8_t fixed_width[10] = {1, 2, 4, 8, 1, 2, 4, 8, 4, 8};
+
+/**
+ * @brief Computes how many bytes the field starting at `p` occupies.
+ *
+ * Only as much of the field as is needed to learn its size is inspected.
+ * Malformed headers get a size that is already available, so the caller
+ * hands them to decoder.c, which reports the error.
+ *
+ * @param p The field's header byte.
+ * @param available The number of received bytes from `p` onward (at least 1).
+ * @param type The field's `CTE_PEEK_TYPE_*` identifier.
+ * @return The field size, or a lower bound on it if that exceeds `available`.
+ * @note Internal helper function.
+ */
+static size_t _field_extent(const uint8_t *p, size_t available, int type)
+{
+    uint8_t code = (p[0] >> 2) & 0x0F;
+    switch (type)
+    {
+    case CTE_PEEK_TYPE_PK_LIST_ED25519:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_128F:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_192F:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_256F:
+        return 1 + code * get_public_key_size(p[0] & CTE_CRYPTO_TYPE_MASK);
+    case CTE_PEEK_TYPE_SIG_LIST_ED25519:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_128F:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_192F:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_256F:
+        return 1 + code * get_signature_item_size(p[0] & CTE_CRYPTO_TYPE_MASK);
+    case CTE_PEEK_TYPE_IXDATA_ULEB128:
+    case CTE_PEEK_TYPE_IXDATA_SLEB128:
+        for (size_t i = 1; i < available && i <= LEB128_MAX_BYTES; ++i)
+        {
+            if (!(p[i] & 0x80))
+            {
+                return i + 1;
+            }
+        }
+        // Unterminated so far: at least one more byte, unless already too long.
+        return available > LEB128_MAX_BYTES ? available : available + 1;
+    case CTE_PEEK_TYPE_IXDATA_INT8:
+    case CTE_PEEK_TYPE_IXDATA_INT16:
+    case CTE_PEEK_TYPE_IXDATA_INT32:
+    case CTE_PEEK_TYPE_IXDATA_INT64:
+    case CTE_PEEK_TYPE_IXDATA_UINT8:
+    case CTE_PEEK_TYPE_IXDATA_UINT16:
+    case CTE_PEEK_TYPE_IXDATA_UINT32:
+    case CTE_PEEK_TYPE_IXDATA_UINT64:
+    case CTE_PEEK_TYPE_IXDATA_FLOAT32:
+    case CTE_PEEK_TYPE_IXDATA_FLOAT64:
+        return 1 + fixed_width[code];
+    case CTE_PEEK_TYPE_CMD_SHORT:
+        return 1 + (p[0] & CTE_COMMAND_SHORT_MAX_LEN);
+    case CTE_PEEK_TYPE_CMD_EXTENDED:
+        if (available < 2)
+        {
+            return 2;
+        }
+        return 2 + ((((size_t)p[0] >> 2) & 0x07) << 8 | p[1]);
+    default:
+        return 1;
+    }
+}
+
+LEA_EXPORT(cte_stream_decoder_init)
+cte_stream_decoder_t *cte_stream_decoder_init(const cte_allocator_t *allocator)
+{
+    cte_stream_decoder_t *stream =
+        cte_allocate(allocator, sizeof(cte_stream_decoder_t), _Alignof(cte_stream_decoder_t));
+    stream->has_allocator = allocator != NULL;
+    if (allocator)
+    {
+        stream->allocator = *allocator;
+    }
+    stream->decoder.data = stream->buffer;
+    cte_stream_decoder_reset(stream);
+    return stream;
+}
+
+LEA_EXPORT(cte_stream_decoder_free)
+void cte_stream_decoder_free(cte_stream_decoder_t *stream)
+{
+    if (!stream)
+    {
+        return;
+    }
+    cte_allocator_t allocator = stream->allocator;
+    cte_deallocate(stream->has_allocator ? &allocator : NULL, stream, sizeof(cte_stream_decoder_t),
+                   _Alignof(cte_stream_decoder_t));
+}
+
+LEA_EXPORT(cte_stream_decoder_reset)
+void cte_stream_decoder_reset(cte_stream_decoder_t *stream)
+{
+    stream->decoder.size = 0;
+    stream->decoder.position = 0;
+    stream->decoder.last_list_count = 0;
+    stream->decoder.last_cmd_len = 0;
+    stream->finished = false;
+}
+
+LEA_EXPORT(cte_stream_decoder_append)
+void cte_stream_decoder_append(cte_stream_decoder_t *stream, const uint8_t *data, size_t size)
+{
+    if (stream->finished)
+    {
+        lea_abort("Append to a finished transaction");
+    }
+    if (size > CTE_MAX_TRANSACTION_SIZE - stream->decoder.size)
+    {
+        lea_abort("Transaction exceeds max transaction size");
+    }
+    memcpy(stream->buffer + stream->decoder.size, data, size);
+    stream->decoder.size += size;
+}
+
+LEA_EXPORT(cte_stream_decoder_finish)
+void cte_stream_decoder_finish(cte_stream_decoder_t *stream)
+{
+    stream->finished = true;
+}
+
+LEA_EXPORT(cte_stream_decoder_next)
+int cte_stream_decoder_next(cte_stream_decoder_t *stream, cte_field_t *field, size_t *needed)
+{
+    if (!stream || !field)
+    {
+        lea_abort("Null argument to stream_decoder_next");
+    }
+    cte_decoder_t *decoder = &stream->decoder;
+    if (decoder->position == 0 && decoder->size > 0)
+    {
+        if (decoder->data[0] != CTE_VERSION_BYTE)
+        {
+            lea_abort("Invalid version byte");
+        }
+        decoder->position = 1;
+    }
+
+    size_t available = decoder->size - decoder->position;
+    size_t extent = 1;
+    if (available > 0)
+    {
+        int type = cte_decoder_peek_type(decoder);
+        extent = _field_extent(decoder->data + decoder->position, available, type);
+        if (extent <= available)
+        {
+            cte_decoder_read_field(decoder, type, field);
+            return type;
+        }
+    }
+    else if (stream->finished)
+    {
+        if (decoder->size == 0)
+        {
+            lea_abort("Zero size buffer");
+        }
+        return CTE_PEEK_EOF;
+    }
+
+    if (stream->finished)
+    {
+        lea_abort("Read past end of buffer");
+    }
+    if (needed)
+    {
+        *needed = extent - available;
+    }
+    return CTE_STREAM_NEED_MORE;
+}
+
+LEA_EXPORT(cte_stream_decoder_position)
+size_t cte_stream_decoder_position(const cte_stream_decoder_t *stream)
+{
+    return stream->decoder.position;
+}
@@ -0,0 +1,95 @@
+#ifndef STREAM_DECODER_H
+#define STREAM_DECODER_H
+
+#include "decoder.h"
+#include <stdlea.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file stream_decoder.h
+ * @brief Incremental decoder for transactions that arrive in pieces.
+ *
+ * Bytes are appended as they are received. `cte_stream_decoder_next()` returns
+ * each field as soon as all of its bytes are present; when the next field
+ * straddles the end of the received data it returns `CTE_STREAM_NEED_MORE`
+ * and the number of bytes still missing, and resumes at the same field after
+ * the next append. Nothing is re-parsed.
+ *
+ * The decoder owns a buffer of `CTE_MAX_TRANSACTION_SIZE` bytes, so field
+ * views stay valid until the decoder is reset or released. Complete fields
+ * are decoded by decoder.c and aborted on exactly as there.
+ */
+
+/** @brief Returned by `cte_stream_decoder_next()` when the next field is incomplete. */
+#define CTE_STREAM_NEED_MORE 0xFE
+
+/** @brief Opaque incremental decoder. */
+typedef struct cte_stream_decoder cte_stream_decoder_t;
+
+/**
+ * @brief Creates an incremental decoder.
+ * @param allocator The allocation hooks, or NULL for stdlea `malloc`.
+ * @return A pointer to the new decoder, ready for a first transaction.
+ */
+cte_stream_decoder_t *cte_stream_decoder_init(const cte_allocator_t *allocator);
+
+/**
+ * @brief Releases an incremental decoder. Passing NULL is a no-op.
+ * @param stream The decoder to release.
+ */
+void cte_stream_decoder_free(cte_stream_decoder_t *stream);
+
+/**
+ * @brief Discards the current transaction and prepares for the next one.
+ * @param stream The incremental decoder.
+ */
+void cte_stream_decoder_reset(cte_stream_decoder_t *stream);
+
+/**
+ * @brief Appends received bytes to the current transaction.
+ * @param stream The incremental decoder.
+ * @param data The received bytes.
+ * @param size The number of bytes.
+ * @note Aborts via `lea_abort` if the transaction would exceed
+ * `CTE_MAX_TRANSACTION_SIZE` or if it was already finished.
+ */
+void cte_stream_decoder_append(cte_stream_decoder_t *stream, const uint8_t *data, size_t size);
+
+/**
+ * @brief Marks the current transaction as complete; no more bytes will be appended.
+ *
+ * After this call `cte_stream_decoder_next()` returns `CTE_PEEK_EOF` at the
+ * end of the data instead of `CTE_STREAM_NEED_MORE`.
+ *
+ * @param stream The incremental decoder.
+ */
+void cte_stream_decoder_finish(cte_stream_decoder_t *stream);
+
+/**
+ * @brief Decodes the next field if all of its bytes have been received.
+ *
+ * @param stream The incremental decoder.
+ * @param field Receives the field; `data` points into the decoder's buffer.
+ * @param needed Receives the minimum number of additional bytes required
+ * when `CTE_STREAM_NEED_MORE` is returned. For ULEB128/SLEB128 values and
+ * extended Command Data headers this may be a lower bound. May be NULL.
+ * @return The field's `CTE_PEEK_TYPE_*` identifier, `CTE_STREAM_NEED_MORE`,
+ * or `CTE_PEEK_EOF` once a finished transaction has been fully decoded.
+ * @warning Aborts on malformed data, and if a finished transaction ends inside a field.
+ */
+int cte_stream_decoder_next(cte_stream_decoder_t *stream, cte_field_t *field, size_t *needed);
+
+/**
+ * @brief Returns the number of bytes of the current transaction consumed so far.
+ * @param stream The incremental decoder.
+ */
+size_t cte_stream_decoder_position(const cte_stream_decoder_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STREAM_DECODER_H
@@ -1,8 +1,29 @@
 #include "decoder.h"
 #include "encoder.h"
+#include "shape_cache.h"
+#include "field_grammar.h"
+#include "stream_decoder.h"
+#include "segment_decoder.h"
+#include "transaction.h"
+#include "hex_codec.h"
+#include "base58_codec.h"
+#include "base64_codec.h"
+#include "json_transcoder.h"
+#include "number_format.h"
+#include "container.h"
+#include "transaction_log.h"
+#include "field_index.h"
+#include "cte_schema.h"
+#include "cte_struct.h"
+#include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #define BUFFER_SIZE 2048
 
@@ -102,6 +123,1269 @@ void print_hex(const char *label, const uint8_t *data, size_t size)
     printf("\n");
 }
 
+#define TEST_RECORD_FIELDS(X)     \
+    X(PUBKEY_ED25519, sender)     \
+    X(SIGNATURE_SLH_128F, proof)  \
+    X(INDEX, slot)                \
+    X(ULEB128, amount)            \
+    X(SLEB128, delta)             \
+    X(INT16, temperature)         \
+    X(UINT64, nonce)              \
+    X(FLOAT64, ratio)             \
+    X(BOOL, urgent)               \
+    X(COMMAND, memo)              \
+    X(COMMAND, payload)
+
+CTE_STRUCT_DEFINE(test_record, TEST_RECORD_FIELDS)
+
+/**
+ * @brief Checks the generated struct codec against the field-by-field API.
+ *
+ * The same values are encoded once through `test_record_encode` and once
+ * through the individual `cte_encoder_write_*` calls; the two byte streams
+ * must be identical, and decoding must reproduce the original struct.
+ */
+static void test_struct_codec(void)
+{
+    printf("\nStruct codec:\n");
+
+    static const uint8_t long_payload[150] = {1, 2, 3};
+    struct test_record in;
+    memset(&in, 0, sizeof(in));
+    memset(in.sender, 0x5A, sizeof(in.sender));
+    memset(in.proof, 0xA5, sizeof(in.proof));
+    in.slot = 9;
+    in.amount = 1234567;
+    in.delta = -4242;
+    in.temperature = -300;
+    in.nonce = 0x0123456789ABCDEFULL;
+    in.ratio = 0.125;
+    in.urgent = true;
+    in.memo.data = (const uint8_t *)"memo";
+    in.memo.length = 4;
+    in.payload.data = long_payload;
+    in.payload.length = sizeof(long_payload);
+
+    cte_encoder_t *generated = cte_encoder_init(BUFFER_SIZE);
+    test_record_encode(generated, &in);
+
+    cte_encoder_t *manual = cte_encoder_init(BUFFER_SIZE);
+    memcpy(cte_encoder_begin_public_key_list(manual, 1, CTE_CRYPTO_TYPE_ED25519), in.sender, sizeof(in.sender));
+    memcpy(cte_encoder_begin_signature_list(manual, 1, CTE_CRYPTO_TYPE_SLH_DSA_128F), in.proof, sizeof(in.proof));
+    cte_encoder_write_ixdata_index_reference(manual, in.slot);
+    cte_encoder_write_ixdata_uleb128(manual, in.amount);
+    cte_encoder_write_ixdata_sleb128(manual, in.delta);
+    cte_encoder_write_ixdata_int16(manual, in.temperature);
+    cte_encoder_write_ixdata_uint64(manual, in.nonce);
+    cte_encoder_write_ixdata_float64(manual, in.ratio);
+    cte_encoder_write_ixdata_boolean(manual, in.urgent);
+    memcpy(cte_encoder_begin_command_data(manual, in.memo.length), in.memo.data, in.memo.length);
+    memcpy(cte_encoder_begin_command_data(manual, in.payload.length), in.payload.data, in.payload.length);
+
+    size_t size = cte_encoder_get_size(generated);
+    if (size != cte_encoder_get_size(manual) ||
+        memcmp(cte_encoder_get_data(generated), cte_encoder_get_data(manual), size) != 0)
+    {
+        printf("  - ERROR: Generated encoding differs from field-by-field encoding!\n");
+    }
+    else
+    {
+        printf("  - Generated encoding matches field-by-field encoding (%zu bytes).\n", size);
+    }
+    if (test_record_encoded_size(&in) + 1 != size)
+    {
+        printf("  - ERROR: Encoded size mismatch!\n");
+    }
+
+    cte_decoder_t *dec = cte_decoder_init(size);
+    memcpy(cte_decoder_load(dec), cte_encoder_get_data(generated), size);
+    struct test_record out;
+    test_record_decode(dec, &out);
+    if (dec->position != size)
+    {
+        printf("  - ERROR: Struct decode stopped at %zu of %zu bytes!\n", dec->position, size);
+    }
+    if (memcmp(out.sender, in.sender, sizeof(in.sender)) != 0 || memcmp(out.proof, in.proof, sizeof(in.proof)) != 0 ||
+        out.slot != in.slot || out.amount != in.amount || out.delta != in.delta ||
+        out.temperature != in.temperature || out.nonce != in.nonce || out.ratio != in.ratio ||
+        out.urgent != in.urgent || out.memo.length != in.memo.length ||
+        memcmp(out.memo.data, in.memo.data, in.memo.length) != 0 || out.payload.length != in.payload.length ||
+        memcmp(out.payload.data, in.payload.data, in.payload.length) != 0)
+    {
+        printf("  - ERROR: Decoded struct differs from the original!\n");
+    }
+    else
+    {
+        printf("  - Decoded struct matches the original.\n");
+    }
+
+    cte_decoder_free(dec);
+    cte_encoder_free(manual);
+    cte_encoder_free(generated);
+}
+
+#define TEST_TRANSFER_SCHEMA(X)      \
+    X(PK_LIST_ED25519, signers)      \
+    X(SIG_LIST_ED25519, signatures)  \
+    X(IXDATA_ULEB128, amount)        \
+    X(IXDATA_ULEB128, fee)           \
+    X(IXDATA_BOOLEAN, urgent)        \
+    X(CMD, memo)
+
+CTE_SCHEMA_DEFINE(test_transfer, TEST_TRANSFER_SCHEMA)
+
+/**
+ * @brief Checks a schema decoder on a matching and a non-matching transaction.
+ *
+ * The non-matching transaction must be rejected without moving the decoder,
+ * after which the generic peek/switch path reads it as usual.
+ */
+static void test_schema_decoder(void)
+{
+    printf("\nSchema decoder:\n");
+
+    uint8_t keys[2 * CTE_PUBKEY_SIZE_ED25519];
+    uint8_t sigs[2 * CTE_SIGNATURE_SIZE_ED25519];
+    memset(keys, 0x11, sizeof(keys));
+    memset(sigs, 0x22, sizeof(sigs));
+
+    cte_encoder_t *enc = cte_encoder_init(BUFFER_SIZE);
+    memcpy(cte_encoder_begin_public_key_list(enc, 2, CTE_CRYPTO_TYPE_ED25519), keys, sizeof(keys));
+    memcpy(cte_encoder_begin_signature_list(enc, 2, CTE_CRYPTO_TYPE_ED25519), sigs, sizeof(sigs));
+    cte_encoder_write_ixdata_uleb128(enc, 250000);
+    cte_encoder_write_ixdata_uleb128(enc, 17);
+    cte_encoder_write_ixdata_boolean(enc, false);
+    memcpy(cte_encoder_begin_command_data(enc, 5), "hello", 5);
+
+    size_t size = cte_encoder_get_size(enc);
+    cte_decoder_t *dec = cte_decoder_init(size);
+    memcpy(cte_decoder_load(dec), cte_encoder_get_data(enc), size);
+
+    struct test_transfer t;
+    if (!test_transfer_try_decode(dec, &t) || dec->position != size)
+    {
+        printf("  - ERROR: Schema decoder rejected a matching transaction!\n");
+    }
+    else if (t.signers.count != 2 || memcmp(t.signers.data, keys, sizeof(keys)) != 0 || t.signatures.count != 2 ||
+             memcmp(t.signatures.data, sigs, sizeof(sigs)) != 0 || t.amount != 250000 || t.fee != 17 ||
+             t.urgent != false || t.memo.length != 5 || memcmp(t.memo.data, "hello", 5) != 0)
+    {
+        printf("  - ERROR: Schema decoder produced wrong values!\n");
+    }
+    else
+    {
+        printf("  - Matching transaction decoded through the schema.\n");
+    }
+    cte_decoder_free(dec);
+
+    // Same fields but a SLEB128 fee: the shape differs at the fourth field.
+    cte_encoder_reset(enc);
+    memcpy(cte_encoder_begin_public_key_list(enc, 2, CTE_CRYPTO_TYPE_ED25519), keys, sizeof(keys));
+    memcpy(cte_encoder_begin_signature_list(enc, 2, CTE_CRYPTO_TYPE_ED25519), sigs, sizeof(sigs));
+    cte_encoder_write_ixdata_uleb128(enc, 250000);
+    cte_encoder_write_ixdata_sleb128(enc, -17);
+    cte_encoder_write_ixdata_boolean(enc, false);
+    memcpy(cte_encoder_begin_command_data(enc, 5), "hello", 5);
+
+    size = cte_encoder_get_size(enc);
+    dec = cte_decoder_init(size);
+    memcpy(cte_decoder_load(dec), cte_encoder_get_data(enc), size);
+    if (test_transfer_try_decode(dec, &t) || dec->position != 0)
+    {
+        printf("  - ERROR: Schema decoder accepted a non-matching transaction!\n");
+    }
+    else
+    {
+        int fields = 0;
+        while (cte_decoder_peek_type(dec) != CTE_PEEK_EOF)
+        {
+            switch (cte_decoder_peek_type(dec))
+            {
+            case CTE_PEEK_TYPE_PK_LIST_ED25519:
+                cte_decoder_read_public_key_list_data(dec);
+                break;
+            case CTE_PEEK_TYPE_SIG_LIST_ED25519:
+                cte_decoder_read_signature_list_data(dec);
+                break;
+            case CTE_PEEK_TYPE_IXDATA_ULEB128:
+                cte_decoder_read_ixdata_uleb128(dec);
+                break;
+            case CTE_PEEK_TYPE_IXDATA_SLEB128:
+                cte_decoder_read_ixdata_sleb128(dec);
+                break;
+            case CTE_PEEK_TYPE_IXDATA_CONST_FALSE:
+                cte_decoder_read_ixdata_boolean(dec);
+                break;
+            default:
+                cte_decoder_read_command_data_payload(dec);
+                break;
+            }
+            fields++;
+        }
+        if (fields != 6)
+        {
+            printf("  - ERROR: Generic fallback read %d fields, expected 6!\n", fields);
+        }
+        else
+        {
+            printf("  - Non-matching transaction rejected and read by the generic fallback.\n");
+        }
+    }
+    cte_decoder_free(dec);
+    cte_encoder_free(enc);
+}
+
+/**
+ * @brief Encodes one of three layouts; `variant` changes values but not the shape.
+ */
+static void encode_shape_sample(cte_encoder_t *enc, int layout, int variant)
+{
+    static const uint8_t bytes[200] = {7, 7, 7};
+    cte_encoder_reset(enc);
+    if (layout == 0)
+    {
+        memcpy(cte_encoder_begin_public_key_list(enc, 1, CTE_CRYPTO_TYPE_SLH_DSA_192F), bytes, CTE_PUBKEY_SIZE_SLH_192F);
+        cte_encoder_write_ixdata_uleb128(enc, (uint64_t)variant * 100003);
+        cte_encoder_write_ixdata_sleb128(enc, -(int64_t)variant * 77);
+        cte_encoder_write_ixdata_int32(enc, -variant);
+        cte_encoder_write_ixdata_float32(enc, variant * 0.5f);
+        memcpy(cte_encoder_begin_command_data(enc, variant % 32), bytes, variant % 32);
+        memcpy(cte_encoder_begin_command_data(enc, 40 + variant), bytes, 40 + variant);
+    }
+    else if (layout == 1)
+    {
+        cte_encoder_write_ixdata_index_reference(enc, 3);
+        cte_encoder_write_ixdata_uint16(enc, (uint16_t)(variant * 1000));
+        cte_encoder_write_ixdata_boolean(enc, variant & 1);
+        cte_encoder_write_ixdata_uint64(enc, (uint64_t)variant << 40);
+        memcpy(cte_encoder_begin_signature_list(enc, 2, CTE_CRYPTO_TYPE_ED25519), bytes, 2 * CTE_SIGNATURE_SIZE_ED25519);
+    }
+    else
+    {
+        cte_encoder_write_ixdata_int8(enc, (int8_t)variant);
+        cte_encoder_write_ixdata_float64(enc, variant * 0.25);
+    }
+}
+
+/**
+ * @brief Checks the shape cache against the generic decoding loop and checks its counters.
+ */
+static void test_shape_cache(void)
+{
+    printf("\nShape cache:\n");
+
+    cte_encoder_t *enc = cte_encoder_init(BUFFER_SIZE);
+    cte_shape_cache_t *cache = cte_shape_cache_init(16);
+    cte_field_t cached[CTE_SHAPE_MAX_FIELDS];
+    cte_field_t generic[CTE_SHAPE_MAX_FIELDS];
+    int mismatches = 0;
+
+    for (int round = 0; round < 20; ++round)
+    {
+        encode_shape_sample(enc, round % 2, round + 1);
+        const uint8_t *data = cte_encoder_get_data(enc);
+        size_t size = cte_encoder_get_size(enc);
+
+        size_t n = cte_shape_cache_decode(cache, data, size, cached, CTE_SHAPE_MAX_FIELDS);
+
+        cte_decoder_t dec = cte_decoder_view(data, size, 0);
+        size_t m = 0;
+        for (int type = cte_decoder_peek_type(&dec); type != CTE_PEEK_EOF; type = cte_decoder_peek_type(&dec))
+        {
+            cte_decoder_read_field(&dec, type, &generic[m++]);
+        }
+        if (n != m)
+        {
+            mismatches++;
+            continue;
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (cached[i].type != generic[i].type || cached[i].offset != generic[i].offset ||
+                cached[i].count != generic[i].count || cached[i].data != generic[i].data ||
+                cached[i].length != generic[i].length || cached[i].value.u64 != generic[i].value.u64)
+            {
+                mismatches++;
+            }
+        }
+    }
+
+    cte_shape_stats_t stats;
+    cte_shape_cache_get_stats(cache, &stats);
+    if (mismatches != 0)
+    {
+        printf("  - ERROR: Cached plans disagree with the generic path (%d mismatches)!\n", mismatches);
+    }
+    else if (stats.lookups != 20 || stats.misses != 2 || stats.hits != 18 || stats.evictions != 0)
+    {
+        printf("  - ERROR: Unexpected counters: %llu lookups, %llu hits, %llu misses, %llu evictions!\n",
+               (unsigned long long)stats.lookups, (unsigned long long)stats.hits, (unsigned long long)stats.misses,
+               (unsigned long long)stats.evictions);
+    }
+    else
+    {
+        printf("  - Cached plans match the generic path; %llu of %llu lookups hit.\n", (unsigned long long)stats.hits,
+               (unsigned long long)stats.lookups);
+    }
+    cte_shape_cache_free(cache);
+
+    // A single 2-way set cycled through three shapes: LRU replacement misses every time.
+    cache = cte_shape_cache_init(1);
+    for (int round = 0; round < 6; ++round)
+    {
+        encode_shape_sample(enc, round % 3, 1);
+        cte_shape_cache_decode(cache, cte_encoder_get_data(enc), cte_encoder_get_size(enc), cached,
+                               CTE_SHAPE_MAX_FIELDS);
+    }
+    cte_shape_cache_get_stats(cache, &stats);
+    if (stats.hits != 0 || stats.misses != 6 || stats.evictions != 4)
+    {
+        printf("  - ERROR: Bounded cache did not evict as expected!\n");
+    }
+    else
+    {
+        printf("  - Single-set cache evicted %llu plans.\n", (unsigned long long)stats.evictions);
+    }
+    cte_shape_cache_free(cache);
+
+    // Five layouts sharing their first four headers: the key covers every header, so they do not share a set.
+    cache = cte_shape_cache_init(64);
+    for (int round = 0; round < 20; ++round)
+    {
+        int layout = round % 5;
+        cte_encoder_reset(enc);
+        cte_encoder_write_ixdata_int8(enc, (int8_t)round);
+        cte_encoder_write_ixdata_uint16(enc, (uint16_t)round);
+        cte_encoder_write_ixdata_boolean(enc, true);
+        cte_encoder_write_ixdata_uint32(enc, (uint32_t)round);
+        for (int extra = 0; extra < layout; ++extra)
+        {
+            cte_encoder_write_ixdata_uint8(enc, (uint8_t)extra);
+        }
+        cte_shape_cache_decode(cache, cte_encoder_get_data(enc), cte_encoder_get_size(enc), cached,
+                               CTE_SHAPE_MAX_FIELDS);
+    }
+    cte_shape_cache_get_stats(cache, &stats);
+    if (stats.hits != 15 || stats.misses != 5 || stats.evictions != 0)
+    {
+        printf("  - ERROR: Layouts with a common prefix evicted each other (%llu hits, %llu evictions)!\n",
+               (unsigned long long)stats.hits, (unsigned long long)stats.evictions);
+    }
+    else
+    {
+        printf("  - Five layouts with a common prefix all stayed cached.\n");
+    }
+    cte_shape_cache_free(cache);
+    cte_encoder_free(enc);
+}
+
+/**
+ * @brief Encodes a transaction from a layout string: 'p' key list, 's' signature
+ * list, 'i' IxData, 'c' command. Returns the offset of the field at `mark`.
+ */
+static size_t encode_grammar_sample(cte_encoder_t *enc, const char *layout, size_t mark)
+{
+    static const uint8_t bytes[CTE_SIGNATURE_SIZE_ED25519] = {0};
+    size_t offset = 0;
+    cte_encoder_reset(enc);
+    for (size_t i = 0; layout[i]; ++i)
+    {
+        if (i == mark)
+        {
+            offset = cte_encoder_get_size(enc);
+        }
+        switch (layout[i])
+        {
+        case 'p':
+            memcpy(cte_encoder_begin_public_key_list(enc, 1, CTE_CRYPTO_TYPE_ED25519), bytes, CTE_PUBKEY_SIZE_ED25519);
+            break;
+        case 's':
+            memcpy(cte_encoder_begin_signature_list(enc, 1, CTE_CRYPTO_TYPE_ED25519), bytes,
+                   CTE_SIGNATURE_SIZE_ED25519);
+            break;
+        case 'i':
+            cte_encoder_write_ixdata_uleb128(enc, i * 1000);
+            break;
+        default:
+            memcpy(cte_encoder_begin_command_data(enc, 40), bytes, 40);
+            break;
+        }
+    }
+    return offset;
+}
+
+/**
+ * @brief Checks the field-order DFA against accepted and rejected layouts.
+ */
+static void test_field_grammar(void)
+{
+    printf("\nField grammar:\n");
+
+    // Keys, then signatures, then IxData, then at most one command.
+    static const cte_grammar_rule_t protocol[] = {
+        {CTE_GRAMMAR_PK_LISTS, 1, CTE_GRAMMAR_UNBOUNDED},
+        {CTE_GRAMMAR_SIG_LISTS, 1, CTE_GRAMMAR_UNBOUNDED},
+        {CTE_GRAMMAR_IXDATA, 0, CTE_GRAMMAR_UNBOUNDED},
+        {CTE_GRAMMAR_COMMANDS, 0, 1},
+    };
+    // Overlapping rules: up to two ULEB128 fields, then exactly one IxData field.
+    static const cte_grammar_rule_t overlap[] = {
+        {CTE_GRAMMAR_TYPE(CTE_PEEK_TYPE_IXDATA_ULEB128), 0, 2},
+        {CTE_GRAMMAR_IXDATA, 1, 1},
+    };
+    static const struct
+    {
+        const cte_grammar_rule_t *rules;
+        size_t rule_count;
+        const char *layout;
+        int bad_field; // Index of the offending field, -1 if accepted, -2 if incomplete.
+    } cases[] = {
+        {protocol, 4, "psic", -1},  {protocol, 4, "ppssiii", -1}, {protocol, 4, "ps", -1},
+        {protocol, 4, "spic", 0},   {protocol, 4, "psipc", 3},    {protocol, 4, "psicc", 4},
+        {protocol, 4, "psci", 3},   {protocol, 4, "p", -2},       {overlap, 2, "i", -1},
+        {overlap, 2, "iii", -1},    {overlap, 2, "iiii", 3},      {overlap, 2, "", -2},
+    };
+
+    cte_encoder_t *enc = cte_encoder_init(BUFFER_SIZE);
+    cte_grammar_t *grammars[2] = {cte_grammar_compile(protocol, 4), cte_grammar_compile(overlap, 2)};
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i)
+    {
+        cte_grammar_t *grammar = grammars[cases[i].rules == overlap];
+        size_t expected = encode_grammar_sample(enc, cases[i].layout, (size_t)cases[i].bad_field);
+        size_t size = cte_encoder_get_size(enc);
+        if (cases[i].bad_field == -2)
+        {
+            expected = size;
+        }
+        size_t offset = 0;
+        bool ok = cte_grammar_validate(grammar, cte_encoder_get_data(enc), size, &offset);
+        if (ok != (cases[i].bad_field == -1) || (!ok && offset != expected))
+        {
+            printf("  - ERROR: Layout \"%s\" %s (offset %zu, expected %zu)!\n", cases[i].layout,
+                   ok ? "accepted" : "rejected", offset, expected);
+            failures++;
+        }
+    }
+
+    // A reserved IxData fixed-type code (0xBE) is rejected at its header, not looked up.
+    static const uint8_t reserved[] = {CTE_VERSION_BYTE, 0xBE};
+    size_t offset = 0;
+    if (cte_grammar_validate(grammars[0], reserved, sizeof(reserved), &offset) || offset != 1)
+    {
+        printf("  - ERROR: Reserved header accepted or rejected at offset %zu!\n", offset);
+        failures++;
+    }
+    if (failures == 0)
+    {
+        printf("  - %zu layouts accepted or rejected at the offending header.\n", sizeof(cases) / sizeof(cases[0]));
+    }
+    cte_grammar_free(grammars[0]);
+    cte_grammar_free(grammars[1]);
+    cte_encoder_free(enc);
+}
+
+/**
+ * @brief Feeds a transaction to the incremental decoder in pieces and checks
+ * that it yields the same fields as the generic loop.
+ * @param chunk Bytes appended per step, or 0 to append exactly what
+ * `CTE_STREAM_NEED_MORE` asked for.
+ * @return The number of mismatches.
+ */
+static int stream_sample(cte_stream_decoder_t *stream, const uint8_t *data, size_t size, size_t chunk)
+{
+    cte_decoder_t dec = cte_decoder_view(data, size, 0);
+    cte_field_t expected;
+    cte_field_t field;
+    size_t fed = 0;
+    size_t needed = 0;
+    int mismatches = 0;
+
+    cte_stream_decoder_reset(stream);
+    for (int type = cte_decoder_peek_type(&dec); type != CTE_PEEK_EOF; type = cte_decoder_peek_type(&dec))
+    {
+        cte_decoder_read_field(&dec, type, &expected);
+        int got;
+        while ((got = cte_stream_decoder_next(stream, &field, &needed)) == CTE_STREAM_NEED_MORE)
+        {
+            size_t step = chunk ? chunk : needed;
+            if (needed == 0 || fed == size)
+            {
+                return mismatches + 1;
+            }
+            step = step < size - fed ? step : size - fed;
+            cte_stream_decoder_append(stream, data + fed, step);
+            fed += step;
+        }
+        if (got != type || field.offset != expected.offset || field.count != expected.count ||
+            field.length != expected.length || field.value.u64 != expected.value.u64 ||
+            (field.length && memcmp(field.data, expected.data, field.length) != 0))
+        {
+            mismatches++;
+        }
+    }
+    cte_stream_decoder_append(stream, data + fed, size - fed);
+    cte_stream_decoder_finish(stream);
+    if (cte_stream_decoder_next(stream, &field, &needed) != CTE_PEEK_EOF ||
+        cte_stream_decoder_position(stream) != size)
+    {
+        mismatches++;
+    }
+    return mismatches;
+}
+
+/**
+ * @brief Checks the incremental decoder with byte-wise, chunked and exact-need feeding.
+ */
+static void test_stream_decoder(void)
+{
+    printf("\nIncremental decoder:\n");
+
+    cte_encoder_t *enc = cte_encoder_init(BUFFER_SIZE);
+    cte_stream_decoder_t *stream = cte_stream_decoder_init(NULL);
+    static const size_t chunks[] = {0, 1, 3, 7, 64};
+    int mismatches = 0;
+    for (int layout = 0; layout < 3; ++layout)
+    {
+        encode_shape_sample(enc, layout, 5);
+        for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); ++c)
+        {
+            mismatches += stream_sample(stream, cte_encoder_get_data(enc), cte_encoder_get_size(enc), chunks[c]);
+        }
+    }
+
+    // The first request is for the version byte, then one header, then the key list.
+    size_t needed = 0;
+    cte_field_t field;
+    encode_shape_sample(enc, 0, 5);
+    cte_stream_decoder_reset(stream);
+    bool ok = cte_stream_decoder_next(stream, &field, &needed) == CTE_STREAM_NEED_MORE && needed == 1;
+    cte_stream_decoder_append(stream, cte_encoder_get_data(enc), 2);
+    ok = ok && cte_stream_decoder_next(stream, &field, &needed) == CTE_STREAM_NEED_MORE &&
+         needed == CTE_PUBKEY_SIZE_SLH_192F;
+
+    if (mismatches != 0 || !ok)
+    {
+        printf("  - ERROR: Incremental decoding disagrees with the generic path (%d mismatches)!\n", mismatches);
+    }
+    else
+    {
+        printf("  - Fields match the generic path for every feeding pattern.\n");
+    }
+    cte_stream_decoder_free(stream);
+    cte_encoder_free(enc);
+}
+
+/**
+ * @brief Decodes a transaction split into segments of `step` bytes (with an
+ * empty segment after each) and compares it with the contiguous decoder.
+ * @return The number of mismatches.
+ */
+static int segment_sample(const uint8_t *data, size_t size, size_t step, size_t *straddling)
+{
+    cte_segment_t segments[2 * BUFFER_SIZE];
+    size_t segment_count = 0;
+    for (size_t pos = 0; pos < size; pos += step)
+    {
+        segments[segment_count].base = data + pos;
+        segments[segment_count++].length = size - pos < step ? size - pos : step;
+        segments[segment_count].base = NULL;
+        segments[segment_count++].length = 0;
+    }
+
+    cte_decoder_t dec = cte_decoder_view(data, size, 0);
+    cte_segment_decoder_t seg;
+    cte_segment_decoder_init(&seg, segments, segment_count);
+    cte_field_t expected;
+    cte_segment_field_t field;
+    uint8_t copy[BUFFER_SIZE];
+    cte_segment_t view[BUFFER_SIZE];
+    int mismatches = 0;
+
+    for (int type = cte_decoder_peek_type(&dec); type != CTE_PEEK_EOF; type = cte_decoder_peek_type(&dec))
+    {
+        cte_decoder_read_field(&dec, type, &expected);
+        if (cte_segment_decoder_peek_type(&seg) != type)
+        {
+            return mismatches + 1;
+        }
+        cte_segment_decoder_read_field(&seg, type, &field);
+        const cte_field_t *got = &field.field;
+        if (got->offset != expected.offset || got->count != expected.count || got->length != expected.length ||
+            got->value.u64 != expected.value.u64)
+        {
+            mismatches++;
+            continue;
+        }
+        if (expected.data && got->length > 0)
+        {
+            // Zero-copy views must point at the original bytes; others must copy out identically.
+            size_t pieces = cte_segment_decoder_payload_segments(&seg, &field, view, BUFFER_SIZE);
+            cte_segment_decoder_copy_payload(&seg, &field, copy);
+            if ((got->data && got->data != expected.data) || (!got->data && pieces < 2) ||
+                memcmp(copy, expected.data, got->length) != 0 || view[0].base != expected.data)
+            {
+                mismatches++;
+            }
+            *straddling += got->data == NULL;
+        }
+    }
+    if (cte_segment_decoder_peek_type(&seg) != CTE_PEEK_EOF || seg.position != size)
+    {
+        mismatches++;
+    }
+    return mismatches;
+}
+
+/**
+ * @brief Checks the segment-chain decoder with boundaries at many positions.
+ */
+static void test_segment_decoder(void)
+{
+    printf("\nSegment decoder:\n");
+
+    cte_encoder_t *enc = cte_encoder_init(BUFFER_SIZE);
+    int mismatches = 0;
+    size_t straddling = 0;
+    for (int layout = 0; layout < 3; ++layout)
+    {
+        encode_shape_sample(enc, layout, 7);
+        size_t size = cte_encoder_get_size(enc);
+        for (size_t step = 1; step <= size; step += (step < 16 ? 1 : 13))
+        {
+            mismatches += segment_sample(cte_encoder_get_data(enc), size, step, &straddling);
+        }
+    }
+    if (mismatches != 0)
+    {
+        printf("  - ERROR: Segment decoding disagrees with the contiguous decoder (%d mismatches)!\n", mismatches);
+    }
+    else
+    {
+        printf("  - Fields match the contiguous decoder; %zu straddling payloads copied out.\n", straddling);
+    }
+    cte_encoder_free(enc);
+}
+
+/**
+ * @brief Checks that interleaved cursors over one transaction agree with the
+ * regular decoder, including cursors started from the field index.
+ */
+static void test_transaction_cursors(void)
+{
+    printf("\nShared transaction cursors:\n");
+
+    cte_encoder_t *enc = cte_encoder_init(BUFFER_SIZE);
+    int mismatches = 0;
+    for (int layout = 0; layout < 3; ++layout)
+    {
+        encode_shape_sample(enc, layout, 9);
+        const uint8_t *data = cte_encoder_get_data(enc);
+        size_t size = cte_encoder_get_size(enc);
+
+        cte_field_t expected[16];
+        size_t expected_count = 0;
+        cte_decoder_t dec = cte_decoder_view(data, size, 0);
+        for (int type = cte_decoder_peek_type(&dec); type != CTE_PEEK_EOF; type = cte_decoder_peek_type(&dec))
+        {
+            cte_decoder_read_field(&dec, type, &expected[expected_count++]);
+        }
+
+        cte_transaction_t tx;
+        cte_transaction_init(&tx, data, size);
+        size_t offsets[16];
+        if (cte_transaction_build_index(&tx, offsets, 0) != expected_count || tx.field_offsets != NULL ||
+            cte_transaction_build_index(&tx, offsets, 16) != expected_count || tx.field_count != expected_count)
+        {
+            mismatches++;
+            continue;
+        }
+
+        // One cursor per starting field, advanced round-robin one field at a time.
+        cte_cursor_t cursors[16];
+        size_t next[16];
+        for (size_t i = 0; i < expected_count; ++i)
+        {
+            cursors[i] = i == 0 ? cte_transaction_cursor(&tx) : cte_transaction_cursor_at(&tx, i);
+            next[i] = i;
+        }
+        for (size_t round = 0; round < expected_count; ++round)
+        {
+            for (size_t i = 0; i < expected_count; ++i)
+            {
+                int type = cte_cursor_peek_type(&tx, &cursors[i]);
+                if (next[i] == expected_count)
+                {
+                    mismatches += type != CTE_PEEK_EOF;
+                    continue;
+                }
+                const cte_field_t *want = &expected[next[i]++];
+                cte_field_t got;
+                if (type != want->type)
+                {
+                    mismatches++;
+                    next[i] = expected_count;
+                    continue;
+                }
+                cte_cursor_read_field(&tx, &cursors[i], type, &got);
+                if (got.offset != want->offset || got.count != want->count || got.length != want->length ||
+                    got.data != want->data || got.value.u64 != want->value.u64)
+                {
+                    mismatches++;
+                }
+            }
+        }
+    }
+    if (mismatches != 0)
+    {
+        printf("  - ERROR: Shared cursors disagree with the regular decoder (%d mismatches)!\n", mismatches);
+    }
+    else
+    {
+        printf("  - Interleaved cursors match the regular decoder.\n");
+    }
+    cte_encoder_free(enc);
+}
+
+/**
+ * @brief Reads `size` bytes with try_read_field() only, until the end or the first failure.
+ * @return The number of fields read, or -1 if a failed read moved the decoder.
+ */
+static int try_read_all(uint8_t *data, size_t size)
+{
+    cte_decoder_t dec = cte_decoder_view(data, size, 0);
+    cte_field_t field;
+    int count = 0;
+    for (;;)
+    {
+        cte_decoder_t probe = dec;
+        int type = cte_decoder_peek_type(&probe);
+        cte_decoder_snapshot_t before = cte_decoder_snapshot(&dec);
+        if (type == CTE_PEEK_EOF || type == -1 || !cte_decoder_try_read_field(&dec, type, &field))
+        {
+            return dec.position == before.position ? count : -1;
+        }
+        count++;
+    }
+}
+
+/**
+ * @brief Checks snapshots and the non-aborting reads on truncated and corrupted
+ * input, and a speculative "optional boolean, then ULEB128" parse.
+ */
+static void test_try_reads(void)
+{
+    printf("\nNon-aborting reads:\n");
+
+    cte_encoder_t *enc = cte_encoder_init(BUFFER_SIZE);
+    uint8_t copy[BUFFER_SIZE];
+    int mismatches = 0;
+    for (int layout = 0; layout < 3; ++layout)
+    {
+        encode_shape_sample(enc, layout, 11);
+        size_t size = cte_encoder_get_size(enc);
+        memcpy(copy, cte_encoder_get_data(enc), size);
+
+        // Every prefix decodes exactly the fields that fit in it.
+        int complete = try_read_all(copy, size);
+        cte_decoder_t dec = cte_decoder_view(copy, size, 0);
+        size_t ends[16];
+        int field_count = 0;
+        cte_field_t field;
+        for (int type = cte_decoder_peek_type(&dec); type != CTE_PEEK_EOF; type = cte_decoder_peek_type(&dec))
+        {
+            cte_decoder_read_field(&dec, type, &field);
+            ends[field_count++] = dec.position;
+        }
+        mismatches += complete != field_count;
+        for (size_t length = 1; length < size; ++length)
+        {
+            int fit = 0;
+            while (fit < field_count && ends[fit] <= length)
+            {
+                fit++;
+            }
+            mismatches += try_read_all(copy, length) != fit;
+        }
+
+        // Any single corrupted byte is rejected or read without aborting.
+        for (size_t i = 1; i < size; ++i)
+        {
+            uint8_t original = copy[i];
+            for (int value = 0; value < 256; ++value)
+            {
+                copy[i] = (uint8_t)value;
+                mismatches += try_read_all(copy, size) < 0;
+            }
+            copy[i] = original;
+        }
+    }
+
+    // Layout 1 starts with a legacy index, then a uint16: try boolean, then ULEB128, then the real types.
+    encode_shape_sample(enc, 1, 4);
+    cte_decoder_t dec = cte_decoder_view(cte_encoder_get_data(enc), cte_encoder_get_size(enc), 0);
+    cte_decoder_snapshot_t start = cte_decoder_snapshot(&dec);
+    bool flag = false;
+    uint64_t wide = 0;
+    uint8_t index = 0;
+    uint16_t narrow = 0;
+    bool ok = !cte_decoder_try_read_ixdata_boolean(&dec, &flag) && !cte_decoder_try_read_ixdata_uleb128(&dec, &wide) &&
+              dec.position == 0 && cte_decoder_try_read_ixdata_index_reference(&dec, &index) && index == 3;
+    cte_decoder_snapshot_t after_index = cte_decoder_snapshot(&dec);
+    ok = ok && cte_decoder_try_read_ixdata_uint16(&dec, &narrow) && narrow == 4000;
+    cte_decoder_restore(&dec, after_index);
+    int16_t signed_narrow = 0;
+    ok = ok && !cte_decoder_try_read_ixdata_int16(&dec, &signed_narrow) &&
+         cte_decoder_peek_type(&dec) == CTE_PEEK_TYPE_IXDATA_UINT16;
+    cte_decoder_restore(&dec, start);
+    ok = ok && cte_decoder_peek_type(&dec) == CTE_PEEK_TYPE_IXDATA_LEGACY_INDEX;
+
+    // The types peek reports for a reserved header and for the end are rejected, not read.
+    static const uint8_t reserved[] = {CTE_VERSION_BYTE, 0x8B};
+    cte_decoder_t reserved_dec = cte_decoder_view(reserved, sizeof(reserved), 1);
+    cte_field_t field;
+    ok = ok && cte_decoder_peek_type(&reserved_dec) == -1 && !cte_decoder_try_read_field(&reserved_dec, -1, &field) &&
+         reserved_dec.position == 1;
+    uint8_t *version_only = malloc(1);
+    version_only[0] = CTE_VERSION_BYTE;
+    cte_decoder_t end_dec = cte_decoder_view(version_only, 1, 1);
+    ok = ok && !cte_decoder_try_read_field(&end_dec, CTE_PEEK_EOF, &field) && end_dec.position == 1;
+    free(version_only);
+
+    // Whole-transaction validation reports the first field that does not decode.
+    size_t bad = SIZE_MAX;
+    ok = ok && cte_decoder_validate(cte_encoder_get_data(enc), cte_encoder_get_size(enc), &bad) && bad == 0;
+    ok = ok && !cte_decoder_validate(reserved, sizeof(reserved), &bad) && bad == 1;
+    cte_decoder_t walk = cte_decoder_view(cte_encoder_get_data(enc), cte_encoder_get_size(enc), 0);
+    size_t last_field = 0;
+    for (int type = cte_decoder_peek_type(&walk); type != CTE_PEEK_EOF; type = cte_decoder_peek_type(&walk))
+    {
+        last_field = walk.position;
+        cte_decoder_read_field(&walk, type, &field);
+    }
+    ok = ok && !cte_decoder_validate(cte_encoder_get_data(enc), cte_encoder_get_size(enc) - 1, &bad) &&
+         bad == last_field;
+    ok = ok && !cte_decoder_validate(reserved + 1, 1, &bad) && bad == 0 && !cte_decoder_validate(reserved, 0, NULL);
+
+    if (mismatches != 0 || !ok)
+    {
+        printf("  - ERROR: Non-aborting reads disagree with the decoder (%d mismatches)!\n", mismatches);
+    }
+    else
+    {
+        printf("  - Truncated and corrupted input rejected without aborting; backtracking works.\n");
+    }
+    cte_encoder_free(enc);
+}
+
+/**
+ * @brief Checks the hex codec against a byte-at-a-time reference for every
+ * length up to a few SIMD blocks, and rejects an invalid digit at every position.
+ */
+static void test_hex_codec(void)
+{
+    printf("\nHex codec:\n");
+
+    static const char reference[] = "0123456789ABCDEF";
+    uint8_t data[160];
+    uint8_t decoded[160];
+    char hex[2 * sizeof(data)];
+    char expected[2 * sizeof(data)];
+    int mismatches = 0;
+    for (size_t i = 0; i < sizeof(data); ++i)
+    {
+        data[i] = (uint8_t)(i * 151 + 7);
+    }
+    for (size_t size = 0; size <= sizeof(data); ++size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            expected[2 * i] = reference[data[i] >> 4];
+            expected[2 * i + 1] = reference[data[i] & 0x0F];
+        }
+        cte_hex_encode(data, size, hex);
+        mismatches += memcmp(hex, expected, 2 * size) != 0;
+
+        // Mixed case must decode to the same bytes.
+        for (size_t i = 0; i < 2 * size; i += 3)
+        {
+            hex[i] = (char)(hex[i] >= 'A' ? hex[i] | 0x20 : hex[i]);
+        }
+        mismatches += !cte_hex_decode(hex, 2 * size, decoded) || memcmp(decoded, data, size) != 0;
+    }
+
+    static const char invalid[] = {'g', 'G', '/', ':', '@', '`', ' ', '\0', (char)0x80, (char)0xB0, (char)0xE1};
+    cte_hex_encode(data, sizeof(data), hex);
+    for (size_t i = 0; i < sizeof(hex); ++i)
+    {
+        char original = hex[i];
+        for (size_t k = 0; k < sizeof(invalid); ++k)
+        {
+            hex[i] = invalid[k];
+            mismatches += cte_hex_decode(hex, sizeof(hex), decoded);
+        }
+        hex[i] = original;
+    }
+    mismatches += cte_hex_decode(hex, 3, decoded);
+
+    if (mismatches != 0)
+    {
+        printf("  - ERROR: Hex codec disagrees with the reference (%d mismatches)!\n", mismatches);
+    }
+    else
+    {
+        printf("  - Encoding and decoding match the reference; invalid digits are rejected.\n");
+    }
+}
+
+/**
+ * @brief Checks Base58 key decoding against known vectors and round trips,
+ * and rejects invalid digits and size mismatches.
+ */
+static void test_base58_codec(void)
+{
+    printf("\nBase58 codec:\n");
+
+    static const char vector[] = "1112hBt2bHTt3Utt6bgd2274wnW3DR2yf3Trhp3tzKa";
+    uint8_t expected[32] = {0};
+    uint8_t key[CTE_BASE58_MAX_SIZE];
+    uint8_t decoded[CTE_BASE58_MAX_SIZE];
+    char text[CTE_BASE58_MAX_LENGTH];
+    int failures = 0;
+    for (size_t i = 0; i < 30; ++i)
+    {
+        expected[2 + i] = (uint8_t)(i * 37);
+    }
+    failures += !cte_base58_decode(vector, sizeof(vector) - 1, decoded, 32) || memcmp(decoded, expected, 32) != 0;
+    size_t length = cte_base58_encode(expected, 32, text);
+    failures += length != sizeof(vector) - 1 || memcmp(text, vector, length) != 0;
+
+    static const size_t sizes[] = {CTE_PUBKEY_SIZE_ED25519, CTE_PUBKEY_SIZE_SLH_192F, CTE_PUBKEY_SIZE_SLH_256F};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        size_t size = sizes[s];
+        for (size_t zeros = 0; zeros <= size; zeros += 7)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                key[i] = i < zeros ? 0 : (uint8_t)(i * 151 + size + 0xA5);
+            }
+            length = cte_base58_encode(key, size, text);
+            failures += length == 0 || length > CTE_BASE58_MAX_LENGTH;
+            failures += !cte_base58_decode(text, length, decoded, size) || memcmp(decoded, key, size) != 0;
+            failures += cte_base58_decode(text, length, decoded, size - 1); // too short for the value
+        }
+    }
+
+    memset(key, 0xFF, sizeof(key));
+    length = cte_base58_encode(key, sizeof(key), text);
+    failures += length != CTE_BASE58_MAX_LENGTH;
+    failures += !cte_base58_decode(text, length, decoded, sizeof(key)) || memcmp(decoded, key, sizeof(key)) != 0;
+
+    static const char invalid[] = {'0', 'O', 'I', 'l', '+', ' ', (char)0xC3};
+    char bad[sizeof(vector)];
+    for (size_t k = 0; k < sizeof(invalid); ++k)
+    {
+        memcpy(bad, vector, sizeof(vector));
+        bad[10] = invalid[k];
+        failures += cte_base58_decode(bad, sizeof(vector) - 1, decoded, 32);
+    }
+    failures += cte_base58_decode(vector + 1, sizeof(vector) - 2, decoded, 32); // one leading zero short
+
+    if (failures != 0)
+    {
+        printf("  - ERROR: Base58 codec failed %d checks!\n", failures);
+    }
+    else
+    {
+        printf("  - Keys of 32, 48 and 64 bytes round-trip; invalid input is rejected.\n");
+    }
+}
+
+/**
+ * @brief Checks Base64 against a scalar reference for every length up to a
+ * few SIMD blocks, and rejects invalid characters and non-canonical padding.
+ */
+static void test_base64_codec(void)
+{
+    printf("\nBase64 codec:\n");
+
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint8_t data[200];
+    uint8_t decoded[200];
+    char text[4 * (sizeof(data) + 2) / 3];
+    char expected[sizeof(text)];
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(data); ++i)
+    {
+        data[i] = (uint8_t)(i * 97 + 13);
+    }
+    for (size_t size = 0; size <= sizeof(data); ++size)
+    {
+        size_t length = cte_base64_encoded_length(size);
+        for (size_t i = 0; i < size; i += 3)
+        {
+            uint32_t v = (uint32_t)data[i] << 16 | (i + 1 < size ? (uint32_t)data[i + 1] << 8 : 0) |
+                         (i + 2 < size ? data[i + 2] : 0);
+            char *q = expected + i / 3 * 4;
+            q[0] = alphabet[v >> 18];
+            q[1] = alphabet[(v >> 12) & 0x3F];
+            q[2] = i + 1 < size ? alphabet[(v >> 6) & 0x3F] : '=';
+            q[3] = i + 2 < size ? alphabet[v & 0x3F] : '=';
+        }
+        cte_base64_encode(data, size, text);
+        failures += memcmp(text, expected, length) != 0;
+
+        size_t decoded_size = 0;
+        failures += !cte_base64_decode(text, length, decoded, &decoded_size) || decoded_size != size ||
+                    memcmp(decoded, data, size) != 0;
+    }
+
+    static const char invalid[] = {'=', '-', '_', '.', ':', '@', '[', '`', '{', ' ', '\0', (char)0x80, (char)0xC1};
+    size_t length = cte_base64_encoded_length(sizeof(data));
+    size_t decoded_size;
+    cte_base64_encode(data, sizeof(data), text);
+    for (size_t i = 0; i + 4 < length; ++i)
+    {
+        char original = text[i];
+        for (size_t k = 0; k < sizeof(invalid); ++k)
+        {
+            text[i] = invalid[k];
+            failures += cte_base64_decode(text, length, decoded, &decoded_size);
+        }
+        text[i] = original;
+    }
+    failures += cte_base64_decode("QQ", 2, decoded, &decoded_size);       // unpadded
+    failures += cte_base64_decode("QR==", 4, decoded, &decoded_size);     // stray bits under padding
+    failures += cte_base64_decode("Q===", 4, decoded, &decoded_size);     // too much padding
+    failures += cte_base64_decode("QQ==QUFB", 8, decoded, &decoded_size); // padding before the end
+
+    if (failures != 0)
+    {
+        printf("  - ERROR: Base64 codec failed %d checks!\n", failures);
+    }
+    else
+    {
+        printf("  - Encoding and decoding match the reference; malformed input is rejected.\n");
+    }
+}
+
+/**
+ * @brief Checks number formatting against known strings, and that floats
+ * read back exactly for a sweep of bit patterns.
+ */
+static void test_number_format(void)
+{
+    printf("\nNumber formatting:\n");
+
+    static const struct
+    {
+        double value;
+        const char *text;
+    } doubles[] = {
+        {0.0, "0"},
+        {-0.0, "-0"},
+        {0.1, "0.1"},
+        {1.0 / 3.0, "0.3333333333333333"},
+        {100.0, "100"},
+        {-2.5, "-2.5"},
+        {1e20, "100000000000000000000"},
+        {1e21, "1e+21"},
+        {1e-6, "0.000001"},
+        {1e-7, "1e-7"},
+        {5e-324, "5e-324"},
+        {1.7976931348623157e308, "1.7976931348623157e+308"},
+        {-__builtin_inf(), "-inf"},
+    };
+    char text[CTE_NUMBER_MAX_LENGTH + 1];
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(doubles) / sizeof(doubles[0]); ++i)
+    {
+        size_t length = cte_format_double(doubles[i].value, text);
+        text[length] = '\0';
+        if (strcmp(text, doubles[i].text) != 0)
+        {
+            printf("  - ERROR: %s formatted as %s\n", doubles[i].text, text);
+            failures++;
+        }
+    }
+    size_t length = cte_format_float(0.1f, text);
+    failures += length != 3 || memcmp(text, "0.1", 3) != 0;
+    length = cte_format_float(3.4028235e38f, text);
+    failures += length != 13 || memcmp(text, "3.4028235e+38", 13) != 0;
+
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (int i = 0; i < 200000; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        double d;
+        memcpy(&d, &state, sizeof(d));
+        float f;
+        uint32_t low = (uint32_t)state;
+        memcpy(&f, &low, sizeof(f));
+        if (d == d && d - d == 0.0)
+        {
+            text[cte_format_double(d, text)] = '\0';
+            failures += strtod(text, NULL) != d;
+        }
+        if (f == f && f - f == 0.0f)
+        {
+            text[cte_format_float(f, text)] = '\0';
+            failures += strtof(text, NULL) != f;
+        }
+
+        char expected[CTE_NUMBER_MAX_LENGTH];
+        int64_t n = (int64_t)state >> (state & 63);
+        snprintf(expected, sizeof(expected), "%lld", (long long)n);
+        text[cte_format_int64(n, text)] = '\0';
+        failures += strcmp(text, expected) != 0;
+    }
+    text[cte_format_int64(INT64_MIN, text)] = '\0';
+    failures += strcmp(text, "-9223372036854775808") != 0;
+    text[cte_format_uint64(UINT64_MAX, text)] = '\0';
+    failures += strcmp(text, "18446744073709551615") != 0;
+
+    if (failures != 0)
+    {
+        printf("  - ERROR: Number formatting failed %d checks!\n", failures);
+    }
+    else
+    {
+        printf("  - Integers match printf; floats are short and read back exactly.\n");
+    }
+}
+
+/**
+ * @brief Renders a transaction with every field type as JSON, checks the
+ * text, parses it back and compares the bytes; then checks parse errors.
+ */
+static void test_json_transcoder(void)
+{
+    printf("\nJSON transcoder:\n");
+
+    cte_encoder_t *enc = cte_encoder_init(CTE_MAX_TRANSACTION_SIZE);
+    uint8_t keys[2 * CTE_PUBKEY_SIZE_ED25519];
+    for (size_t i = 0; i < sizeof(keys); ++i)
+    {
+        keys[i] = (uint8_t)i;
+    }
+    memcpy(cte_encoder_begin_public_key_list(enc, 2, CTE_CRYPTO_TYPE_ED25519), keys, sizeof(keys));
+    memset(cte_encoder_begin_signature_list(enc, 1, CTE_CRYPTO_TYPE_SLH_DSA_192F), 0xAB,
+           CTE_SIGNATURE_HASH_SIZE_PQC);
+    cte_encoder_write_ixdata_index_reference(enc, 15);
+    cte_encoder_write_ixdata_uleb128(enc, 0);
+    cte_encoder_write_ixdata_uleb128(enc, UINT64_MAX);
+    cte_encoder_write_ixdata_sleb128(enc, INT64_MIN);
+    cte_encoder_write_ixdata_int8(enc, -128);
+    cte_encoder_write_ixdata_int16(enc, 32767);
+    cte_encoder_write_ixdata_int32(enc, INT32_MIN);
+    cte_encoder_write_ixdata_int64(enc, -1);
+    cte_encoder_write_ixdata_uint8(enc, 255);
+    cte_encoder_write_ixdata_uint16(enc, 0);
+    cte_encoder_write_ixdata_uint32(enc, UINT32_MAX);
+    cte_encoder_write_ixdata_uint64(enc, 12345678901234567890ull);
+    cte_encoder_write_ixdata_float32(enc, 0.1f);
+    cte_encoder_write_ixdata_float64(enc, 1.0 / 3.0);
+    cte_encoder_write_ixdata_float64(enc, -__builtin_inf());
+    cte_encoder_write_ixdata_boolean(enc, false);
+    cte_encoder_write_ixdata_boolean(enc, true);
+    memcpy(cte_encoder_begin_command_data(enc, 3), "\x01\x02\xFF", 3);
+    memset(cte_encoder_begin_command_data(enc, 300), 0x5A, 300);
+
+    const uint8_t *data = cte_encoder_get_data(enc);
+    size_t size = cte_encoder_get_size(enc);
+    static char json[CTE_JSON_MAX_LENGTH + 1];
+    size_t length = cte_json_from_cte(data, size, json, sizeof(json));
+    int failures = length == 0;
+    static const char middle[] = "{\"index\":15},{\"uleb\":0},{\"uleb\":18446744073709551615},"
+                                 "{\"sleb\":-9223372036854775808},{\"int8\":-128},{\"int16\":32767},"
+                                 "{\"int32\":-2147483648},{\"int64\":-1},{\"uint8\":255},{\"uint16\":0},"
+                                 "{\"uint32\":4294967295},{\"uint64\":12345678901234567890},"
+                                 "{\"float\":0.1},{\"double\":0.3333333333333333},"
+                                 "{\"double\":\"-Infinity\"},{\"bool\":false},{\"bool\":true},"
+                                 "{\"cmd\":\"0102FF\"},{\"cmd\":\"5A5A";
+    failures += strncmp(json, "[{\"pk-list-ed25519\":\"000102", 27) != 0 || strstr(json, middle) == NULL;
+
+    // Parsing the rendering, with extra whitespace, reproduces the bytes.
+    cte_encoder_t *round_trip = cte_encoder_init(CTE_MAX_TRANSACTION_SIZE);
+    failures += !cte_json_to_cte(round_trip, json, length, NULL);
+    failures += cte_encoder_get_size(round_trip) != size || memcmp(cte_encoder_get_data(round_trip), data, size) != 0;
+    static const char spaced[] = " [ { \"uint8\" : 7 } ,\t{\"double\": -2.5e-3}, {\"cmd\":\"\"} ]\n";
+    cte_encoder_reset(round_trip);
+    failures += !cte_json_to_cte(round_trip, spaced, sizeof(spaced) - 1, NULL);
+    length = cte_json_from_cte(cte_encoder_get_data(round_trip), cte_encoder_get_size(round_trip), json, sizeof(json));
+    failures += strcmp(json, "[{\"uint8\":7},{\"double\":-0.0025},{\"cmd\":\"\"}]") != 0;
+
+    static const struct
+    {
+        const char *json;
+        size_t offset;
+    } invalid[] = {
+        {"{}", 0},
+        {"[{\"uint8\":256}]", 10},
+        {"[{\"int8\":-129}]", 9},
+        {"[{\"uint16\":1.5}]", 11},
+        {"[{\"uint32\":-1}]", 11},
+        {"[{\"uint64\":18446744073709551616}]", 11},
+        {"[{\"index\":16}]", 10},
+        {"[{\"bool\":1}]", 9},
+        {"[{\"cmd\":\"ABC\"}]", 8},
+        {"[{\"cmd\":\"A\\u0042\"}]", 8},
+        {"[{\"pk-list-ed25519\":\"AABB\"}]", 20},
+        {"[{\"nope\":1}]", 2},
+        {"[{\"uint8\":1} {\"uint8\":2}]", 13},
+        {"[{\"uint8\":1}] x", 14},
+        {"[{\"double\":01}]", 11},
+        {"[{\"double\":1e400}]", 11},
+        {"[{\"double\":-1e400}]", 11},
+        {"[{\"float\":1e39}]", 10},
+        {"[{\"uint8\":1}", 12},
+    };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+    {
+        cte_json_error_t error = {0, NULL};
+        cte_encoder_reset(round_trip);
+        if (cte_json_to_cte(round_trip, invalid[i].json, strlen(invalid[i].json), &error) ||
+            error.offset != invalid[i].offset || error.message == NULL)
+        {
+            printf("  - ERROR: '%s' gave offset %zu (%s)\n", invalid[i].json, error.offset,
+                   error.message ? error.message : "accepted");
+            failures++;
+        }
+    }
+
+    // A payload past the extended Command Data limit is rejected at its string, not aborted on.
+    static char long_command[2 * (CTE_COMMAND_EXTENDED_MAX_LEN + 1) + 16];
+    int long_length = snprintf(long_command, sizeof(long_command), "[{\"cmd\":\"%0*d\"}]",
+                               2 * (CTE_COMMAND_EXTENDED_MAX_LEN + 1), 0);
+    cte_json_error_t long_error = {0, NULL};
+    cte_encoder_reset(round_trip);
+    failures += cte_json_to_cte(round_trip, long_command, (size_t)long_length, &long_error) || long_error.offset != 8;
+
+    // Field type names: shared by both directions, NULL outside the peek types.
+    failures += strcmp(cte_json_field_name(CTE_PEEK_TYPE_IXDATA_VARINT_ZERO), "uleb") != 0;
+    failures += strcmp(cte_json_field_name(CTE_PEEK_TYPE_CMD_EXTENDED), "cmd") != 0;
+    failures += cte_json_field_name(-1) != NULL || cte_json_field_name(CTE_PEEK_EOF) != NULL;
+
+    // Malformed transactions are reported rather than aborting.
+    failures += cte_json_from_cte(data, 10, json, sizeof(json)) != 0; // truncated key list
+    failures += cte_json_from_cte(data + 1, size - 1, json, sizeof(json)) != 0;
+    failures += cte_json_from_cte(data, size, json, 64) != 0;
+
+    cte_encoder_free(round_trip);
+    cte_encoder_free(enc);
+    if (failures != 0)
+    {
+        printf("  - ERROR: JSON transcoder failed %d checks!\n", failures);
+    }
+    else
+    {
+        printf("  - All field types round-trip through JSON; errors are located.\n");
+    }
+}
+
 /**
  * @brief Main entry point for the native CTE test harness.
  *
@@ -117,6 +1401,451 @@ void print_hex(const char *label, const uint8_t *data, size_t size)
  *
  * @return 0 on successful completion.
  */
+/**
+ * @brief Growing in-memory sink for container tests.
+ */
+typedef struct
+{
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+} memory_sink_t;
+
+static bool memory_sink(void *context, const uint8_t *data, size_t size)
+{
+    memory_sink_t *sink = context;
+    if (sink->size + size > sink->capacity)
+    {
+        sink->capacity = 2 * (sink->size + size);
+        sink->data = realloc(sink->data, sink->capacity);
+    }
+    memcpy(sink->data + sink->size, data, size);
+    sink->size += size;
+    return true;
+}
+
+/**
+ * @brief Writes a container and reads it back by number, sequentially and
+ * in split ranges, with an intact index, a damaged record and no index.
+ */
+static void test_container(void)
+{
+    printf("\nContainer:\n");
+
+    int failures = 0;
+    failures += cte_crc32c(0, (const uint8_t *)"123456789", 9) != 0xE3069283u;
+    failures += cte_crc32c(cte_crc32c(0, (const uint8_t *)"1234", 4), (const uint8_t *)"56789", 5) != 0xE3069283u;
+
+    enum { RECORDS = 1000, INTERVAL = 64 };
+    uint8_t tx[CTE_MAX_TRANSACTION_SIZE];
+    memory_sink_t sink = {0};
+    cte_container_writer_t *writer =
+        cte_container_writer_init(INTERVAL, CTE_CONTAINER_CHECKSUMS, memory_sink, &sink, NULL);
+    for (size_t i = 0; i < RECORDS; ++i)
+    {
+        size_t size = 1 + (i * 37) % CTE_MAX_TRANSACTION_SIZE; // crosses the 1- to 2-byte length prefix
+        tx[0] = CTE_VERSION_BYTE;
+        for (size_t k = 1; k < size; ++k)
+        {
+            tx[k] = (uint8_t)(i + k);
+        }
+        failures += !cte_container_writer_append(writer, tx, size);
+    }
+    failures += cte_container_writer_count(writer) != RECORDS;
+    failures += !cte_container_writer_finish(writer);
+    cte_container_writer_free(writer);
+
+    cte_container_t container;
+    cte_container_record_t record;
+    failures += !cte_container_open(&container, sink.data, sink.size);
+    failures += !container.indexed || container.record_count != RECORDS;
+    for (uint64_t i = 0; i < RECORDS; i += 7)
+    {
+        failures += cte_container_get(&container, i, &record) != CTE_CONTAINER_OK ||
+                    record.size != 1 + (i * 37) % CTE_MAX_TRANSACTION_SIZE ||
+                    (record.size > 1 && record.data[1] != (uint8_t)(i + 1));
+    }
+    failures += cte_container_get(&container, RECORDS, &record) != CTE_CONTAINER_OUT_OF_RANGE;
+
+    // Split ranges cover every record exactly once, in order.
+    uint64_t expected = 0;
+    for (unsigned part = 0; part < 5; ++part)
+    {
+        size_t offset, end;
+        cte_container_split(&container, part, 5, &offset, &end);
+        uint64_t index = 0;
+        while (offset < end)
+        {
+            failures += cte_container_next(&container, &offset, &index, &record) != CTE_CONTAINER_OK ||
+                        record.index != expected++;
+        }
+    }
+    failures += expected != RECORDS;
+
+    // A flipped payload byte is a checksum failure that does not stop iteration.
+    cte_container_get(&container, 500, &record);
+    size_t damaged = record.offset + 3;
+    sink.data[damaged] ^= 0x40;
+    failures += cte_container_get(&container, 500, &record) != CTE_CONTAINER_CHECKSUM;
+    size_t offset = CTE_CONTAINER_HEADER_SIZE;
+    uint64_t index = 0;
+    size_t bad = 0;
+    cte_container_status_t status;
+    while ((status = cte_container_next(&container, &offset, &index, &record)) != CTE_CONTAINER_END)
+    {
+        bad += status != CTE_CONTAINER_OK;
+    }
+    failures += bad != 1 || index != RECORDS;
+    sink.data[damaged] ^= 0x40;
+
+    // An unfinished container is still read and split through the sync markers.
+    failures += !cte_container_open(&container, sink.data, container.body_end) || container.indexed;
+    expected = 0;
+    for (unsigned part = 0; part < 3; ++part)
+    {
+        size_t end;
+        cte_container_split(&container, part, 3, &offset, &end);
+        while (offset < end && cte_container_next(&container, &offset, &index, &record) == CTE_CONTAINER_OK)
+        {
+            failures += record.index != expected++;
+        }
+    }
+    failures += expected != RECORDS;
+
+    // Resuming the unfinished container rebuilds its index and keeps appending.
+    sink.size = container.body_end;
+    writer = cte_container_writer_resume(&container, container.body_end, memory_sink, &sink, NULL);
+    failures += writer == NULL || cte_container_writer_count(writer) != RECORDS;
+    failures += cte_container_writer_resume(&container, container.body_end - 1, memory_sink, &sink, NULL) != NULL;
+    if (writer)
+    {
+        failures += !cte_container_writer_append(writer, tx, 1) || !cte_container_writer_finish(writer);
+        cte_container_writer_free(writer);
+        failures += !cte_container_open(&container, sink.data, sink.size) || !container.indexed ||
+                    container.record_count != RECORDS + 1;
+        failures += cte_container_get(&container, 777, &record) != CTE_CONTAINER_OK ||
+                    record.size != 1 + (777 * 37) % CTE_MAX_TRANSACTION_SIZE;
+    }
+    failures += cte_container_open(&container, sink.data + 1, sink.size - 1);
+    free(sink.data);
+
+    if (failures != 0)
+    {
+        printf("  - ERROR: Container failed %d checks!\n", failures);
+    }
+    else
+    {
+        printf("  - Records read back by number, in order and in split ranges; damage is detected.\n");
+    }
+}
+
+/**
+ * @brief Encodes the transaction the log test appends as number `sequence`.
+ */
+static void encode_log_sample(cte_encoder_t *enc, uint64_t sequence)
+{
+    cte_encoder_reset(enc);
+    cte_encoder_write_ixdata_uint64(enc, sequence);
+    size_t length = 1 + sequence % 200;
+    memset(cte_encoder_begin_command_data(enc, length), (int)(sequence & 0xFF), length);
+}
+
+/**
+ * @brief Checks every record of the log in `directory` against `encode_log_sample()`.
+ * @return The number of records, or `UINT64_MAX` on a mismatch.
+ */
+static uint64_t check_log_records(const char *directory, cte_encoder_t *enc, size_t *segments)
+{
+    uint64_t sequence = 0;
+    *segments = 0;
+    for (;;)
+    {
+        char path[256];
+        snprintf(path, sizeof(path), "%s/%020" PRIu64 CTE_LOG_SEGMENT_SUFFIX, directory, sequence);
+        FILE *file = fopen(path, "rb");
+        if (!file)
+        {
+            return sequence;
+        }
+        static uint8_t data[2 * CTE_LOG_MIN_SEGMENT_SIZE];
+        size_t size = fread(data, 1, sizeof(data), file);
+        fclose(file);
+        (*segments)++;
+
+        cte_container_t container;
+        cte_container_record_t record;
+        size_t offset = CTE_CONTAINER_HEADER_SIZE;
+        uint64_t index = 0;
+        if (!cte_container_open(&container, data, size))
+        {
+            return UINT64_MAX;
+        }
+        while (cte_container_next(&container, &offset, &index, &record) == CTE_CONTAINER_OK)
+        {
+            encode_log_sample(enc, sequence++);
+            if (record.size != cte_encoder_get_size(enc) || memcmp(record.data, cte_encoder_get_data(enc), record.size))
+            {
+                return UINT64_MAX;
+            }
+        }
+        if (offset != container.body_end)
+        {
+            return UINT64_MAX;
+        }
+    }
+}
+
+/**
+ * @brief Appends across several segments, reopens the log, and recovers
+ * it after the last record is torn.
+ */
+static void test_transaction_log(void)
+{
+    printf("\nTransaction Log:\n");
+
+    enum { RECORDS = 3000 };
+    char directory[] = "/tmp/cte_log_test_XXXXXX";
+    if (!mkdtemp(directory))
+    {
+        printf("  - ERROR: Could not create a temporary directory!\n");
+        return;
+    }
+    int failures = 0;
+    cte_encoder_t *enc = cte_encoder_init(BUFFER_SIZE);
+    cte_log_options_t options;
+    cte_log_default_options(&options);
+    options.segment_size = CTE_LOG_MIN_SEGMENT_SIZE;
+    options.batch_size = 16 * 1024;
+    options.max_delay_us = 200;
+    options.sync_interval = 16;
+
+    cte_log_recovery_t recovery;
+    cte_log_t *log = cte_log_open(directory, &options, &recovery);
+    failures += log == NULL || recovery.next_sequence != 0 || recovery.segments != 0;
+    uint64_t sequence = 0;
+    for (uint64_t i = 0; log && i < RECORDS; ++i)
+    {
+        encode_log_sample(enc, i);
+        failures += !cte_log_append(log, cte_encoder_get_data(enc), cte_encoder_get_size(enc), &sequence) ||
+                    sequence != i;
+    }
+    uint8_t malformed[] = {CTE_VERSION_BYTE, 0xFF};
+    failures += log == NULL || cte_log_append(log, malformed, sizeof(malformed), NULL);
+    failures += log == NULL || !cte_log_sync(log, sequence);
+    cte_log_stats_t stats = {0};
+    if (log)
+    {
+        cte_log_stats(log, &stats);
+    }
+    failures += stats.appended != RECORDS || stats.durable != RECORDS || stats.batches >= RECORDS || stats.segments < 3;
+    failures += !cte_log_close(log);
+
+    size_t segments = 0;
+    failures += check_log_records(directory, enc, &segments) != RECORDS || segments != stats.segments;
+
+    // Reopening starts a new segment; tear the last record of it off mid-write.
+    log = cte_log_open(directory, &options, &recovery);
+    failures += log == NULL || recovery.next_sequence != RECORDS || recovery.truncated_bytes != 0;
+    for (uint64_t i = RECORDS; log && i < RECORDS + 10; ++i)
+    {
+        encode_log_sample(enc, i);
+        failures += !cte_log_append(log, cte_encoder_get_data(enc), cte_encoder_get_size(enc), &sequence);
+    }
+    failures += !cte_log_close(log);
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%020d" CTE_LOG_SEGMENT_SUFFIX, directory, RECORDS);
+    static uint8_t data[CTE_LOG_MIN_SEGMENT_SIZE];
+    FILE *file = fopen(path, "rb");
+    size_t size = file ? fread(data, 1, sizeof(data), file) : 0;
+    if (file)
+    {
+        fclose(file);
+    }
+    cte_container_t container;
+    failures += !cte_container_open(&container, data, size) || truncate(path, (off_t)container.body_end - 3) != 0;
+
+    log = cte_log_open(directory, &options, &recovery);
+    failures += log == NULL || recovery.next_sequence != RECORDS + 9 || recovery.truncated_bytes == 0;
+    encode_log_sample(enc, RECORDS + 9);
+    failures += log == NULL || !cte_log_append(log, cte_encoder_get_data(enc), cte_encoder_get_size(enc), &sequence) ||
+                sequence != RECORDS + 9;
+    failures += !cte_log_close(log);
+    failures += check_log_records(directory, enc, &segments) != RECORDS + 10;
+
+    // An unfinished segment before the last is damage: opening fails without writing to it.
+    snprintf(path, sizeof(path), "%s/%020d" CTE_LOG_SEGMENT_SUFFIX, directory, 0);
+    file = fopen(path, "rb");
+    size = file ? fread(data, 1, sizeof(data), file) : 0;
+    if (file)
+    {
+        fclose(file);
+    }
+    failures += !cte_container_open(&container, data, size) || truncate(path, (off_t)container.body_end - 3) != 0;
+    size = container.body_end - 3;
+    errno = 0;
+    failures += cte_log_open(directory, &options, &recovery) != NULL || errno != EBADMSG;
+    static uint8_t after[CTE_LOG_MIN_SEGMENT_SIZE + 1];
+    file = fopen(path, "rb");
+    failures += file == NULL || fread(after, 1, sizeof(after), file) != size || memcmp(after, data, size) != 0;
+    if (file)
+    {
+        fclose(file);
+    }
+
+    for (uint64_t first = 0; first <= RECORDS + 9; ++first)
+    {
+        snprintf(path, sizeof(path), "%s/%020" PRIu64 CTE_LOG_SEGMENT_SUFFIX, directory, first);
+        unlink(path);
+    }
+    rmdir(directory);
+    cte_encoder_free(enc);
+
+    if (failures != 0)
+    {
+        printf("  - ERROR: Transaction log failed %d checks!\n", failures);
+    }
+    else
+    {
+        printf("  - %" PRIu64 " transactions in %" PRIu64 " batches over %zu segments; a torn tail is truncated on reopen.\n",
+               stats.appended, stats.batches, (size_t)stats.segments);
+    }
+}
+
+/**
+ * @brief Builds sidecars for a prefix-framed archive and a container, checks
+ * field lookups against the decoder, and rebuilds a stale sidecar on load.
+ */
+static void test_field_index(void)
+{
+    printf("\nField Index:\n");
+
+    enum { TRANSACTIONS = 500 };
+    int failures = 0;
+    cte_encoder_t *enc = cte_encoder_init(BUFFER_SIZE);
+    memory_sink_t archive = {0};
+    memory_sink_t container_archive = {0};
+    cte_container_writer_t *writer = cte_container_writer_init(64, CTE_CONTAINER_CHECKSUMS, memory_sink,
+                                                               &container_archive, NULL);
+    for (uint64_t i = 0; i < TRANSACTIONS; ++i)
+    {
+        cte_encoder_reset(enc);
+        cte_encoder_write_ixdata_uleb128(enc, i);
+        for (uint64_t k = 0; k < i % 4; ++k)
+        {
+            size_t length = 1 + (i * 7 + k) % 60;
+            memset(cte_encoder_begin_command_data(enc, length), (int)k, length);
+        }
+        cte_encoder_write_ixdata_boolean(enc, i & 1);
+        size_t size = cte_encoder_get_size(enc);
+        uint8_t prefix[2] = {(uint8_t)((size & 0x7F) | (size > 0x7F ? 0x80 : 0)), (uint8_t)(size >> 7)};
+        memory_sink(&archive, prefix, size > 0x7F ? 2 : 1);
+        memory_sink(&archive, cte_encoder_get_data(enc), size);
+        cte_container_writer_append(writer, cte_encoder_get_data(enc), size);
+    }
+    cte_container_writer_finish(writer);
+    cte_container_writer_free(writer);
+
+    for (int source = 0; source < 2; ++source)
+    {
+        const memory_sink_t *input = source == 0 ? &archive : &container_archive;
+        cte_field_index_stamp_t stamp;
+        cte_field_index_stamp(input->data, input->size, 0, &stamp);
+        memory_sink_t sidecar = {0};
+        cte_field_index_t index;
+        failures += !cte_field_index_build(input->data, input->size, &stamp, memory_sink, &sidecar, NULL);
+        failures += !cte_field_index_open(&index, sidecar.data, sidecar.size) ||
+                    index.transaction_count != TRANSACTIONS || index.flags != 0 || index.stamp.size != input->size;
+
+        // Field k of transaction n is where the decoder finds it.
+        cte_field_index_transaction_t transaction;
+        cte_field_index_field_t entry;
+        size_t payloads = 0;
+        for (uint64_t n = 0; n < TRANSACTIONS; n += 13)
+        {
+            failures += !cte_field_index_get_transaction(&index, n, &transaction) || !transaction.valid ||
+                        transaction.field_count != 2 + n % 4;
+            cte_decoder_t dec = cte_decoder_view(input->data + transaction.offset, transaction.size, 0);
+            cte_field_t field;
+            for (size_t k = 0; k < transaction.field_count; ++k)
+            {
+                int type = cte_decoder_peek_type(&dec);
+                cte_decoder_read_field(&dec, type, &field);
+                failures += !cte_field_index_get_field(&index, n, k, &entry) || entry.type != type ||
+                            entry.offset != transaction.offset + field.offset ||
+                            (field.data && (entry.value != (uint64_t)(field.data - input->data) ||
+                                            entry.length != field.length));
+            }
+            failures += cte_field_index_get_field(&index, n, transaction.field_count, &entry);
+        }
+
+        // Every Command Data payload, in order, without touching other fields.
+        cte_field_index_cursor_t cursor = {0};
+        uint64_t last = 0;
+        while (cte_field_index_next(&index, &cursor, 1u << CTE_PEEK_TYPE_CMD_SHORT | 1u << CTE_PEEK_TYPE_CMD_EXTENDED,
+                                    &entry))
+        {
+            failures += entry.transaction < last || entry.number == 0 || entry.number > 3 ||
+                        entry.length != 1 + (entry.transaction * 7 + entry.number - 1) % 60 ||
+                        input->data[entry.value] != (uint8_t)(entry.number - 1);
+            last = entry.transaction;
+            payloads++;
+        }
+        failures += payloads != (TRANSACTIONS / 4) * (0 + 1 + 2 + 3);
+        failures += cte_field_index_get_transaction(&index, TRANSACTIONS, &transaction);
+
+        sidecar.data[32] ^= 1; // transaction count, covered by the header CRC
+        failures += cte_field_index_open(&index, sidecar.data, sidecar.size);
+        free(sidecar.data);
+    }
+
+    // A torn prefix-framed archive is indexed up to the damage and flagged.
+    {
+        cte_field_index_stamp_t stamp;
+        cte_field_index_stamp(archive.data, archive.size - 1, 0, &stamp);
+        memory_sink_t sidecar = {0};
+        cte_field_index_t index;
+        failures += !cte_field_index_build(archive.data, archive.size - 1, &stamp, memory_sink, &sidecar, NULL) ||
+                    !cte_field_index_open(&index, sidecar.data, sidecar.size) ||
+                    index.transaction_count != TRANSACTIONS - 1 || !(index.flags & CTE_FIELD_INDEX_PARTIAL);
+        free(sidecar.data);
+    }
+
+    // Loading builds the sidecar once, reuses it, and rebuilds it after the archive changes.
+    char path[] = "/tmp/cte_field_index_XXXXXX";
+    int fd = mkstemp(path);
+    failures += fd < 0 || write(fd, archive.data, archive.size) != (ssize_t)archive.size;
+    cte_field_index_file_t file;
+    failures += !cte_field_index_load(&file, path) || !file.rebuilt || !file.persisted ||
+                file.index.transaction_count != TRANSACTIONS;
+    cte_field_index_unload(&file);
+    failures += !cte_field_index_load(&file, path) || file.rebuilt || file.index.transaction_count != TRANSACTIONS;
+    cte_field_index_unload(&file);
+    failures += fd < 0 || write(fd, archive.data, archive.size) != (ssize_t)archive.size;
+    failures += !cte_field_index_load(&file, path) || !file.rebuilt || file.index.transaction_count != 2 * TRANSACTIONS;
+    cte_field_index_unload(&file);
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    unlink(path);
+    char sidecar_path[sizeof(path) + sizeof(CTE_FIELD_INDEX_SUFFIX)];
+    snprintf(sidecar_path, sizeof(sidecar_path), "%s" CTE_FIELD_INDEX_SUFFIX, path);
+    unlink(sidecar_path);
+
+    free(archive.data);
+    free(container_archive.data);
+    cte_encoder_free(enc);
+
+    if (failures != 0)
+    {
+        printf("  - ERROR: Field index failed %d checks!\n", failures);
+    }
+    else
+    {
+        printf("  - Fields found by number and by type from the sidecar; stale sidecars are rebuilt.\n");
+    }
+}
+
 int main()
 {
     printf("CTE Encoder/Decoder Native Test\n");
@@ -377,6 +2106,23 @@ end_loop:;
         printf("\nSuccessfully decoded all fields. Final position matches encoded size.\n");
     }
 
+    test_struct_codec();
+    test_schema_decoder();
+    test_shape_cache();
+    test_field_grammar();
+    test_stream_decoder();
+    test_segment_decoder();
+    test_transaction_cursors();
+    test_try_reads();
+    test_hex_codec();
+    test_base58_codec();
+    test_base64_codec();
+    test_number_format();
+    test_json_transcoder();
+    test_container();
+    test_transaction_log();
+    test_field_index();
+
     printf("\n--- Test Complete ---\n");
     return 0;
 }
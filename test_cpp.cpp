@@ -0,0 +1,559 @@
+#include "cte.hpp"
+#include "transaction.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <memory_resource>
+#include <ranges>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#define BUFFER_SIZE 2048
+
+static_assert(std::forward_iterator<cte::field_range::iterator>);
+static_assert(std::ranges::forward_range<cte::field_range>);
+
+namespace pb = cte::prebaked;
+
+constexpr pb::bytes<2 * CTE_PUBKEY_SIZE_ED25519> prebaked_keys = [] {
+    pb::bytes<2 * CTE_PUBKEY_SIZE_ED25519> keys{};
+    for (size_t i = 0; i < keys.size(); ++i)
+        keys[i] = (uint8_t)(0xAA + i);
+    return keys;
+}();
+
+constexpr auto prebaked_tx = pb::transaction(
+    pb::public_key_list<CTE_CRYPTO_TYPE_ED25519>(prebaked_keys),
+    pb::command_data(pb::literal("transfer")),
+    pb::index_reference(3),
+    pb::uleb128<300>(),
+    pb::uleb128<UINT64_MAX>(),
+    pb::sleb128<-78910>(),
+    pb::int8(-120),
+    pb::uint16(60000),
+    pb::int32(-1000),
+    pb::uint64(9876543210ULL),
+    pb::float32(3.14159f),
+    pb::float64(1.23456789012345),
+    pb::boolean(true),
+    pb::boolean(false),
+    pb::command_data(pb::bytes<150>{}));
+
+static_assert(pb::uleb128<300>().size() == 3);
+static_assert(pb::sleb128<-1>().size() == 2);
+static_assert(pb::command_data(pb::bytes<31>{}).size() == 32);
+static_assert(pb::command_data(pb::bytes<32>{}).size() == 34);
+static_assert(prebaked_tx[0] == CTE_VERSION_BYTE);
+
+/**
+ * @brief Runs `body` in a child process and reports whether it aborted.
+ */
+template <typename Body> static bool aborts(Body body)
+{
+    fflush(stdout);
+    pid_t child = fork();
+    if (child == 0)
+    {
+        freopen("/dev/null", "w", stderr);
+        body();
+        _exit(0);
+    }
+    int status = 0;
+    return child > 0 && waitpid(child, &status, 0) == child && WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+}
+
+/**
+ * @brief Checks that list writers take whole items only, instead of copying
+ * a partial item past the reserved bytes.
+ */
+static void test_list_sizes()
+{
+    printf("\nList sizes:\n");
+    uint8_t bytes[2 * CTE_PUBKEY_SIZE_ED25519] = {};
+    cte::encoder enc(BUFFER_SIZE);
+    enc.write_public_key_list(CTE_CRYPTO_TYPE_ED25519, bytes);
+    bool ok = enc.data().size() == 2 + sizeof(bytes);
+    ok = ok && aborts([&] { enc.write_public_key_list(CTE_CRYPTO_TYPE_ED25519, {bytes, 40}); });
+    ok = ok && aborts([&] { enc.write_signature_list(CTE_CRYPTO_TYPE_SLH_DSA_128F, {bytes, 40}); });
+    if (!ok)
+        printf("  - ERROR: A partial list item was accepted!\n");
+    else
+        printf("  - Whole items written; partial items abort.\n");
+}
+
+/**
+ * @brief Checks that compile-time fragments match the runtime encoder byte for byte.
+ */
+static void test_prebaked()
+{
+    printf("\nPrebaked fragments:\n");
+    cte::encoder enc(BUFFER_SIZE);
+    enc.write_public_key_list(CTE_CRYPTO_TYPE_ED25519, prebaked_keys);
+    enc.write_command_data(pb::literal("transfer"));
+    enc.write_index_reference(3);
+    enc.write_uleb128(300);
+    enc.write_uleb128(UINT64_MAX);
+    enc.write_sleb128(-78910);
+    enc.write_int8(-120);
+    enc.write_uint16(60000);
+    enc.write_int32(-1000);
+    enc.write_uint64(9876543210ULL);
+    enc.write_float32(3.14159f);
+    enc.write_float64(1.23456789012345);
+    enc.write_boolean(true);
+    enc.write_boolean(false);
+    uint8_t zeros[150] = {0};
+    enc.write_command_data(zeros);
+
+    if (enc.data().size() != prebaked_tx.size() || memcmp(enc.data().data(), prebaked_tx.data(), prebaked_tx.size()) != 0)
+        printf("  - ERROR: Prebaked transaction differs from runtime encoding!\n");
+    else
+        printf("  - Prebaked transaction matches runtime encoding (%zu bytes).\n", prebaked_tx.size());
+
+    constexpr auto prefix = pb::concat(pb::command_data(pb::literal("transfer")), pb::boolean(true));
+    cte::encoder spliced(BUFFER_SIZE);
+    spliced.append(prefix);
+    spliced.write_uleb128(42);
+    cte::encoder manual(BUFFER_SIZE);
+    manual.write_command_data(pb::literal("transfer"));
+    manual.write_boolean(true);
+    manual.write_uleb128(42);
+    if (spliced.data().size() != manual.data().size() ||
+        memcmp(spliced.data().data(), manual.data().data(), manual.data().size()) != 0)
+        printf("  - ERROR: Appended prefix differs from runtime encoding!\n");
+    else
+        printf("  - Appended prefix matches runtime encoding.\n");
+}
+
+/**
+ * @brief Small deterministic generator for the differential test.
+ */
+static uint64_t next_random(uint64_t &state)
+{
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state >> 33;
+}
+
+/**
+ * @brief Appends one randomly chosen field with random contents to `enc`.
+ */
+static void write_random_field(cte::encoder &enc, uint64_t &state)
+{
+    static uint8_t payload[CTE_LIST_MAX_LEN * CTE_SIGNATURE_SIZE_ED25519];
+    for (size_t i = 0; i < sizeof(payload); ++i)
+        payload[i] = (uint8_t)next_random(state);
+    uint64_t r = next_random(state);
+    size_t count = 1 + next_random(state) % 3;
+    uint8_t crypto = (uint8_t)(next_random(state) % 4);
+    uint64_t wide = (next_random(state) << 32) ^ next_random(state);
+    int shift = (int)(next_random(state) % 64);
+    switch (r % 18)
+    {
+    case 0:
+        enc.write_public_key_list(crypto, {payload, count * cte::detail::public_key_size[crypto]});
+        break;
+    case 1:
+        enc.write_signature_list(crypto, {payload, count * cte::detail::signature_item_size[crypto]});
+        break;
+    case 2:
+        enc.write_index_reference((uint8_t)(wide % 16));
+        break;
+    case 3:
+        enc.write_uleb128(wide >> shift);
+        break;
+    case 4:
+        enc.write_sleb128((int64_t)wide >> shift);
+        break;
+    case 5:
+        enc.write_int8((int8_t)wide);
+        break;
+    case 6:
+        enc.write_int16((int16_t)wide);
+        break;
+    case 7:
+        enc.write_int32((int32_t)wide);
+        break;
+    case 8:
+        enc.write_int64((int64_t)wide);
+        break;
+    case 9:
+        enc.write_uint8((uint8_t)wide);
+        break;
+    case 10:
+        enc.write_uint16((uint16_t)wide);
+        break;
+    case 11:
+        enc.write_uint32((uint32_t)wide);
+        break;
+    case 12:
+        enc.write_uint64(wide);
+        break;
+    case 13:
+        enc.write_float32((float)(int64_t)wide / 7.0f);
+        break;
+    case 14:
+        enc.write_float64((double)(int64_t)wide / 3.0);
+        break;
+    case 15:
+        enc.write_boolean(wide & 1);
+        break;
+    case 16:
+        enc.write_command_data({payload, (size_t)(wide % 32)});
+        break;
+    default:
+        enc.write_command_data({payload, CTE_COMMAND_EXTENDED_MIN_LEN + (size_t)(wide % 200)});
+        break;
+    }
+}
+
+/**
+ * @brief Compares two decoded fields member by member.
+ */
+static bool same_field(const cte::field_view &a, const cte::field_view &b)
+{
+    if (a.type != b.type || a.offset != b.offset || a.count != b.count || a.bytes.data() != b.bytes.data() ||
+        a.bytes.size() != b.bytes.size())
+        return false;
+    switch (a.type)
+    {
+    case CTE_PEEK_TYPE_IXDATA_FLOAT32:
+        return memcmp(&a.value.f32, &b.value.f32, sizeof(float)) == 0;
+    case CTE_PEEK_TYPE_IXDATA_CONST_FALSE:
+    case CTE_PEEK_TYPE_IXDATA_CONST_TRUE:
+        return a.value.boolean == b.value.boolean;
+    case CTE_PEEK_TYPE_PK_LIST_ED25519:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_128F:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_192F:
+    case CTE_PEEK_TYPE_PK_LIST_SLH_256F:
+    case CTE_PEEK_TYPE_SIG_LIST_ED25519:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_128F:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_192F:
+    case CTE_PEEK_TYPE_SIG_LIST_SLH_256F:
+    case CTE_PEEK_TYPE_CMD_SHORT:
+    case CTE_PEEK_TYPE_CMD_EXTENDED:
+        return true;
+    default:
+        return a.value.u64 == b.value.u64;
+    }
+}
+
+/**
+ * @brief Differential test: the C decoder, `strict_decoder` and `minimal_decoder`
+ * must produce the same fields for randomly generated valid transactions.
+ */
+static void test_policy_decoders()
+{
+    printf("\nPolicy decoders:\n");
+    uint64_t state = 0x5EED;
+    int mismatches = 0;
+    size_t total_fields = 0;
+    for (int tx = 0; tx < 2000 && mismatches == 0; ++tx)
+    {
+        cte::encoder enc(CTE_MAX_TRANSACTION_SIZE);
+        size_t field_count = next_random(state) % 12;
+        for (size_t i = 0; i < field_count && enc.data().size() < 600; ++i)
+            write_random_field(enc, state);
+
+        cte::decoder reference(enc.data());
+        std::span<const uint8_t> bytes(reference.get()->data, reference.get()->size);
+        cte::strict_decoder strict(bytes);
+        cte::minimal_decoder minimal(bytes);
+        cte::field_view s, m;
+        for (const cte::field_view &f : reference.fields())
+        {
+            bool ok_s = strict.next(s);
+            bool ok_m = minimal.next(m);
+            if (!ok_s || !ok_m || !same_field(f, s) || !same_field(f, m))
+            {
+                printf("  - ERROR: Transaction %d differs at offset %zu!\n", tx, f.offset);
+                ++mismatches;
+                break;
+            }
+            ++total_fields;
+        }
+        if (mismatches == 0 && (strict.next(s) || minimal.next(m) || strict.position() != bytes.size() ||
+                                minimal.position() != bytes.size()))
+        {
+            printf("  - ERROR: Transaction %d: policy decoders did not stop at the end!\n", tx);
+            ++mismatches;
+        }
+    }
+    if (mismatches == 0)
+        printf("  - C, strict and minimal decoders agree on %zu fields.\n", total_fields);
+}
+
+/**
+ * @brief Reads the main test transaction through the typed reads of one policy.
+ */
+template <typename Policy>
+static void check_typed_reads(const char *name, std::span<const uint8_t> bytes, const uint8_t *keys,
+                              const char *short_cmd, size_t long_cmd_len)
+{
+    cte::basic_decoder<Policy> dec(bytes);
+    bool ok = dec.read_public_key_list().size() == 2 * CTE_PUBKEY_SIZE_ED25519 && dec.last_list_count() == 2;
+    ok = ok && memcmp(bytes.data() + 2, keys, 2 * CTE_PUBKEY_SIZE_ED25519) == 0;
+    ok = ok && dec.read_signature_list().size() == CTE_SIGNATURE_HASH_SIZE_PQC;
+    ok = ok && dec.read_index_reference() == 7;
+    ok = ok && dec.read_uleb128() == 123456;
+    ok = ok && dec.read_sleb128() == -78910;
+    ok = ok && dec.read_int16() == -30000;
+    ok = ok && dec.read_uint64() == 9876543210ULL;
+    ok = ok && dec.read_float64() == 1.23456789012345;
+    ok = ok && dec.read_boolean();
+    ok = ok && dec.read_command_data().size() == strlen(short_cmd);
+    ok = ok && dec.read_command_data().size() == long_cmd_len;
+    ok = ok && dec.position() == bytes.size();
+    if (!ok)
+        printf("  - ERROR: %s typed reads mismatch!\n", name);
+    else
+        printf("  - %s typed reads match.\n", name);
+}
+
+/**
+ * @brief Memory resource that counts what passes through it to an upstream resource.
+ */
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+    explicit counting_resource(std::pmr::memory_resource *upstream) : upstream_(upstream) {}
+
+    size_t live = 0;
+    size_t allocations = 0;
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        live += bytes;
+        ++allocations;
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override
+    {
+        live -= bytes;
+        upstream_->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+    std::pmr::memory_resource *upstream_;
+};
+
+/**
+ * @brief Checks that contexts created with a memory resource allocate and free only through it.
+ */
+static void test_pmr_allocator()
+{
+    printf("\nAllocator hooks:\n");
+    alignas(std::max_align_t) static uint8_t arena[8192];
+    std::pmr::monotonic_buffer_resource monotonic(arena, sizeof(arena), std::pmr::null_memory_resource());
+    counting_resource counting(&monotonic);
+    {
+        cte::encoder enc(512, &counting);
+        enc.write_uleb128(300);
+        cte::decoder dec(enc.data(), &counting);
+        uint8_t *context = reinterpret_cast<uint8_t *>(enc.get());
+        bool in_arena = context >= arena && context < arena + sizeof(arena) && dec.get()->data >= arena &&
+                        dec.get()->data < arena + sizeof(arena);
+        bool decoded = dec.peek_type() == CTE_PEEK_TYPE_IXDATA_ULEB128 && dec.read_uleb128() == 300;
+        if (counting.allocations != 4 || !in_arena || !decoded)
+            printf("  - ERROR: Contexts were not placed in the arena (%zu allocations)!\n", counting.allocations);
+    }
+    if (counting.live != 0)
+        printf("  - ERROR: %zu bytes were not returned to the memory resource!\n", counting.live);
+    else
+        printf("  - Encoder and decoder allocated %zu blocks from the arena and released them all.\n",
+               counting.allocations);
+}
+
+/**
+ * @brief Reads one shared transaction from several threads at once, each with
+ * its own cursors, and compares every field with a single-threaded pass.
+ */
+static void test_shared_transaction()
+{
+    printf("\nShared transaction:\n");
+    uint64_t state = 0xC0FFEE;
+    cte::encoder enc(CTE_MAX_TRANSACTION_SIZE);
+    while (enc.data().size() < 600)
+        write_random_field(enc, state);
+
+    cte::decoder reference(enc.data());
+    std::vector<cte::field_view> expected;
+    for (const cte::field_view &f : reference.fields())
+        expected.push_back(f);
+
+    cte_transaction_t tx;
+    cte_transaction_init(&tx, reference.get()->data, reference.get()->size);
+    std::vector<size_t> offsets(expected.size());
+    cte_transaction_build_index(&tx, offsets.data(), offsets.size());
+
+    constexpr size_t thread_count = 4;
+    size_t mismatches[thread_count] = {};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thread_count; ++t)
+    {
+        threads.emplace_back([&, t] {
+            for (int pass = 0; pass < 200; ++pass)
+            {
+                size_t first = (t * 7 + pass) % expected.size();
+                cte_cursor_t cursor = cte_transaction_cursor_at(&tx, first);
+                cte_field_t field;
+                for (size_t i = first; i < expected.size(); ++i)
+                {
+                    int type = cte_cursor_peek_type(&tx, &cursor);
+                    if (type != expected[i].type)
+                    {
+                        ++mismatches[t];
+                        break;
+                    }
+                    cte_cursor_read_field(&tx, &cursor, type, &field);
+                    if (field.offset != expected[i].offset || field.count != expected[i].count ||
+                        (field.data && field.data != expected[i].bytes.data()) ||
+                        field.length != expected[i].bytes.size())
+                        ++mismatches[t];
+                }
+                if (cte_cursor_peek_type(&tx, &cursor) != CTE_PEEK_EOF)
+                    ++mismatches[t];
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+
+    size_t total = 0;
+    for (size_t count : mismatches)
+        total += count;
+    if (tx.field_count != expected.size() || total != 0)
+        printf("  - ERROR: Concurrent cursors disagree with the reference pass (%zu mismatches)!\n", total);
+    else
+        printf("  - %zu threads read %zu fields concurrently and matched the reference.\n", thread_count,
+               expected.size());
+}
+
+/**
+ * @brief Main entry point for the native C++ layer test harness.
+ *
+ * Encodes a transaction through `cte::encoder`, then decodes it through the
+ * `cte::decoder` field range and compares every field with what was written.
+ * Mismatches are reported with an `ERROR:` line.
+ *
+ * @return 0 on successful completion.
+ */
+int main()
+{
+    printf("CTE C++ Layer Native Test\n");
+
+    uint8_t keys[2 * CTE_PUBKEY_SIZE_ED25519];
+    for (size_t i = 0; i < sizeof(keys); ++i)
+        keys[i] = (uint8_t)(0xAA + i);
+    uint8_t sig_hash[CTE_SIGNATURE_HASH_SIZE_PQC];
+    for (size_t i = 0; i < sizeof(sig_hash); ++i)
+        sig_hash[i] = (uint8_t)(0xBB + i);
+    uint8_t long_cmd[150];
+    memset(long_cmd, 'L', sizeof(long_cmd));
+    const char *short_cmd = "Short payload";
+
+    cte::encoder scratch(BUFFER_SIZE);
+    cte::encoder enc(std::move(scratch));
+    if (scratch.get() != nullptr)
+        printf("ERROR: Moved-from encoder still owns a context!\n");
+
+    enc.write_public_key_list(CTE_CRYPTO_TYPE_ED25519, keys);
+    enc.write_signature_list(CTE_CRYPTO_TYPE_SLH_DSA_128F, sig_hash);
+    enc.write_index_reference(7);
+    enc.write_uleb128(123456);
+    enc.write_sleb128(-78910);
+    enc.write_int16(-30000);
+    enc.write_uint64(9876543210ULL);
+    enc.write_float64(1.23456789012345);
+    enc.write_boolean(true);
+    enc.write_command_data({(const uint8_t *)short_cmd, strlen(short_cmd)});
+    enc.write_command_data(long_cmd);
+    printf("Encoded %zu bytes.\n", enc.data().size());
+
+    cte::decoder dec(enc.data());
+    auto fields = dec.fields();
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        int n = 0;
+        for (const cte::field_view &f : fields)
+        {
+            switch (n)
+            {
+            case 0:
+                if (f.type != CTE_PEEK_TYPE_PK_LIST_ED25519 || f.count != 2 || f.bytes.size() != sizeof(keys) ||
+                    memcmp(f.bytes.data(), keys, sizeof(keys)) != 0)
+                    printf("  - ERROR: Key list mismatch!\n");
+                break;
+            case 1:
+                if (f.type != CTE_PEEK_TYPE_SIG_LIST_SLH_128F || f.count != 1 || f.bytes.size() != sizeof(sig_hash))
+                    printf("  - ERROR: Sig list mismatch!\n");
+                break;
+            case 2:
+                if (f.type != CTE_PEEK_TYPE_IXDATA_LEGACY_INDEX || f.value.u64 != 7)
+                    printf("  - ERROR: Index mismatch!\n");
+                break;
+            case 3:
+                if (f.type != CTE_PEEK_TYPE_IXDATA_ULEB128 || f.value.u64 != 123456)
+                    printf("  - ERROR: ULEB128 mismatch!\n");
+                break;
+            case 4:
+                if (f.type != CTE_PEEK_TYPE_IXDATA_SLEB128 || f.value.i64 != -78910)
+                    printf("  - ERROR: SLEB128 mismatch!\n");
+                break;
+            case 5:
+                if (f.type != CTE_PEEK_TYPE_IXDATA_INT16 || f.value.i64 != -30000)
+                    printf("  - ERROR: Int16 mismatch!\n");
+                break;
+            case 6:
+                if (f.type != CTE_PEEK_TYPE_IXDATA_UINT64 || f.value.u64 != 9876543210ULL)
+                    printf("  - ERROR: Uint64 mismatch!\n");
+                break;
+            case 7:
+                if (f.type != CTE_PEEK_TYPE_IXDATA_FLOAT64 || f.value.f64 != 1.23456789012345)
+                    printf("  - ERROR: Float64 mismatch!\n");
+                break;
+            case 8:
+                if (f.type != CTE_PEEK_TYPE_IXDATA_CONST_TRUE || !f.value.boolean)
+                    printf("  - ERROR: Boolean mismatch!\n");
+                break;
+            case 9:
+                if (f.type != CTE_PEEK_TYPE_CMD_SHORT || f.bytes.size() != strlen(short_cmd) ||
+                    memcmp(f.bytes.data(), short_cmd, f.bytes.size()) != 0)
+                    printf("  - ERROR: Short command mismatch!\n");
+                break;
+            case 10:
+                if (f.type != CTE_PEEK_TYPE_CMD_EXTENDED || f.bytes.size() != sizeof(long_cmd) ||
+                    memcmp(f.bytes.data(), long_cmd, sizeof(long_cmd)) != 0)
+                    printf("  - ERROR: Extended command mismatch!\n");
+                break;
+            }
+            ++n;
+        }
+        if (n != 11)
+            printf("ERROR: Pass %d visited %d fields, expected 11!\n", pass, n);
+        else
+            printf("Pass %d: decoded all %d fields.\n", pass, n);
+    }
+
+    if (std::ranges::distance(fields) != 11)
+        printf("ERROR: Range distance mismatch!\n");
+    if (dec.get()->position != 0)
+        printf("ERROR: Iterating the range moved the owning decoder!\n");
+
+    test_prebaked();
+    test_policy_decoders();
+    test_pmr_allocator();
+    test_shared_transaction();
+    test_list_sizes();
+    check_typed_reads<cte::strict_checks>("Strict", enc.data(), keys, short_cmd, sizeof(long_cmd));
+    check_typed_reads<cte::minimal_checks>("Minimal", enc.data(), keys, short_cmd, sizeof(long_cmd));
+
+    printf("\n--- Test Complete ---\n");
+    return 0;
+}
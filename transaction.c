@@ -0,0 +1,116 @@
+#include "transaction.h"
+#include <stdlea.h>
+
+/**
+ * @brief Builds a decoder view of `transaction` positioned at `cursor`.
+ * @note Internal helper function.
+ */
+static cte_decoder_t _view(const cte_transaction_t *transaction, const cte_cursor_t *cursor)
+{
+    cte_decoder_t view = cte_decoder_view(transaction->data, transaction->size, cursor->position);
+    view.last_list_count = cursor->last_list_count;
+    view.last_cmd_len = cursor->last_cmd_len;
+    return view;
+}
+
+LEA_EXPORT(cte_transaction_init)
+void cte_transaction_init(cte_transaction_t *transaction, const uint8_t *data, size_t size)
+{
+    if (!transaction || !data)
+    {
+        lea_abort("Null argument to transaction_init");
+    }
+    if (size == 0)
+    {
+        lea_abort("Zero size buffer");
+    }
+    if (size > CTE_MAX_TRANSACTION_SIZE)
+    {
+        lea_abort("Initial buffer size exceeds max transaction size");
+    }
+    if (data[0] != CTE_VERSION_BYTE)
+    {
+        lea_abort("Invalid version byte");
+    }
+    transaction->data = data;
+    transaction->size = size;
+    transaction->field_offsets = NULL;
+    transaction->field_count = 0;
+}
+
+LEA_EXPORT(cte_transaction_build_index)
+size_t cte_transaction_build_index(cte_transaction_t *transaction, size_t *offsets, size_t capacity)
+{
+    if (!transaction || (!offsets && capacity != 0))
+    {
+        lea_abort("Null argument to transaction_build_index");
+    }
+    cte_cursor_t cursor = cte_transaction_cursor(transaction);
+    cte_field_t field;
+    size_t count = 0;
+    int type;
+    while ((type = cte_cursor_peek_type(transaction, &cursor)) != CTE_PEEK_EOF)
+    {
+        if (count < capacity)
+        {
+            offsets[count] = cursor.position;
+        }
+        count++;
+        cte_cursor_read_field(transaction, &cursor, type, &field);
+    }
+    if (count <= capacity)
+    {
+        transaction->field_offsets = offsets;
+        transaction->field_count = count;
+    }
+    return count;
+}
+
+LEA_EXPORT(cte_transaction_cursor)
+cte_cursor_t cte_transaction_cursor(const cte_transaction_t *transaction)
+{
+    cte_cursor_t cursor = {1, 0, 0};
+    (void)transaction;
+    return cursor;
+}
+
+LEA_EXPORT(cte_transaction_cursor_at)
+cte_cursor_t cte_transaction_cursor_at(const cte_transaction_t *transaction, size_t index)
+{
+    if (!transaction->field_offsets)
+    {
+        lea_abort("Transaction has no field index");
+    }
+    if (index >= transaction->field_count)
+    {
+        lea_abort("Field index out of range");
+    }
+    cte_cursor_t cursor = {transaction->field_offsets[index], 0, 0};
+    return cursor;
+}
+
+LEA_EXPORT(cte_cursor_peek_type)
+int cte_cursor_peek_type(const cte_transaction_t *transaction, const cte_cursor_t *cursor)
+{
+    if (!transaction || !cursor)
+    {
+        lea_abort("Null argument to cursor_peek_type");
+    }
+    cte_decoder_t view = _view(transaction, cursor);
+    return cte_decoder_peek_type(&view);
+}
+
+LEA_EXPORT(cte_cursor_read_field)
+void cte_cursor_read_field(const cte_transaction_t *transaction, cte_cursor_t *cursor, int type,
+                           cte_field_t *field)
+{
+    if (!transaction || !cursor)
+    {
+        lea_abort("Null argument to cursor_read_field");
+    }
+    cte_decoder_t view = _view(transaction, cursor);
+    cte_decoder_read_field(&view, type, field);
+    cursor->position = view.position;
+    cursor->last_list_count = view.last_list_count;
+    cursor->last_cmd_len = view.last_cmd_len;
+}
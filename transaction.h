@@ -0,0 +1,116 @@
+#ifndef TRANSACTION_H
+#define TRANSACTION_H
+
+#include "decoder.h"
+#include <stdlea.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file transaction.h
+ * @brief A read-only transaction shared by independent cursors.
+ *
+ * `cte_decoder_t` keeps its read position and last-read state next to the
+ * data, so a decoder cannot be shared between threads. Here the two are
+ * split: a `cte_transaction_t` holds the buffer (and optionally an index of
+ * field offsets) and is never written after setup, while each reader keeps
+ * its own `cte_cursor_t` by value. Any number of threads may read the same
+ * transaction at once without locks or copies.
+ *
+ * Fields are decoded by decoder.c, so validation and error messages are the
+ * same as for the regular decoder.
+ */
+
+/**
+ * @struct cte_transaction
+ * @brief An encoded transaction and its optional field index.
+ *
+ * The buffer and the index are borrowed; they must outlive the transaction
+ * and every field read from it. Set up the transaction (including
+ * `cte_transaction_build_index()`) before sharing it.
+ */
+typedef struct cte_transaction
+{
+    const uint8_t *data;         /**< @param data The encoded transaction, starting with the version byte. */
+    size_t size;                 /**< @param size Size of the transaction in bytes. */
+    const size_t *field_offsets; /**< @param field_offsets Offset of each field's header byte, or NULL. */
+    size_t field_count;          /**< @param field_count Number of entries in `field_offsets`. */
+} cte_transaction_t;
+
+/**
+ * @struct cte_cursor
+ * @brief One reader's position in a transaction. Copy it to fork a reader.
+ */
+typedef struct cte_cursor
+{
+    size_t position;        /**< @param position Offset of the next field's header byte. */
+    size_t last_list_count; /**< @param last_list_count Item count of the last list read. */
+    size_t last_cmd_len;    /**< @param last_cmd_len Payload length of the last command data read. */
+} cte_cursor_t;
+
+/**
+ * @brief Wraps an encoded transaction for shared reading.
+ * @param transaction The transaction to initialize.
+ * @param data The encoded bytes; not copied.
+ * @param size The number of bytes at `data`.
+ * @note Aborts via `lea_abort` if size is 0 or exceeds `CTE_MAX_TRANSACTION_SIZE`,
+ * or if the version byte is incorrect.
+ */
+void cte_transaction_init(cte_transaction_t *transaction, const uint8_t *data, size_t size);
+
+/**
+ * @brief Walks the transaction once and records the offset of every field.
+ *
+ * The index is attached only if all offsets fit in `capacity`; pass a
+ * capacity of 0 to count the fields first.
+ *
+ * @param transaction The transaction; must not be shared yet.
+ * @param offsets Storage for the offsets; must outlive the transaction.
+ * @param capacity The number of elements in `offsets`.
+ * @return The number of fields in the transaction.
+ * @warning Aborts on malformed data, like the regular decoder.
+ */
+size_t cte_transaction_build_index(cte_transaction_t *transaction, size_t *offsets, size_t capacity);
+
+/**
+ * @brief Returns a cursor at the first field after the version byte.
+ * @param transaction The transaction.
+ * @return The new cursor.
+ */
+cte_cursor_t cte_transaction_cursor(const cte_transaction_t *transaction);
+
+/**
+ * @brief Returns a cursor at the field with the given index.
+ * @param transaction A transaction with a field index.
+ * @param index The zero-based field number.
+ * @return The new cursor.
+ * @note Aborts via `lea_abort` if there is no index or `index` is out of range.
+ */
+cte_cursor_t cte_transaction_cursor_at(const cte_transaction_t *transaction, size_t index);
+
+/**
+ * @brief Identifies the field at the cursor without consuming it.
+ * @param transaction The transaction.
+ * @param cursor The cursor.
+ * @return The `CTE_PEEK_TYPE_*` identifier, or `CTE_PEEK_EOF` at the end.
+ */
+int cte_cursor_peek_type(const cte_transaction_t *transaction, const cte_cursor_t *cursor);
+
+/**
+ * @brief Reads the field at the cursor and advances past it.
+ * @param transaction The transaction.
+ * @param cursor The cursor to advance.
+ * @param type The identifier returned by `cte_cursor_peek_type()` for this field.
+ * @param field The structure to fill; `data` points into the transaction.
+ * @warning Aborts on malformed data or if `type` is not a valid field type.
+ */
+void cte_cursor_read_field(const cte_transaction_t *transaction, cte_cursor_t *cursor, int type,
+                           cte_field_t *field);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRANSACTION_H
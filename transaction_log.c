@@ -0,0 +1,683 @@
+#include "transaction_log.h"
+#include "decoder.h"
+#include <stdlea.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/** @brief Length of a segment file name: 20 digits and the suffix. */
+#define SEGMENT_NAME_LENGTH (20 + sizeof(CTE_LOG_SEGMENT_SUFFIX) - 1)
+/** @brief Appends wait once the unwritten batch holds this many times `batch_size`. */
+#define MAX_QUEUED_BATCHES 4
+/** @brief Smallest batch buffer allocation. */
+#define MIN_BATCH_CAPACITY (64 * 1024)
+
+/** @brief A point in a batch where a new segment starts. */
+typedef struct
+{
+    size_t offset;  /**< Offset in the batch of the new segment's header. */
+    uint64_t first; /**< Sequence number of the segment's first transaction. */
+} segment_start_t;
+
+/** @brief Bytes collected for one write, and the segments started inside them. */
+typedef struct
+{
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+    segment_start_t *starts;
+    size_t start_count;
+    size_t start_capacity;
+} batch_t;
+
+struct cte_log
+{
+    cte_log_options_t options;
+    int directory_fd;
+    int segment_fd; /**< The current segment file; written only by the flusher. */
+    pthread_t flusher;
+    pthread_mutex_t lock;
+    pthread_cond_t wake; /**< Wakes the flusher. */
+    pthread_cond_t done; /**< Wakes appends and syncs after a batch is written. */
+    // Everything below is guarded by `lock`.
+    cte_container_writer_t *writer; /**< Writes the current segment into `filling`. */
+    uint32_t segment_interval;      /**< Sync interval of the current segment. */
+    size_t segment_bytes;           /**< Size of the current segment, unwritten bytes included. */
+    batch_t batches[2];
+    batch_t *filling;            /**< The batch appends go to; the other one is being written. */
+    uint64_t oldest_ns;          /**< When the oldest transaction in `filling` was appended. */
+    uint64_t next_sequence;      /**< Sequence number of the next append. */
+    uint64_t durable_sequence;   /**< Every transaction below this is durable. */
+    uint64_t requested_sequence; /**< A sync waits for every transaction below this. */
+    bool closing;
+    int error; /**< `errno` of the first failed write or sync, or 0. */
+    cte_log_stats_t stats;
+};
+
+/**
+ * @brief Reads the monotonic clock.
+ * @note Internal helper function.
+ */
+static uint64_t _now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Formats the file name of the segment starting at `first`.
+ * @note Internal helper function.
+ */
+static void _segment_name(char name[SEGMENT_NAME_LENGTH + 1], uint64_t first)
+{
+    snprintf(name, SEGMENT_NAME_LENGTH + 1, "%020" PRIu64 CTE_LOG_SEGMENT_SUFFIX, first);
+}
+
+/**
+ * @brief Writes all bytes, retrying short and interrupted writes.
+ * @note Internal helper function.
+ */
+static bool _write_all(int fd, const uint8_t *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(fd, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+/**
+ * @brief Doubles a buffer until it holds `needed` items.
+ * @note Internal helper function.
+ */
+static void *_grow(void *array, size_t *capacity, size_t needed, size_t item, size_t minimum)
+{
+    if (needed <= *capacity)
+    {
+        return array;
+    }
+    size_t grown = *capacity ? *capacity : minimum;
+    while (grown < needed)
+    {
+        grown *= 2;
+    }
+    void *bigger = cte_allocate(NULL, grown * item, 8);
+    if (array)
+    {
+        memcpy(bigger, array, *capacity * item);
+        cte_deallocate(NULL, array, *capacity * item, 8);
+    }
+    *capacity = grown;
+    return bigger;
+}
+
+/**
+ * @brief Container sink of the current segment: appends to the filling batch.
+ * @note Internal helper function. Called with the lock held.
+ */
+static bool _batch_sink(void *context, const uint8_t *data, size_t size)
+{
+    cte_log_t *log = context;
+    batch_t *batch = log->filling;
+    batch->data = _grow(batch->data, &batch->capacity, batch->size + size, 1, MIN_BATCH_CAPACITY);
+    memcpy(batch->data + batch->size, data, size);
+    batch->size += size;
+    log->segment_bytes += size;
+    return true;
+}
+
+/**
+ * @brief Starts a new segment in the filling batch; the flusher creates its file.
+ * @note Internal helper function. Called with the lock held.
+ */
+static void _start_segment(cte_log_t *log, uint64_t first)
+{
+    batch_t *batch = log->filling;
+    batch->starts = _grow(batch->starts, &batch->start_capacity, batch->start_count + 1, sizeof(segment_start_t), 4);
+    batch->starts[batch->start_count++] = (segment_start_t){batch->size, first};
+    log->segment_bytes = 0;
+    log->segment_interval = log->options.sync_interval;
+    log->writer = cte_container_writer_init(log->options.sync_interval,
+                                            log->options.checksums ? CTE_CONTAINER_CHECKSUMS : 0, _batch_sink,
+                                            log, NULL);
+}
+
+/**
+ * @brief Size of the index and trailer that finish a segment of `records` records.
+ * @note Internal helper function.
+ */
+static size_t _index_size(const cte_log_t *log, uint64_t records)
+{
+    uint64_t blocks = (records + log->segment_interval - 1) / log->segment_interval;
+    return (size_t)(8 * blocks + 4 * records) + CTE_CONTAINER_TRAILER_SIZE;
+}
+
+/**
+ * @brief Writes a batch, creating the segments that start inside it, and syncs it.
+ * @note Internal helper function. Called by the flusher without the lock.
+ */
+static bool _write_batch(cte_log_t *log, const batch_t *batch)
+{
+    bool created = false;
+    size_t written = 0;
+    for (size_t i = 0; i <= batch->start_count; ++i)
+    {
+        size_t end = i < batch->start_count ? batch->starts[i].offset : batch->size;
+        if (end > written && !_write_all(log->segment_fd, batch->data + written, end - written))
+        {
+            return false;
+        }
+        written = end;
+        if (i == batch->start_count)
+        {
+            break;
+        }
+
+        // The previous segment is complete on disk before the next one exists.
+        if (log->segment_fd >= 0)
+        {
+            if (fdatasync(log->segment_fd) != 0)
+            {
+                return false;
+            }
+            close(log->segment_fd);
+        }
+        char name[SEGMENT_NAME_LENGTH + 1];
+        _segment_name(name, batch->starts[i].first);
+        log->segment_fd = openat(log->directory_fd, name, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+        if (log->segment_fd < 0)
+        {
+            return false;
+        }
+        created = true;
+    }
+    if (fdatasync(log->segment_fd) != 0)
+    {
+        return false;
+    }
+    return !created || fsync(log->directory_fd) == 0;
+}
+
+/**
+ * @brief Background thread writing batches: the group commit.
+ *
+ * While one batch is written and synced, appends fill the other, so a sync
+ * covers everything that arrived during the previous one.
+ *
+ * @note Internal helper function.
+ */
+static void *_flusher(void *arg)
+{
+    cte_log_t *log = arg;
+    pthread_mutex_lock(&log->lock);
+    for (;;)
+    {
+        batch_t *batch = log->filling;
+        if (batch->size == 0)
+        {
+            if (log->closing)
+            {
+                break;
+            }
+            pthread_cond_wait(&log->wake, &log->lock);
+            continue;
+        }
+        uint64_t deadline = log->oldest_ns + (uint64_t)log->options.max_delay_us * 1000u;
+        if (!log->closing && log->requested_sequence <= log->durable_sequence &&
+            batch->size < log->options.batch_size && _now_ns() < deadline)
+        {
+            struct timespec until = {(time_t)(deadline / 1000000000u), (long)(deadline % 1000000000u)};
+            pthread_cond_timedwait(&log->wake, &log->lock, &until);
+            continue;
+        }
+
+        log->filling = batch == &log->batches[0] ? &log->batches[1] : &log->batches[0];
+        uint64_t end = log->next_sequence;
+        pthread_mutex_unlock(&log->lock);
+        bool written = _write_batch(log, batch);
+        int error = errno;
+        pthread_mutex_lock(&log->lock);
+
+        if (!written)
+        {
+            log->error = error ? error : EIO;
+            pthread_cond_broadcast(&log->done);
+            break;
+        }
+        log->stats.durable += end - log->durable_sequence;
+        log->durable_sequence = end;
+        log->stats.batches++;
+        log->stats.bytes += batch->size;
+        log->stats.segments += batch->start_count;
+        batch->size = 0;
+        batch->start_count = 0;
+        pthread_cond_broadcast(&log->done);
+    }
+    pthread_mutex_unlock(&log->lock);
+    return NULL;
+}
+
+/**
+ * @brief Compares segment sequence numbers for `qsort`.
+ * @note Internal helper function.
+ */
+static int _compare_firsts(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * @brief Lists the first sequence numbers of the segment files, sorted.
+ * @note Internal helper function.
+ */
+static bool _list_segments(int directory_fd, uint64_t **firsts, size_t *count, size_t *capacity)
+{
+    int fd = dup(directory_fd);
+    DIR *directory = fd >= 0 ? fdopendir(fd) : NULL;
+    if (!directory)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return false;
+    }
+    rewinddir(directory);
+    struct dirent *entry;
+    while ((entry = readdir(directory)) != NULL)
+    {
+        const char *name = entry->d_name;
+        if (strlen(name) != SEGMENT_NAME_LENGTH || strcmp(name + 20, CTE_LOG_SEGMENT_SUFFIX) != 0 ||
+            strspn(name, "0123456789") != 20)
+        {
+            continue;
+        }
+        *firsts = _grow(*firsts, capacity, *count + 1, sizeof(uint64_t), 16);
+        (*firsts)[(*count)++] = strtoull(name, NULL, 10);
+    }
+    closedir(directory);
+    // An empty directory leaves *firsts NULL, which qsort must not be given.
+    if (*count > 1)
+    {
+        qsort(*firsts, *count, sizeof(uint64_t), _compare_firsts);
+    }
+    return true;
+}
+
+/**
+ * @brief Recovers one segment, cutting off a torn tail.
+ *
+ * A finished segment is trusted. Segments are finished and synced before
+ * the next one is created, so only the last may be unfinished: it keeps its
+ * records up to the first that fails to frame, checksum or decode, and is
+ * continued. An unfinished earlier segment is damage and is left untouched.
+ *
+ * @param next In: the segment's first sequence number. Out: the sequence number after its last record.
+ * @note Internal helper function.
+ */
+static bool _recover_segment(cte_log_t *log, bool last, uint64_t *next, cte_log_recovery_t *recovery)
+{
+    char name[SEGMENT_NAME_LENGTH + 1];
+    _segment_name(name, *next);
+    int fd = openat(log->directory_fd, name, O_RDWR | O_CLOEXEC);
+    struct stat status;
+    if (fd < 0)
+    {
+        return false;
+    }
+    if (fstat(fd, &status) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)status.st_size;
+    const uint8_t *data = NULL;
+    cte_container_t container;
+    if (size >= CTE_CONTAINER_HEADER_SIZE)
+    {
+        data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            return false;
+        }
+    }
+    if (!data || !cte_container_open(&container, data, size))
+    {
+        if (data)
+        {
+            munmap((void *)data, size);
+        }
+        close(fd);
+        // Only a crash while creating the last segment leaves it without a complete header.
+        if (!last || size >= CTE_CONTAINER_HEADER_SIZE)
+        {
+            errno = EBADMSG;
+            return false;
+        }
+        recovery->truncated_bytes += size;
+        return unlinkat(log->directory_fd, name, 0) == 0 && fsync(log->directory_fd) == 0;
+    }
+    if (container.indexed)
+    {
+        *next += container.record_count;
+        munmap((void *)data, size);
+        close(fd);
+        return true;
+    }
+    if (!last)
+    {
+        munmap((void *)data, size);
+        close(fd);
+        errno = EBADMSG;
+        return false;
+    }
+
+    size_t offset = CTE_CONTAINER_HEADER_SIZE;
+    size_t end = offset;
+    uint64_t index = 0;
+    uint64_t records = 0;
+    cte_container_record_t record;
+    while (cte_container_next(&container, &offset, &index, &record) == CTE_CONTAINER_OK &&
+           record.index == records && cte_decoder_validate(record.data, record.size, NULL))
+    {
+        end = offset;
+        records++;
+    }
+    cte_container_writer_t *writer = cte_container_writer_resume(&container, end, _batch_sink, log, NULL);
+    munmap((void *)data, size);
+    if (!writer)
+    {
+        close(fd);
+        errno = EBADMSG;
+        return false;
+    }
+    if (end < size)
+    {
+        if (ftruncate(fd, (off_t)end) != 0 || fsync(fd) != 0)
+        {
+            cte_container_writer_free(writer);
+            close(fd);
+            return false;
+        }
+        recovery->truncated_bytes += size - end;
+    }
+    lseek(fd, 0, SEEK_END);
+    *next += records;
+    log->writer = writer;
+    log->segment_interval = container.sync_interval;
+    log->segment_bytes = end;
+    log->segment_fd = fd;
+    return true;
+}
+
+/**
+ * @brief Recovers every segment and positions the log after the last record.
+ * @note Internal helper function.
+ */
+static bool _recover(cte_log_t *log, cte_log_recovery_t *recovery)
+{
+    uint64_t *firsts = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    if (!_list_segments(log->directory_fd, &firsts, &count, &capacity))
+    {
+        return false;
+    }
+    recovery->segments = count;
+    uint64_t next = count ? firsts[0] : 0;
+    bool recovered = true;
+    for (size_t i = 0; recovered && i < count; ++i)
+    {
+        if (firsts[i] != next)
+        {
+            errno = EBADMSG;
+            recovered = false;
+            break;
+        }
+        recovered = _recover_segment(log, i + 1 == count, &next, recovery);
+    }
+    if (firsts)
+    {
+        cte_deallocate(NULL, firsts, capacity * sizeof(uint64_t), 8);
+    }
+    if (!recovered)
+    {
+        return false;
+    }
+    recovery->next_sequence = next;
+    log->next_sequence = next;
+    log->durable_sequence = next;
+    log->requested_sequence = next;
+    if (!log->writer)
+    {
+        _start_segment(log, next);
+    }
+    log->oldest_ns = _now_ns();
+    return true;
+}
+
+/**
+ * @brief Releases everything a log owns; the flusher must not be running.
+ * @note Internal helper function.
+ */
+static void _free_log(cte_log_t *log)
+{
+    cte_container_writer_free(log->writer);
+    for (size_t i = 0; i < 2; ++i)
+    {
+        batch_t *batch = &log->batches[i];
+        if (batch->data)
+        {
+            cte_deallocate(NULL, batch->data, batch->capacity, 8);
+        }
+        if (batch->starts)
+        {
+            cte_deallocate(NULL, batch->starts, batch->start_capacity * sizeof(segment_start_t), 8);
+        }
+    }
+    if (log->segment_fd >= 0)
+    {
+        close(log->segment_fd);
+    }
+    close(log->directory_fd);
+    pthread_cond_destroy(&log->done);
+    pthread_cond_destroy(&log->wake);
+    pthread_mutex_destroy(&log->lock);
+    cte_deallocate(NULL, log, sizeof(cte_log_t), _Alignof(cte_log_t));
+}
+
+LEA_EXPORT(cte_log_default_options)
+void cte_log_default_options(cte_log_options_t *options)
+{
+    options->segment_size = 64 * 1024 * 1024;
+    options->batch_size = 1024 * 1024;
+    options->max_delay_us = 1000;
+    options->sync_interval = 1024;
+    options->checksums = true;
+}
+
+LEA_EXPORT(cte_log_open)
+cte_log_t *cte_log_open(const char *directory, const cte_log_options_t *options, cte_log_recovery_t *recovery)
+{
+    cte_log_options_t defaults;
+    if (!options)
+    {
+        cte_log_default_options(&defaults);
+        options = &defaults;
+    }
+    if (options->segment_size < CTE_LOG_MIN_SEGMENT_SIZE || options->batch_size < 1 ||
+        options->sync_interval < 1 || options->sync_interval > CTE_CONTAINER_MAX_SYNC_INTERVAL)
+    {
+        lea_abort("Log option out of range");
+    }
+    if (mkdir(directory, 0777) != 0 && errno != EEXIST)
+    {
+        return NULL;
+    }
+    int directory_fd = open(directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (directory_fd < 0)
+    {
+        return NULL;
+    }
+
+    cte_log_t *log = cte_allocate(NULL, sizeof(cte_log_t), _Alignof(cte_log_t));
+    memset(log, 0, sizeof(*log));
+    log->options = *options;
+    log->directory_fd = directory_fd;
+    log->segment_fd = -1;
+    log->filling = &log->batches[0];
+    pthread_mutex_init(&log->lock, NULL);
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&log->wake, &attributes);
+    pthread_cond_init(&log->done, NULL);
+    pthread_condattr_destroy(&attributes);
+
+    cte_log_recovery_t found = {0};
+    int error = 0;
+    if (!_recover(log, &found))
+    {
+        error = errno;
+    }
+    else if ((error = pthread_create(&log->flusher, NULL, _flusher, log)) == 0)
+    {
+        if (recovery)
+        {
+            *recovery = found;
+        }
+        return log;
+    }
+    _free_log(log);
+    errno = error;
+    return NULL;
+}
+
+LEA_EXPORT(cte_log_append)
+bool cte_log_append(cte_log_t *log, const uint8_t *data, size_t size, uint64_t *sequence)
+{
+    if (!cte_decoder_validate(data, size, NULL))
+    {
+        errno = EINVAL;
+        return false;
+    }
+    pthread_mutex_lock(&log->lock);
+    while (!log->error && log->filling->size >= MAX_QUEUED_BATCHES * log->options.batch_size)
+    {
+        pthread_cond_wait(&log->done, &log->lock);
+    }
+    if (log->error)
+    {
+        errno = log->error;
+        pthread_mutex_unlock(&log->lock);
+        return false;
+    }
+
+    // Roll over before the record (sync marker, length and checksum included) and the index would not fit.
+    uint64_t records = cte_container_writer_count(log->writer);
+    if (records > 0 && log->segment_bytes + CTE_CONTAINER_SYNC_SIZE + 2 + size + 4 + _index_size(log, records + 1) >
+                           log->options.segment_size)
+    {
+        cte_container_writer_finish(log->writer);
+        cte_container_writer_free(log->writer);
+        _start_segment(log, log->next_sequence);
+    }
+    batch_t *batch = log->filling;
+    size_t before = batch->size;
+    cte_container_writer_append(log->writer, data, size);
+    if (sequence)
+    {
+        *sequence = log->next_sequence;
+    }
+    log->next_sequence++;
+    log->stats.appended++;
+    if (before == 0)
+    {
+        log->oldest_ns = _now_ns();
+        pthread_cond_signal(&log->wake);
+    }
+    else if (before < log->options.batch_size && batch->size >= log->options.batch_size)
+    {
+        pthread_cond_signal(&log->wake);
+    }
+    pthread_mutex_unlock(&log->lock);
+    return true;
+}
+
+LEA_EXPORT(cte_log_sync)
+bool cte_log_sync(cte_log_t *log, uint64_t sequence)
+{
+    pthread_mutex_lock(&log->lock);
+    if (sequence >= log->next_sequence)
+    {
+        lea_abort("Sync of a transaction not yet appended");
+    }
+    if (log->requested_sequence <= sequence)
+    {
+        log->requested_sequence = sequence + 1;
+        pthread_cond_signal(&log->wake);
+    }
+    while (!log->error && log->durable_sequence <= sequence)
+    {
+        pthread_cond_wait(&log->done, &log->lock);
+    }
+    bool durable = log->durable_sequence > sequence;
+    if (!durable)
+    {
+        errno = log->error;
+    }
+    pthread_mutex_unlock(&log->lock);
+    return durable;
+}
+
+LEA_EXPORT(cte_log_stats)
+void cte_log_stats(cte_log_t *log, cte_log_stats_t *stats)
+{
+    pthread_mutex_lock(&log->lock);
+    *stats = log->stats;
+    pthread_mutex_unlock(&log->lock);
+}
+
+LEA_EXPORT(cte_log_close)
+bool cte_log_close(cte_log_t *log)
+{
+    if (!log)
+    {
+        return true;
+    }
+    pthread_mutex_lock(&log->lock);
+    // An empty segment stays unfinished, so the next open continues it instead of reusing its name.
+    if (!log->error && cte_container_writer_count(log->writer) > 0)
+    {
+        cte_container_writer_finish(log->writer);
+    }
+    log->closing = true;
+    pthread_cond_signal(&log->wake);
+    pthread_mutex_unlock(&log->lock);
+    pthread_join(log->flusher, NULL);
+
+    int error = log->error;
+    _free_log(log);
+    errno = error;
+    return error == 0;
+}
@@ -0,0 +1,148 @@
+#ifndef TRANSACTION_LOG_H
+#define TRANSACTION_LOG_H
+
+#include "container.h"
+#include <stdlea.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file transaction_log.h
+ * @brief A durable, append-only log of transactions with group commit.
+ *
+ * The log is a directory of segment files. Each segment is a container (see
+ * container.h) named after the sequence number of its first transaction,
+ * `%020llu.ctelog`. Once a segment would grow past the configured size it
+ * is finished (index and trailer written) and a new one is started.
+ *
+ * Appends only copy the transaction into an in-memory batch. A background
+ * thread writes each batch with one `write` and one `fdatasync` while the
+ * next batch fills, so many transactions share the cost of a sync. A batch
+ * is written when it reaches `batch_size` bytes, when its oldest
+ * transaction has waited `max_delay_us`, or as soon as a caller waits for
+ * it with `cte_log_sync()`.
+ *
+ * Opening a log recovers it after a crash. Every record of an unfinished
+ * segment is checked (framing, checksum if enabled, and a full decode), and
+ * the segment is cut off before the first record that fails: a torn write
+ * can only lose transactions no `cte_log_sync()` call had returned for.
+ *
+ * POSIX only; not part of the WASM builds.
+ */
+
+/** @brief Extension of segment file names. */
+#define CTE_LOG_SEGMENT_SUFFIX ".ctelog"
+/** @brief Smallest accepted `segment_size`. */
+#define CTE_LOG_MIN_SEGMENT_SIZE (64 * 1024)
+
+/**
+ * @struct cte_log_options
+ * @brief Tuning of a log, filled with defaults by `cte_log_default_options()`.
+ */
+typedef struct cte_log_options
+{
+    size_t segment_size;    /**< @param segment_size Largest segment file, index included (default 64 MiB). */
+    size_t batch_size;      /**< @param batch_size Bytes that trigger a write without waiting (default 1 MiB). */
+    uint32_t max_delay_us;  /**< @param max_delay_us Longest a transaction waits before its batch is written (default 1000). */
+    uint32_t sync_interval; /**< @param sync_interval Container sync interval of new segments (default 1024). */
+    bool checksums;         /**< @param checksums Store a CRC-32C with every record (default `true`). */
+} cte_log_options_t;
+
+/**
+ * @struct cte_log_recovery
+ * @brief What `cte_log_open()` found on disk.
+ */
+typedef struct cte_log_recovery
+{
+    uint64_t next_sequence;   /**< @param next_sequence Sequence number the next append receives. */
+    uint64_t truncated_bytes; /**< @param truncated_bytes Bytes of torn or damaged records cut off. */
+    size_t segments;          /**< @param segments Segment files found. */
+} cte_log_recovery_t;
+
+/**
+ * @struct cte_log_stats
+ * @brief Counters since the log was opened.
+ */
+typedef struct cte_log_stats
+{
+    uint64_t appended; /**< @param appended Transactions appended. */
+    uint64_t durable;  /**< @param durable Transactions written and synced. */
+    uint64_t batches;  /**< @param batches Batches written, i.e. `fdatasync` calls. */
+    uint64_t bytes;    /**< @param bytes Bytes written to segment files. */
+    uint64_t segments; /**< @param segments Segment files created. */
+} cte_log_stats_t;
+
+/** @brief Opaque log. */
+typedef struct cte_log cte_log_t;
+
+/**
+ * @brief Fills `options` with the defaults.
+ * @param options The options to fill.
+ */
+void cte_log_default_options(cte_log_options_t *options);
+
+/**
+ * @brief Opens (creating if needed) the log in a directory and recovers it.
+ *
+ * Only the last segment is normally unfinished. If it was finished, or the
+ * directory holds no segments, appends go to a new segment. Otherwise they
+ * continue the last one after its last intact record.
+ *
+ * @param directory The log directory; created if missing.
+ * @param options The tuning, or NULL for the defaults. The record format of
+ * an existing unfinished segment is kept.
+ * @param recovery Receives what was found; may be NULL.
+ * @return A pointer to the new log, or NULL with `errno` set. `EBADMSG`
+ * means a segment other than the last is damaged or missing.
+ * @note Aborts via `lea_abort` if an option is out of range.
+ */
+cte_log_t *cte_log_open(const char *directory, const cte_log_options_t *options, cte_log_recovery_t *recovery);
+
+/**
+ * @brief Appends a transaction; it becomes durable with a later batch.
+ *
+ * Safe to call from several threads. Blocks only while the unwritten
+ * batches exceed a few times `batch_size`.
+ *
+ * @param log The log.
+ * @param data The encoded transaction, e.g. from `cte_encoder_get_data()`.
+ * @param size Its size, 1 to `CTE_MAX_TRANSACTION_SIZE`.
+ * @param sequence Receives the transaction's sequence number; may be NULL.
+ * @return `false` with `errno` set to `EINVAL` if the transaction does not
+ * decode, or to the error of a failed write; after a write error every
+ * later call fails.
+ */
+bool cte_log_append(cte_log_t *log, const uint8_t *data, size_t size, uint64_t *sequence);
+
+/**
+ * @brief Waits until a transaction and all before it are durable.
+ * @param log The log.
+ * @param sequence A sequence number returned by `cte_log_append()`.
+ * @return `false` with `errno` set if a write or sync failed.
+ */
+bool cte_log_sync(cte_log_t *log, uint64_t sequence);
+
+/**
+ * @brief Reads the counters.
+ * @param log The log.
+ * @param stats Receives the counters.
+ */
+void cte_log_stats(cte_log_t *log, cte_log_stats_t *stats);
+
+/**
+ * @brief Writes everything appended, finishes the current segment and releases the log.
+ *
+ * The next `cte_log_open()` starts a new segment.
+ *
+ * @param log The log; NULL is a no-op.
+ * @return `false` with `errno` set if a write or sync failed at any point.
+ */
+bool cte_log_close(cte_log_t *log);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRANSACTION_LOG_H